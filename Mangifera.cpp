@@ -56,12 +56,16 @@ protected:
 int main(int argc, char** argv)
 {
     bool headless = false;
+    bool pipelined = false;
     uint32_t headless_frames = 1;
     for (int index = 1; index < argc; ++index) {
         const std::string arg = argv[index];
         if (arg == "--headless") {
             headless = true;
         }
+        else if (arg == "--pipelined") {
+            pipelined = true;
+        }
         else if (arg == "--frames" && index + 1 < argc) {
             headless_frames = static_cast<uint32_t>((std::max)(std::stoi(argv[++index]), 1));
         }
@@ -100,6 +104,7 @@ int main(int argc, char** argv)
         app_desc.graphics_backend = app::Graphics_Backend::Vulkan;
         app_desc.max_frames_in_flight = 2;
         app_desc.run_mode = app::Run_Mode::runtime;
+        app_desc.pipelined_rendering = pipelined;
 
         // Create and run application
         Test_Application app(app_desc);
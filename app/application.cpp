@@ -2,7 +2,9 @@
 #include "application.hpp"
 #include "log/historiographer.hpp"
 #include "manager/world.hpp"
+#include "thread/worker-pool.hpp"
 #include "resource/transform.hpp"
+#include "resource/world_transform.hpp"
 #include "resource/camera.hpp"
 #include "resource/mesh.hpp"
 #include "resource/model.hpp"
@@ -24,6 +26,9 @@
 #include <cstring>
 #include <cstddef>
 #include <filesystem>
+#include <algorithm>
+#include <utility>
+#include <cmath>
 
 namespace
 {
@@ -35,13 +40,6 @@ namespace
         mango::math::Vec4 camera_pos;
     };
 
-    struct Push_Constants
-    {
-        mango::math::Mat4 model;
-        mango::math::Vec4 base_color;
-        mango::math::Vec4 params;
-    };
-
     static constexpr int MAX_LIGHTS = 8;
 
     struct Light_Data
@@ -80,6 +78,8 @@ namespace mango::app
 
     Application::Application(const Application_Desc& desc)
         : desc_(desc)
+        , viewport_width_(desc.width)
+        , viewport_height_(desc.height)
     {
         UH_INFO("=== Mangifera Starting ===");
         UH_INFO_FMT("Application: {}", desc_.title);
@@ -172,6 +172,7 @@ namespace mango::app
         renderer_ = std::make_unique<Renderer>(renderer_desc);
 
         renderer_->set_pre_render_callback([this](graphics::Command_Buffer_Handle cmd) {
+            run_gpu_culling(cmd);
             render_shadow_pass(cmd);
         });
 
@@ -181,46 +182,28 @@ namespace mango::app
 
         renderer_->set_post_process_callback([this](graphics::Command_Buffer_Handle cmd) {
             if (post_process_manager_.is_ready()) {
-                post_process_manager_.set_delta_time(delta_time_);
-                post_process_manager_.set_frame_index(static_cast<uint32_t>(frame_count_));
+                post_process_manager_.set_delta_time(frame_context_.delta_time);
+                post_process_manager_.set_frame_index(static_cast<uint32_t>(frame_context_.frame_index));
 
                 // Pass projection matrix to post-process (needed for SSAO)
-                auto* world = core::World::current_instance();
-                if (world) {
-                    auto* cam_store = world->get_twig_storage<resource::Camera>();
-                    auto* t_store = world->get_twig_storage<resource::Transform>();
-                    if (cam_store && !cam_store->data.empty() && t_store) {
-                        auto& cam_pair = *cam_store->data.begin();
-                        auto& cam = cam_pair.second;
-                        auto proj = cam.get_projection_matrix();
-                        post_process_manager_.set_projection_matrix(&proj[0][0]);
-                        auto inv_proj = glm::inverse(proj);
-                        post_process_manager_.set_inv_projection_matrix(&inv_proj[0][0]);
-                        auto t_it = t_store->data.find(cam_pair.first);
-                        if (t_it != t_store->data.end()) {
-                            auto view = cam.get_view_matrix(t_it->second);
-                            post_process_manager_.set_view_matrix(&view[0][0]);
-
-                            // Inverse view-projection for volumetric light
-                            auto inv_vp = glm::inverse(proj * view);
-                            post_process_manager_.set_inv_view_proj(&inv_vp[0][0]);
-                        }
-                    }
+                const auto& camera = frame_scene().camera;
+                if (camera.valid) {
+                    post_process_manager_.set_projection_matrix(&camera.proj[0][0]);
+                    auto inv_proj = glm::inverse(camera.proj);
+                    post_process_manager_.set_inv_projection_matrix(&inv_proj[0][0]);
+                    post_process_manager_.set_view_matrix(&camera.view[0][0]);
+
+                    // Inverse view-projection for volumetric light
+                    auto inv_vp = glm::inverse(camera.view_proj);
+                    post_process_manager_.set_inv_view_proj(&inv_vp[0][0]);
+                }
 
-                    // Find first point/spot light for volumetric
-                    auto* light_store = world->get_twig_storage<resource::Light>();
-                    if (light_store && t_store) {
-                        for (auto& [entity, light] : light_store->data) {
-                            if (light.type == resource::Light_Type::point || light.type == resource::Light_Type::spot) {
-                                auto lt_it = t_store->data.find(entity);
-                                if (lt_it != t_store->data.end()) {
-                                    auto& pos = lt_it->second.position;
-                                    post_process_manager_.set_light_position(pos.x, pos.y, pos.z);
-                                    post_process_manager_.set_light_color(light.color.x, light.color.y, light.color.z, light.intensity);
-                                    break;
-                                }
-                            }
-                        }
+                // Find first point/spot light for volumetric
+                for (const auto& light : frame_scene().lights) {
+                    if (light.position_type.w != 0.0f) {
+                        post_process_manager_.set_light_position(light.position_type.x, light.position_type.y, light.position_type.z);
+                        post_process_manager_.set_light_color(light.color_intensity.x, light.color_intensity.y, light.color_intensity.z, light.color_intensity.w);
+                        break;
                     }
                 }
 
@@ -236,6 +219,11 @@ namespace mango::app
                     renderer_->get_depth_texture(),
                     renderer_->get_gbuffer_normal_texture());
 
+                // Next frame's GPU culling reprojects into this frame's depth pyramid
+                if (gpu_culling_enabled() && camera.valid && post_process_manager_.is_hiz_valid()) {
+                    gpu_culling_.set_hiz_view_proj(camera.view_proj);
+                }
+
                 // Switch blit to read from post-processed output
                 auto output = post_process_manager_.get_output_texture();
                 if (output) {
@@ -289,6 +277,11 @@ namespace mango::app
 
     void Application::main_loop()
     {
+        if (desc_.pipelined_rendering) {
+            main_loop_pipelined();
+            return;
+        }
+
         while (!should_exit_ && !window_->should_close()) {
             // Update timing
             update_time();
@@ -324,6 +317,199 @@ namespace mango::app
         UH_INFO_FMT("Main loop finished (total frames: {})", frame_count_);
     }
 
+    void Application::main_loop_pipelined()
+    {
+        scene_buffer_ = std::make_unique<Render_Scene_Buffer>(desc_.render_scene_slots);
+        render_thread_ = std::thread([this] { render_thread_main(); });
+        UH_INFO_FMT("Pipelined rendering with {} scene snapshots", scene_buffer_->get_slot_count());
+
+        while (!should_exit_ && !window_->should_close()) {
+            update_time();
+
+            // GLFW events stay on the main thread
+            window_->poll_events();
+
+            if (minimized_) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                continue;
+            }
+
+            // Simulates frame N + 1 while the render thread records frame N
+            update(delta_time_);
+            on_render();
+
+            // Sync point: blocks while every snapshot is still queued or being recorded
+            if (!scene_buffer_->publish(scene_extractor_.get_scene(), make_frame_context())) {
+                break;
+            }
+
+            frame_count_++;
+            fps_frame_count_++;
+            calculate_fps();
+        }
+
+        // Let the render thread drain what was published, then stop it
+        scene_buffer_->close();
+        render_thread_.join();
+        if (renderer_) {
+            renderer_->wait_idle();
+        }
+        scene_buffer_.reset();
+
+        UH_INFO_FMT("Main loop finished (total frames: {})", frame_count_);
+        if (render_error_) {
+            std::rethrow_exception(std::exchange(render_error_, nullptr));
+        }
+    }
+
+    void Application::render_thread_main()
+    {
+        // Own pool slot, so pool work run here never shares per-thread scratch with the main thread
+        auto* pool = core::Worker_Pool::current_instance();
+        pool->register_external_thread();
+        try {
+            Frame_Context context{};
+            while (scene_buffer_->acquire(context)) {
+                // Resizes reported on the main thread are applied where the swapchain is used
+                if (context.width != renderer_->get_width() || context.height != renderer_->get_height()) {
+                    renderer_->handle_resize(context.width, context.height);
+                    post_process_manager_.resize(context.width, context.height);
+                }
+
+                frame_context_ = context;
+                sync_render_bvh();
+                renderer_->render_frame();
+                frame_context_.scene = nullptr;
+                scene_buffer_->release();
+            }
+        }
+        catch (const std::exception& e) {
+            UH_FATAL_FMT("Fatal error on the render thread: {}", e.what());
+            render_error_ = std::current_exception();
+            should_exit_ = true;
+            scene_buffer_->close();
+        }
+        pool->unregister_external_thread();
+    }
+
+    auto Application::make_frame_context() const -> Frame_Context
+    {
+        Frame_Context context{};
+        context.frame_index = frame_count_;
+        context.width = viewport_width_;
+        context.height = viewport_height_;
+        context.mode = desc_.run_mode;
+        context.delta_time = delta_time_;
+        return context;
+    }
+
+    auto Application::frame_scene() const -> const Render_Scene&
+    {
+        return frame_context_.scene ? *frame_context_.scene : scene_extractor_.get_scene();
+    }
+
+    auto Application::sync_render_bvh() -> void
+    {
+        // Every frame is recorded in order, so the previous frame's tree plus this frame's
+        // changed rows describe this frame's proxies
+        const auto& proxies = frame_scene().proxies;
+        if (frame_context_.changed_proxies) {
+            render_bvh_.sync(proxies, *frame_context_.changed_proxies);
+        } else {
+            render_bvh_.rebuild(proxies);
+        }
+    }
+
+    auto Application::cull_view(Render_View& view) const -> void
+    {
+        // The linear SIMD pass beats the tree traversal on small scenes
+        const auto& proxies = frame_scene().proxies;
+        if (proxies.size() >= BVH_CULL_MIN_PROXIES) {
+            render_bvh_.cull(proxies, view);
+        } else {
+            Frustum_Culler::cull(proxies, view);
+        }
+    }
+
+    auto Application::occlude_view(Occlusion_Culler& culler, const math::Mat4& view_proj, Render_View& view,
+                                   const std::vector<Render_Material>* materials) -> void
+    {
+        // Removes hidden rows from view.visible; culler's visibility mask matches the result
+        if (desc_.occlusion_culling) {
+            culler.cull(frame_scene().proxies, view_proj, view, materials);
+        }
+    }
+
+    auto Application::gpu_culling_enabled() const -> bool
+    {
+        return desc_.gpu_driven_culling && gpu_culling_.is_ready() && pbr_state_.ready;
+    }
+
+    auto Application::run_gpu_culling(graphics::Command_Buffer_Handle cmd) -> void
+    {
+        if (!cmd || !gpu_culling_enabled()) return;
+
+        // Instances are patched every frame, even without a camera, so no change is missed
+        const auto& scene = frame_scene();
+        gpu_culling_.update(scene, frame_context_.changed_proxies, renderer_->get_current_frame_index());
+        if (scene.camera.valid) {
+            gpu_culling_.cull(cmd, scene.camera, post_process_manager_);
+        }
+    }
+
+    auto Application::upload_instances(const Instance_Batcher& batcher, Instance_Buffers& target) -> bool
+    {
+        auto device = renderer_->get_device();
+        if (!device || !pbr_state_.instance_layout) return false;
+
+        const auto& instances = batcher.get_instances();
+        const auto& materials = frame_scene().materials;
+
+        // Grows by doubling; the frame that last used this slot has completed
+        auto reserve = [&](graphics::Buffer_Handle& buffer, std::size_t size) -> bool {
+            std::size_t capacity = buffer ? buffer->get_buffer_desc().size : 0;
+            if (size <= capacity) return false;
+
+            graphics::Buffer_Desc desc{};
+            desc.size = (std::max)({ size, capacity * 2, std::size_t(256) });
+            desc.usage = graphics::Buffer_Type::storage;
+            desc.memory = graphics::Memory_Type::cpu2gpu;
+            buffer = device->create_buffer(desc);
+            return true;
+        };
+        bool rewrite = !target.set;
+        rewrite |= reserve(target.instances, (std::max)(instances.size(), std::size_t(1)) * sizeof(Render_Instance));
+        rewrite |= reserve(target.materials, (std::max)(materials.size(), std::size_t(1)) * sizeof(Render_Material));
+        if (!target.set) {
+            target.set = device->create_descriptor_set(pbr_state_.instance_layout);
+        }
+        if (!target.set || !target.instances || !target.materials) return false;
+
+        if (rewrite) {
+            auto buffer_write = [](uint32_t binding, const graphics::Buffer_Handle& buffer) {
+                graphics::Descriptor_Write w{};
+                w.binding = binding;
+                w.type = graphics::Descriptor_Type::storage_buffer;
+                w.buffers = { buffer };
+                w.buffer_offsets = { 0 };
+                w.buffer_ranges = { buffer->get_buffer_desc().size };
+                return w;
+            };
+            target.set->update({ buffer_write(0, target.instances), buffer_write(1, target.materials) });
+        }
+
+        auto vk_instances = std::dynamic_pointer_cast<graphics::vk::Vk_Buffer>(target.instances);
+        auto vk_materials = std::dynamic_pointer_cast<graphics::vk::Vk_Buffer>(target.materials);
+        if (!vk_instances || !vk_materials) return false;
+        if (!instances.empty()) {
+            vk_instances->upload(instances.data(), instances.size() * sizeof(Render_Instance));
+        }
+        if (!materials.empty()) {
+            vk_materials->upload(materials.data(), materials.size() * sizeof(Render_Material));
+        }
+        return true;
+    }
+
     void Application::update(float delta_time)
     {
         // Step physics before game logic
@@ -334,6 +520,39 @@ namespace mango::app
 
         // Call user update
         on_update(delta_time);
+
+        // Everything that moves entities ran above; compose world matrices once for the frame
+        propagate_transforms();
+        extract_render_scene();
+    }
+
+    void Application::propagate_transforms()
+    {
+        auto* world = core::World::current_instance();
+        auto* scene_graph = renderer_ ? renderer_->get_scene_graph() : nullptr;
+        if (!world || !scene_graph) {
+            return;
+        }
+        transform_propagation_.run(*world, *scene_graph);
+    }
+
+    void Application::extract_render_scene()
+    {
+        auto* world = core::World::current_instance();
+        if (!world) {
+            scene_extractor_.reset();
+            return;
+        }
+
+        if (viewport_height_ > 0) {
+            auto aspect = static_cast<float>(viewport_width_) / static_cast<float>(viewport_height_);
+            if (auto* cameras = world->get_twig_storage<resource::Camera>(); cameras && !cameras->empty()) {
+                cameras->get_data().front().aspect = aspect;
+            }
+        }
+
+        // The passes below read only this snapshot; static entities cost nothing here
+        scene_extractor_.extract(*world);
     }
 
     void Application::render()
@@ -343,6 +562,10 @@ namespace mango::app
 
         // Execute frame rendering
         if (renderer_) {
+            frame_context_ = make_frame_context();
+            frame_context_.scene = &scene_extractor_.get_scene();
+            frame_context_.changed_proxies = &frame_context_.scene->dirty_proxies;
+            sync_render_bvh();
             renderer_->render_frame();
         }
     }
@@ -375,8 +598,17 @@ namespace mango::app
             last_fps_update_time_ = current_time;
 
             // Log FPS
-            UH_INFO_FMT("FPS: {:.1f} | Frame Time: {:.2f}ms",
-                fps_, delta_time_ * 1000.0f);
+            UH_INFO_FMT("FPS: {:.1f} | Frame Time: {:.2f}ms | Drawn: {} (culled {}) | Shadow casters: {} (culled {})"
+                " | Occlusion: {} occluders {:.2f}ms, hidden {} + {} casters {:.2f}ms"
+                " | Draws/pipelines/meshes: {}/{}/{} (unsorted {}/{}/{}) | Triangles: {} of {} | Clusters: {} of {}",
+                fps_, delta_time_ * 1000.0f,
+                main_cull_visible_.load(), main_cull_culled_.load(),
+                shadow_cull_visible_.load(), shadow_cull_culled_.load(),
+                occluder_count_.load(), occluder_ms_.load(),
+                main_occluded_.load(), shadow_occluded_.load(), occludee_ms_.load(),
+                draw_calls_.load(), pipeline_binds_.load(), mesh_binds_.load(),
+                unsorted_draw_calls_.load(), unsorted_pipeline_binds_.load(), unsorted_mesh_binds_.load(),
+                lod_triangles_.load(), full_triangles_.load(), visible_clusters_.load(), tested_clusters_.load());
         }
     }
 
@@ -392,15 +624,17 @@ namespace mango::app
         }
 
         minimized_ = false;
+        viewport_width_ = width;
+        viewport_height_ = height;
 
-        // Update renderer
-        if (renderer_) {
-            renderer_->handle_resize(width, height);
+        // The render thread picks the new size up from the next Frame_Context
+        if (!desc_.pipelined_rendering) {
+            if (renderer_) {
+                renderer_->handle_resize(width, height);
+            }
+            post_process_manager_.resize(width, height);
         }
 
-        // Update post-process manager
-        post_process_manager_.resize(width, height);
-
         // Call user callback
         on_window_resize(width, height);
     }
@@ -428,16 +662,25 @@ namespace mango::app
 
     void Application::cleanup()
     {
+        // A main loop that threw leaves the render thread waiting for frames
+        if (scene_buffer_) {
+            scene_buffer_->close();
+        }
+        if (render_thread_.joinable()) {
+            render_thread_.join();
+        }
+
         // Wait for all GPU work to finish BEFORE destroying any resources
         if (renderer_) {
             renderer_->wait_idle();
         }
 
         shutdown_imgui();
+        gpu_culling_ = Gpu_Culling_Manager{};
+        instance_frames_.clear();
         pbr_state_ = {};
         ibl_resources_ = {};
-        mesh_cache_.clear();
-        entity_mesh_cache_.clear();
+        mesh_data_cache_.clear();
 
         // Clean up in reverse order of creation
         renderer_.reset();
@@ -461,34 +704,32 @@ namespace mango::app
         ImGui::End();
     }
 
-    auto Application::display_scene_node(const std::shared_ptr<core::Scene_Node>& node) -> void
+    auto Application::display_scene_node(core::Scene_Node_Id node) -> void
     {
-        if (!node) {
+        auto scene_graph = get_renderer()->get_scene_graph();
+        if (!scene_graph || node == core::INVALID_SCENE_NODE) {
             return;
         }
 
         ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_OpenOnArrow | ImGuiTreeNodeFlags_SpanAvailWidth;
-        bool is_open = ImGui::TreeNodeEx((void*) (uintptr_t) node->id, flags, "%s", node->name.c_str());
+        bool is_open = ImGui::TreeNodeEx((void*) (uintptr_t) node, flags, "%s", scene_graph->name_of(node).c_str());
 
         if (ImGui::IsItemClicked()) {
-            auto scene_graph = get_renderer()->get_scene_graph();
-            if (scene_graph) {
-                scene_graph->set_current_selected_node(node);
-            }
+            scene_graph->set_current_selected_node(node);
         }
 
         if (ImGui::IsItemClicked(1)) {
-            std::string menu_id = "NodeMenu##" + std::to_string(node->id);
+            std::string menu_id = "NodeMenu##" + std::to_string(node);
             ImGui::OpenPopup(menu_id.c_str());
         }
 
-        std::string menu_id = "NodeMenu##" + std::to_string(node->id);
+        std::string menu_id = "NodeMenu##" + std::to_string(node);
         if (ImGui::BeginPopup(menu_id.c_str())) {
             if (ImGui::MenuItem("Add Child")) {
                 add_child_node(node);
             }
             if (ImGui::MenuItem("Attach Twig")) {
-                std::string twig_menu_id = "TwigMenu##" + std::to_string(node->id);
+                std::string twig_menu_id = "TwigMenu##" + std::to_string(node);
                 ImGui::OpenPopup(twig_menu_id.c_str());
             }
             ImGui::EndPopup();
@@ -497,16 +738,16 @@ namespace mango::app
         attach_twig_to_node(node);
 
         if (is_open) {
-            auto child = node->children;
-            while (child) {
+            auto child = scene_graph->first_child_of(node);
+            while (child != core::INVALID_SCENE_NODE) {
                 display_scene_node(child);
-                child = child->next;
+                child = scene_graph->next_decendent_of(child);
             }
             ImGui::TreePop();
         }
     }
 
-    auto Application::add_child_node(const std::shared_ptr<core::Scene_Node>& node) -> void
+    auto Application::add_child_node(core::Scene_Node_Id node) -> void
     {
         auto world = core::World::current_instance();
 
@@ -520,21 +761,13 @@ namespace mango::app
         world->attach_twig(new_entity, resource::Transform());
     }
 
-    auto Application::get_entity_from_scene_node(const std::shared_ptr<core::Scene_Node>& node) -> core::Entity
+    auto Application::get_entity_from_scene_node(core::Scene_Node_Id node) -> core::Entity
     {
-        if (!node) {
-            return core::INVALID_ENTITY;
-        }
-
-        for (const auto& pair : renderer_->get_scene_graph()->get_entities_mapping()) {
-            if (pair.second && pair.second->id == node->id) {
-                return pair.first;
-            }
-        }
-        return core::INVALID_ENTITY;
+        auto scene_graph = renderer_->get_scene_graph();
+        return scene_graph ? scene_graph->entity_of(node) : core::INVALID_ENTITY;
     }
 
-    auto Application::attach_twig_to_node(const std::shared_ptr<core::Scene_Node>& node) -> void
+    auto Application::attach_twig_to_node(core::Scene_Node_Id node) -> void
     {
         auto world = core::World::current_instance();
 
@@ -543,7 +776,7 @@ namespace mango::app
             return;
         }
 
-        std::string menu_id = "TwigMenu##" + std::to_string(node->id);
+        std::string menu_id = "TwigMenu##" + std::to_string(node);
         if (ImGui::BeginPopup(menu_id.c_str())) {
             if (ImGui::MenuItem("Transform")) {
                 if (!world->has_twig<resource::Transform>(entity)) {
@@ -586,7 +819,7 @@ namespace mango::app
         ImGui::InputText("Model Path", model_path_input_.data(), model_path_input_.size());
 
         auto scene_graph = get_renderer()->get_scene_graph();
-        auto selected = scene_graph ? scene_graph->get_current_selected_node() : nullptr;
+        auto selected = scene_graph ? scene_graph->get_current_selected_node() : core::INVALID_SCENE_NODE;
 
         if (ImGui::Button("Add Node")) {
             auto world = core::World::current_instance();
@@ -750,7 +983,8 @@ namespace mango::app
 
     auto Application::render_imgui(graphics::Command_Buffer_Handle cmd) -> void
     {
-        if (!imgui_initialized_) {
+        // The editor windows touch the World, which the main thread owns while pipelined
+        if (!imgui_initialized_ || desc_.pipelined_rendering) {
             return;
         }
         ImGui_ImplGlfw_NewFrame();
@@ -773,9 +1007,9 @@ namespace mango::app
         }
 
         auto scene_graph = get_renderer()->get_scene_graph();
-        auto selected = scene_graph ? scene_graph->get_current_selected_node() : nullptr;
+        auto selected = scene_graph ? scene_graph->get_current_selected_node() : core::INVALID_SCENE_NODE;
 
-        if (!selected) {
+        if (selected == core::INVALID_SCENE_NODE) {
             ImGui::TextDisabled("No node selected");
             ImGui::End();
             return;
@@ -790,7 +1024,7 @@ namespace mango::app
             return;
         }
 
-        ImGui::Text("Node: %s", selected->name.c_str());
+        ImGui::Text("Node: %s", scene_graph->name_of(selected).c_str());
         ImGui::Separator();
 
         edit_transform_component(entity);
@@ -1073,20 +1307,28 @@ namespace mango::app
         shadow_sample_layout_desc.bindings.push_back(shadow_tex_binding);
         shadow_state_.shadow_sample_layout = device->create_descriptor_set_layout(shadow_sample_layout_desc);
 
-        // Set up pipeline with IBL (set 1) + shadow (set 2) descriptor sets
-        if (ibl_resources_.ready && ibl_resources_.ibl_set_layout && shadow_state_.shadow_sample_layout) {
-            pipeline_desc.descriptor_set_layouts = { pbr_state_.set_layout, ibl_resources_.ibl_set_layout, shadow_state_.shadow_sample_layout };
-        } else if (ibl_resources_.ready && ibl_resources_.ibl_set_layout) {
-            pipeline_desc.descriptor_set_layouts = { pbr_state_.set_layout, ibl_resources_.ibl_set_layout };
-        } else {
-            pipeline_desc.descriptor_set_layouts = { pbr_state_.set_layout };
+        // Instances and materials (set 3), indexed by gl_InstanceIndex; the shadow pipeline
+        // reads the same layout as its set 1
+        graphics::Descriptor_Set_Layout_Desc instance_layout_desc{};
+        for (uint32_t binding = 0; binding < 2; ++binding) {
+            graphics::Descriptor_Binding instance_binding{};
+            instance_binding.binding = binding;
+            instance_binding.type = graphics::Descriptor_Type::storage_buffer;
+            instance_binding.count = 1;
+            instance_binding.shader_stages = VK_SHADER_STAGE_VERTEX_BIT;
+            instance_layout_desc.bindings.push_back(instance_binding);
+        }
+        pbr_state_.instance_layout = device->create_descriptor_set_layout(instance_layout_desc);
+        instance_frames_.assign(desc_.max_frames_in_flight, Instance_Frame{});
+
+        // Set up pipeline with IBL (set 1) + shadow (set 2) + instance (set 3) descriptor sets
+        if (!ibl_resources_.ready || !ibl_resources_.ibl_set_layout || !shadow_state_.shadow_sample_layout ||
+            !pbr_state_.instance_layout) {
+            UH_ERROR("PBR pipeline needs the IBL, shadow and instance descriptor set layouts");
+            return;
         }
-
-        graphics::Push_Constant_Range pc_range{};
-        pc_range.offset = 0;
-        pc_range.size = sizeof(Push_Constants);
-        pc_range.shader_stages = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
-        pipeline_desc.push_constants.push_back(pc_range);
+        pipeline_desc.descriptor_set_layouts = { pbr_state_.set_layout, ibl_resources_.ibl_set_layout,
+                                                 shadow_state_.shadow_sample_layout, pbr_state_.instance_layout };
 
         graphics::Vertex_Attribute pos{};
         pos.semantic = "POSITION";
@@ -1111,6 +1353,23 @@ namespace mango::app
 
         pbr_state_.pipeline = device->create_graphics_pipeline(pipeline_desc);
 
+        // Translucent materials draw after the opaque ones, blended over them
+        auto transparent_desc = pipeline_desc;
+        transparent_desc.blend_state.blend_enable = true;
+        transparent_desc.depth_stencil_state.depth_write_enable = false;
+        pbr_state_.transparent_pipeline = device->create_graphics_pipeline(transparent_desc);
+
+        // The GPU culling buffers fill set 3 of the same pipeline
+        if (desc_.gpu_driven_culling && pbr_state_.pipeline) {
+            gpu_culling_.init(device, desc_.max_frames_in_flight);
+
+            // The cull pass tests against last frame's depth pyramid
+            post_process_manager_.set_hiz_requested(gpu_culling_.is_ready());
+            if (gpu_culling_.is_ready()) {
+                UH_INFO("GPU-driven culling enabled");
+            }
+        }
+
         // Create skybox pipeline
         if (ibl_resources_.ready) {
             auto skybox_vs_spv = graphics::utils::compile_shader_form_file(pbr_shader_path("skybox.vert"), shaderc_vertex_shader);
@@ -1265,13 +1524,7 @@ namespace mango::app
         shadow_pipe_desc.depth_stencil_state.depth_test_enable = true;
         shadow_pipe_desc.depth_stencil_state.depth_write_enable = true;
         shadow_pipe_desc.blend_state.blend_enable = false;
-        shadow_pipe_desc.descriptor_set_layouts = { shadow_state_.shadow_ubo_layout };
-
-        graphics::Push_Constant_Range shadow_pc_range{};
-        shadow_pc_range.offset = 0;
-        shadow_pc_range.size = sizeof(Push_Constants);
-        shadow_pc_range.shader_stages = VK_SHADER_STAGE_VERTEX_BIT;
-        shadow_pipe_desc.push_constants.push_back(shadow_pc_range);
+        shadow_pipe_desc.descriptor_set_layouts = { shadow_state_.shadow_ubo_layout, pbr_state_.instance_layout };
 
         // Same vertex layout as PBR
         graphics::Vertex_Attribute spos{};
@@ -1332,7 +1585,7 @@ namespace mango::app
     {
         auto world = core::World::current_instance();
         auto camera_store = world->get_twig_storage<resource::Camera>();
-        if (camera_store && !camera_store->data.empty()) {
+        if (camera_store && !camera_store->empty()) {
             return;
         }
 
@@ -1359,12 +1612,12 @@ namespace mango::app
         // Only create default scene if there are no mesh/model entities yet
         auto mesh_store = world->get_twig_storage<resource::Mesh>();
         auto model_store = world->get_twig_storage<resource::Model>();
-        if ((mesh_store && !mesh_store->data.empty()) || (model_store && !model_store->data.empty())) {
+        if ((mesh_store && !mesh_store->empty()) || (model_store && !model_store->empty())) {
             return;
         }
 
         auto scene_graph = get_renderer()->get_scene_graph();
-        auto root = scene_graph ? scene_graph->get_root_node() : nullptr;
+        auto root = scene_graph ? scene_graph->get_root_node() : core::INVALID_SCENE_NODE;
 
         // Asset directory
         auto asset_dir = std::filesystem::path(__FILE__).parent_path().parent_path() / "asset";
@@ -1416,78 +1669,38 @@ namespace mango::app
             }
         }
 
-        // Ceiling light (approximating the quad area light from the scene file)
-        {
-            core::Entity entity = world->create_entity();
-            resource::Transform t;
-            t.position = {0.278f, 0.548f, 0.280f};
-            world->attach_twig(entity, t);
-
-            resource::Light light;
-            light.type = resource::Light_Type::point;
-            light.color = {1.0f, 0.85f, 0.7f};
-            light.intensity = 3.0f;
-            light.range = 2.0f;
-            world->attach_twig(entity, light);
-
-            if (scene_graph) {
-                scene_graph->add_entity_to_scene(entity, root, "Ceiling Light");
-            }
-        }
-
-        // GI bounce lights — simulate first-bounce color bleeding from walls
-        // Red wall bounce (reddish fill near red wall, pointing inward)
-        {
-            core::Entity entity = world->create_entity();
-            resource::Transform t;
-            t.position = {0.45f, 0.274f, 0.280f}; // near red wall, mid height
-            world->attach_twig(entity, t);
-
-            resource::Light light;
-            light.type = resource::Light_Type::point;
-            light.color = {0.63f, 0.065f, 0.05f}; // red wall color
-            light.intensity = 0.6f;
-            light.range = 0.5f;
-            world->attach_twig(entity, light);
-
-            if (scene_graph) {
-                scene_graph->add_entity_to_scene(entity, root, "Red Bounce");
-            }
-        }
-        // Green wall bounce (greenish fill near green wall, pointing inward)
-        {
-            core::Entity entity = world->create_entity();
-            resource::Transform t;
-            t.position = {0.10f, 0.274f, 0.280f}; // near green wall, mid height
-            world->attach_twig(entity, t);
+        // Ceiling light (approximating the quad area light from the scene file), plus
+        // GI bounce lights simulating first-bounce color bleeding from the walls and floor
+        struct Cornell_Light {
+            const char* name;
+            math::Vec3 position;
+            math::Vec3 color;
+            float intensity;
+            float range;
+        };
 
-            resource::Light light;
-            light.type = resource::Light_Type::point;
-            light.color = {0.14f, 0.45f, 0.091f}; // green wall color
-            light.intensity = 0.6f;
-            light.range = 0.5f;
-            world->attach_twig(entity, light);
+        const Cornell_Light lights[] = {
+            {"Ceiling Light", {0.278f, 0.548f, 0.280f}, {1.0f, 0.85f, 0.7f},        3.0f, 2.0f},
+            {"Red Bounce",    {0.45f, 0.274f, 0.280f},  {0.63f, 0.065f, 0.05f},     0.6f, 0.5f}, // near red wall, mid height
+            {"Green Bounce",  {0.10f, 0.274f, 0.280f},  {0.14f, 0.45f, 0.091f},     0.6f, 0.5f}, // near green wall, mid height
+            {"Floor Bounce",  {0.278f, 0.05f, 0.280f},  {0.725f, 0.71f, 0.68f},     0.3f, 0.4f}, // warm upward fill from the floor
+        };
 
-            if (scene_graph) {
-                scene_graph->add_entity_to_scene(entity, root, "Green Bounce");
-            }
-        }
-        // Floor bounce (warm upward fill simulating floor reflection)
-        {
-            core::Entity entity = world->create_entity();
-            resource::Transform t;
-            t.position = {0.278f, 0.05f, 0.280f}; // near floor center
-            world->attach_twig(entity, t);
+        resource::Light point_light;
+        point_light.type = resource::Light_Type::point;
+        core::Prefab light_prefab{ resource::Transform{}, point_light };
 
-            resource::Light light;
-            light.type = resource::Light_Type::point;
-            light.color = {0.725f, 0.71f, 0.68f}; // floor color
-            light.intensity = 0.3f;
-            light.range = 0.4f;
-            world->attach_twig(entity, light);
+        auto light_entities = world->instantiate(light_prefab, std::size(lights),
+            [&](std::size_t i, core::Entity, resource::Transform& t, resource::Light& light) {
+                t.position = lights[i].position;
+                light.color = lights[i].color;
+                light.intensity = lights[i].intensity;
+                light.range = lights[i].range;
+            });
 
-            if (scene_graph) {
-                scene_graph->add_entity_to_scene(entity, root, "Floor Bounce");
+        if (scene_graph) {
+            for (std::size_t i = 0; i < light_entities.size(); ++i) {
+                scene_graph->add_entity_to_scene(light_entities[i], root, lights[i].name);
             }
         }
 
@@ -1498,21 +1711,12 @@ namespace mango::app
     {
         if (!cmd || !shadow_state_.ready || !pbr_state_.ready || !shadow_enabled_) return;
 
-        auto world = core::World::current_instance();
-        auto transform_store = world->get_twig_storage<resource::Transform>();
-        auto light_store = world->get_twig_storage<resource::Light>();
-
         // Find the first point/spot light for shadow casting
         math::Vec3 light_pos{0.278f, 0.548f, 0.280f};
-        if (light_store && transform_store) {
-            for (auto& [entity, light] : light_store->data) {
-                if (light.type == resource::Light_Type::point || light.type == resource::Light_Type::spot) {
-                    auto t_it = transform_store->data.find(entity);
-                    if (t_it != transform_store->data.end()) {
-                        light_pos = t_it->second.position;
-                        break;
-                    }
-                }
+        for (const auto& light : frame_scene().lights) {
+            if (light.position_type.w != 0.0f) {
+                light_pos = math::Vec3(light.position_type);
+                break;
             }
         }
 
@@ -1534,60 +1738,66 @@ namespace mango::app
             vk_shadow_buf->upload(&shadow_ubo, sizeof(shadow_ubo));
         }
 
+        // Only casters inside the light frustum that the main pass has already uploaded
+        const auto& proxies = frame_scene().proxies;
+        shadow_view_.frustum = Frustum::from_view_proj(shadow_state_.light_view_proj);
+        shadow_view_.required_flags = RENDER_PROXY_CASTS_SHADOW;
+        cull_view(shadow_view_);
+        // A caster hidden from the light by other casters adds nothing to the shadow map.
+        // The shadow pass draws transparent casters opaque, so every caster may occlude.
+        occlude_view(shadow_occlusion_, shadow_state_.light_view_proj, shadow_view_, nullptr);
+        shadow_cull_visible_ = shadow_view_.stats.visible;
+        shadow_cull_culled_ = shadow_view_.stats.culled;
+        shadow_occluded_ = shadow_occlusion_.get_stats().occluded;
+
+        // Front to back from the light, one instanced draw per caster mesh LOD
+        shadow_lods_.select(proxies, shadow_view_.visible, light_view, std::abs(light_proj[1][1]) * 2048.0f * 0.5f);
+        shadow_draws_.build(proxies, shadow_view_.visible, light_view, nullptr, &shadow_lods_.get_lods());
+        shadow_batches_.build_sorted(proxies, shadow_draws_);
+        auto& instances = instance_frames_[renderer_->get_current_frame_index() % instance_frames_.size()].shadow;
+        if (!upload_instances(shadow_batches_, instances)) return;
+
         // Begin shadow render pass
         cmd->begin_render_pass(shadow_state_.shadow_pass, shadow_state_.shadow_framebuffer, 2048, 2048);
         cmd->set_viewport(0.0f, 0.0f, 2048.0f, 2048.0f);
         cmd->set_scissor(0, 0, 2048, 2048);
         cmd->bind_pipeline(shadow_state_.shadow_pipeline);
         cmd->bind_descriptor_set(0, shadow_state_.shadow_ubo_set);
+        cmd->bind_descriptor_set(1, instances.set);
 
-        // Helper lambda to draw a gpu mesh with a given model matrix
-        auto draw_shadow_mesh = [&](const Gpu_Mesh& gpu_mesh, const math::Mat4& model_mat) {
+        // Helper lambda to draw one batch of a gpu mesh
+        auto draw_shadow_batch = [&](const Gpu_Mesh& gpu_mesh, const Instance_Batch& batch) {
             if (!gpu_mesh.vertex_buffer) return;
-            Push_Constants pc{};
-            pc.model = model_mat;
-            cmd->push_constants(0, sizeof(Push_Constants), &pc);
             cmd->bind_vertex_buffer(0, gpu_mesh.vertex_buffer, 0);
             if (gpu_mesh.indexed && gpu_mesh.index_buffer) {
+                auto lod = batch.mesh->get_lod(batch.lod);
                 cmd->bind_index_buffer(gpu_mesh.index_buffer, 0, 1);
-                cmd->draw_indexed(gpu_mesh.index_count);
+                cmd->draw_indexed(lod.index_count, batch.instance_count, lod.first_index, 0, batch.first_instance);
             } else {
-                cmd->draw(gpu_mesh.index_count, 1, 0, 0);
+                cmd->draw(gpu_mesh.index_count, batch.instance_count, 0, batch.first_instance);
             }
         };
 
-        // Render Model-based entities (Cornell box parts use Model component)
-        auto model_store = world->get_twig_storage<resource::Model>();
-        if (model_store && transform_store) {
-            for (auto& pair : model_store->data) {
-                auto t_it = transform_store->data.find(pair.first);
-                if (t_it == transform_store->data.end()) continue;
-
-                auto& model = pair.second;
-                for (auto& instance : model.get_instances()) {
-                    auto mesh = instance.get_mesh();
-                    if (!mesh) continue;
-
-                    std::size_t key = reinterpret_cast<std::size_t>(mesh.get());
-                    auto it = mesh_cache_.find(key);
-                    if (it == mesh_cache_.end()) continue; // not yet uploaded
-
-                    draw_shadow_mesh(it->second, t_it->second.get_matrix());
-                }
+        if (gpu_culling_enabled() && gpu_culling_.get_vertex_buffer()) {
+            // The main pass draws from the GPU culling geometry buffers instead of the cache
+            cmd->bind_vertex_buffer(0, gpu_culling_.get_vertex_buffer(), 0);
+            cmd->bind_index_buffer(gpu_culling_.get_index_buffer(), 0, 1);
+            for (const auto& batch : shadow_batches_.get_batches()) {
+                const auto* mesh = gpu_culling_.find_mesh(batch.mesh);
+                if (!mesh || mesh->index_count == 0) continue;
+
+                // Meshes without indices were given a 0..n sequence and have no LODs
+                auto lod = batch.mesh->indices.empty() ? resource::Mesh_Lod{ 0, mesh->index_count, 0.0f }
+                                                       : batch.mesh->get_lod(batch.lod);
+                cmd->draw_indexed(lod.index_count, batch.instance_count, mesh->first_index + lod.first_index,
+                                  mesh->vertex_offset, batch.first_instance);
             }
-        }
-
-        // Render Mesh-based entities
-        auto mesh_store = world->get_twig_storage<resource::Mesh>();
-        if (mesh_store && transform_store) {
-            for (auto& pair : mesh_store->data) {
-                auto t_it = transform_store->data.find(pair.first);
-                if (t_it == transform_store->data.end()) continue;
-
-                auto cache_it = entity_mesh_cache_.find(pair.first.id);
-                if (cache_it == entity_mesh_cache_.end()) continue;
+        } else {
+            for (const auto& batch : shadow_batches_.get_batches()) {
+                auto cache_it = mesh_data_cache_.find(batch.mesh);
+                if (cache_it == mesh_data_cache_.end()) continue;
 
-                draw_shadow_mesh(cache_it->second, t_it->second.get_matrix());
+                draw_shadow_batch(cache_it->second, batch);
             }
         }
 
@@ -1604,34 +1814,14 @@ namespace mango::app
             return;
         }
 
-        auto world = core::World::current_instance();
-        auto camera_store = world->get_twig_storage<resource::Camera>();
-        auto transform_store = world->get_twig_storage<resource::Transform>();
-        auto material_store = world->get_twig_storage<resource::Pbr_Material>();
-
-        resource::Camera* camera = nullptr;
-        resource::Transform* camera_transform = nullptr;
-        if (camera_store && !camera_store->data.empty()) {
-            auto& pair = *camera_store->data.begin();
-            camera = &pair.second;
-            if (transform_store) {
-                auto it = transform_store->data.find(pair.first);
-                if (it != transform_store->data.end()) {
-                    camera_transform = &it->second;
-                }
-            }
-        }
-
-        if (camera && camera_transform) {
-            if (renderer_) {
-                camera->aspect = static_cast<float>(renderer_->get_width()) / static_cast<float>(renderer_->get_height());
-            }
-
+        const auto& scene = frame_scene();
+        const auto& camera = scene.camera;
+        if (camera.valid) {
             Camera_UBO ubo{};
-            ubo.view = camera->get_view_matrix(*camera_transform);
-            ubo.proj = camera->get_projection_matrix();
-            ubo.view_proj = camera->get_view_projection_matrix(*camera_transform);
-            ubo.camera_pos = mango::math::Vec4(camera_transform->position, 0.8f); // w = exposure
+            ubo.view = camera.view;
+            ubo.proj = camera.proj;
+            ubo.view_proj = camera.view_proj;
+            ubo.camera_pos = mango::math::Vec4(math::Vec3(camera.position), 0.8f); // w = exposure
 
             auto vk_buffer = std::dynamic_pointer_cast<graphics::vk::Vk_Buffer>(pbr_state_.camera_buffer);
             if (vk_buffer) {
@@ -1641,33 +1831,12 @@ namespace mango::app
 
         // Update lights UBO
         {
-            Lights_UBO lights_ubo{};
-            int light_count = 0;
-
-            auto light_store = world->get_twig_storage<resource::Light>();
-            if (light_store && transform_store) {
-                for (auto& [entity, light] : light_store->data) {
-                    if (light_count >= MAX_LIGHTS) break;
-                    auto& ld = lights_ubo.lights[light_count];
-
-                    if (light.type == resource::Light_Type::directional) {
-                        auto dir = glm::normalize(light.direction);
-                        ld.position_type = {dir.x, dir.y, dir.z, 0.0f};
-                    } else {
-                        auto t_it = transform_store->data.find(entity);
-                        math::Vec3 pos = (t_it != transform_store->data.end()) ? t_it->second.position : math::Vec3(0);
-                        ld.position_type = {pos.x, pos.y, pos.z, static_cast<float>(static_cast<int>(light.type))};
-                    }
+            static_assert(sizeof(Light_Data) == sizeof(Render_Light), "Render_Light must match the lights UBO layout");
 
-                    ld.color_intensity = {light.color.x, light.color.y, light.color.z, light.intensity};
-                    ld.params = {light.direction.x, light.direction.y, light.direction.z, light.range};
-
-                    float inner_cos = std::cos(glm::radians(light.inner_angle));
-                    float outer_cos = std::cos(glm::radians(light.outer_angle));
-                    ld.spot_params = {inner_cos, outer_cos, 0.0f, 0.0f};
-
-                    light_count++;
-                }
+            Lights_UBO lights_ubo{};
+            int light_count = static_cast<int>(std::min<std::size_t>(scene.lights.size(), MAX_LIGHTS));
+            if (light_count > 0) {
+                std::memcpy(lights_ubo.lights, scene.lights.data(), light_count * sizeof(Light_Data));
             }
 
             // Fallback: if no lights, add a default directional light
@@ -1698,7 +1867,8 @@ namespace mango::app
             cmd->draw(3, 1, 0, 0); // Fullscreen triangle
         }
 
-        // Draw PBR scene objects
+        // Draw PBR scene objects; with GPU culling the cull pass already chose them
+        bool gpu_driven = gpu_culling_enabled() && camera.valid;
         cmd->bind_pipeline(pbr_state_.pipeline);
         cmd->bind_descriptor_set(0, pbr_state_.set);
         if (ibl_resources_.ready && ibl_resources_.ibl_set) {
@@ -1708,19 +1878,31 @@ namespace mango::app
             cmd->bind_descriptor_set(2, shadow_state_.shadow_sample_set);
         }
 
+        if (gpu_driven) {
+            gpu_culling_.draw(cmd);
+            const auto& stats = gpu_culling_.get_stats();
+            main_cull_visible_ = stats.visible;
+            main_cull_culled_ = stats.instances - (std::min)(stats.visible, stats.instances);
+            visible_clusters_ = stats.visible_clusters;
+            tested_clusters_ = stats.clusters;
+            main_occluded_ = 0;
+            const auto& shadow_occlusion = shadow_occlusion_.get_stats();
+            occluder_count_ = shadow_occlusion.occluders;
+            occluder_ms_ = shadow_occlusion.occluder_ms;
+            occludee_ms_ = shadow_occlusion.occludee_ms;
+            return;
+        }
+
         auto device = renderer_->get_device();
         if (!device) {
             return;
         }
 
-        auto create_gpu_mesh = [&](const std::shared_ptr<resource::Mesh>& mesh) -> Gpu_Mesh {
+        auto create_gpu_mesh = [&](const resource::Mesh_Data& mesh) -> Gpu_Mesh {
             Gpu_Mesh gpu{};
-            if (!mesh) {
-                return gpu;
-            }
-
-            const auto& vertices = mesh->get_vertices();
-            const auto& indices = mesh->get_indices();
+            const auto& vertices = mesh.vertices;
+            const auto& indices = mesh.indices;
+            const auto& lod_indices = mesh.lod_indices;
 
             if (vertices.empty()) {
                 return gpu;
@@ -1738,14 +1920,20 @@ namespace mango::app
             }
 
             if (!indices.empty()) {
+                // Every LOD in one buffer: the full list, then lod_indices (Mesh_Lod::first_index)
+                std::vector<std::uint32_t> all_indices;
+                all_indices.reserve(indices.size() + lod_indices.size());
+                all_indices.insert(all_indices.end(), indices.begin(), indices.end());
+                all_indices.insert(all_indices.end(), lod_indices.begin(), lod_indices.end());
+
                 graphics::Buffer_Desc idesc{};
-                idesc.size = indices.size() * sizeof(std::uint32_t);
+                idesc.size = all_indices.size() * sizeof(std::uint32_t);
                 idesc.usage = graphics::Buffer_Type::index;
                 idesc.memory = graphics::Memory_Type::cpu2gpu;
                 gpu.index_buffer = device->create_buffer(idesc);
                 auto vk_ib = std::dynamic_pointer_cast<graphics::vk::Vk_Buffer>(gpu.index_buffer);
                 if (vk_ib) {
-                    vk_ib->upload(indices.data(), idesc.size);
+                    vk_ib->upload(all_indices.data(), idesc.size);
                 }
                 gpu.index_count = static_cast<uint32_t>(indices.size());
                 gpu.indexed = true;
@@ -1757,99 +1945,81 @@ namespace mango::app
             return gpu;
         };
 
-        if (transform_store) {
-            auto model_store = world->get_twig_storage<resource::Model>();
-            if (model_store) {
-                for (auto& pair : model_store->data) {
-                    auto transform_it = transform_store->data.find(pair.first);
-                    if (transform_it == transform_store->data.end()) {
-                        continue;
-                    }
-
-                    auto& model = pair.second;
-                    for (auto& instance : model.get_instances()) {
-                        auto mesh = instance.get_mesh();
-                        if (!mesh) {
-                            continue;
-                        }
-
-                        std::size_t key = reinterpret_cast<std::size_t>(mesh.get());
-                        auto it = mesh_cache_.find(key);
-                        if (it == mesh_cache_.end()) {
-                            auto gpu = create_gpu_mesh(mesh);
-                            it = mesh_cache_.emplace(key, std::move(gpu)).first;
-                        }
-
-                        auto& gpu = it->second;
-                        if (!gpu.vertex_buffer) {
-                            continue;
-                        }
+        // Without a camera the frustum is left open and everything is drawn
+        const auto& proxies = scene.proxies;
+        main_view_.frustum = camera.valid ? Frustum::from_view_proj(camera.view_proj) : Frustum{};
+        cull_view(main_view_);
+        if (camera.valid) {
+            // Transparent rows show what is behind them and never occlude
+            occlude_view(main_occlusion_, camera.view_proj, main_view_, &scene.materials);
+        }
+        main_cull_visible_ = main_view_.stats.visible;
+        main_cull_culled_ = main_view_.stats.culled;
+        const auto& main_occlusion = main_occlusion_.get_stats();
+        const auto& shadow_occlusion = shadow_occlusion_.get_stats();
+        main_occluded_ = main_occlusion.occluded;
+        occluder_count_ = main_occlusion.occluders + shadow_occlusion.occluders;
+        occluder_ms_ = main_occlusion.occluder_ms + shadow_occlusion.occluder_ms;
+        occludee_ms_ = main_occlusion.occludee_ms + shadow_occlusion.occludee_ms;
+
+        // LODs by projected error, sorted by pipeline, mesh, LOD and depth, then one
+        // instanced draw per run of a mesh LOD
+        main_lods_.select(proxies, main_view_.visible, camera.view,
+                          std::abs(camera.proj[1][1]) * static_cast<float>(renderer_->get_height()) * 0.5f);
+        main_draws_.build(proxies, main_view_.visible, camera.view, &scene.materials, &main_lods_.get_lods());
+        main_batches_.build_sorted(proxies, main_draws_);
+        const auto& sorted = main_draws_.get_sorted_stats();
+        const auto& unsorted = main_draws_.get_unsorted_stats();
+        draw_calls_ = sorted.draws;
+        pipeline_binds_ = sorted.pipeline_binds;
+        mesh_binds_ = sorted.mesh_binds;
+        unsorted_draw_calls_ = unsorted.draws;
+        unsorted_pipeline_binds_ = unsorted.pipeline_binds;
+        unsorted_mesh_binds_ = unsorted.mesh_binds;
+        lod_triangles_ = main_lods_.get_stats().triangles;
+        full_triangles_ = main_lods_.get_stats().full_triangles;
+
+        auto& instances = instance_frames_[renderer_->get_current_frame_index() % instance_frames_.size()].main;
+        if (!upload_instances(main_batches_, instances)) {
+            return;
+        }
+        cmd->bind_descriptor_set(3, instances.set);
 
-                        resource::Pbr_Material material{};
-                        if (material_store) {
-                            auto mat_it = material_store->data.find(pair.first);
-                            if (mat_it != material_store->data.end()) {
-                                material = mat_it->second;
-                            }
-                        }
-                        Push_Constants pc{};
-                        pc.model = transform_it->second.get_matrix();
-                        pc.base_color = material.base_color;
-                        pc.params = material.params;
-                        cmd->push_constants(0, sizeof(Push_Constants), &pc);
-
-                        cmd->bind_vertex_buffer(0, gpu.vertex_buffer, 0);
-                        if (gpu.indexed && gpu.index_buffer) {
-                            cmd->bind_index_buffer(gpu.index_buffer, 0, 1);
-                            cmd->draw_indexed(gpu.index_count);
-                        } else {
-                            cmd->draw(gpu.index_count);
-                        }
-                    }
-                }
+        // Both PBR pipelines share one layout, so the bound sets stay valid across the switch
+        auto bound_pass = Draw_Pass::opaque;
+        const Gpu_Mesh* bound_mesh = nullptr;
+        for (const auto& batch : main_batches_.get_batches()) {
+            auto pass = Draw_Key::pass(batch.key);
+            if (pass != bound_pass && pass == Draw_Pass::transparent && pbr_state_.transparent_pipeline) {
+                cmd->bind_pipeline(pbr_state_.transparent_pipeline);
+                bound_pass = pass;
             }
 
-            auto mesh_store = world->get_twig_storage<resource::Mesh>();
-            if (mesh_store) {
-                for (auto& pair : mesh_store->data) {
-                    auto transform_it = transform_store->data.find(pair.first);
-                    if (transform_it == transform_store->data.end()) {
-                        continue;
-                    }
-
-                    auto cache_it = entity_mesh_cache_.find(pair.first.id);
-                    if (cache_it == entity_mesh_cache_.end()) {
-                        auto mesh_ptr = std::make_shared<resource::Mesh>(pair.second);
-                        auto gpu = create_gpu_mesh(mesh_ptr);
-                        cache_it = entity_mesh_cache_.emplace(pair.first.id, std::move(gpu)).first;
-                    }
+            const auto* mesh_data = batch.mesh;
+            auto cache_it = mesh_data_cache_.find(mesh_data);
+            if (cache_it == mesh_data_cache_.end()) {
+                auto gpu = create_gpu_mesh(*mesh_data);
+                gpu.source = mesh_data->shared_from_this();
+                cache_it = mesh_data_cache_.emplace(mesh_data, std::move(gpu)).first;
+            }
 
-                    auto& gpu = cache_it->second;
-                    if (!gpu.vertex_buffer) {
-                        continue;
-                    }
+            auto& gpu = cache_it->second;
+            if (!gpu.vertex_buffer) {
+                continue;
+            }
 
-                    resource::Pbr_Material material{};
-                    if (material_store) {
-                        auto mat_it = material_store->data.find(pair.first);
-                        if (mat_it != material_store->data.end()) {
-                            material = mat_it->second;
-                        }
-                    }
-                    Push_Constants pc{};
-                    pc.model = transform_it->second.get_matrix();
-                    pc.base_color = material.base_color;
-                    pc.params = material.params;
-                    cmd->push_constants(0, sizeof(Push_Constants), &pc);
-
-                    cmd->bind_vertex_buffer(0, gpu.vertex_buffer, 0);
-                    if (gpu.indexed && gpu.index_buffer) {
-                        cmd->bind_index_buffer(gpu.index_buffer, 0, 1);
-                        cmd->draw_indexed(gpu.index_count);
-                    } else {
-                        cmd->draw(gpu.index_count);
-                    }
+            if (bound_mesh != &gpu) {
+                cmd->bind_vertex_buffer(0, gpu.vertex_buffer, 0);
+                if (gpu.indexed && gpu.index_buffer) {
+                    cmd->bind_index_buffer(gpu.index_buffer, 0, 1);
                 }
+                bound_mesh = &gpu;
+            }
+            if (gpu.indexed && gpu.index_buffer) {
+                auto lod = mesh_data->get_lod(batch.lod);
+                cmd->draw_indexed(lod.index_count, batch.instance_count, lod.first_index, 0, batch.first_instance);
+            } else {
+                cmd->draw(gpu.index_count, batch.instance_count, 0, batch.first_instance);
             }
         }
     }
@@ -1878,26 +2048,26 @@ namespace mango::app
         if (!world)
             return;
 
-        auto* storage = world->get_twig_storage<resource::Physics_Body>();
-        if (!storage)
-            return;
-
-        for (auto& [entity, body] : storage->data)
+        auto* transform_store = world->get_twig_storage<resource::Transform>();
+        world->view<resource::Physics_Body, resource::Transform>().each([&](core::Entity entity, resource::Physics_Body& body, resource::Transform& transform)
         {
             if (body.runtime_handle == physics::INVALID_BODY)
-                continue;
+                return;
 
             // Only sync dynamic/kinematic bodies
             if (body.type == physics::Body_Type::static_body)
-                continue;
+                return;
 
-            if (!world->has_twig<resource::Transform>(entity))
-                continue;
+            auto position = physics_world_->get_body_position(body.runtime_handle);
+            auto rotation = physics_world_->get_body_rotation(body.runtime_handle);
+            if (position == transform.position && rotation == transform.rotation)
+                return;
 
-            auto& transform = world->get_twig<resource::Transform>(entity);
-            transform.position = physics_world_->get_body_position(body.runtime_handle);
-            transform.rotation = physics_world_->get_body_rotation(body.runtime_handle);
-        }
+            // Only bodies that actually moved are stamped as changed
+            transform.position = position;
+            transform.rotation = rotation;
+            transform_store->mark_changed(entity);
+        });
     }
     void Application::update_orbit_camera(float delta_time)
     {
@@ -1995,7 +2165,7 @@ namespace mango::app
         auto* camera_storage = world->get_twig_storage<resource::Camera>();
         if (!camera_storage) return;
 
-        for (auto& [entity, cam] : camera_storage->data) {
+        for (auto [entity, cam] : *camera_storage) {
             if (!world->has_twig<resource::Transform>(entity)) continue;
             auto& transform = world->get_twig<resource::Transform>(entity);
             transform.position = cam_pos;
@@ -3,6 +3,7 @@
 #include "window/window.hpp"
 #include "renderer/renderer.hpp"
 #include "manager/scene-graph.hpp"
+#include "manager/transform-propagation.hpp"
 #include "render-resource/buffer.hpp"
 #include "render-resource/descriptor-set.hpp"
 #include "pipeline-state/graphics-pipeline-state.hpp"
@@ -12,14 +13,28 @@
 #include "resource/transform.hpp"
 #include "ibl/ibl_generator.hpp"
 #include "post_process/post_process_manager.hpp"
+#include "gpu_culling/gpu_culling_manager.hpp"
 #include "physics/physics_world.hpp"
 #include "render_core/run_mode.hpp"
+#include "render_core/render_scene_extractor.hpp"
+#include "render_core/render_scene_buffer.hpp"
+#include "render_core/frame_context.hpp"
+#include "render_core/frustum_culler.hpp"
+#include "render_core/occlusion_culler.hpp"
+#include "render_core/render_bvh.hpp"
+#include "render_core/draw_list.hpp"
+#include "render_core/instance_batcher.hpp"
+#include "render_core/lod_selector.hpp"
 #include <vulkan/vulkan.h>
 #include <memory>
 #include <chrono>
 #include <unordered_map>
 #include <array>
+#include <vector>
+#include <atomic>
 #include <cstdint>
+#include <exception>
+#include <thread>
 
 namespace mango::app
 {
@@ -35,6 +50,20 @@ namespace mango::app
         uint32_t target_fps = 60;
         uint32_t max_frames_in_flight = 2;
         Run_Mode run_mode = Run_Mode::runtime;
+
+        // Record frame N on a render thread while the main thread simulates frame N + 1.
+        // The editor UI reads and writes the World, so it is not drawn in this mode.
+        bool pipelined_rendering = false;
+        uint32_t render_scene_slots = 2;        // snapshots in flight between the threads (2 or 3)
+
+        // Drop proxies hidden behind large occluders before the main and shadow passes
+        bool occlusion_culling = true;
+
+        // Cull and draw the main view on the GPU (compute pass plus indirect draws) instead of
+        // the CPU culling above; the shadow pass keeps the CPU path. Transparency is not
+        // supported there: every row, whatever its material alpha, is drawn with the opaque
+        // pipeline and without back to front sorting.
+        bool gpu_driven_culling = false;
     };
 
     class Application
@@ -51,7 +80,7 @@ namespace mango::app
 
         // Application control
         void request_exit();
-        bool should_exit() const { return should_exit_; }
+        bool should_exit() const { return should_exit_.load(std::memory_order_relaxed); }
 
         // Getters
         auto get_window() -> Window* { return window_.get(); }
@@ -69,10 +98,10 @@ namespace mango::app
         virtual void on_window_resize(uint32_t width, uint32_t height) {}
 
         auto scene_tree_window() -> void;
-        auto display_scene_node(const std::shared_ptr<core::Scene_Node>& node) -> void;
-        auto add_child_node(const std::shared_ptr<core::Scene_Node>& node) -> void;
-        auto attach_twig_to_node(const std::shared_ptr<core::Scene_Node>& node) -> void;
-        auto get_entity_from_scene_node(const std::shared_ptr<core::Scene_Node>& node) -> core::Entity;
+        auto display_scene_node(core::Scene_Node_Id node) -> void;
+        auto add_child_node(core::Scene_Node_Id node) -> void;
+        auto attach_twig_to_node(core::Scene_Node_Id node) -> void;
+        auto get_entity_from_scene_node(core::Scene_Node_Id node) -> core::Entity;
         auto resource_window() -> void;
         auto render_ui() -> void;
         auto ensure_pbr_resources() -> void;
@@ -98,6 +127,8 @@ namespace mango::app
     private:
         void physics_step(float delta_time);
         void sync_physics_transforms();
+        void propagate_transforms();
+        void extract_render_scene();
         void update_orbit_camera(float delta_time);
 
         // Initialization
@@ -107,8 +138,20 @@ namespace mango::app
 
         // Main loop
         void main_loop();
+        void main_loop_pipelined();
+        void render_thread_main();
         void update(float delta_time);
         void render();
+        auto make_frame_context() const -> Frame_Context;
+        auto frame_scene() const -> const Render_Scene&;
+        auto sync_render_bvh() -> void;
+        auto cull_view(Render_View& view) const -> void;
+        auto occlude_view(Occlusion_Culler& culler, const math::Mat4& view_proj, Render_View& view,
+                          const std::vector<Render_Material>* materials) -> void;
+        auto gpu_culling_enabled() const -> bool;
+        auto run_gpu_culling(graphics::Command_Buffer_Handle cmd) -> void;
+        struct Instance_Buffers;
+        auto upload_instances(const Instance_Batcher& batcher, Instance_Buffers& target) -> bool;
 
         // Cleanup
         void shutdown();
@@ -143,7 +186,7 @@ namespace mango::app
 
         // State
         bool initialized_ = false;
-        bool should_exit_ = false;
+        std::atomic<bool> should_exit_ = false;
         bool minimized_ = false;
         bool imgui_initialized_ = false;
 
@@ -151,7 +194,9 @@ namespace mango::app
         {
             graphics::Graphics_Pipeline_Handle pipeline;
             graphics::Graphics_Pipeline_Handle skybox_pipeline;
+            graphics::Graphics_Pipeline_Handle transparent_pipeline;    // alpha blended, no depth writes
             graphics::Descriptor_Set_Layout_Handle set_layout;
+            graphics::Descriptor_Set_Layout_Handle instance_layout;     // set 3 for PBR, set 1 for shadow
             graphics::Descriptor_Set_Handle set;
             graphics::Buffer_Handle camera_buffer;
             graphics::Buffer_Handle lights_buffer;
@@ -164,6 +209,7 @@ namespace mango::app
             graphics::Buffer_Handle index_buffer;
             uint32_t index_count = 0;
             bool indexed = false;
+            std::shared_ptr<const resource::Mesh_Data> source; // keeps the cache key alive
         };
 
         struct Shadow_State
@@ -182,11 +228,27 @@ namespace mango::app
             bool ready = false;
         };
 
+        // One view's instanced draw data: the batcher's instances and the scene materials,
+        // read through gl_InstanceIndex and the instance's material index
+        struct Instance_Buffers
+        {
+            graphics::Buffer_Handle instances;
+            graphics::Buffer_Handle materials;
+            graphics::Descriptor_Set_Handle set;
+        };
+
+        // Written while recording the frame in that slot, after its fence was waited, so
+        // the buffers can be replaced without stalling the device
+        struct Instance_Frame
+        {
+            Instance_Buffers main;
+            Instance_Buffers shadow;
+        };
+
         Pbr_State pbr_state_;
         Shadow_State shadow_state_;
         IBL_Resources ibl_resources_;
-        std::unordered_map<std::size_t, Gpu_Mesh> mesh_cache_;
-        std::unordered_map<std::uint32_t, Gpu_Mesh> entity_mesh_cache_;
+        std::unordered_map<const resource::Mesh_Data*, Gpu_Mesh> mesh_data_cache_;
         std::array<char, 260> model_path_input_{};
         std::array<char, 64> node_name_input_{};
         VkDescriptorPool imgui_descriptor_pool_ = VK_NULL_HANDLE;
@@ -194,9 +256,74 @@ namespace mango::app
         // Post-processing
         Post_Process_Manager post_process_manager_;
 
+        // GPU-driven main view (Application_Desc::gpu_driven_culling)
+        Gpu_Culling_Manager gpu_culling_;
+
         // Physics
         std::shared_ptr<physics::Physics_World> physics_world_;
 
+        // Composes local transforms into World_Transform once per frame
+        core::Transform_Propagation transform_propagation_;
+
+        // Everything the passes draw this frame, patched after propagation
+        Render_Scene_Extractor scene_extractor_;
+
+        // Frame being recorded; written only by the thread that calls render_frame()
+        Frame_Context frame_context_;
+
+        // Spatial index over the recorded frame's proxies; used for culling from this many up
+        static constexpr std::size_t BVH_CULL_MIN_PROXIES = 4096;
+        Render_Bvh render_bvh_;
+
+        // Per-view culling results, reused every frame by the thread that records
+        Render_View main_view_;
+        Render_View shadow_view_;
+        Occlusion_Culler main_occlusion_;
+        Occlusion_Culler shadow_occlusion_;
+
+        // LOD per row, sorted draw order and one instanced draw per run of a mesh LOD, per
+        // view; instance data per frame in flight
+        Lod_Selector main_lods_;
+        Lod_Selector shadow_lods_;
+        Draw_List main_draws_;
+        Draw_List shadow_draws_;
+        Instance_Batcher main_batches_;
+        Instance_Batcher shadow_batches_;
+        std::vector<Instance_Frame> instance_frames_;
+
+        // Last frame's culling counts for the FPS log; written while recording
+        std::atomic<uint32_t> main_cull_visible_ = 0;
+        std::atomic<uint32_t> main_cull_culled_ = 0;
+        std::atomic<uint32_t> shadow_cull_visible_ = 0;
+        std::atomic<uint32_t> shadow_cull_culled_ = 0;
+        std::atomic<uint32_t> main_occluded_ = 0;
+        std::atomic<uint32_t> shadow_occluded_ = 0;
+        std::atomic<uint32_t> occluder_count_ = 0;
+        std::atomic<float> occluder_ms_ = 0.0f;         // both views
+        std::atomic<float> occludee_ms_ = 0.0f;
+        // Main pass state changes as recorded, and as drawing each row in extraction order would
+        std::atomic<uint32_t> draw_calls_ = 0;
+        std::atomic<uint32_t> pipeline_binds_ = 0;
+        std::atomic<uint32_t> mesh_binds_ = 0;
+        std::atomic<uint32_t> unsorted_draw_calls_ = 0;
+        std::atomic<uint32_t> unsorted_pipeline_binds_ = 0;
+        std::atomic<uint32_t> unsorted_mesh_binds_ = 0;
+        // Main pass triangles with the selected LODs and at full detail
+        std::atomic<uint32_t> lod_triangles_ = 0;
+        std::atomic<uint32_t> full_triangles_ = 0;
+        // GPU-driven main pass: meshlet clusters kept and tested
+        std::atomic<uint32_t> visible_clusters_ = 0;
+        std::atomic<uint32_t> tested_clusters_ = 0;
+
+        // Pipelined rendering: snapshots handed from the main thread to render_thread_
+        std::unique_ptr<Render_Scene_Buffer> scene_buffer_;
+        std::thread render_thread_;
+        std::exception_ptr render_error_;
+
+        // Window size as last reported to the main thread; the render thread applies it
+        uint32_t viewport_width_ = 0;
+        uint32_t viewport_height_ = 0;
+
         // Debug visualization mode (0=RGB, 1=Normals, 2=Depth)
         int debug_mode_ = 0;
 
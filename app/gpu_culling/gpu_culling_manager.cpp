@@ -0,0 +1,667 @@
+#include "gpu_culling_manager.hpp"
+#include "render_core/frustum_culler.hpp"
+#include "resource/mesh.hpp"
+#include "utils/shader-compiler.hpp"
+#include "backends/vulkan/vulkan-render-resource/vk-buffer.hpp"
+#include "sync/barrier.hpp"
+#include "log/historiographer.hpp"
+#include <filesystem>
+#include <algorithm>
+#include <numeric>
+
+namespace
+{
+    auto make_barrier(void* resource, mango::graphics::Resource_State before, mango::graphics::Resource_State after) -> mango::graphics::Barrier
+    {
+        mango::graphics::Barrier b{};
+        b.resource = resource;
+        b.before = before;
+        b.after = after;
+        return b;
+    }
+
+    auto culling_shader_path(const char* filename) -> std::string
+    {
+        auto base = std::filesystem::path(__FILE__).parent_path().parent_path();
+        return (base / "shaders" / filename).string();
+    }
+
+    // std430 layout shared with gpu_cull.comp; instances are Render_Instance
+    struct Cull_Params
+    {
+        mango::math::Vec4 planes[mango::app::Frustum::PLANE_COUNT];
+        mango::math::Mat4 hiz_view_proj;
+        uint32_t counts[4];     // x=instance count, y=flags, z=cluster entry count
+        mango::math::Vec4 camera_position;
+    };
+
+    // VkDrawIndexedIndirectCommand
+    constexpr uint32_t DRAW_COMMAND_STRIDE = 5 * sizeof(uint32_t);
+    constexpr uint32_t CULL_GROUP_SIZE = 64;
+    constexpr uint32_t CULL_FLAG_HIZ = 1u;
+    constexpr uint32_t CULL_FLAG_COMPACT = 2u;
+    // Draw count, visible instances, visible clusters
+    constexpr uint32_t CULL_COUNTERS = 3;
+
+    auto upload(const mango::graphics::Buffer_Handle& buffer, const void* data, std::size_t size, std::size_t offset = 0) -> void
+    {
+        auto vk_buffer = std::dynamic_pointer_cast<mango::graphics::vk::Vk_Buffer>(buffer);
+        if (vk_buffer && size > 0) {
+            vk_buffer->upload(data, size, offset);
+        }
+    }
+
+    using DT = mango::graphics::Descriptor_Type;
+}
+
+namespace mango::app
+{
+    void Gpu_Culling_Manager::init(graphics::Device_Handle device, uint32_t frames_in_flight)
+    {
+        device_ = device;
+
+        const auto& caps = device_->get_capabilities();
+        draw_indirect_count_ = caps.draw_indirect_count_supported;
+        multi_draw_indirect_ = caps.multi_draw_indirect_supported;
+        if (!caps.draw_indirect_first_instance_supported) {
+            UH_WARN("GPU culling disabled: indirect draws cannot set firstInstance on this device");
+            return;
+        }
+
+        auto spv = graphics::utils::compile_shader_form_file(culling_shader_path("gpu_cull.comp"), shaderc_compute_shader);
+        if (spv.empty()) {
+            UH_ERROR("Failed to compile gpu_cull.comp");
+            return;
+        }
+
+        graphics::Shader_Desc sd{};
+        sd.type = graphics::Shader_Type::compute;
+        sd.bytecode = std::move(spv);
+        auto shader = device_->create_shader(sd);
+        if (!shader) return;
+
+        // Set 0 of the cull pass: params, instances, meshes, draw commands, counters, Hi-Z
+        // mips, clusters, cluster entries
+        graphics::Descriptor_Set_Layout_Desc cull_layout{};
+        auto add_binding = [](graphics::Descriptor_Set_Layout_Desc& layout, uint32_t binding, DT type, uint32_t count, uint32_t stages) {
+            graphics::Descriptor_Binding db{};
+            db.binding = binding;
+            db.type = type;
+            db.count = count;
+            db.shader_stages = stages;
+            layout.bindings.push_back(db);
+        };
+        add_binding(cull_layout, 0, DT::uniform_buffer, 1, VK_SHADER_STAGE_COMPUTE_BIT);
+        add_binding(cull_layout, 1, DT::storage_buffer, 1, VK_SHADER_STAGE_COMPUTE_BIT);
+        add_binding(cull_layout, 2, DT::storage_buffer, 1, VK_SHADER_STAGE_COMPUTE_BIT);
+        add_binding(cull_layout, 3, DT::storage_buffer, 1, VK_SHADER_STAGE_COMPUTE_BIT);
+        add_binding(cull_layout, 4, DT::storage_buffer, 1, VK_SHADER_STAGE_COMPUTE_BIT);
+        add_binding(cull_layout, 5, DT::combined_image_sampler, Post_Process_Manager::HIZ_MIP_COUNT, VK_SHADER_STAGE_COMPUTE_BIT);
+        add_binding(cull_layout, 6, DT::storage_buffer, 1, VK_SHADER_STAGE_COMPUTE_BIT);
+        add_binding(cull_layout, 7, DT::storage_buffer, 1, VK_SHADER_STAGE_COMPUTE_BIT);
+        cull_set_layout_ = device_->create_descriptor_set_layout(cull_layout);
+
+        graphics::Compute_Pipeline_Desc pd{};
+        pd.compute_shader = shader;
+        pd.descriptor_set_layouts = { cull_set_layout_ };
+        cull_pipeline_ = device_->create_compute_pipeline(pd);
+
+        // Set 3 of the PBR pipeline: instances and materials
+        graphics::Descriptor_Set_Layout_Desc draw_layout{};
+        add_binding(draw_layout, 0, DT::storage_buffer, 1, VK_SHADER_STAGE_VERTEX_BIT);
+        add_binding(draw_layout, 1, DT::storage_buffer, 1, VK_SHADER_STAGE_VERTEX_BIT);
+        draw_set_layout_ = device_->create_descriptor_set_layout(draw_layout);
+
+        graphics::Sampler_Desc sampler_desc{};
+        sampler_desc.minFilter = graphics::Filter_Mode::nearest;
+        sampler_desc.magFilter = graphics::Filter_Mode::nearest;
+        hiz_sampler_ = device_->create_sampler(sampler_desc);
+
+        graphics::Buffer_Desc count_desc{};
+        count_desc.size = CULL_COUNTERS * sizeof(uint32_t);
+        count_desc.usage = graphics::Buffer_Type::indirect;
+        count_desc.memory = graphics::Memory_Type::gpu_only;
+        count_buffer_ = device_->create_buffer(count_desc);
+
+        graphics::Buffer_Desc params_desc{};
+        params_desc.size = sizeof(Cull_Params);
+        params_desc.usage = graphics::Buffer_Type::uniform;
+        params_desc.memory = graphics::Memory_Type::cpu2gpu;
+
+        graphics::Buffer_Desc readback_desc{};
+        readback_desc.size = CULL_COUNTERS * sizeof(uint32_t);
+        readback_desc.usage = graphics::Buffer_Type::storage;
+        readback_desc.memory = graphics::Memory_Type::gpu2cpu;
+
+        bool frames_ready = frames_in_flight > 0;
+        frames_.assign((std::max)(frames_in_flight, 1u), Frame{});
+        for (auto& frame : frames_) {
+            frame.params = device_->create_buffer(params_desc);
+            frame.readback = device_->create_buffer(readback_desc);
+            frame.cull_set = device_->create_descriptor_set(cull_set_layout_);
+            frame.draw_set = device_->create_descriptor_set(draw_set_layout_);
+            frames_ready &= frame.params && frame.readback && frame.cull_set && frame.draw_set;
+        }
+        frame_ = 0;
+
+        // Row 0 of the mesh table is the empty mesh, used by proxies without geometry
+        mesh_table_.assign(1, Gpu_Culling_Mesh{});
+        mesh_order_.assign(1, nullptr);
+        mesh_first_cluster_.assign(1, 0);
+        mesh_usage_.assign(1, Mesh_Usage{});
+
+        ready_ = cull_pipeline_ && hiz_sampler_ && count_buffer_ && frames_ready;
+        if (ready_) {
+            UH_INFO_FMT("GPU culling ready (indirect count: {}, multi-draw indirect: {}, frames in flight: {})",
+                        draw_indirect_count_, multi_draw_indirect_, frames_.size());
+        }
+    }
+
+    auto Gpu_Culling_Manager::reserve(graphics::Buffer_Handle& buffer, std::size_t size, graphics::Buffer_Type usage,
+                                      graphics::Memory_Type memory, bool shared) -> bool
+    {
+        std::size_t capacity = buffer ? buffer->get_buffer_desc().size : 0;
+        if (size <= capacity) {
+            return false;
+        }
+
+        if (shared && buffer) {
+            frames_[frame_].retired.push_back(buffer);
+            for (auto& frame : frames_) {
+                frame.descriptors_dirty = true;
+            }
+        }
+
+        graphics::Buffer_Desc desc{};
+        desc.size = (std::max)({ size, capacity * 2, std::size_t(256) });
+        desc.usage = usage;
+        desc.memory = memory;
+        buffer = device_->create_buffer(desc);
+        frames_[frame_].descriptors_dirty = true;
+        return true;
+    }
+
+    auto Gpu_Culling_Manager::register_mesh(const resource::Mesh_Data* mesh) -> uint32_t
+    {
+        if (!mesh) {
+            return 0;
+        }
+        if (auto it = meshes_.find(mesh); it != meshes_.end()) {
+            return it->second.index;
+        }
+
+        // Meshes without indices get a trivial index list so every draw is indexed
+        auto index_count = static_cast<uint32_t>(mesh->indices.empty() ? mesh->vertices.size() : mesh->indices.size());
+        if (mesh->vertices.empty()) {
+            index_count = 0;
+        }
+
+        // LOD index lists follow the full one, as in Mesh_Data::lods
+        auto lod_index_count = static_cast<uint32_t>(mesh->indices.empty() ? 0 : mesh->lod_indices.size());
+
+        Gpu_Culling_Mesh entry{};
+        entry.index_count = index_count;
+        entry.first_index = index_count_;
+        entry.vertex_offset = static_cast<int32_t>(vertex_count_);
+        if (!mesh->indices.empty()) {
+            entry.cluster_count = static_cast<uint32_t>(mesh->meshlets.size());
+        }
+
+        auto write_mesh = [&](const resource::Mesh_Data& data, const Gpu_Culling_Mesh& where) {
+            upload(vertex_buffer_, data.vertices.data(), data.vertices.size() * sizeof(resource::Vertex),
+                   static_cast<std::size_t>(where.vertex_offset) * sizeof(resource::Vertex));
+            if (!data.indices.empty()) {
+                upload(index_buffer_, data.indices.data(), data.indices.size() * sizeof(uint32_t),
+                       std::size_t(where.first_index) * sizeof(uint32_t));
+                if (!data.lod_indices.empty()) {
+                    upload(index_buffer_, data.lod_indices.data(), data.lod_indices.size() * sizeof(uint32_t),
+                           (std::size_t(where.first_index) + data.indices.size()) * sizeof(uint32_t));
+                }
+            } else if (where.index_count > 0) {
+                std::vector<uint32_t> sequence(where.index_count);
+                std::iota(sequence.begin(), sequence.end(), 0u);
+                upload(index_buffer_, sequence.data(), sequence.size() * sizeof(uint32_t),
+                       std::size_t(where.first_index) * sizeof(uint32_t));
+            }
+        };
+
+        auto vertex_bytes = (std::size_t(vertex_count_) + mesh->vertices.size()) * sizeof(resource::Vertex);
+        auto index_bytes = (std::size_t(index_count_) + index_count + lod_index_count) * sizeof(uint32_t);
+        bool grown = reserve(vertex_buffer_, vertex_bytes, graphics::Buffer_Type::vertex, graphics::Memory_Type::cpu2gpu, true);
+        grown |= reserve(index_buffer_, index_bytes, graphics::Buffer_Type::index, graphics::Memory_Type::cpu2gpu, true);
+        if (grown) {
+            // Fresh buffers: copy every mesh registered so far back in
+            for (std::size_t row = 1; row < mesh_order_.size(); ++row) {
+                write_mesh(*mesh_order_[row], mesh_table_[row]);
+            }
+        }
+        write_mesh(*mesh, entry);
+
+        vertex_count_ += static_cast<uint32_t>(mesh->vertices.size());
+        index_count_ += index_count + lod_index_count;
+
+        mesh_first_cluster_.push_back(static_cast<uint32_t>(cluster_table_.size()));
+        for (uint32_t i = 0; i < entry.cluster_count; ++i) {
+            const auto& meshlet = mesh->meshlets[i];
+            Gpu_Culling_Cluster cluster;
+            cluster.center_radius = math::Vec4(meshlet.center, meshlet.radius);
+            cluster.cone = math::Vec4(meshlet.cone_axis, meshlet.cone_cutoff);
+            cluster.first_index = entry.first_index + meshlet.first_index;
+            cluster.index_count = meshlet.index_count;
+            cluster_table_.push_back(cluster);
+        }
+        if (entry.cluster_count > 0) {
+            ++cluster_table_version_;
+        }
+
+        Mesh_Usage usage{};
+        usage.unused_since = update_count_;
+        usage.vertex_count = static_cast<uint32_t>(mesh->vertices.size());
+        usage.index_count = index_count + lod_index_count;
+
+        auto index = static_cast<uint32_t>(mesh_table_.size());
+        mesh_table_.push_back(entry);
+        mesh_order_.push_back(mesh);
+        mesh_usage_.push_back(usage);
+        meshes_.emplace(mesh, Mesh_Entry{ index, mesh->shared_from_this() });
+        ++mesh_table_version_;
+        return index;
+    }
+
+    auto Gpu_Culling_Manager::find_mesh(const resource::Mesh_Data* mesh) const -> const Gpu_Culling_Mesh*
+    {
+        auto it = meshes_.find(mesh);
+        return it != meshes_.end() ? &mesh_table_[it->second.index] : nullptr;
+    }
+
+    void Gpu_Culling_Manager::update_instances(const Render_Proxies& proxies, uint32_t begin, uint32_t end)
+    {
+        for (uint32_t row = begin; row < end; ++row) {
+            auto& instance = instances_[row];
+            instance = Render_Instance::from_proxy(proxies, row);
+            instance.mesh = register_mesh(proxies.meshes[row]);
+            set_row_mesh(row, instance.mesh);
+        }
+    }
+
+    void Gpu_Culling_Manager::set_row_mesh(uint32_t row, uint32_t mesh)
+    {
+        auto previous = row_meshes_[row];
+        if (previous == mesh) return;
+
+        // Row 0, the empty mesh, is never dropped and needs no count
+        if (previous != 0 && --mesh_usage_[previous].instances == 0) {
+            mesh_usage_[previous].unused_since = update_count_;
+        }
+        if (mesh != 0) {
+            ++mesh_usage_[mesh].instances;
+        }
+        row_meshes_[row] = mesh;
+        cluster_entries_dirty_ = true;
+    }
+
+    void Gpu_Culling_Manager::retire_meshes()
+    {
+        for (uint32_t row = 1; row < mesh_order_.size(); ++row) {
+            const auto& usage = mesh_usage_[row];
+            if (!mesh_order_[row] || usage.instances > 0 || update_count_ - usage.unused_since < MESH_RETIRE_FRAMES) {
+                continue;
+            }
+
+            // No instance points at the row, so no draw reads its geometry any more
+            dead_vertices_ += usage.vertex_count;
+            dead_indices_ += usage.index_count;
+            dead_clusters_ += mesh_table_[row].cluster_count;
+            ++dead_rows_;
+            meshes_.erase(mesh_order_[row]);
+            mesh_order_[row] = nullptr;
+            mesh_table_[row] = Gpu_Culling_Mesh{};
+            ++mesh_table_version_;
+        }
+
+        // Compacting only once the holes outweigh the live data keeps the copies amortized
+        bool wasteful = dead_vertices_ * 2 > vertex_count_ || dead_indices_ * 2 > index_count_ ||
+                        dead_clusters_ * 2 > cluster_table_.size() || dead_rows_ * 2 > mesh_table_.size();
+        if (dead_rows_ > 0 && wasteful) {
+            compact_meshes();
+        }
+    }
+
+    void Gpu_Culling_Manager::compact_meshes()
+    {
+        // The sources stay alive while the tables are rebuilt from them
+        std::vector<std::shared_ptr<const resource::Mesh_Data>> live;
+        std::vector<uint32_t> live_rows;
+        std::size_t vertex_total = 0;
+        std::size_t index_total = 0;
+        for (uint32_t row = 1; row < mesh_order_.size(); ++row) {
+            if (!mesh_order_[row]) continue;
+            live.push_back(meshes_.at(mesh_order_[row]).source);
+            live_rows.push_back(row);
+            vertex_total += mesh_usage_[row].vertex_count;
+            index_total += mesh_usage_[row].index_count;
+        }
+        auto dropped = dead_rows_;
+        auto old_usage = std::move(mesh_usage_);
+
+        meshes_.clear();
+        mesh_table_.assign(1, Gpu_Culling_Mesh{});
+        mesh_order_.assign(1, nullptr);
+        mesh_first_cluster_.assign(1, 0);
+        mesh_usage_.assign(1, Mesh_Usage{});
+        cluster_table_.clear();
+        vertex_count_ = 0;
+        index_count_ = 0;
+        dead_vertices_ = 0;
+        dead_indices_ = 0;
+        dead_clusters_ = 0;
+        dead_rows_ = 0;
+
+        // Fresh buffers sized for the live meshes; frames in flight may still read the old ones
+        auto& retired = frames_[frame_].retired;
+        for (auto* buffer : { &vertex_buffer_, &index_buffer_ }) {
+            if (*buffer) {
+                retired.push_back(*buffer);
+                buffer->reset();
+            }
+        }
+        reserve(vertex_buffer_, (std::max)(vertex_total, std::size_t(1)) * sizeof(resource::Vertex),
+                graphics::Buffer_Type::vertex, graphics::Memory_Type::cpu2gpu);
+        reserve(index_buffer_, (std::max)(index_total, std::size_t(1)) * sizeof(uint32_t),
+                graphics::Buffer_Type::index, graphics::Memory_Type::cpu2gpu);
+
+        std::vector<uint32_t> remap(old_usage.size(), 0);
+        for (std::size_t i = 0; i < live.size(); ++i) {
+            auto row = register_mesh(live[i].get());
+            remap[live_rows[i]] = row;
+            mesh_usage_[row].instances = old_usage[live_rows[i]].instances;
+            mesh_usage_[row].unused_since = old_usage[live_rows[i]].unused_since;
+        }
+
+        // Every instance names its mesh by row, so every slot uploads them all again
+        for (std::size_t row = 0; row < row_meshes_.size(); ++row) {
+            row_meshes_[row] = remap[row_meshes_[row]];
+            instances_[row].mesh = row_meshes_[row];
+        }
+        for (auto& frame : frames_) {
+            frame.full_upload = true;
+            frame.pending.clear();
+        }
+        ++mesh_table_version_;
+        ++cluster_table_version_;
+        cluster_entries_dirty_ = true;
+
+        UH_INFO_FMT("GPU culling: compacted mesh buffers ({} meshes dropped, {} kept)", dropped, live.size());
+    }
+
+    void Gpu_Culling_Manager::upload_instances(Frame& frame)
+    {
+        auto upload_rows = [&](uint32_t begin, uint32_t end) {
+            end = (std::min)(end, instance_count_);
+            if (begin < end) {
+                upload(frame.instances, instances_.data() + begin, std::size_t(end - begin) * sizeof(Render_Instance),
+                       std::size_t(begin) * sizeof(Render_Instance));
+            }
+        };
+
+        if (frame.full_upload) {
+            upload_rows(0, instance_count_);
+        } else {
+            for (const auto& range : frame.pending) {
+                upload_rows(range.begin, range.end);
+            }
+        }
+        frame.pending.clear();
+        frame.full_upload = false;
+    }
+
+    void Gpu_Culling_Manager::rebuild_cluster_entries()
+    {
+        cluster_entries_.clear();
+        for (uint32_t row = 0; row < instance_count_; ++row) {
+            auto mesh = row_meshes_[row];
+            auto first = mesh_first_cluster_[mesh];
+            for (uint32_t cluster = 0; cluster < mesh_table_[mesh].cluster_count; ++cluster) {
+                cluster_entries_.push_back(row);
+                cluster_entries_.push_back(first + cluster);
+            }
+        }
+        cluster_entry_count_ = static_cast<uint32_t>(cluster_entries_.size() / 2);
+        ++cluster_entry_version_;
+    }
+
+    void Gpu_Culling_Manager::update(const Render_Scene& scene, const std::vector<Render_Range>* changed, uint32_t frame_index)
+    {
+        if (!ready_) return;
+
+        // This slot's fence was waited: its buffers are free, and whatever it retired while
+        // last recorded was last read by a frame that has completed too
+        frame_ = frame_index % static_cast<uint32_t>(frames_.size());
+        auto& frame = frames_[frame_];
+        frame.retired.clear();
+        ++update_count_;
+
+        const auto& proxies = scene.proxies;
+        auto count = static_cast<uint32_t>(proxies.size());
+        if (row_meshes_.size() != count) {
+            for (auto row = count; row < row_meshes_.size(); ++row) {
+                set_row_mesh(row, 0);
+            }
+            row_meshes_.resize(count, 0);
+            instances_.resize(count);
+            cluster_entries_dirty_ = true;
+        }
+        instance_count_ = count;
+
+        // Refresh the CPU copy, and queue the rows for every slot
+        if (!changed) {
+            update_instances(proxies, 0, count);
+            for (auto& other : frames_) {
+                other.full_upload = true;
+                other.pending.clear();
+            }
+        } else {
+            for (const auto& range : *changed) {
+                update_instances(proxies, range.begin, (std::min)(range.end, count));
+            }
+            for (auto& other : frames_) {
+                if (!other.full_upload) {
+                    other.pending.insert(other.pending.end(), changed->begin(), changed->end());
+                }
+            }
+        }
+        retire_meshes();
+
+        if (reserve(frame.instances, std::size_t((std::max)(count, 1u)) * sizeof(Render_Instance),
+                    graphics::Buffer_Type::storage, graphics::Memory_Type::cpu2gpu)) {
+            frame.full_upload = true;
+        }
+        upload_instances(frame);
+
+        if (reserve(frame.clusters, (std::max)(cluster_table_.size(), std::size_t(1)) * sizeof(Gpu_Culling_Cluster),
+                    graphics::Buffer_Type::storage, graphics::Memory_Type::cpu2gpu)) {
+            frame.cluster_table_version = 0;
+        }
+        if (frame.cluster_table_version != cluster_table_version_) {
+            upload(frame.clusters, cluster_table_.data(), cluster_table_.size() * sizeof(Gpu_Culling_Cluster));
+            frame.cluster_table_version = cluster_table_version_;
+        }
+
+        if (cluster_entries_dirty_) {
+            rebuild_cluster_entries();
+            cluster_entries_dirty_ = false;
+        }
+        if (reserve(frame.cluster_entries, (std::max)(cluster_entries_.size(), std::size_t(2)) * sizeof(uint32_t),
+                    graphics::Buffer_Type::storage, graphics::Memory_Type::cpu2gpu)) {
+            frame.cluster_entry_version = 0;
+        }
+        if (frame.cluster_entry_version != cluster_entry_version_) {
+            upload(frame.cluster_entries, cluster_entries_.data(), cluster_entries_.size() * sizeof(uint32_t));
+            frame.cluster_entry_version = cluster_entry_version_;
+        }
+
+        // A draw slot per instance and per cluster entry
+        reserve(draw_buffer_, std::size_t((std::max)(count + cluster_entry_count_, 1u)) * DRAW_COMMAND_STRIDE,
+                graphics::Buffer_Type::indirect, graphics::Memory_Type::gpu_only, true);
+
+        // Materials are few; rewrite them all
+        auto material_bytes = scene.materials.size() * sizeof(Render_Material);
+        reserve(frame.materials, (std::max)(material_bytes, sizeof(Render_Material)),
+                graphics::Buffer_Type::storage, graphics::Memory_Type::cpu2gpu);
+        upload(frame.materials, scene.materials.data(), material_bytes);
+
+        if (reserve(frame.meshes, mesh_table_.size() * sizeof(Gpu_Culling_Mesh),
+                    graphics::Buffer_Type::storage, graphics::Memory_Type::cpu2gpu)) {
+            frame.mesh_table_version = 0;
+        }
+        if (frame.mesh_table_version != mesh_table_version_) {
+            upload(frame.meshes, mesh_table_.data(), mesh_table_.size() * sizeof(Gpu_Culling_Mesh));
+            frame.mesh_table_version = mesh_table_version_;
+        }
+
+        if (frame.descriptors_dirty) {
+            write_descriptors(frame);
+            frame.descriptors_dirty = false;
+        }
+    }
+
+    void Gpu_Culling_Manager::write_descriptors(Frame& frame)
+    {
+        auto buffer_write = [](uint32_t binding, DT type, const graphics::Buffer_Handle& buffer) {
+            graphics::Descriptor_Write w{};
+            w.binding = binding;
+            w.type = type;
+            w.buffers = { buffer };
+            w.buffer_offsets = { 0 };
+            w.buffer_ranges = { buffer->get_buffer_desc().size };
+            return w;
+        };
+
+        frame.cull_set->update({
+            buffer_write(0, DT::uniform_buffer, frame.params),
+            buffer_write(1, DT::storage_buffer, frame.instances),
+            buffer_write(2, DT::storage_buffer, frame.meshes),
+            buffer_write(3, DT::storage_buffer, draw_buffer_),
+            buffer_write(4, DT::storage_buffer, count_buffer_),
+            buffer_write(6, DT::storage_buffer, frame.clusters),
+            buffer_write(7, DT::storage_buffer, frame.cluster_entries)
+        });
+        frame.draw_set->update({
+            buffer_write(0, DT::storage_buffer, frame.instances),
+            buffer_write(1, DT::storage_buffer, frame.materials)
+        });
+    }
+
+    void Gpu_Culling_Manager::write_hiz_descriptors(Frame& frame, const Post_Process_Manager& post_process)
+    {
+        graphics::Descriptor_Write w{};
+        w.binding = 5;
+        w.type = DT::combined_image_sampler;
+        for (uint32_t mip = 0; mip < Post_Process_Manager::HIZ_MIP_COUNT; ++mip) {
+            w.textures.push_back(post_process.get_hiz_mip(mip));
+            w.samplers.push_back(hiz_sampler_);
+        }
+        frame.cull_set->update({ w });
+        frame.bound_hiz = post_process.get_hiz_mip(0);
+    }
+
+    void Gpu_Culling_Manager::set_hiz_view_proj(const math::Mat4& view_proj)
+    {
+        hiz_view_proj_ = view_proj;
+        hiz_view_proj_valid_ = true;
+    }
+
+    void Gpu_Culling_Manager::cull(graphics::Command_Buffer_Handle cmd, const Render_Camera& camera, const Post_Process_Manager& post_process)
+    {
+        if (!ready_ || !cmd || !post_process.get_hiz_mip(0)) return;
+        auto& frame = frames_[frame_];
+        if (!frame.instances) return;
+
+        // The pyramid is recreated on resize, after the device went idle
+        if (frame.bound_hiz != post_process.get_hiz_mip(0)) {
+            write_hiz_descriptors(frame, post_process);
+        }
+
+        // Before post-processing first builds the pyramid its mips are still undefined;
+        // give them the layout the descriptors promise even though the shader skips them
+        bool use_hiz = hiz_view_proj_valid_ && post_process.is_hiz_valid();
+        if (!post_process.is_hiz_valid()) {
+            for (uint32_t mip = 0; mip < Post_Process_Manager::HIZ_MIP_COUNT; ++mip) {
+                cmd->resource_barrier(make_barrier(post_process.get_hiz_mip(mip).get(),
+                    graphics::Resource_State::undefined, graphics::Resource_State::shader_resource));
+            }
+        }
+
+        Cull_Params params{};
+        auto frustum = Frustum::from_view_proj(camera.view_proj);
+        std::copy(frustum.planes.begin(), frustum.planes.end(), params.planes);
+        params.hiz_view_proj = hiz_view_proj_;
+        params.counts[0] = instance_count_;
+        params.counts[1] = (use_hiz ? CULL_FLAG_HIZ : 0u) | (draw_indirect_count_ ? CULL_FLAG_COMPACT : 0u);
+        params.counts[2] = cluster_entry_count_;
+        params.camera_position = camera.position;
+        upload(frame.params, &params, sizeof(params));
+
+        // Last frame's count was read by the draw and the stats copy
+        cmd->resource_barrier(make_barrier(count_buffer_.get(),
+            graphics::Resource_State::indirect_argument, graphics::Resource_State::copy_dst));
+        cmd->fill_buffer(count_buffer_, 0, CULL_COUNTERS * sizeof(uint32_t), 0);
+        cmd->resource_barrier(make_barrier(count_buffer_.get(),
+            graphics::Resource_State::copy_dst, graphics::Resource_State::unordered_access));
+        cmd->resource_barrier(make_barrier(draw_buffer_.get(),
+            graphics::Resource_State::indirect_argument, graphics::Resource_State::unordered_access));
+
+        // Instances first, then cluster entries, one invocation each
+        auto invocations = instance_count_ + cluster_entry_count_;
+        if (invocations > 0) {
+            cmd->bind_pipeline(cull_pipeline_);
+            cmd->bind_descriptor_set(0, frame.cull_set);
+            cmd->dispatch((invocations + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE, 1, 1);
+        }
+
+        cmd->resource_barrier(make_barrier(draw_buffer_.get(),
+            graphics::Resource_State::unordered_access, graphics::Resource_State::indirect_argument));
+        cmd->resource_barrier(make_barrier(count_buffer_.get(),
+            graphics::Resource_State::unordered_access, graphics::Resource_State::copy_src));
+
+        // Counts of the last frame recorded in this slot, complete since its fence was
+        // waited; read before this frame's copy overwrites them
+        auto vk_readback = std::dynamic_pointer_cast<graphics::vk::Vk_Buffer>(frame.readback);
+        if (vk_readback && frame.readback_pending) {
+            uint32_t counters[CULL_COUNTERS] = {};
+            vk_readback->download(counters, sizeof(counters));
+            stats_.visible = counters[1];
+            stats_.visible_clusters = counters[2];
+        }
+        cmd->copy_buffer(count_buffer_, frame.readback, 0, 0, CULL_COUNTERS * sizeof(uint32_t));
+        frame.readback_pending = true;
+        cmd->resource_barrier(make_barrier(count_buffer_.get(),
+            graphics::Resource_State::copy_src, graphics::Resource_State::indirect_argument));
+
+        stats_.instances = instance_count_;
+        stats_.clusters = cluster_entry_count_;
+        stats_.hiz = use_hiz;
+    }
+
+    void Gpu_Culling_Manager::draw(graphics::Command_Buffer_Handle cmd)
+    {
+        if (!ready_ || !cmd || instance_count_ == 0 || !vertex_buffer_ || !index_buffer_) return;
+
+        cmd->bind_descriptor_set(3, frames_[frame_].draw_set);
+        cmd->bind_vertex_buffer(0, vertex_buffer_, 0);
+        cmd->bind_index_buffer(index_buffer_, 0, 1);
+
+        // One call for the whole scene when the GPU supplies the count; otherwise every
+        // instance and cluster entry has a slot and hidden ones draw zero instances
+        auto slots = instance_count_ + cluster_entry_count_;
+        if (draw_indirect_count_) {
+            cmd->draw_indexed_indirect_count(draw_buffer_, 0, count_buffer_, 0, slots, DRAW_COMMAND_STRIDE);
+        } else if (multi_draw_indirect_) {
+            cmd->draw_indexed_indirect(draw_buffer_, 0, slots, DRAW_COMMAND_STRIDE);
+        } else {
+            for (uint32_t i = 0; i < slots; ++i) {
+                cmd->draw_indexed_indirect(draw_buffer_, std::uint64_t(i) * DRAW_COMMAND_STRIDE, 1, DRAW_COMMAND_STRIDE);
+            }
+        }
+    }
+}
@@ -0,0 +1,235 @@
+#pragma once
+#include "device.hpp"
+#include "command-execution/command-buffer.hpp"
+#include "render-resource/buffer.hpp"
+#include "render-resource/descriptor-set.hpp"
+#include "render-resource/sampler.hpp"
+#include "pipeline-state/compute-pipeline-state.hpp"
+#include "post_process/post_process_manager.hpp"
+#include "render_core/render_scene.hpp"
+#include "render_core/instance_batcher.hpp"
+#include <memory>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace mango::resource
+{
+    struct Mesh_Data;
+}
+
+namespace mango::app
+{
+    // Where a mesh lives in the shared vertex and index buffers; index_count is the full
+    // mesh, and Mesh_Lod::first_index and Meshlet::first_index count from first_index
+    struct Gpu_Culling_Mesh
+    {
+        uint32_t index_count = 0;
+        uint32_t first_index = 0;
+        int32_t vertex_offset = 0;
+        uint32_t cluster_count = 0;     // meshlets; instances of such a mesh draw per cluster
+    };
+
+    // One meshlet in the cluster table, std430 like gpu_cull.comp's Cluster
+    struct Gpu_Culling_Cluster
+    {
+        math::Vec4 center_radius{0.0f, 0.0f, 0.0f, 0.0f};  // mesh space
+        math::Vec4 cone{0.0f, 0.0f, 1.0f, 1.0f};           // xyz=axis, w=cutoff
+        uint32_t first_index = 0;                           // in the shared index buffer
+        uint32_t index_count = 0;
+        uint32_t padding[2] = {};
+    };
+    static_assert(sizeof(Gpu_Culling_Cluster) == 48, "Gpu_Culling_Cluster must match the shader Cluster layout");
+
+    // Counts read back from the last frame recorded in the same slot
+    struct Gpu_Culling_Stats
+    {
+        uint32_t instances = 0;
+        uint32_t visible = 0;           // instances passing the instance test
+        uint32_t clusters = 0;          // (instance, meshlet) pairs tested
+        uint32_t visible_clusters = 0;
+        bool hiz = false;               // the occlusion test ran this frame
+    };
+
+    // GPU-driven main view: every proxy is an instance in a storage buffer, a compute pass
+    // tests each one against the frustum and the previous frame's Hi-Z pyramid and writes
+    // an indexed draw command per survivor, and draw() submits all of them with one
+    // indirect call. All meshes share one vertex and one index buffer so the draws need
+    // no rebinding, and instances and materials use the layout pbr.vert reads for CPU
+    // instancing, so the whole scene is a single bucket drawn with the PBR pipeline.
+    // Instances of meshes with meshlets are culled per cluster instead, in the same
+    // dispatch: every (instance, meshlet) pair is tested against the frustum, its normal
+    // cone and the Hi-Z pyramid and draws its own index range, so only plain compute and
+    // indirect draws are needed.
+    //
+    // Frame order: update() and cull() outside any render pass, draw() inside the scene
+    // pass, then set_hiz_view_proj() once post-processing built the pyramid from that
+    // frame's depth.
+    //
+    // Everything the CPU rewrites (params, instances, materials, mesh and cluster tables)
+    // has one copy per frame in flight, written only while recording the frame in that
+    // slot, after its fence was waited. The shared geometry and the GPU-written draw and
+    // count buffers are never rewritten in place; when they grow the old buffer is kept
+    // until the slot that replaced it records again.
+    //
+    // Meshes are registered on first use and held alive by the manager. One that no
+    // instance has used for MESH_RETIRE_FRAMES updates is dropped, and once dropped meshes
+    // take more space than the live ones the shared buffers are rebuilt without them, so
+    // edited (copy-on-write) or streamed meshes do not grow them without bound.
+    class Gpu_Culling_Manager
+    {
+    public:
+        static constexpr uint32_t MESH_RETIRE_FRAMES = 120;
+
+        Gpu_Culling_Manager() = default;
+        ~Gpu_Culling_Manager() = default;
+
+        void init(graphics::Device_Handle device, uint32_t frames_in_flight);
+        bool is_ready() const { return ready_; }
+
+        // Uploads the changed instances (all of them when changed is null) and every
+        // material into the buffers of frame slot frame_index, adding meshes it has not
+        // seen to the shared buffers
+        void update(const Render_Scene& scene, const std::vector<Render_Range>* changed, uint32_t frame_index);
+
+        // Records the culling dispatch and leaves the draw commands ready for draw()
+        void cull(graphics::Command_Buffer_Handle cmd, const Render_Camera& camera, const Post_Process_Manager& post_process);
+
+        // Draws what cull() kept; the caller binds the PBR pipeline and sets 0-2
+        void draw(graphics::Command_Buffer_Handle cmd);
+
+        // View-projection the current Hi-Z pyramid was rendered with
+        void set_hiz_view_proj(const math::Mat4& view_proj);
+
+        auto find_mesh(const resource::Mesh_Data* mesh) const -> const Gpu_Culling_Mesh*;
+        auto get_vertex_buffer() const -> graphics::Buffer_Handle { return vertex_buffer_; }
+        auto get_index_buffer() const -> graphics::Buffer_Handle { return index_buffer_; }
+
+        // Set 3 of the PBR pipeline: instances and materials of the frame being recorded
+        auto get_draw_set_layout() const -> graphics::Descriptor_Set_Layout_Handle { return draw_set_layout_; }
+        auto get_draw_set() const -> graphics::Descriptor_Set_Handle
+        {
+            return frames_.empty() ? nullptr : frames_[frame_].draw_set;
+        }
+
+        auto get_stats() const -> const Gpu_Culling_Stats& { return stats_; }
+
+    private:
+        struct Mesh_Entry
+        {
+            uint32_t index = 0;                                 // row in the mesh table
+            std::shared_ptr<const resource::Mesh_Data> source;  // keeps the key alive
+        };
+
+        // CPU-side bookkeeping of a mesh table row
+        struct Mesh_Usage
+        {
+            uint32_t instances = 0;         // instances drawing this mesh
+            uint64_t unused_since = 0;      // update count when instances dropped to 0
+            uint32_t vertex_count = 0;      // space held in the shared buffers
+            uint32_t index_count = 0;       // full list plus LODs
+        };
+
+        // Buffers and descriptor sets of one frame in flight
+        struct Frame
+        {
+            graphics::Buffer_Handle params;
+            graphics::Buffer_Handle instances;
+            graphics::Buffer_Handle materials;
+            graphics::Buffer_Handle meshes;
+            graphics::Buffer_Handle clusters;
+            graphics::Buffer_Handle cluster_entries;
+            graphics::Buffer_Handle readback;
+            graphics::Descriptor_Set_Handle cull_set;
+            graphics::Descriptor_Set_Handle draw_set;
+            graphics::Texture_Handle bound_hiz;                 // mip 0 the cull set points at
+            bool descriptors_dirty = true;
+            bool readback_pending = false;                      // a counter copy was recorded
+
+            // Instance rows changed since this slot last uploaded them
+            std::vector<Render_Range> pending;
+            bool full_upload = true;
+
+            // Table versions this slot holds; 0 forces an upload
+            uint64_t mesh_table_version = 0;
+            uint64_t cluster_table_version = 0;
+            uint64_t cluster_entry_version = 0;
+
+            // Shared buffers replaced while recording this slot; other frames in flight may
+            // still read them, so they go when this slot records again
+            std::vector<graphics::Buffer_Handle> retired;
+        };
+
+        auto register_mesh(const resource::Mesh_Data* mesh) -> uint32_t;
+        void update_instances(const Render_Proxies& proxies, uint32_t begin, uint32_t end);
+        void set_row_mesh(uint32_t row, uint32_t mesh);
+        // Drops meshes unused for MESH_RETIRE_FRAMES and compacts once holes dominate
+        void retire_meshes();
+        // Rebuilds the shared buffers and tables from the live meshes and renumbers them
+        void compact_meshes();
+        void upload_instances(Frame& frame);
+        // One (instance, cluster) pair per meshlet of every clustered instance
+        void rebuild_cluster_entries();
+        // Grows buffer to hold at least size bytes; returns true when it was recreated.
+        // A shared buffer may still be read by the other frames in flight and is retired
+        // into the current frame instead of released.
+        auto reserve(graphics::Buffer_Handle& buffer, std::size_t size, graphics::Buffer_Type usage,
+                     graphics::Memory_Type memory, bool shared = false) -> bool;
+        void write_descriptors(Frame& frame);
+        void write_hiz_descriptors(Frame& frame, const Post_Process_Manager& post_process);
+
+        graphics::Device_Handle device_;
+        bool ready_ = false;
+        bool draw_indirect_count_ = false;
+        bool multi_draw_indirect_ = false;
+
+        graphics::Compute_Pipeline_Handle cull_pipeline_;
+        graphics::Descriptor_Set_Layout_Handle cull_set_layout_;
+        graphics::Descriptor_Set_Layout_Handle draw_set_layout_;
+        graphics::Sampler_Handle hiz_sampler_;
+
+        std::vector<Frame> frames_;
+        uint32_t frame_ = 0;                                // slot being recorded
+
+        // Shared geometry, grown by whole-buffer copies from the mesh sources
+        graphics::Buffer_Handle vertex_buffer_;
+        graphics::Buffer_Handle index_buffer_;
+        uint32_t vertex_count_ = 0;
+        uint32_t index_count_ = 0;
+        std::unordered_map<const resource::Mesh_Data*, Mesh_Entry> meshes_;
+        std::vector<Gpu_Culling_Mesh> mesh_table_;
+        std::vector<const resource::Mesh_Data*> mesh_order_;   // null for dropped rows
+        std::vector<Mesh_Usage> mesh_usage_;
+        uint64_t mesh_table_version_ = 1;
+        uint64_t update_count_ = 0;
+        // Space held by dropped meshes until the next compaction
+        std::size_t dead_vertices_ = 0;
+        std::size_t dead_indices_ = 0;
+        std::size_t dead_clusters_ = 0;
+        std::size_t dead_rows_ = 0;
+
+        // Meshlets of every registered mesh, and the pairs the cull pass tests
+        std::vector<Gpu_Culling_Cluster> cluster_table_;
+        std::vector<uint32_t> mesh_first_cluster_;         // per mesh table row
+        uint64_t cluster_table_version_ = 1;
+        std::vector<uint32_t> row_meshes_;                 // mesh table row of every instance
+        std::vector<uint32_t> cluster_entries_;            // instance, cluster; flattened
+        uint32_t cluster_entry_count_ = 0;
+        uint64_t cluster_entry_version_ = 1;
+        bool cluster_entries_dirty_ = true;
+
+        // Every instance as last uploaded, so a slot can catch up on rows changed while
+        // the other slots were recorded
+        std::vector<Render_Instance> instances_;
+        uint32_t instance_count_ = 0;
+
+        // Written by the cull pass only, ordered between frames by barriers
+        graphics::Buffer_Handle draw_buffer_;
+        graphics::Buffer_Handle count_buffer_;
+
+        math::Mat4 hiz_view_proj_{1.0f};
+        bool hiz_view_proj_valid_ = false;
+
+        Gpu_Culling_Stats stats_;
+    };
+}
\ No newline at end of file
@@ -188,6 +188,7 @@ namespace mango::app
         volumetric_ = make_tex(qw, qh, graphics::Texture_Format::rgba16f);
 
         // Hi-Z mip chain (r32f)
+        hiz_valid_ = false;
         uint32_t hzw = hw, hzh = hh;
         for (uint32_t i = 0; i < HIZ_MIP_COUNT; i++) {
             hiz_mips_[i] = make_tex(hzw, hzh, graphics::Texture_Format::r32f);
@@ -726,14 +727,18 @@ namespace mango::app
         }
 
         // === Step 1b: Hi-Z Pyramid ===
-        if (settings_.ssr_enabled && hiz_pipeline_) {
+        if ((settings_.ssr_enabled || hiz_requested_) && hiz_pipeline_) {
+            // Readers of the previous pyramid (e.g. GPU culling earlier in the frame) must
+            // finish before it is overwritten, so only discard it when it was never built
+            auto hiz_before = hiz_valid_ ? graphics::Resource_State::shader_resource : graphics::Resource_State::undefined;
             uint32_t hzw = hw, hzh = hh;
             uint32_t hzs_w = width_, hzs_h = height_;
+            uint32_t built = 0;
             for (uint32_t i = 0; i < HIZ_MIP_COUNT; i++) {
                 if (!hiz_sets_[i] || !hiz_mips_[i]) break;
 
                 cmd->resource_barrier(make_barrier(hiz_mips_[i].get(),
-                    graphics::Resource_State::undefined, graphics::Resource_State::unordered_access));
+                    hiz_before, graphics::Resource_State::unordered_access));
 
                 cmd->bind_pipeline(hiz_pipeline_);
                 cmd->bind_descriptor_set(0, hiz_sets_[i]);
@@ -750,7 +755,11 @@ namespace mango::app
                 hzs_w = hzw; hzs_h = hzh;
                 hzw = (std::max)(hzw / 2, 1u);
                 hzh = (std::max)(hzh / 2, 1u);
+                built++;
             }
+            hiz_valid_ = built == HIZ_MIP_COUNT;
+        } else {
+            hiz_valid_ = false;
         }
 
         // === Step 1c: SSR Trace + Upsample ===
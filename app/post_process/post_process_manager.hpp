@@ -62,6 +62,8 @@ namespace mango::app
     class Post_Process_Manager
     {
     public:
+        static constexpr uint32_t HIZ_MIP_COUNT = 8;
+
         Post_Process_Manager() = default;
         ~Post_Process_Manager() = default;
 
@@ -92,6 +94,13 @@ namespace mango::app
         void set_view_matrix(const float* mat) { memcpy(view_, mat, sizeof(float) * 16); }
         void set_inv_projection_matrix(const float* mat) { memcpy(inv_projection_, mat, sizeof(float) * 16); }
 
+        // Hi-Z pyramid: farthest depth per texel, mip 0 at half resolution. It is built by
+        // execute() when SSR is on or another pass asked for it, and stays readable
+        // (shader_resource) until the next execute() overwrites it.
+        void set_hiz_requested(bool requested) { hiz_requested_ = requested; }
+        bool is_hiz_valid() const { return hiz_valid_; }
+        auto get_hiz_mip(uint32_t mip) const -> graphics::Texture_Handle { return mip < HIZ_MIP_COUNT ? hiz_mips_[mip] : nullptr; }
+
         // Volumetric light data
         void set_shadow_map(graphics::Texture_Handle tex) { shadow_map_ = tex; }
         void set_shadow_sampler(graphics::Sampler_Handle s) { shadow_sampler_ = s; }
@@ -154,8 +163,9 @@ namespace mango::app
         graphics::Texture_Handle ssr_full_;          // full-res SSR (rgba16f)
 
         // Hi-Z pyramid
-        static constexpr uint32_t HIZ_MIP_COUNT = 8;
         graphics::Texture_Handle hiz_mips_[HIZ_MIP_COUNT]; // r32f per mip
+        bool hiz_requested_ = false;
+        bool hiz_valid_ = false;                           // every mip written by the last execute()
 
         // Volumetric light
         graphics::Texture_Handle volumetric_;        // quarter-res rgba16f
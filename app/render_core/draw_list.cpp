@@ -0,0 +1,171 @@
+#include "render_core/draw_list.hpp"
+#include "thread/worker-pool.hpp"
+#include <algorithm>
+#include <bit>
+#include <utility>
+
+namespace mango::app
+{
+    auto Draw_Key::depth_bits(float depth) -> uint32_t
+    {
+        // IEEE floats of one sign compare like their bit patterns; !(> 0) also catches NaN
+        return depth > 0.0f ? std::bit_cast<uint32_t>(depth) : 0u;
+    }
+
+    auto Draw_Key::make(Draw_Pass pass, uint32_t pipeline, uint32_t mesh_rank, float depth) -> uint64_t
+    {
+        auto key = (uint64_t(pass) << PASS_SHIFT) | (uint64_t(std::min(pipeline, MAX_PIPELINE)) << PIPELINE_SHIFT);
+        auto rank = uint64_t(std::min(mesh_rank, MAX_MESH_RANK));
+        auto depth_code = uint64_t(depth_bits(depth));
+        if (pass == Draw_Pass::transparent) {
+            return key | ((~depth_code & 0xFFFFFFFFull) << MESH_BITS) | rank;
+        }
+        return key | (rank << 32) | depth_code;
+    }
+
+    auto Radix_Sorter::sort(std::vector<uint64_t>& keys, std::vector<uint32_t>& values) -> void
+    {
+        const auto count = keys.size();
+        if (count < 2) return;
+
+        const auto chunk_count = (count + CHUNK_SIZE - 1) / CHUNK_SIZE;
+        scratch_keys_.resize(count);
+        scratch_values_.resize(count);
+        chunk_offsets_.resize(chunk_count);
+        auto* pool = core::Worker_Pool::current_instance();
+
+        for (uint32_t shift = 0; shift < 64; shift += 8) {
+            // Per-chunk digit counts; chunks are fixed ranges so the scatter stays stable
+            pool->parallel_for(chunk_count, 1, [&](std::size_t first_chunk, std::size_t last_chunk, std::uint32_t) {
+                for (auto chunk = first_chunk; chunk < last_chunk; ++chunk) {
+                    auto& counts = chunk_offsets_[chunk];
+                    counts.fill(0);
+                    for (auto i = chunk * CHUNK_SIZE; i < std::min(count, (chunk + 1) * CHUNK_SIZE); ++i) {
+                        ++counts[(keys[i] >> shift) & 0xFF];
+                    }
+                }
+            });
+
+            // Turn counts into each chunk's first slot per digit: digits in order, and
+            // inside a digit the chunks in input order
+            uint32_t running = 0;
+            bool single_digit = false;
+            for (uint32_t digit = 0; digit < 256; ++digit) {
+                uint32_t digit_total = 0;
+                for (auto& counts : chunk_offsets_) {
+                    auto n = counts[digit];
+                    counts[digit] = running + digit_total;
+                    digit_total += n;
+                }
+                single_digit |= digit_total == count;
+                running += digit_total;
+            }
+            if (single_digit) continue;
+
+            pool->parallel_for(chunk_count, 1, [&](std::size_t first_chunk, std::size_t last_chunk, std::uint32_t) {
+                for (auto chunk = first_chunk; chunk < last_chunk; ++chunk) {
+                    auto& offsets = chunk_offsets_[chunk];
+                    for (auto i = chunk * CHUNK_SIZE; i < std::min(count, (chunk + 1) * CHUNK_SIZE); ++i) {
+                        auto slot = offsets[(keys[i] >> shift) & 0xFF]++;
+                        scratch_keys_[slot] = keys[i];
+                        scratch_values_[slot] = values[i];
+                    }
+                }
+            });
+            keys.swap(scratch_keys_);
+            values.swap(scratch_values_);
+        }
+    }
+
+    auto Draw_List::build(const Render_Proxies& proxies, const std::vector<uint32_t>& rows, const math::Mat4& view,
+                          const std::vector<Render_Material>* materials, const std::vector<uint8_t>* lods) -> void
+    {
+        const auto count = rows.size();
+        rows_.assign(rows.begin(), rows.end());
+        keys_.resize(count);
+        depths_.resize(count);
+        geometry_of_row_.resize(count);
+        mesh_ids_.clear();
+        geometry_ids_.clear();
+        mesh_ranks_.clear();
+        geometries_.clear();
+
+        // View depth of each bounds center, and each mesh's nearest instance
+        const auto& bounds = proxies.bounds;
+        for (std::size_t i = 0; i < count; ++i) {
+            auto row = rows_[i];
+            auto depth = -(view[0][2] * bounds.center_x[row] + view[1][2] * bounds.center_y[row] +
+                           view[2][2] * bounds.center_z[row] + view[3][2]);
+            depths_[i] = depth;
+
+            auto [it, inserted] = mesh_ids_.try_emplace(proxies.meshes[row], static_cast<uint32_t>(mesh_ranks_.size()));
+            if (inserted) {
+                mesh_ranks_.push_back({ depth, it->second });
+            }
+            auto mesh = it->second;
+            mesh_ranks_[mesh].nearest = std::min(mesh_ranks_[mesh].nearest, depth);
+
+            uint32_t lod = lods ? (*lods)[row] : 0;
+            auto [geometry, added] = geometry_ids_.try_emplace((uint64_t(mesh) << 8) | lod,
+                                                              static_cast<uint32_t>(geometries_.size()));
+            if (added) {
+                geometries_.push_back({ mesh, lod });
+            }
+            geometry_of_row_[i] = geometry->second;
+        }
+
+        // Meshes with the nearest instances first, so opaque batches also run front to back,
+        // and the LODs of a mesh next to each other
+        geometry_order_.resize(geometries_.size());
+        for (uint32_t i = 0; i < geometry_order_.size(); ++i) {
+            geometry_order_[i] = i;
+        }
+        std::sort(geometry_order_.begin(), geometry_order_.end(), [&](uint32_t a, uint32_t b) {
+            const auto& ga = geometries_[a];
+            const auto& gb = geometries_[b];
+            const auto& ra = mesh_ranks_[ga.mesh];
+            const auto& rb = mesh_ranks_[gb.mesh];
+            if (ra.nearest != rb.nearest) return ra.nearest < rb.nearest;
+            return ra.first != rb.first ? ra.first < rb.first : ga.lod < gb.lod;
+        });
+        rank_of_geometry_.resize(geometry_order_.size());
+        for (uint32_t rank = 0; rank < geometry_order_.size(); ++rank) {
+            rank_of_geometry_[geometry_order_[rank]] = rank;
+        }
+
+        for (std::size_t i = 0; i < count; ++i) {
+            auto pass = Draw_Pass::opaque;
+            if (materials) {
+                auto material = proxies.material_indices[rows_[i]];
+                if (material < materials->size() && (*materials)[material].base_color.w < 1.0f) {
+                    pass = Draw_Pass::transparent;
+                }
+            }
+            keys_[i] = Draw_Key::make(pass, 0, rank_of_geometry_[geometry_of_row_[i]], depths_[i]);
+        }
+
+        unsorted_stats_ = count_state_changes(proxies, lods, false);
+        sorter_.sort(keys_, rows_);
+        sorted_stats_ = count_state_changes(proxies, lods, true);
+
+        lods_.resize(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            lods_[i] = lods ? (*lods)[rows_[i]] : 0;
+        }
+    }
+
+    auto Draw_List::count_state_changes(const Render_Proxies& proxies, const std::vector<uint8_t>* lods,
+                                        bool batched) const -> Draw_List_Stats
+    {
+        Draw_List_Stats stats;
+        for (std::size_t i = 0; i < rows_.size(); ++i) {
+            bool new_state = i == 0 || Draw_Key::state(keys_[i]) != Draw_Key::state(keys_[i - 1]);
+            bool new_mesh = i == 0 || proxies.meshes[rows_[i]] != proxies.meshes[rows_[i - 1]];
+            bool new_lod = lods && i > 0 && (*lods)[rows_[i]] != (*lods)[rows_[i - 1]];
+            stats.pipeline_binds += new_state;
+            stats.mesh_binds += new_mesh;
+            stats.draws += !batched || new_state || new_mesh || new_lod;
+        }
+        return stats;
+    }
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "render_core/render_scene.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace mango::app
+{
+    enum class Draw_Pass : uint32_t
+    {
+        opaque = 0,
+        transparent = 1,
+    };
+
+    // 64-bit draw sort key, most significant bits first:
+    //   opaque:       pass (2) | pipeline (6) | mesh rank (24) | view depth (32)
+    //   transparent:  pass (2) | pipeline (6) | inverted view depth (32) | mesh rank (24)
+    // Pass and pipeline form the state bits; sorting by them first groups draws by
+    // pipeline. Opaque draws then group by mesh, meshes ranked by their nearest instance,
+    // and run front to back inside each mesh. Transparent draws run back to front and only
+    // share a mesh bind when consecutive. With LODs the rank covers (mesh, LOD) pairs, the
+    // LODs of one mesh kept next to each other.
+    struct Draw_Key
+    {
+        static constexpr uint32_t PASS_SHIFT = 62;
+        static constexpr uint32_t PIPELINE_SHIFT = 56;
+        static constexpr uint32_t STATE_SHIFT = PIPELINE_SHIFT;
+        static constexpr uint32_t MESH_BITS = 24;
+        static constexpr uint32_t MAX_PIPELINE = (1u << (PASS_SHIFT - PIPELINE_SHIFT)) - 1;
+        static constexpr uint32_t MAX_MESH_RANK = (1u << MESH_BITS) - 1;
+
+        static auto make(Draw_Pass pass, uint32_t pipeline, uint32_t mesh_rank, float depth) -> uint64_t;
+
+        static auto pass(uint64_t key) -> Draw_Pass { return static_cast<Draw_Pass>(key >> PASS_SHIFT); }
+        static auto pipeline(uint64_t key) -> uint32_t { return static_cast<uint32_t>(key >> PIPELINE_SHIFT) & MAX_PIPELINE; }
+        // Pass and pipeline; a change means a pipeline bind
+        static auto state(uint64_t key) -> uint32_t { return static_cast<uint32_t>(key >> STATE_SHIFT); }
+
+        // Order-preserving 32-bit code of a non-negative depth; negative depths clamp to 0
+        static auto depth_bits(float depth) -> uint32_t;
+    };
+
+    // Stable ascending LSD radix sort of 64-bit keys, 8 bits per pass, carrying a 32-bit
+    // value along. Fixed chunks of the input build their digit histograms and scatter on
+    // the worker pool, so equal keys keep their input order. Passes over a digit every key
+    // shares are skipped. Buffers keep their capacity between calls.
+    class Radix_Sorter
+    {
+    public:
+        static constexpr std::size_t CHUNK_SIZE = 16384;    // keys per parallel chunk
+
+        auto sort(std::vector<uint64_t>& keys, std::vector<uint32_t>& values) -> void;
+
+    private:
+        std::vector<uint64_t> scratch_keys_;
+        std::vector<uint32_t> scratch_values_;
+        std::vector<std::array<uint32_t, 256>> chunk_offsets_;
+    };
+
+    // State changes recorded by a pass: a pipeline bind whenever the state bits change
+    // and a vertex/index buffer bind whenever the mesh does. LODs of a mesh share its
+    // buffers, so a LOD change costs a draw but no bind.
+    struct Draw_List_Stats
+    {
+        uint32_t draws = 0;
+        uint32_t pipeline_binds = 0;
+        uint32_t mesh_binds = 0;
+    };
+
+    // Orders one view's visible rows for recording. build() keys every row, sorts the keys
+    // and reports the state changes of drawing the rows one by one in their incoming order
+    // next to those of the sorted order drawn in runs of one mesh (see Instance_Batcher::
+    // build_sorted). A row is transparent when its material's base color alpha is below 1;
+    // without materials every row is opaque, as in depth-only passes. Every row uses
+    // pipeline 0 of its pass. lods, indexed by proxy row (Lod_Selector::get_lods), picks
+    // each row's LOD; without it every row draws LOD 0.
+    class Draw_List
+    {
+    public:
+        auto build(const Render_Proxies& proxies, const std::vector<uint32_t>& rows, const math::Mat4& view,
+                   const std::vector<Render_Material>* materials, const std::vector<uint8_t>* lods = nullptr) -> void;
+
+        // Rows in draw order, their keys and their LODs
+        auto get_rows() const -> const std::vector<uint32_t>& { return rows_; }
+        auto get_keys() const -> const std::vector<uint64_t>& { return keys_; }
+        auto get_lods() const -> const std::vector<uint8_t>& { return lods_; }
+
+        auto get_unsorted_stats() const -> const Draw_List_Stats& { return unsorted_stats_; }
+        auto get_sorted_stats() const -> const Draw_List_Stats& { return sorted_stats_; }
+
+    private:
+        struct Mesh_Rank
+        {
+            float nearest = 0.0f;
+            uint32_t first = 0;         // order of first appearance, breaks depth ties
+        };
+
+        // One LOD of one mesh
+        struct Geometry
+        {
+            uint32_t mesh = 0;          // into mesh_ranks_
+            uint32_t lod = 0;
+        };
+
+        auto count_state_changes(const Render_Proxies& proxies, const std::vector<uint8_t>* lods, bool batched) const
+            -> Draw_List_Stats;
+
+        std::vector<uint32_t> rows_;
+        std::vector<uint64_t> keys_;
+        std::vector<uint8_t> lods_;
+        std::vector<float> depths_;
+        std::vector<uint32_t> geometry_of_row_;
+        std::unordered_map<const resource::Mesh_Data*, uint32_t> mesh_ids_;
+        std::unordered_map<uint64_t, uint32_t> geometry_ids_;
+        std::vector<Mesh_Rank> mesh_ranks_;
+        std::vector<Geometry> geometries_;
+        std::vector<uint32_t> geometry_order_;
+        std::vector<uint32_t> rank_of_geometry_;
+        Radix_Sorter sorter_;
+        Draw_List_Stats unsorted_stats_;
+        Draw_List_Stats sorted_stats_;
+    };
+}
@@ -1,11 +1,15 @@
 #pragma once
 
 #include <cstdint>
+#include <vector>
 #include "render_core/run_mode.hpp"
 #include "render_core/sensor_output.hpp"
 
 namespace mango::app
 {
+    struct Render_Scene;
+    struct Render_Range;
+
     struct Frame_Context
     {
         uint64_t frame_index = 0;
@@ -13,5 +17,10 @@ namespace mango::app
         uint32_t height = 0;
         Run_Mode mode = Run_Mode::runtime;
         Sensor_Output_Set outputs{};
+        float delta_time = 0.0f;
+        const Render_Scene* scene = nullptr;    // immutable snapshot the frame is recorded from
+        // Proxy rows extraction rewrote since the previous frame; frames are recorded in
+        // order, so state kept across frames (the render BVH) can be patched from these
+        const std::vector<Render_Range>* changed_proxies = nullptr;
     };
 }
@@ -0,0 +1,223 @@
+#include "render_core/frustum_culler.hpp"
+#include <cmath>
+#include <cstddef>
+
+#if defined(__AVX2__)
+#define MANGO_CULL_AVX2 1
+#include <immintrin.h>
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MANGO_CULL_SSE 1
+#include <emmintrin.h>
+#endif
+
+namespace mango::app
+{
+    namespace
+    {
+        // Broadcast-ready plane terms: normal, |normal| and distance
+        struct Plane_Terms
+        {
+            float nx, ny, nz, d;
+            float ax, ay, az;
+        };
+
+        auto make_terms(const Frustum& frustum) -> std::array<Plane_Terms, Frustum::PLANE_COUNT>
+        {
+            std::array<Plane_Terms, Frustum::PLANE_COUNT> terms{};
+            for (uint32_t p = 0; p < Frustum::PLANE_COUNT; ++p) {
+                const auto& plane = frustum.planes[p];
+                terms[p] = { plane.x, plane.y, plane.z, plane.w, std::abs(plane.x), std::abs(plane.y), std::abs(plane.z) };
+            }
+            return terms;
+        }
+
+        // Appends row if the caller's flag filter lets it through
+        inline auto emit(const Render_Proxies& proxies, uint32_t required_flags, uint32_t row, std::vector<uint32_t>& visible) -> void
+        {
+            if ((proxies.flags[row] & required_flags) == required_flags) {
+                visible.push_back(row);
+            }
+        }
+
+        // A box is outside a plane when its center lies further behind it than the box's
+        // projected radius along the normal
+        auto cull_rows_scalar(const Render_Proxies& proxies, const std::array<Plane_Terms, Frustum::PLANE_COUNT>& terms,
+                              uint32_t required_flags, std::size_t begin, std::size_t end, std::vector<uint32_t>& visible) -> void
+        {
+            const auto& b = proxies.bounds;
+            for (auto row = begin; row < end; ++row) {
+                bool inside = true;
+                for (const auto& t : terms) {
+                    // Same association as the SIMD batches so every path agrees on boxes touching a plane
+                    float distance = (t.nx * b.center_x[row] + t.ny * b.center_y[row]) + (t.nz * b.center_z[row] + t.d);
+                    float reach = t.ax * b.extent_x[row] + t.ay * b.extent_y[row] + t.az * b.extent_z[row];
+                    if (distance + reach < 0.0f) {
+                        inside = false;
+                        break;
+                    }
+                }
+                if (inside) {
+                    emit(proxies, required_flags, static_cast<uint32_t>(row), visible);
+                }
+            }
+        }
+
+#if defined(MANGO_CULL_SSE)
+        // Lane mask (bit i = box begin + i) of 4 boxes
+        inline auto cull_batch_sse(const Render_Bounds_Columns& b, const std::array<Plane_Terms, Frustum::PLANE_COUNT>& terms, std::size_t begin) -> uint32_t
+        {
+            const __m128 cx = _mm_loadu_ps(b.center_x.data() + begin);
+            const __m128 cy = _mm_loadu_ps(b.center_y.data() + begin);
+            const __m128 cz = _mm_loadu_ps(b.center_z.data() + begin);
+            const __m128 ex = _mm_loadu_ps(b.extent_x.data() + begin);
+            const __m128 ey = _mm_loadu_ps(b.extent_y.data() + begin);
+            const __m128 ez = _mm_loadu_ps(b.extent_z.data() + begin);
+            const __m128 zero = _mm_setzero_ps();
+
+            uint32_t mask = 0xF;
+            for (const auto& t : terms) {
+                __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(t.nx), cx), _mm_mul_ps(_mm_set1_ps(t.ny), cy)),
+                                             _mm_add_ps(_mm_mul_ps(_mm_set1_ps(t.nz), cz), _mm_set1_ps(t.d)));
+                __m128 reach = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(t.ax), ex), _mm_mul_ps(_mm_set1_ps(t.ay), ey)),
+                                          _mm_mul_ps(_mm_set1_ps(t.az), ez));
+                mask &= static_cast<uint32_t>(_mm_movemask_ps(_mm_cmpge_ps(_mm_add_ps(distance, reach), zero)));
+                if (mask == 0) {
+                    break;
+                }
+            }
+            return mask;
+        }
+#endif
+
+#if defined(MANGO_CULL_AVX2)
+        // Lane mask (bit i = box begin + i) of 8 boxes
+        inline auto cull_batch_avx2(const Render_Bounds_Columns& b, const std::array<Plane_Terms, Frustum::PLANE_COUNT>& terms, std::size_t begin) -> uint32_t
+        {
+            const __m256 cx = _mm256_loadu_ps(b.center_x.data() + begin);
+            const __m256 cy = _mm256_loadu_ps(b.center_y.data() + begin);
+            const __m256 cz = _mm256_loadu_ps(b.center_z.data() + begin);
+            const __m256 ex = _mm256_loadu_ps(b.extent_x.data() + begin);
+            const __m256 ey = _mm256_loadu_ps(b.extent_y.data() + begin);
+            const __m256 ez = _mm256_loadu_ps(b.extent_z.data() + begin);
+            const __m256 zero = _mm256_setzero_ps();
+
+            uint32_t mask = 0xFF;
+            for (const auto& t : terms) {
+                __m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(t.nx), cx), _mm256_mul_ps(_mm256_set1_ps(t.ny), cy)),
+                                                _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(t.nz), cz), _mm256_set1_ps(t.d)));
+                __m256 reach = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(t.ax), ex), _mm256_mul_ps(_mm256_set1_ps(t.ay), ey)),
+                                             _mm256_mul_ps(_mm256_set1_ps(t.az), ez));
+                mask &= static_cast<uint32_t>(_mm256_movemask_ps(_mm256_cmp_ps(_mm256_add_ps(distance, reach), zero, _CMP_GE_OQ)));
+                if (mask == 0) {
+                    break;
+                }
+            }
+            return mask;
+        }
+#endif
+
+        // Pushes the rows of a batch's lane mask in ascending order
+        inline auto emit_mask(const Render_Proxies& proxies, uint32_t required_flags, std::size_t begin, uint32_t mask,
+                              std::vector<uint32_t>& visible) -> void
+        {
+            for (uint32_t lane = 0; mask != 0; ++lane, mask >>= 1) {
+                if (mask & 1u) {
+                    emit(proxies, required_flags, static_cast<uint32_t>(begin + lane), visible);
+                }
+            }
+        }
+    }
+
+    auto Frustum::from_view_proj(const math::Mat4& view_proj) -> Frustum
+    {
+        // Rows of the matrix; GLM stores columns, so row i is m[c][i]
+        auto row = [&](int i) { return math::Vec4(view_proj[0][i], view_proj[1][i], view_proj[2][i], view_proj[3][i]); };
+        const auto r0 = row(0);
+        const auto r1 = row(1);
+        const auto r2 = row(2);
+        const auto r3 = row(3);
+
+        Frustum frustum;
+        frustum.planes = { r3 + r0, r3 - r0, r3 + r1, r3 - r1, r2, r3 - r2 };
+        for (auto& plane : frustum.planes) {
+            float length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+            if (length > 0.0f) {
+                plane *= 1.0f / length;
+            }
+        }
+        return frustum;
+    }
+
+    auto Frustum_Culler::cull(const Render_Proxies& proxies, Render_View& view) -> void
+    {
+        cull(proxies, view, get_best_path());
+    }
+
+    auto Frustum_Culler::cull(const Render_Proxies& proxies, Render_View& view, Cull_Path path) -> void
+    {
+        const auto terms = make_terms(view.frustum);
+        const auto count = proxies.size();
+        auto& visible = view.visible;
+        visible.clear();
+        visible.reserve(count);
+
+        std::size_t row = 0;
+        switch (is_available(path) ? path : Cull_Path::scalar) {
+#if defined(MANGO_CULL_AVX2)
+        case Cull_Path::avx2:
+            for (; row + 8 <= count; row += 8) {
+                emit_mask(proxies, view.required_flags, row, cull_batch_avx2(proxies.bounds, terms, row), visible);
+            }
+            break;
+#endif
+#if defined(MANGO_CULL_SSE)
+        case Cull_Path::sse:
+            for (; row + 8 <= count; row += 8) {
+                uint32_t mask = cull_batch_sse(proxies.bounds, terms, row) | (cull_batch_sse(proxies.bounds, terms, row + 4) << 4);
+                emit_mask(proxies, view.required_flags, row, mask, visible);
+            }
+            break;
+#endif
+        default:
+            break;
+        }
+        cull_rows_scalar(proxies, terms, view.required_flags, row, count, visible);
+
+        view.stats.tested = static_cast<uint32_t>(count);
+        view.stats.visible = static_cast<uint32_t>(visible.size());
+        view.stats.culled = view.stats.tested - view.stats.visible;
+    }
+
+    auto Frustum_Culler::is_available(Cull_Path path) -> bool
+    {
+        switch (path) {
+        case Cull_Path::scalar:
+            return true;
+        case Cull_Path::sse:
+#if defined(MANGO_CULL_SSE)
+            return true;
+#else
+            return false;
+#endif
+        case Cull_Path::avx2:
+#if defined(MANGO_CULL_AVX2)
+            return true;
+#else
+            return false;
+#endif
+        }
+        return false;
+    }
+
+    auto Frustum_Culler::get_best_path() -> Cull_Path
+    {
+        if (is_available(Cull_Path::avx2)) {
+            return Cull_Path::avx2;
+        }
+        if (is_available(Cull_Path::sse)) {
+            return Cull_Path::sse;
+        }
+        return Cull_Path::scalar;
+    }
+}
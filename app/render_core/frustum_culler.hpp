@@ -0,0 +1,62 @@
+#pragma once
+
+#include "render_core/render_scene.hpp"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace mango::app
+{
+    // Six inward-facing planes, xyz = unit normal, w = distance; a point p is inside when
+    // dot(xyz, p) + w >= 0 for every plane. A default Frustum (all planes zero) accepts
+    // everything. Order: left, right, bottom, top, near, far.
+    struct Frustum
+    {
+        static constexpr uint32_t PLANE_COUNT = 6;
+
+        std::array<math::Vec4, PLANE_COUNT> planes{};
+
+        // Extracts the planes of a view-projection matrix with a [0, 1] depth range
+        static auto from_view_proj(const math::Mat4& view_proj) -> Frustum;
+    };
+
+    enum class Cull_Path
+    {
+        scalar,
+        sse,        // two batches of 4 boxes per iteration
+        avx2,       // one batch of 8 boxes per iteration
+    };
+
+    struct Cull_Stats
+    {
+        uint32_t tested = 0;
+        uint32_t visible = 0;
+        uint32_t culled = 0;
+    };
+
+    // One view's culling input and result. visible lists proxy rows in ascending order
+    // and keeps its capacity between frames.
+    struct Render_View
+    {
+        Frustum frustum;
+        uint32_t required_flags = 0;        // rows lacking any of these flags are skipped
+        std::vector<uint32_t> visible;
+        Cull_Stats stats;
+    };
+
+    // Tests the AABBs in Render_Proxies::bounds against a view's frustum, 8 boxes per
+    // iteration straight from the bounds columns. The AVX2 path is compiled in when the
+    // build targets AVX2 (MANGO_ENABLE_AVX2); SSE is the baseline on x86-64 and the scalar
+    // loop handles the tail and other targets. Every path produces the same list.
+    class Frustum_Culler
+    {
+    public:
+        // Uses the widest path compiled in
+        static auto cull(const Render_Proxies& proxies, Render_View& view) -> void;
+        // Falls back to scalar when path is not compiled in
+        static auto cull(const Render_Proxies& proxies, Render_View& view, Cull_Path path) -> void;
+
+        static auto is_available(Cull_Path path) -> bool;
+        static auto get_best_path() -> Cull_Path;
+    };
+}
@@ -0,0 +1,70 @@
+#include "render_core/instance_batcher.hpp"
+
+namespace mango::app
+{
+    auto Render_Instance::from_proxy(const Render_Proxies& proxies, std::size_t row) -> Render_Instance
+    {
+        auto bound = proxies.bounds[row];
+        Render_Instance instance;
+        instance.model = proxies.world_matrices[row];
+        instance.center_radius = math::Vec4(bound.center, bound.radius);
+        instance.extents = math::Vec4(bound.extents, 0.0f);
+        instance.material = proxies.material_indices[row];
+        instance.flags = proxies.flags[row];
+        return instance;
+    }
+
+    auto Instance_Batcher::build(const Render_Proxies& proxies, const std::vector<uint32_t>& rows) -> void
+    {
+        batches_.clear();
+        batch_of_mesh_.clear();
+        batch_of_row_.resize(rows.size());
+
+        // Count instances per mesh, then lay the batches out back to back
+        for (std::size_t i = 0; i < rows.size(); ++i) {
+            const auto* mesh = proxies.meshes[rows[i]];
+            auto [it, inserted] = batch_of_mesh_.try_emplace(mesh, static_cast<uint32_t>(batches_.size()));
+            if (inserted) {
+                batches_.push_back({ mesh, 0, 0 });
+            }
+            batch_of_row_[i] = it->second;
+            ++batches_[it->second].instance_count;
+        }
+
+        uint32_t first = 0;
+        for (auto& batch : batches_) {
+            batch.first_instance = first;
+            first += batch.instance_count;
+            batch.instance_count = 0;
+        }
+
+        instances_.resize(rows.size());
+        rows_.resize(rows.size());
+        for (std::size_t i = 0; i < rows.size(); ++i) {
+            auto& batch = batches_[batch_of_row_[i]];
+            auto slot = batch.first_instance + batch.instance_count++;
+            instances_[slot] = Render_Instance::from_proxy(proxies, rows[i]);
+            rows_[slot] = rows[i];
+        }
+    }
+
+    auto Instance_Batcher::build_sorted(const Render_Proxies& proxies, const Draw_List& draws) -> void
+    {
+        const auto& rows = draws.get_rows();
+        const auto& keys = draws.get_keys();
+        const auto& lods = draws.get_lods();
+        batches_.clear();
+        instances_.resize(rows.size());
+        rows_.assign(rows.begin(), rows.end());
+
+        for (std::size_t i = 0; i < rows.size(); ++i) {
+            const auto* mesh = proxies.meshes[rows[i]];
+            if (batches_.empty() || batches_.back().mesh != mesh || batches_.back().lod != lods[i] ||
+                Draw_Key::state(batches_.back().key) != Draw_Key::state(keys[i])) {
+                batches_.push_back({ mesh, static_cast<uint32_t>(i), 0, keys[i], lods[i] });
+            }
+            ++batches_.back().instance_count;
+            instances_[i] = Render_Instance::from_proxy(proxies, rows[i]);
+        }
+    }
+}
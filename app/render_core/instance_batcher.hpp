@@ -0,0 +1,64 @@
+#pragma once
+
+#include "render_core/render_scene.hpp"
+#include "render_core/draw_list.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace mango::app
+{
+    // One entry of the instance storage buffer read by pbr.vert and shadow.vert through
+    // gl_InstanceIndex (std430). The bounds and mesh fields are for gpu_cull.comp; CPU
+    // batches leave mesh at 0.
+    struct Render_Instance
+    {
+        math::Mat4 model{1.0f};
+        math::Vec4 center_radius{0.0f, 0.0f, 0.0f, 0.0f};
+        math::Vec4 extents{0.0f, 0.0f, 0.0f, 0.0f};
+        uint32_t mesh = 0;
+        uint32_t material = 0;
+        uint32_t flags = 0;
+        uint32_t padding = 0;
+
+        static auto from_proxy(const Render_Proxies& proxies, std::size_t row) -> Render_Instance;
+    };
+    static_assert(sizeof(Render_Instance) == 112, "Render_Instance must match the shader Instance layout");
+
+    // Draws of one mesh; its instances are [first_instance, first_instance + instance_count)
+    // of the batcher's instance list, so one draw with that firstInstance covers them
+    struct Instance_Batch
+    {
+        const resource::Mesh_Data* mesh = nullptr;
+        uint32_t first_instance = 0;
+        uint32_t instance_count = 0;
+        uint64_t key = 0;                   // draw key of the first instance (build_sorted)
+        uint32_t lod = 0;                   // index into mesh->lods (build_sorted)
+    };
+
+    // Turns a view's visible rows into one instanced draw per mesh. Each pass binds a
+    // single pipeline, so the mesh is the whole batch key within a pass. Batches come out
+    // in order of each mesh's first visible row, and instances keep the row order inside
+    // a batch. build_sorted() instead follows a Draw_List's order, batching runs of rows
+    // that share the key's state bits, the mesh and the LOD. Containers keep their capacity between
+    // frames.
+    class Instance_Batcher
+    {
+    public:
+        auto build(const Render_Proxies& proxies, const std::vector<uint32_t>& rows) -> void;
+        auto build_sorted(const Render_Proxies& proxies, const Draw_List& draws) -> void;
+
+        auto get_batches() const -> const std::vector<Instance_Batch>& { return batches_; }
+        auto get_instances() const -> const std::vector<Render_Instance>& { return instances_; }
+        // Proxy row of each instance
+        auto get_rows() const -> const std::vector<uint32_t>& { return rows_; }
+
+    private:
+        std::vector<Instance_Batch> batches_;
+        std::vector<Render_Instance> instances_;
+        std::vector<uint32_t> rows_;
+        std::vector<uint32_t> batch_of_row_;
+        std::unordered_map<const resource::Mesh_Data*, uint32_t> batch_of_mesh_;
+    };
+}
@@ -0,0 +1,65 @@
+#include "render_core/lod_selector.hpp"
+#include "resource/mesh.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace mango::app
+{
+    Lod_Selector::Lod_Selector(const Lod_Settings& settings)
+        : settings_(settings)
+    {
+    }
+
+    auto Lod_Selector::select(const Render_Proxies& proxies, const std::vector<uint32_t>& rows, const math::Mat4& view,
+                              float pixels_per_unit) -> void
+    {
+        stats_ = {};
+        if (lods_.size() != proxies.size()) {
+            lods_.resize(proxies.size(), 0);
+            entities_.resize(proxies.size(), ~0ull);
+        }
+
+        const auto& bounds = proxies.bounds;
+        const float limit = settings_.max_pixel_error;
+        const float coarsen_limit = limit * (1.0f - settings_.hysteresis);
+        for (auto row : rows) {
+            const auto* mesh = proxies.meshes[row];
+            if (!mesh) continue;
+
+            uint32_t lod = 0;
+            auto count = mesh->get_lod_count();
+            auto depth = -(view[0][2] * bounds.center_x[row] + view[1][2] * bounds.center_y[row] +
+                           view[2][2] * bounds.center_z[row] + view[3][2]);
+            auto distance = depth - bounds.radius[row];
+            if (count > 1 && distance > 0.0f) {
+                // Object-space error grows with the largest axis scale of the world matrix
+                const auto& world = proxies.world_matrices[row];
+                auto scale = std::max({ glm::length(math::Vec3(world[0])), glm::length(math::Vec3(world[1])),
+                                        glm::length(math::Vec3(world[2])) });
+                auto pixels_per_error = scale * pixels_per_unit / distance;
+                auto coarsest_within = [&](uint32_t from, float pixels) {
+                    // Errors never shrink along the chain
+                    while (from + 1 < count && mesh->lods[from + 1].error * pixels_per_error <= pixels) {
+                        ++from;
+                    }
+                    return from;
+                };
+
+                lod = coarsest_within(0, limit);
+                if (entities_[row] == proxies.entity_ids[row]) {
+                    auto previous = std::min<uint32_t>(lods_[row], count - 1);
+                    if (lod > previous) {
+                        lod = coarsest_within(previous, coarsen_limit);
+                    }
+                }
+            }
+            lods_[row] = static_cast<uint8_t>(std::min<uint32_t>(lod, 255));
+            entities_[row] = proxies.entity_ids[row];
+
+            auto full = static_cast<uint32_t>(mesh->indices.empty() ? mesh->vertices.size() : mesh->indices.size()) / 3;
+            stats_.full_triangles += full;
+            stats_.triangles += count > 1 ? mesh->get_lod(lod).index_count / 3 : full;
+            stats_.reduced += lod > 0;
+        }
+    }
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "render_core/render_scene.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace mango::app
+{
+    struct Lod_Settings
+    {
+        float max_pixel_error = 1.0f;       // projected simplification error allowed, in pixels
+        float hysteresis = 0.25f;           // a coarser LOD must stay this share below the limit
+    };
+
+    struct Lod_Stats
+    {
+        uint32_t triangles = 0;             // drawn with the selected LODs
+        uint32_t full_triangles = 0;        // the same rows at full detail
+        uint32_t reduced = 0;               // rows drawn below full detail
+    };
+
+    // Picks one LOD of Mesh_Data::lods per visible row of a view: the coarsest whose error,
+    // scaled by the row's world matrix and projected at the near side of its bounding
+    // sphere, stays within max_pixel_error. The choice is kept per row across frames and
+    // only coarsens once the coarser LOD is below the limit by the hysteresis margin, so a
+    // proxy sitting at a switch distance does not alternate; refining happens at once.
+    // One selector per view, since every view has its own distances and resolution.
+    class Lod_Selector
+    {
+    public:
+        explicit Lod_Selector(const Lod_Settings& settings = {});
+
+        // pixels_per_unit: pixels covered by one world unit at view depth 1, e.g.
+        // |proj[1][1]| * viewport_height / 2 for a perspective projection
+        auto select(const Render_Proxies& proxies, const std::vector<uint32_t>& rows, const math::Mat4& view,
+                    float pixels_per_unit) -> void;
+
+        // LOD of every proxy row; rows outside the last select() keep their older choice
+        auto get_lods() const -> const std::vector<uint8_t>& { return lods_; }
+        auto get_stats() const -> const Lod_Stats& { return stats_; }
+        auto get_settings() const -> const Lod_Settings& { return settings_; }
+        auto set_settings(const Lod_Settings& settings) -> void { settings_ = settings; }
+
+    private:
+        Lod_Settings settings_;
+        Lod_Stats stats_;
+        std::vector<uint8_t> lods_;
+        std::vector<uint64_t> entities_;    // owner of each row's choice; a new owner has no history
+    };
+}
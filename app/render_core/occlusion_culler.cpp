@@ -0,0 +1,549 @@
+#include "render_core/occlusion_culler.hpp"
+#include "resource/mesh.hpp"
+#include "thread/worker-pool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+#if defined(__AVX2__)
+#define MANGO_OCCLUSION_AVX2 1
+#include <immintrin.h>
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MANGO_OCCLUSION_SSE 1
+#include <emmintrin.h>
+#endif
+
+namespace mango::app
+{
+    namespace
+    {
+        using Clock = std::chrono::steady_clock;
+
+        constexpr uint32_t TRANSFORM_GRAIN = 1;         // occluders per parallel_for chunk
+        constexpr uint32_t RASTER_BAND_TILES = 2;       // tile rows per rasterization chunk
+        constexpr std::size_t TEST_GRAIN = 256;         // occludees per parallel_for chunk
+        constexpr float GUARD_BAND = 2.0f;              // triangles are clipped to this multiple of the NDC square
+        constexpr uint32_t MAX_CLIPPED = 9;             // a triangle clipped by 5 planes has at most 8 corners
+
+        auto ms_since(Clock::time_point begin) -> float
+        {
+            return std::chrono::duration<float, std::milli>(Clock::now() - begin).count();
+        }
+
+        auto transform_point(const math::Mat4& m, const math::Vec3& p) -> math::Vec4
+        {
+            return m[0] * p.x + m[1] * p.y + (m[2] * p.z + m[3]);
+        }
+
+        // Signed distance of a clip-space point to the planes that keep it in front of the
+        // near plane and inside the guard band
+        auto clip_distance(const math::Vec4& p, uint32_t plane) -> float
+        {
+            switch (plane) {
+            case 0: return p.z;
+            case 1: return GUARD_BAND * p.w - p.x;
+            case 2: return GUARD_BAND * p.w + p.x;
+            case 3: return GUARD_BAND * p.w - p.y;
+            default: return GUARD_BAND * p.w + p.y;
+            }
+        }
+
+        // Edge function coefficients of one triangle edge and its depth plane, relative to
+        // the triangle's first vertex
+        struct Triangle_Setup
+        {
+            float ex[3], ey[3];     // edge i through (ox[i], oy[i]): ex * (x - ox) + ey * (y - oy) >= 0 inside
+            float ox[3], oy[3];
+            float x0, y0, z0;
+            float dzdx, dzdy;
+            float z_min;
+        };
+
+        // Returns false for degenerate triangles. Winding is normalized so both faces draw.
+        auto setup_triangle(const float* x, const float* y, const float* z, Triangle_Setup& s) -> bool
+        {
+            float area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+            if (!(std::abs(area) > 1e-8f)) {
+                return false;
+            }
+            uint32_t order[3] = { 0, 1, 2 };
+            if (area < 0.0f) {
+                std::swap(order[1], order[2]);
+                area = -area;
+            }
+            for (uint32_t i = 0; i < 3; ++i) {
+                auto a = order[i];
+                auto b = order[(i + 1) % 3];
+                s.ex[i] = -(y[b] - y[a]);
+                s.ey[i] = x[b] - x[a];
+                s.ox[i] = x[a];
+                s.oy[i] = y[a];
+            }
+            float inv_area = 1.0f / area;
+            float sign = order[1] == 1 ? 1.0f : -1.0f;     // gradients use the original winding's area
+            s.x0 = x[0];
+            s.y0 = y[0];
+            s.z0 = z[0];
+            s.dzdx = sign * ((z[1] - z[0]) * (y[2] - y[0]) - (z[2] - z[0]) * (y[1] - y[0])) * inv_area;
+            s.dzdy = sign * ((z[2] - z[0]) * (x[1] - x[0]) - (z[1] - z[0]) * (x[2] - x[0])) * inv_area;
+            s.z_min = std::min({ z[0], z[1], z[2] });
+            return true;
+        }
+
+        // Writes the triangle's depth into one 8 pixel row of a tile where the pixel centers
+        // at (px + lane, py) are covered. All paths evaluate the same expressions in the same order.
+        auto raster_row_scalar(const Triangle_Setup& s, float px, float py, float* row) -> void
+        {
+            for (uint32_t lane = 0; lane < Occlusion_Culler::TILE_WIDTH; ++lane) {
+                float x = px + static_cast<float>(lane);
+                bool inside = true;
+                for (uint32_t e = 0; e < 3; ++e) {
+                    inside &= s.ex[e] * (x - s.ox[e]) + s.ey[e] * (py - s.oy[e]) >= 0.0f;
+                }
+                if (inside) {
+                    float z = std::max(s.z0 + s.dzdx * (x - s.x0) + s.dzdy * (py - s.y0), s.z_min);
+                    row[lane] = std::min(row[lane], z);
+                }
+            }
+        }
+
+#if defined(MANGO_OCCLUSION_SSE)
+        auto raster_half_sse(const Triangle_Setup& s, __m128 x, float py, float* row) -> void
+        {
+            __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            for (uint32_t e = 0; e < 3; ++e) {
+                __m128 edge = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(s.ex[e]), _mm_sub_ps(x, _mm_set1_ps(s.ox[e]))),
+                                         _mm_set1_ps(s.ey[e] * (py - s.oy[e])));
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(edge, _mm_setzero_ps()));
+            }
+            if (_mm_movemask_ps(inside) == 0) {
+                return;
+            }
+            __m128 z = _mm_add_ps(_mm_add_ps(_mm_set1_ps(s.z0), _mm_mul_ps(_mm_set1_ps(s.dzdx), _mm_sub_ps(x, _mm_set1_ps(s.x0)))),
+                                  _mm_set1_ps(s.dzdy * (py - s.y0)));
+            z = _mm_max_ps(z, _mm_set1_ps(s.z_min));
+            __m128 depth = _mm_loadu_ps(row);
+            __m128 nearer = _mm_min_ps(depth, z);
+            _mm_storeu_ps(row, _mm_or_ps(_mm_and_ps(inside, nearer), _mm_andnot_ps(inside, depth)));
+        }
+
+        auto raster_row_sse(const Triangle_Setup& s, float px, float py, float* row) -> void
+        {
+            const __m128 lanes = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+            raster_half_sse(s, _mm_add_ps(_mm_set1_ps(px), lanes), py, row);
+            raster_half_sse(s, _mm_add_ps(_mm_set1_ps(px + 4.0f), lanes), py, row + 4);
+        }
+#endif
+
+#if defined(MANGO_OCCLUSION_AVX2)
+        auto raster_row_avx2(const Triangle_Setup& s, float px, float py, float* row) -> void
+        {
+            const __m256 x = _mm256_add_ps(_mm256_set1_ps(px), _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f));
+            __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+            for (uint32_t e = 0; e < 3; ++e) {
+                __m256 edge = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(s.ex[e]), _mm256_sub_ps(x, _mm256_set1_ps(s.ox[e]))),
+                                            _mm256_set1_ps(s.ey[e] * (py - s.oy[e])));
+                inside = _mm256_and_ps(inside, _mm256_cmp_ps(edge, _mm256_setzero_ps(), _CMP_GE_OQ));
+            }
+            if (_mm256_movemask_ps(inside) == 0) {
+                return;
+            }
+            __m256 z = _mm256_add_ps(_mm256_add_ps(_mm256_set1_ps(s.z0), _mm256_mul_ps(_mm256_set1_ps(s.dzdx), _mm256_sub_ps(x, _mm256_set1_ps(s.x0)))),
+                                     _mm256_set1_ps(s.dzdy * (py - s.y0)));
+            z = _mm256_max_ps(z, _mm256_set1_ps(s.z_min));
+            __m256 depth = _mm256_loadu_ps(row);
+            _mm256_storeu_ps(row, _mm256_blendv_ps(depth, _mm256_min_ps(depth, z), inside));
+        }
+#endif
+
+        // True when any of the row's pixels in lanes [first, last] is at or behind depth
+        auto row_reaches_scalar(const float* row, uint32_t first, uint32_t last, float depth) -> bool
+        {
+            for (auto lane = first; lane <= last; ++lane) {
+                if (row[lane] >= depth) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+#if defined(MANGO_OCCLUSION_SSE)
+        auto row_reaches_sse(const float* row, uint32_t first, uint32_t last, float depth) -> bool
+        {
+            const __m128 reference = _mm_set1_ps(depth);
+            uint32_t hits = static_cast<uint32_t>(_mm_movemask_ps(_mm_cmpge_ps(_mm_loadu_ps(row), reference)))
+                          | static_cast<uint32_t>(_mm_movemask_ps(_mm_cmpge_ps(_mm_loadu_ps(row + 4), reference))) << 4;
+            uint32_t lanes = ((2u << last) - 1u) & ~((1u << first) - 1u);
+            return (hits & lanes) != 0;
+        }
+#endif
+
+#if defined(MANGO_OCCLUSION_AVX2)
+        auto row_reaches_avx2(const float* row, uint32_t first, uint32_t last, float depth) -> bool
+        {
+            uint32_t hits = static_cast<uint32_t>(_mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(row), _mm256_set1_ps(depth), _CMP_GE_OQ)));
+            uint32_t lanes = ((2u << last) - 1u) & ~((1u << first) - 1u);
+            return (hits & lanes) != 0;
+        }
+#endif
+    }
+
+    Occlusion_Culler::Occlusion_Culler(const Occlusion_Settings& settings)
+        : settings_(settings)
+    {
+        if (!Frustum_Culler::is_available(settings_.path)) {
+            settings_.path = Cull_Path::scalar;
+        }
+        tiles_x_ = std::max<uint32_t>(1, (settings_.width + TILE_WIDTH - 1) / TILE_WIDTH);
+        tiles_y_ = std::max<uint32_t>(1, (settings_.height + TILE_HEIGHT - 1) / TILE_HEIGHT);
+        depth_.assign(static_cast<std::size_t>(tiles_x_) * tiles_y_ * TILE_PIXELS, 1.0f);
+        tile_max_.assign(static_cast<std::size_t>(tiles_x_) * tiles_y_, 1.0f);
+    }
+
+    auto Occlusion_Culler::cull(const Render_Proxies& proxies, const math::Mat4& view_proj, Render_View& view,
+                                const std::vector<Render_Material>* materials) -> void
+    {
+        auto* pool = core::Worker_Pool::current_instance();
+        stats_ = {};
+        visibility_.assign(proxies.size(), 0);
+
+        // Occluders: the largest projected opaque bounding spheres, until either budget runs out
+        auto begin = Clock::now();
+        clear();
+        const float scale_x = std::sqrt(view_proj[0][0] * view_proj[0][0] + view_proj[1][0] * view_proj[1][0] + view_proj[2][0] * view_proj[2][0]);
+        const float scale_y = std::sqrt(view_proj[0][1] * view_proj[0][1] + view_proj[1][1] * view_proj[1][1] + view_proj[2][1] * view_proj[2][1]);
+        occluders_.clear();
+        for (auto row : view.visible) {
+            const auto* mesh = proxies.meshes[row];
+            if (!mesh || mesh->indices.size() < 3) {
+                continue;
+            }
+            if (materials) {
+                auto material = proxies.material_indices[row];
+                if (material < materials->size() && (*materials)[material].base_color.w < 1.0f) {
+                    continue;
+                }
+            }
+            auto bound = proxies.bounds[row];
+            float w = transform_point(view_proj, bound.center).w;
+            // Spheres around the eye cover the whole view
+            float area = 1.0f;
+            if (w > bound.radius) {
+                // Ellipse area over the 2x2 NDC square
+                area = std::min(1.0f, 0.25f * 3.14159265f * (bound.radius * scale_x / w) * (bound.radius * scale_y / w));
+            }
+            if (area >= settings_.min_occluder_area) {
+                occluders_.push_back({ row, area });
+            }
+        }
+        std::sort(occluders_.begin(), occluders_.end(), [](const Occluder& a, const Occluder& b) {
+            return a.area > b.area || (a.area == b.area && a.row < b.row);
+        });
+        std::size_t triangle_count = 0;
+        std::size_t taken = 0;
+        for (const auto& occluder : occluders_) {
+            if (taken == settings_.occluder_budget) {
+                break;
+            }
+            auto triangles = proxies.meshes[occluder.row]->indices.size() / 3;
+            if (triangle_count + triangles > settings_.triangle_budget) {
+                continue;
+            }
+            triangle_count += triangles;
+            occluders_[taken++] = occluder;
+        }
+        occluders_.resize(taken);
+        stats_.occluders = static_cast<uint32_t>(taken);
+        stats_.occluder_triangles = static_cast<uint32_t>(triangle_count);
+
+        if (occluders_.empty()) {
+            for (auto row : view.visible) {
+                visibility_[row] = 1;
+            }
+            stats_.tested = static_cast<uint32_t>(view.visible.size());
+            stats_.occluder_ms = ms_since(begin);
+            return;
+        }
+
+        occluder_triangles_.resize(std::max(occluder_triangles_.size(), occluders_.size()));
+        clip_scratch_.resize(pool->get_thread_count());
+        pool->parallel_for(occluders_.size(), TRANSFORM_GRAIN, [&](std::size_t first, std::size_t last, std::uint32_t thread_index) {
+            for (auto i = first; i < last; ++i) {
+                auto row = occluders_[i].row;
+                occluder_triangles_[i].clear();
+                transform(*proxies.meshes[row], view_proj * proxies.world_matrices[row], clip_scratch_[thread_index], occluder_triangles_[i]);
+            }
+        });
+        triangles_.clear();
+        for (std::size_t i = 0; i < occluders_.size(); ++i) {
+            triangles_.insert(triangles_.end(), occluder_triangles_[i].begin(), occluder_triangles_[i].end());
+        }
+        pool->parallel_for(tiles_y_, RASTER_BAND_TILES, [&](std::size_t first, std::size_t last, std::uint32_t) {
+            rasterize_tile_rows(triangles_.data(), triangles_.size(), static_cast<uint32_t>(first), static_cast<uint32_t>(last));
+        });
+        stats_.occluder_ms = ms_since(begin);
+
+        // Occludees: every row that passed the frustum, occluders included
+        begin = Clock::now();
+        survived_.resize(view.visible.size());
+        pool->parallel_for(view.visible.size(), TEST_GRAIN, [&](std::size_t first, std::size_t last, std::uint32_t) {
+            for (auto i = first; i < last; ++i) {
+                survived_[i] = is_box_visible(proxies.bounds[view.visible[i]], view_proj) ? 1 : 0;
+            }
+        });
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < view.visible.size(); ++i) {
+            if (survived_[i]) {
+                auto row = view.visible[i];
+                visibility_[row] = 1;
+                view.visible[kept++] = row;
+            }
+        }
+        stats_.tested = static_cast<uint32_t>(view.visible.size());
+        stats_.occluded = static_cast<uint32_t>(view.visible.size() - kept);
+        view.visible.resize(kept);
+        view.stats.visible = static_cast<uint32_t>(kept);
+        view.stats.culled += stats_.occluded;
+        stats_.occludee_ms = ms_since(begin);
+    }
+
+    auto Occlusion_Culler::clear() -> void
+    {
+        std::fill(depth_.begin(), depth_.end(), 1.0f);
+        std::fill(tile_max_.begin(), tile_max_.end(), 1.0f);
+    }
+
+    auto Occlusion_Culler::rasterize(const resource::Mesh_Data& mesh, const math::Mat4& world_view_proj) -> void
+    {
+        clip_scratch_.resize(std::max<std::size_t>(clip_scratch_.size(), 1));
+        triangles_.clear();
+        transform(mesh, world_view_proj, clip_scratch_[0], triangles_);
+        rasterize_tile_rows(triangles_.data(), triangles_.size(), 0, tiles_y_);
+    }
+
+    auto Occlusion_Culler::transform(const resource::Mesh_Data& mesh, const math::Mat4& world_view_proj,
+                                     std::vector<math::Vec4>& clip, std::vector<Screen_Triangle>& out) const -> void
+    {
+        clip.resize(mesh.vertices.size());
+        for (std::size_t i = 0; i < mesh.vertices.size(); ++i) {
+            clip[i] = transform_point(world_view_proj, mesh.vertices[i].position);
+        }
+
+        const float half_width = 0.5f * static_cast<float>(get_width());
+        const float half_height = 0.5f * static_cast<float>(get_height());
+        auto emit = [&](const math::Vec4& a, const math::Vec4& b, const math::Vec4& c) {
+            Screen_Triangle triangle;
+            const math::Vec4* corners[3] = { &a, &b, &c };
+            for (uint32_t k = 0; k < 3; ++k) {
+                float inv_w = 1.0f / corners[k]->w;
+                triangle.x[k] = (corners[k]->x * inv_w + 1.0f) * half_width;
+                triangle.y[k] = (corners[k]->y * inv_w + 1.0f) * half_height;
+                triangle.z[k] = corners[k]->z * inv_w;
+            }
+            out.push_back(triangle);
+        };
+
+        const auto vertex_count = clip.size();
+        for (std::size_t i = 0; i + 2 < mesh.indices.size(); i += 3) {
+            auto i0 = mesh.indices[i];
+            auto i1 = mesh.indices[i + 1];
+            auto i2 = mesh.indices[i + 2];
+            if (i0 >= vertex_count || i1 >= vertex_count || i2 >= vertex_count) {
+                continue;
+            }
+            const math::Vec4 corners[3] = { clip[i0], clip[i1], clip[i2] };
+
+            uint32_t outside_all = 0x1F;
+            uint32_t outside_any = 0;
+            for (const auto& corner : corners) {
+                uint32_t outside = 0;
+                for (uint32_t plane = 0; plane < 5; ++plane) {
+                    outside |= (clip_distance(corner, plane) < 0.0f ? 1u : 0u) << plane;
+                }
+                outside_all &= outside;
+                outside_any |= outside;
+            }
+            if (outside_all != 0) {
+                continue;
+            }
+            if (outside_any == 0) {
+                emit(corners[0], corners[1], corners[2]);
+                continue;
+            }
+
+            // Sutherland-Hodgman against the planes the triangle crosses, then a fan
+            math::Vec4 polygon[MAX_CLIPPED];
+            math::Vec4 scratch[MAX_CLIPPED];
+            uint32_t count = 3;
+            std::copy(std::begin(corners), std::end(corners), polygon);
+            for (uint32_t plane = 0; plane < 5 && count >= 3; ++plane) {
+                if (!(outside_any & (1u << plane))) {
+                    continue;
+                }
+                uint32_t clipped = 0;
+                for (uint32_t k = 0; k < count; ++k) {
+                    const auto& current = polygon[k];
+                    const auto& next = polygon[(k + 1) % count];
+                    float d0 = clip_distance(current, plane);
+                    float d1 = clip_distance(next, plane);
+                    if (d0 >= 0.0f) {
+                        scratch[clipped++] = current;
+                    }
+                    if ((d0 >= 0.0f) != (d1 >= 0.0f)) {
+                        scratch[clipped++] = current + (next - current) * (d0 / (d0 - d1));
+                    }
+                }
+                std::copy(scratch, scratch + clipped, polygon);
+                count = clipped;
+            }
+            for (uint32_t k = 1; k + 1 < count; ++k) {
+                emit(polygon[0], polygon[k], polygon[k + 1]);
+            }
+        }
+    }
+
+    auto Occlusion_Culler::rasterize_tile_rows(const Screen_Triangle* triangles, std::size_t count, uint32_t tile_row_begin,
+                                               uint32_t tile_row_end) -> void
+    {
+        auto raster_row = raster_row_scalar;
+#if defined(MANGO_OCCLUSION_SSE)
+        if (settings_.path == Cull_Path::sse) {
+            raster_row = raster_row_sse;
+        }
+#endif
+#if defined(MANGO_OCCLUSION_AVX2)
+        if (settings_.path == Cull_Path::avx2) {
+            raster_row = raster_row_avx2;
+        }
+#endif
+
+        const float band_top = static_cast<float>(tile_row_begin * TILE_HEIGHT);
+        const float band_bottom = static_cast<float>(tile_row_end * TILE_HEIGHT);
+        const float right = static_cast<float>(get_width());
+        Triangle_Setup setup;
+        for (std::size_t t = 0; t < count; ++t) {
+            const auto& triangle = triangles[t];
+            // Pixel centers inside the bounding box, clamped to the band
+            float min_x = std::min({ triangle.x[0], triangle.x[1], triangle.x[2] });
+            float max_x = std::max({ triangle.x[0], triangle.x[1], triangle.x[2] });
+            float min_y = std::min({ triangle.y[0], triangle.y[1], triangle.y[2] });
+            float max_y = std::max({ triangle.y[0], triangle.y[1], triangle.y[2] });
+            if (max_x < 0.5f || min_x > right - 0.5f || max_y < band_top + 0.5f || min_y > band_bottom - 0.5f) {
+                continue;
+            }
+            if (!setup_triangle(triangle.x, triangle.y, triangle.z, setup)) {
+                continue;
+            }
+            auto first_x = static_cast<uint32_t>(std::max(0.0f, std::floor(min_x - 0.5f)));
+            auto last_x = static_cast<uint32_t>(std::min(right - 1.0f, std::ceil(max_x - 0.5f)));
+            auto first_y = static_cast<uint32_t>(std::max(band_top, std::floor(min_y - 0.5f)));
+            auto last_y = static_cast<uint32_t>(std::min(band_bottom - 1.0f, std::ceil(max_y - 0.5f)));
+
+            for (auto y = first_y; y <= last_y; ++y) {
+                float py = static_cast<float>(y) + 0.5f;
+                auto ty = y / TILE_HEIGHT;
+                for (auto tx = first_x / TILE_WIDTH; tx <= last_x / TILE_WIDTH; ++tx) {
+                    float* row = depth_.data() + (static_cast<std::size_t>(ty) * tiles_x_ + tx) * TILE_PIXELS + (y % TILE_HEIGHT) * TILE_WIDTH;
+                    raster_row(setup, static_cast<float>(tx * TILE_WIDTH) + 0.5f, py, row);
+                }
+            }
+        }
+        update_tile_max(tile_row_begin, tile_row_end);
+    }
+
+    auto Occlusion_Culler::update_tile_max(uint32_t tile_row_begin, uint32_t tile_row_end) -> void
+    {
+        for (auto tile = static_cast<std::size_t>(tile_row_begin) * tiles_x_; tile < static_cast<std::size_t>(tile_row_end) * tiles_x_; ++tile) {
+            const float* pixels = depth_.data() + tile * TILE_PIXELS;
+            tile_max_[tile] = *std::max_element(pixels, pixels + TILE_PIXELS);
+        }
+    }
+
+    auto Occlusion_Culler::is_box_visible(const Render_Bounds& bounds, const math::Mat4& view_proj) const -> bool
+    {
+        // Screen rectangle and nearest depth of the 8 corners; boxes reaching past the near
+        // plane are never hidden
+        const auto center = transform_point(view_proj, bounds.center);
+        const auto axis_x = view_proj[0] * bounds.extents.x;
+        const auto axis_y = view_proj[1] * bounds.extents.y;
+        const auto axis_z = view_proj[2] * bounds.extents.z;
+        const float half_width = 0.5f * static_cast<float>(get_width());
+        const float half_height = 0.5f * static_cast<float>(get_height());
+        float min_x = std::numeric_limits<float>::max();
+        float min_y = std::numeric_limits<float>::max();
+        float max_x = std::numeric_limits<float>::lowest();
+        float max_y = std::numeric_limits<float>::lowest();
+        float nearest = 1.0f;
+        for (uint32_t corner = 0; corner < 8; ++corner) {
+            auto p = center + axis_x * ((corner & 1u) ? 1.0f : -1.0f) + axis_y * ((corner & 2u) ? 1.0f : -1.0f)
+                   + axis_z * ((corner & 4u) ? 1.0f : -1.0f);
+            if (!(p.z >= 0.0f) || !(p.w > 0.0f)) {
+                return true;
+            }
+            float inv_w = 1.0f / p.w;
+            float x = (p.x * inv_w + 1.0f) * half_width;
+            float y = (p.y * inv_w + 1.0f) * half_height;
+            min_x = std::min(min_x, x);
+            max_x = std::max(max_x, x);
+            min_y = std::min(min_y, y);
+            max_y = std::max(max_y, y);
+            nearest = std::min(nearest, p.z * inv_w);
+        }
+
+        // Every pixel the rectangle touches plus a one pixel border, since occluders only
+        // cover the pixels whose centers they contain
+        const float right = static_cast<float>(get_width());
+        const float bottom = static_cast<float>(get_height());
+        if (max_x < 0.0f || min_x > right || max_y < 0.0f || min_y > bottom) {
+            return true;
+        }
+        auto first_x = static_cast<uint32_t>(std::max(0.0f, std::floor(min_x) - 1.0f));
+        auto last_x = static_cast<uint32_t>(std::min(right - 1.0f, std::floor(max_x) + 1.0f));
+        auto first_y = static_cast<uint32_t>(std::max(0.0f, std::floor(min_y) - 1.0f));
+        auto last_y = static_cast<uint32_t>(std::min(bottom - 1.0f, std::floor(max_y) + 1.0f));
+
+        auto row_reaches = row_reaches_scalar;
+#if defined(MANGO_OCCLUSION_SSE)
+        if (settings_.path == Cull_Path::sse) {
+            row_reaches = row_reaches_sse;
+        }
+#endif
+#if defined(MANGO_OCCLUSION_AVX2)
+        if (settings_.path == Cull_Path::avx2) {
+            row_reaches = row_reaches_avx2;
+        }
+#endif
+
+        for (auto ty = first_y / TILE_HEIGHT; ty <= last_y / TILE_HEIGHT; ++ty) {
+            for (auto tx = first_x / TILE_WIDTH; tx <= last_x / TILE_WIDTH; ++tx) {
+                auto tile = static_cast<std::size_t>(ty) * tiles_x_ + tx;
+                // The whole tile lies in front of the box
+                if (nearest > tile_max_[tile]) {
+                    continue;
+                }
+                uint32_t lane_first = std::max(first_x, tx * TILE_WIDTH) - tx * TILE_WIDTH;
+                uint32_t lane_last = std::min(last_x, tx * TILE_WIDTH + TILE_WIDTH - 1) - tx * TILE_WIDTH;
+                uint32_t y_first = std::max(first_y, ty * TILE_HEIGHT);
+                uint32_t y_last = std::min(last_y, ty * TILE_HEIGHT + TILE_HEIGHT - 1);
+                for (auto y = y_first; y <= y_last; ++y) {
+                    const float* row = depth_.data() + tile * TILE_PIXELS + (y % TILE_HEIGHT) * TILE_WIDTH;
+                    if (row_reaches(row, lane_first, lane_last, nearest)) {
+                        return true;
+                    }
+                }
+            }
+        }
+        return false;
+    }
+
+    auto Occlusion_Culler::get_depth(uint32_t x, uint32_t y) const -> float
+    {
+        if (x >= get_width() || y >= get_height()) {
+            return 1.0f;
+        }
+        auto tile = static_cast<std::size_t>(y / TILE_HEIGHT) * tiles_x_ + x / TILE_WIDTH;
+        return depth_[tile * TILE_PIXELS + (y % TILE_HEIGHT) * TILE_WIDTH + x % TILE_WIDTH];
+    }
+}
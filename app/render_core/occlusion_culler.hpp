@@ -0,0 +1,104 @@
+#pragma once
+
+#include "render_core/frustum_culler.hpp"
+#include "render_core/render_scene.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace mango::app
+{
+    struct Occlusion_Settings
+    {
+        uint32_t width = 256;                   // depth buffer size, rounded up to whole tiles
+        uint32_t height = 128;
+        uint32_t occluder_budget = 48;          // occluders rasterized per view
+        uint32_t triangle_budget = 16384;       // triangles rasterized per view
+        float min_occluder_area = 0.01f;        // projected bounding sphere area, fraction of the screen
+        Cull_Path path = Frustum_Culler::get_best_path();
+    };
+
+    struct Occlusion_Stats
+    {
+        uint32_t occluders = 0;
+        uint32_t occluder_triangles = 0;
+        uint32_t tested = 0;
+        uint32_t occluded = 0;
+        float occluder_ms = 0.0f;       // selection, transform and rasterization
+        float occludee_ms = 0.0f;       // bounds tests and compaction
+    };
+
+    // CPU occlusion culling for one view. cull() picks the proxies in the view's visible list
+    // with the largest projected bounds as occluders, rasterizes their triangles into a small
+    // depth buffer, then tests every visible proxy's bounds against it and drops the hidden
+    // ones from the list. Both halves run on the worker pool.
+    // With materials, rows whose material is transparent (base color alpha below 1, as in
+    // Draw_List) are never occluders, since what is behind them stays visible; they are
+    // still tested as occludees. Without materials every row is opaque, as in depth-only views.
+    // The depth buffer is stored in 8x4 pixel tiles, each with its farthest depth, so most
+    // bounds are accepted or rejected per tile; rasterization and per-pixel tests process a
+    // tile row at once (AVX2 with MANGO_ENABLE_AVX2, SSE, or scalar; see settings.path).
+    // Occluders are rasterized two-sided, matching the PBR and shadow pipelines.
+    class Occlusion_Culler
+    {
+    public:
+        static constexpr uint32_t TILE_WIDTH = 8;
+        static constexpr uint32_t TILE_HEIGHT = 4;
+
+        explicit Occlusion_Culler(const Occlusion_Settings& settings = {});
+
+        auto cull(const Render_Proxies& proxies, const math::Mat4& view_proj, Render_View& view,
+                  const std::vector<Render_Material>* materials = nullptr) -> void;
+
+        // 1 for rows of the last cull()'s input list that survived, 0 for everything else
+        auto get_visibility_mask() const -> const std::vector<uint8_t>& { return visibility_; }
+        auto is_visible(uint32_t row) const -> bool { return row < visibility_.size() && visibility_[row] != 0; }
+        auto get_stats() const -> const Occlusion_Stats& { return stats_; }
+
+        // Building blocks of cull(), exposed for tests and debugging views
+        auto clear() -> void;
+        auto rasterize(const resource::Mesh_Data& mesh, const math::Mat4& world_view_proj) -> void;
+        auto is_box_visible(const Render_Bounds& bounds, const math::Mat4& view_proj) const -> bool;
+        auto get_width() const -> uint32_t { return tiles_x_ * TILE_WIDTH; }
+        auto get_height() const -> uint32_t { return tiles_y_ * TILE_HEIGHT; }
+        // Depth at a pixel, 1 where nothing was drawn
+        auto get_depth(uint32_t x, uint32_t y) const -> float;
+
+    private:
+        static constexpr uint32_t TILE_PIXELS = TILE_WIDTH * TILE_HEIGHT;
+
+        // Screen-space triangle: x, y in pixels, z in [0, 1]
+        struct Screen_Triangle
+        {
+            float x[3];
+            float y[3];
+            float z[3];
+        };
+
+        struct Occluder
+        {
+            uint32_t row;
+            float area;
+        };
+
+        // Clips to the near plane and a guard band, then projects to pixels
+        auto transform(const resource::Mesh_Data& mesh, const math::Mat4& world_view_proj, std::vector<math::Vec4>& clip,
+                       std::vector<Screen_Triangle>& out) const -> void;
+        auto rasterize_tile_rows(const Screen_Triangle* triangles, std::size_t count, uint32_t tile_row_begin, uint32_t tile_row_end) -> void;
+        auto update_tile_max(uint32_t tile_row_begin, uint32_t tile_row_end) -> void;
+
+        Occlusion_Settings settings_;
+        uint32_t tiles_x_ = 0;
+        uint32_t tiles_y_ = 0;
+        std::vector<float> depth_;          // tile by tile, rows of TILE_WIDTH inside a tile
+        std::vector<float> tile_max_;
+
+        Occlusion_Stats stats_;
+        std::vector<uint8_t> visibility_;
+        std::vector<Occluder> occluders_;
+        std::vector<std::vector<Screen_Triangle>> occluder_triangles_;     // one list per occluder
+        std::vector<Screen_Triangle> triangles_;
+        std::vector<std::vector<math::Vec4>> clip_scratch_;                 // one per pool thread
+        std::vector<uint8_t> survived_;
+    };
+}
@@ -0,0 +1,723 @@
+#include "render_core/render_bvh.hpp"
+#include "thread/worker-pool.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace mango::app
+{
+    namespace
+    {
+        constexpr std::size_t PARALLEL_GRAIN = 4096;          // rows per parallel_for chunk
+        constexpr std::size_t PARALLEL_BUILD_MIN = 8192;      // smaller ranges build on one thread
+        constexpr uint32_t PARALLEL_BUILD_DEPTH = 6;
+        constexpr uint32_t MORTON_BITS = 10;                  // per axis
+        constexpr uint32_t RADIX_BITS = 10;
+        constexpr uint32_t COST_CHECK_INTERVAL = 64;          // syncs between SAH cost checks
+        constexpr uint32_t ALL_PLANES = (1u << Frustum::PLANE_COUNT) - 1;
+
+        auto half_area(const math::Vec3& min, const math::Vec3& max) -> float
+        {
+            auto d = max - min;
+            return d.x * d.y + d.y * d.z + d.z * d.x;
+        }
+
+        auto component_min(const math::Vec3& a, const math::Vec3& b) -> math::Vec3
+        {
+            return math::Vec3(std::min(a.x, b.x), std::min(a.y, b.y), std::min(a.z, b.z));
+        }
+
+        auto component_max(const math::Vec3& a, const math::Vec3& b) -> math::Vec3
+        {
+            return math::Vec3(std::max(a.x, b.x), std::max(a.y, b.y), std::max(a.z, b.z));
+        }
+
+        auto contains(const math::Vec3& outer_min, const math::Vec3& outer_max, const math::Vec3& inner_min, const math::Vec3& inner_max) -> bool
+        {
+            return outer_min.x <= inner_min.x && outer_min.y <= inner_min.y && outer_min.z <= inner_min.z
+                && inner_max.x <= outer_max.x && inner_max.y <= outer_max.y && inner_max.z <= outer_max.z;
+        }
+
+        auto row_center(const Render_Bounds_Columns& b, std::size_t row) -> math::Vec3
+        {
+            return math::Vec3(b.center_x[row], b.center_y[row], b.center_z[row]);
+        }
+
+        auto row_extents(const Render_Bounds_Columns& b, std::size_t row) -> math::Vec3
+        {
+            return math::Vec3(b.extent_x[row], b.extent_y[row], b.extent_z[row]);
+        }
+
+        // Same expression as Frustum_Culler so both agree on boxes touching a plane
+        auto row_visible(const Frustum& frustum, uint32_t mask, const Render_Bounds_Columns& b, std::size_t row) -> bool
+        {
+            for (uint32_t p = 0; p < Frustum::PLANE_COUNT; ++p) {
+                if (!(mask & (1u << p))) {
+                    continue;
+                }
+                const auto& n = frustum.planes[p];
+                float distance = (n.x * b.center_x[row] + n.y * b.center_y[row]) + (n.z * b.center_z[row] + n.w);
+                float reach = std::abs(n.x) * b.extent_x[row] + std::abs(n.y) * b.extent_y[row] + std::abs(n.z) * b.extent_z[row];
+                if (distance + reach < 0.0f) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Spreads the low 10 bits of v so two zero bits follow each one
+        auto spread_bits(uint32_t v) -> uint32_t
+        {
+            v = (v | (v << 16)) & 0x030000FFu;
+            v = (v | (v << 8)) & 0x0300F00Fu;
+            v = (v | (v << 4)) & 0x030C30C3u;
+            v = (v | (v << 2)) & 0x09249249u;
+            return v;
+        }
+
+        auto row_touches_sphere(const Render_Bounds_Columns& b, std::size_t row, const math::Vec3& center, float radius) -> bool
+        {
+            float distance_sq = 0.0f;
+            for (int axis = 0; axis < 3; ++axis) {
+                float c = row_center(b, row)[axis];
+                float e = row_extents(b, row)[axis];
+                float d = std::max(std::abs(center[axis] - c) - e, 0.0f);
+                distance_sq += d * d;
+            }
+            return distance_sq <= radius * radius;
+        }
+    }
+
+    Render_Bvh::Render_Bvh(const Render_Bvh_Settings& settings)
+        : settings_(settings)
+    {
+    }
+
+    auto Render_Bvh::sync(const Render_Proxies& proxies, const std::vector<Render_Range>& changed) -> void
+    {
+        const auto count = proxies.size();
+        const auto old_count = leaf_of_row_.size();
+        const auto resized = count > old_count ? count - old_count : old_count - count;
+        last_moved_count_ = 0;
+        if (root_ == NULL_NODE || should_rebuild(churn_ + resized, count)) {
+            rebuild(proxies);
+            return;
+        }
+
+        for (auto row = old_count; row > count; --row) {
+            remove(static_cast<uint32_t>(row - 1));
+        }
+        leaf_of_row_.resize(count, NULL_NODE);
+
+        // Rows that kept their leaf: containment checks and fat box refreshes are per leaf,
+        // so they run in parallel; the tree links are only touched afterwards
+        const auto kept = std::min(count, old_count);
+        changed_rows_.clear();
+        for (const auto& range : changed) {
+            for (auto row = range.begin; row < std::min<std::size_t>(range.end, kept); ++row) {
+                changed_rows_.push_back(row);
+            }
+        }
+        escaped_.assign(changed_rows_.size(), 0);
+        core::Worker_Pool::current_instance()->parallel_for(changed_rows_.size(), PARALLEL_GRAIN,
+            [&](std::size_t begin, std::size_t end, std::uint32_t) {
+                for (auto i = begin; i < end; ++i) {
+                    auto row = changed_rows_[i];
+                    auto& leaf = nodes_[leaf_of_row_[row]];
+                    auto center = row_center(proxies.bounds, row);
+                    auto extents = row_extents(proxies.bounds, row);
+                    auto tight_min = center - extents;
+                    auto tight_max = center + extents;
+                    // Also refresh boxes that are far larger than needed, e.g. after a teleport
+                    bool loose = half_area(leaf.min, leaf.max) > 4.0f * half_area(tight_min, tight_max) + settings_.min_margin;
+                    if (leaf.flags == proxies.flags[row] && !loose && contains(leaf.min, leaf.max, tight_min, tight_max)) {
+                        continue;
+                    }
+                    set_leaf_box(leaf, center, extents);
+                    leaf.flags = proxies.flags[row];
+                    escaped_[i] = 1;
+                }
+            });
+
+        moved_.clear();
+        for (std::size_t i = 0; i < changed_rows_.size(); ++i) {
+            if (escaped_[i]) {
+                moved_.push_back(leaf_of_row_[changed_rows_[i]]);
+            }
+        }
+        last_moved_count_ = moved_.size();
+        churn_ += resized + moved_.size();
+        if (should_rebuild(churn_, count)) {
+            rebuild(proxies);
+            last_moved_count_ = moved_.size();
+            return;
+        }
+
+        for (auto row = old_count; row < count; ++row) {
+            insert(static_cast<uint32_t>(row), proxies.bounds[row], proxies.flags[row]);
+        }
+
+        if (moved_.size() > settings_.reinsert_limit) {
+            refit_moved();
+        } else {
+            for (auto leaf : moved_) {
+                remove_leaf(leaf);
+                insert_leaf(leaf);
+            }
+        }
+
+        // Refits and skewed insertions degrade the tree slowly; check its cost now and then
+        if (++syncs_since_cost_check_ >= COST_CHECK_INTERVAL) {
+            syncs_since_cost_check_ = 0;
+            if (get_cost() > built_cost_ * settings_.rebuild_cost_ratio) {
+                rebuild(proxies);
+                last_moved_count_ = moved_.size();
+            }
+        }
+    }
+
+    auto Render_Bvh::rebuild(const Render_Proxies& proxies) -> void
+    {
+        const auto count = proxies.size();
+        nodes_.clear();
+        free_list_ = NULL_NODE;
+        root_ = NULL_NODE;
+        leaf_of_row_.assign(count, NULL_NODE);
+        leaf_count_ = count;
+        churn_ = 0;
+        syncs_since_cost_check_ = 0;
+        built_cost_ = 0.0f;
+        ++rebuild_count_;
+        if (count == 0) {
+            return;
+        }
+
+        // Leaves in Morton order of their centers, so median splits keep neighbours together
+        auto lo = row_center(proxies.bounds, 0);
+        auto hi = lo;
+        for (std::size_t row = 1; row < count; ++row) {
+            lo = component_min(lo, row_center(proxies.bounds, row));
+            hi = component_max(hi, row_center(proxies.bounds, row));
+        }
+        const float cells = static_cast<float>((1u << MORTON_BITS) - 1);
+        // One scale for all axes keeps the cells cubic, so flat scenes do not waste splits
+        // on their thin axis
+        auto span = hi - lo;
+        float widest = std::max({ span.x, span.y, span.z });
+        float scale = widest > 0.0f ? cells / widest : 0.0f;
+        build_items_.resize(count);
+        for (std::size_t row = 0; row < count; ++row) {
+            auto cell = (row_center(proxies.bounds, row) - lo) * scale;
+            auto code = (spread_bits(static_cast<uint32_t>(cell.x)) << 2) | (spread_bits(static_cast<uint32_t>(cell.y)) << 1)
+                      | spread_bits(static_cast<uint32_t>(cell.z));
+            build_items_[row] = { code, static_cast<uint32_t>(row) };
+        }
+        sort_build_items();
+
+        // A subtree over n leaves occupies 2n - 1 consecutive nodes, so every range knows
+        // where its nodes go and the halves can be built concurrently
+        nodes_.resize(2 * count - 1);
+        build(proxies, 0, 0, count, NULL_NODE, 0);
+        root_ = 0;
+        built_cost_ = get_cost();
+    }
+
+    auto Render_Bvh::clear() -> void
+    {
+        nodes_.clear();
+        leaf_of_row_.clear();
+        root_ = NULL_NODE;
+        free_list_ = NULL_NODE;
+        leaf_count_ = 0;
+        churn_ = 0;
+        built_cost_ = 0.0f;
+        syncs_since_cost_check_ = 0;
+        last_moved_count_ = 0;
+    }
+
+    auto Render_Bvh::insert(uint32_t row, const Render_Bounds& bounds, uint32_t flags) -> void
+    {
+        if (row >= leaf_of_row_.size()) {
+            leaf_of_row_.resize(row + 1, NULL_NODE);
+        }
+        if (leaf_of_row_[row] != NULL_NODE) {
+            update(row, bounds, flags);
+            return;
+        }
+
+        auto leaf = allocate_node();
+        auto& node = nodes_[leaf];
+        set_leaf_box(node, bounds.center, bounds.extents);
+        node.row = row;
+        node.flags = flags;
+        leaf_of_row_[row] = leaf;
+        insert_leaf(leaf);
+        ++leaf_count_;
+    }
+
+    auto Render_Bvh::remove(uint32_t row) -> void
+    {
+        if (row >= leaf_of_row_.size() || leaf_of_row_[row] == NULL_NODE) {
+            return;
+        }
+        auto leaf = leaf_of_row_[row];
+        remove_leaf(leaf);
+        free_node(leaf);
+        leaf_of_row_[row] = NULL_NODE;
+        --leaf_count_;
+    }
+
+    auto Render_Bvh::update(uint32_t row, const Render_Bounds& bounds, uint32_t flags) -> bool
+    {
+        if (row >= leaf_of_row_.size() || leaf_of_row_[row] == NULL_NODE) {
+            insert(row, bounds, flags);
+            return true;
+        }
+
+        auto leaf = leaf_of_row_[row];
+        auto& node = nodes_[leaf];
+        if (node.flags == flags && contains(node.min, node.max, bounds.center - bounds.extents, bounds.center + bounds.extents)) {
+            return false;
+        }
+        remove_leaf(leaf);
+        set_leaf_box(nodes_[leaf], bounds.center, bounds.extents);
+        nodes_[leaf].flags = flags;
+        insert_leaf(leaf);
+        return true;
+    }
+
+    auto Render_Bvh::cull(const Render_Proxies& proxies, Render_View& view) const -> void
+    {
+        auto& visible = view.visible;
+        visible.clear();
+        const auto required = view.required_flags;
+        const auto& frustum = view.frustum;
+
+        // Each entry carries the planes its parent was not already fully inside of
+        struct Entry
+        {
+            int32_t node;
+            uint32_t mask;
+        };
+        std::vector<Entry> stack;
+        stack.reserve(64);
+        if (root_ != NULL_NODE) {
+            stack.push_back({ root_, ALL_PLANES });
+        }
+
+        while (!stack.empty()) {
+            auto [index, mask] = stack.back();
+            stack.pop_back();
+            const auto& node = nodes_[index];
+            if ((node.flags & required) != required) {
+                continue;
+            }
+            if (node.is_leaf()) {
+                if (mask == 0 || row_visible(frustum, mask, proxies.bounds, node.row)) {
+                    visible.push_back(node.row);
+                }
+                continue;
+            }
+
+            auto center = (node.min + node.max) * 0.5f;
+            auto extents = (node.max - node.min) * 0.5f;
+            bool outside = false;
+            for (uint32_t p = 0; p < Frustum::PLANE_COUNT && mask != 0; ++p) {
+                if (!(mask & (1u << p))) {
+                    continue;
+                }
+                const auto& n = frustum.planes[p];
+                float distance = n.x * center.x + n.y * center.y + n.z * center.z + n.w;
+                float reach = std::abs(n.x) * extents.x + std::abs(n.y) * extents.y + std::abs(n.z) * extents.z;
+                if (distance + reach < 0.0f) {
+                    outside = true;
+                    break;
+                }
+                if (distance - reach >= 0.0f) {
+                    mask &= ~(1u << p);
+                }
+            }
+            if (!outside) {
+                stack.push_back({ node.child2, mask });
+                stack.push_back({ node.child1, mask });
+            }
+        }
+
+        view.stats.tested = static_cast<uint32_t>(leaf_count_);
+        view.stats.visible = static_cast<uint32_t>(visible.size());
+        view.stats.culled = view.stats.tested - view.stats.visible;
+    }
+
+    auto Render_Bvh::query_sphere(const Render_Proxies& proxies, const math::Vec3& center, float radius, uint32_t required_flags,
+                                  std::vector<uint32_t>& rows) const -> void
+    {
+        rows.clear();
+        std::vector<int32_t> stack;
+        stack.reserve(64);
+        if (root_ != NULL_NODE) {
+            stack.push_back(root_);
+        }
+
+        while (!stack.empty()) {
+            const auto& node = nodes_[stack.back()];
+            stack.pop_back();
+            if ((node.flags & required_flags) != required_flags) {
+                continue;
+            }
+            if (node.is_leaf()) {
+                if (row_touches_sphere(proxies.bounds, node.row, center, radius)) {
+                    rows.push_back(node.row);
+                }
+                continue;
+            }
+            auto nearest = component_max(node.min, component_min(center, node.max));
+            auto offset = nearest - center;
+            if (offset.x * offset.x + offset.y * offset.y + offset.z * offset.z > radius * radius) {
+                continue;
+            }
+            stack.push_back(node.child2);
+            stack.push_back(node.child1);
+        }
+    }
+
+    auto Render_Bvh::get_height() const -> int32_t
+    {
+        return root_ == NULL_NODE ? 0 : nodes_[root_].height;
+    }
+
+    auto Render_Bvh::get_cost() const -> float
+    {
+        if (root_ == NULL_NODE) {
+            return 0.0f;
+        }
+        float root_area = half_area(nodes_[root_].min, nodes_[root_].max);
+        if (root_area <= 0.0f) {
+            return 0.0f;
+        }
+        float total = 0.0f;
+        for (const auto& node : nodes_) {
+            if (node.height > 0) {
+                total += half_area(node.min, node.max);
+            }
+        }
+        return total / root_area;
+    }
+
+    auto Render_Bvh::validate(const Render_Proxies& proxies) const -> bool
+    {
+        std::size_t leaves = 0;
+        for (std::size_t i = 0; i < nodes_.size(); ++i) {
+            const auto& node = nodes_[i];
+            if (node.height < 0) {
+                continue;
+            }
+            auto index = static_cast<int32_t>(i);
+            if (node.parent == NULL_NODE ? root_ != index : (nodes_[node.parent].child1 != index && nodes_[node.parent].child2 != index)) {
+                return false;
+            }
+            if (node.is_leaf()) {
+                ++leaves;
+                auto row = node.row;
+                if (row >= proxies.size() || leaf_of_row_[row] != index || node.height != 0 || node.flags != proxies.flags[row]) {
+                    return false;
+                }
+                auto center = row_center(proxies.bounds, row);
+                auto extents = row_extents(proxies.bounds, row);
+                if (!contains(node.min, node.max, center - extents, center + extents)) {
+                    return false;
+                }
+                continue;
+            }
+            const auto& a = nodes_[node.child1];
+            const auto& b = nodes_[node.child2];
+            if (a.parent != index || b.parent != index || node.height != 1 + std::max(a.height, b.height)
+                || node.flags != (a.flags | b.flags)
+                || node.min != component_min(a.min, b.min) || node.max != component_max(a.max, b.max)) {
+                return false;
+            }
+        }
+        return leaves == leaf_count_ && leaf_of_row_.size() == proxies.size();
+    }
+
+    auto Render_Bvh::allocate_node() -> int32_t
+    {
+        if (free_list_ == NULL_NODE) {
+            nodes_.emplace_back();
+            return static_cast<int32_t>(nodes_.size() - 1);
+        }
+        auto index = free_list_;
+        free_list_ = nodes_[index].parent;
+        nodes_[index] = Node{};
+        return index;
+    }
+
+    auto Render_Bvh::free_node(int32_t index) -> void
+    {
+        nodes_[index].parent = free_list_;
+        nodes_[index].height = -1;
+        free_list_ = index;
+    }
+
+    auto Render_Bvh::set_leaf_box(Node& leaf, const math::Vec3& center, const math::Vec3& extents) const -> void
+    {
+        float margin = std::max({ extents.x, extents.y, extents.z }) * settings_.margin_scale + settings_.min_margin;
+        auto fat = extents + math::Vec3(margin, margin, margin);
+        leaf.min = center - fat;
+        leaf.max = center + fat;
+        leaf.child1 = NULL_NODE;
+        leaf.child2 = NULL_NODE;
+        leaf.height = 0;
+    }
+
+    auto Render_Bvh::insert_leaf(int32_t leaf) -> void
+    {
+        if (root_ == NULL_NODE) {
+            root_ = leaf;
+            nodes_[leaf].parent = NULL_NODE;
+            return;
+        }
+
+        // Descend towards the sibling with the lowest surface area increase
+        const auto leaf_min = nodes_[leaf].min;
+        const auto leaf_max = nodes_[leaf].max;
+        auto index = root_;
+        while (!nodes_[index].is_leaf()) {
+            const auto& node = nodes_[index];
+            float area = half_area(node.min, node.max);
+            float combined = half_area(component_min(node.min, leaf_min), component_max(node.max, leaf_max));
+            float cost = 2.0f * combined;
+            float inheritance = 2.0f * (combined - area);
+
+            auto descend_cost = [&](int32_t child) {
+                const auto& c = nodes_[child];
+                float grown = half_area(component_min(c.min, leaf_min), component_max(c.max, leaf_max));
+                return (c.is_leaf() ? grown : grown - half_area(c.min, c.max)) + inheritance;
+            };
+            float cost1 = descend_cost(node.child1);
+            float cost2 = descend_cost(node.child2);
+            if (cost < cost1 && cost < cost2) {
+                break;
+            }
+            index = cost1 < cost2 ? node.child1 : node.child2;
+        }
+
+        auto sibling = index;
+        auto old_parent = nodes_[sibling].parent;
+        auto new_parent = allocate_node();
+        nodes_[new_parent].parent = old_parent;
+        nodes_[new_parent].child1 = sibling;
+        nodes_[new_parent].child2 = leaf;
+        nodes_[sibling].parent = new_parent;
+        nodes_[leaf].parent = new_parent;
+        if (old_parent == NULL_NODE) {
+            root_ = new_parent;
+        } else if (nodes_[old_parent].child1 == sibling) {
+            nodes_[old_parent].child1 = new_parent;
+        } else {
+            nodes_[old_parent].child2 = new_parent;
+        }
+
+        for (auto up = new_parent; up != NULL_NODE; up = nodes_[up].parent) {
+            up = balance(up);
+            refit_node(up);
+        }
+    }
+
+    auto Render_Bvh::remove_leaf(int32_t leaf) -> void
+    {
+        if (leaf == root_) {
+            root_ = NULL_NODE;
+            return;
+        }
+
+        auto parent = nodes_[leaf].parent;
+        auto grand_parent = nodes_[parent].parent;
+        auto sibling = nodes_[parent].child1 == leaf ? nodes_[parent].child2 : nodes_[parent].child1;
+        free_node(parent);
+        if (grand_parent == NULL_NODE) {
+            root_ = sibling;
+            nodes_[sibling].parent = NULL_NODE;
+            return;
+        }
+
+        if (nodes_[grand_parent].child1 == parent) {
+            nodes_[grand_parent].child1 = sibling;
+        } else {
+            nodes_[grand_parent].child2 = sibling;
+        }
+        nodes_[sibling].parent = grand_parent;
+        for (auto up = grand_parent; up != NULL_NODE; up = nodes_[up].parent) {
+            up = balance(up);
+            refit_node(up);
+        }
+    }
+
+    auto Render_Bvh::balance(int32_t a) -> int32_t
+    {
+        // AVL-style rotation: lift the taller grandchild's parent over a
+        if (nodes_[a].is_leaf() || nodes_[a].height < 2) {
+            return a;
+        }
+        auto b = nodes_[a].child1;
+        auto c = nodes_[a].child2;
+        auto skew = nodes_[c].height - nodes_[b].height;
+        if (skew >= -1 && skew <= 1) {
+            return a;
+        }
+
+        // up replaces a; a keeps the shorter side and up's shorter child
+        auto up = skew > 1 ? c : b;
+        auto f = nodes_[up].child1;
+        auto g = nodes_[up].child2;
+        auto parent = nodes_[a].parent;
+        nodes_[up].child1 = a;
+        nodes_[up].parent = parent;
+        nodes_[a].parent = up;
+        if (parent == NULL_NODE) {
+            root_ = up;
+        } else if (nodes_[parent].child1 == a) {
+            nodes_[parent].child1 = up;
+        } else {
+            nodes_[parent].child2 = up;
+        }
+
+        auto taller = nodes_[f].height > nodes_[g].height ? f : g;
+        auto shorter = taller == f ? g : f;
+        nodes_[up].child2 = taller;
+        if (up == c) {
+            nodes_[a].child2 = shorter;
+        } else {
+            nodes_[a].child1 = shorter;
+        }
+        nodes_[shorter].parent = a;
+        refit_node(a);
+        refit_node(up);
+        return up;
+    }
+
+    auto Render_Bvh::refit_node(int32_t index) -> void
+    {
+        auto& node = nodes_[index];
+        const auto& a = nodes_[node.child1];
+        const auto& b = nodes_[node.child2];
+        node.min = component_min(a.min, b.min);
+        node.max = component_max(a.max, b.max);
+        node.height = 1 + std::max(a.height, b.height);
+        node.flags = a.flags | b.flags;
+    }
+
+    auto Render_Bvh::refit_moved() -> void
+    {
+        // Collect every ancestor of a moved leaf once
+        refit_marked_.resize(nodes_.size(), 0);
+        refit_nodes_.clear();
+        int32_t top_height = 0;
+        for (auto leaf : moved_) {
+            for (auto up = nodes_[leaf].parent; up != NULL_NODE && !refit_marked_[up]; up = nodes_[up].parent) {
+                refit_marked_[up] = 1;
+                refit_nodes_.push_back(up);
+                top_height = std::max(top_height, nodes_[up].height);
+            }
+        }
+
+        // Nodes of one height only read lower ones, so each height is refit in parallel
+        std::vector<std::size_t> level_start(static_cast<std::size_t>(top_height) + 2, 0);
+        for (auto index : refit_nodes_) {
+            ++level_start[static_cast<std::size_t>(nodes_[index].height) + 1];
+        }
+        for (std::size_t h = 1; h < level_start.size(); ++h) {
+            level_start[h] += level_start[h - 1];
+        }
+        refit_order_.resize(refit_nodes_.size());
+        {
+            auto cursor = level_start;
+            for (auto index : refit_nodes_) {
+                refit_order_[cursor[static_cast<std::size_t>(nodes_[index].height)]++] = index;
+                refit_marked_[index] = 0;
+            }
+        }
+
+        auto* pool = core::Worker_Pool::current_instance();
+        for (std::size_t h = 1; h + 1 < level_start.size(); ++h) {
+            auto first = level_start[h];
+            pool->parallel_for(level_start[h + 1] - first, PARALLEL_GRAIN, [&](std::size_t begin, std::size_t end, std::uint32_t) {
+                for (auto i = begin; i < end; ++i) {
+                    refit_node(refit_order_[first + i]);
+                }
+            });
+        }
+    }
+
+    auto Render_Bvh::sort_build_items() -> void
+    {
+        // LSD radix sort on the 30-bit codes; stable, so equal codes keep row order
+        constexpr uint32_t BUCKETS = 1u << RADIX_BITS;
+        sort_scratch_.resize(build_items_.size());
+        std::vector<std::size_t> offsets(BUCKETS);
+        for (uint32_t shift = 0; shift < 3 * MORTON_BITS; shift += RADIX_BITS) {
+            std::fill(offsets.begin(), offsets.end(), 0);
+            for (const auto& item : build_items_) {
+                ++offsets[(item.code >> shift) & (BUCKETS - 1)];
+            }
+            std::size_t sum = 0;
+            for (auto& offset : offsets) {
+                auto bucket = offset;
+                offset = sum;
+                sum += bucket;
+            }
+            for (const auto& item : build_items_) {
+                sort_scratch_[offsets[(item.code >> shift) & (BUCKETS - 1)]++] = item;
+            }
+            build_items_.swap(sort_scratch_);
+        }
+    }
+
+    auto Render_Bvh::build(const Render_Proxies& proxies, int32_t first, std::size_t begin, std::size_t end, int32_t parent, uint32_t depth) -> void
+    {
+        auto& node = nodes_[first];
+        node.parent = parent;
+        if (end - begin == 1) {
+            auto row = build_items_[begin].row;
+            set_leaf_box(node, row_center(proxies.bounds, row), row_extents(proxies.bounds, row));
+            node.row = row;
+            node.flags = proxies.flags[row];
+            leaf_of_row_[row] = first;
+            return;
+        }
+
+        // Split where the highest differing Morton bit flips, i.e. along an octree cell
+        // boundary; ranges of one code fall back to the median
+        auto mid = begin + (end - begin) / 2;
+        auto first_code = build_items_[begin].code;
+        auto last_code = build_items_[end - 1].code;
+        if (first_code != last_code) {
+            auto bit = 1u << (31 - std::countl_zero(first_code ^ last_code));
+            auto split = std::partition_point(build_items_.begin() + static_cast<std::ptrdiff_t>(begin),
+                                              build_items_.begin() + static_cast<std::ptrdiff_t>(end),
+                                              [bit](const Build_Item& item) { return !(item.code & bit); });
+            mid = static_cast<std::size_t>(split - build_items_.begin());
+        }
+        auto left = first + 1;
+        auto right = first + static_cast<int32_t>(2 * (mid - begin));
+        node.child1 = left;
+        node.child2 = right;
+        if (end - begin >= PARALLEL_BUILD_MIN && depth < PARALLEL_BUILD_DEPTH) {
+            auto* pool = core::Worker_Pool::current_instance();
+            core::Task_Group group;
+            pool->run(group, [&, left, begin, mid] { build(proxies, left, begin, mid, first, depth + 1); });
+            build(proxies, right, mid, end, first, depth + 1);
+            pool->wait(group);
+        } else {
+            build(proxies, left, begin, mid, first, depth + 1);
+            build(proxies, right, mid, end, first, depth + 1);
+        }
+        refit_node(first);
+    }
+
+    auto Render_Bvh::should_rebuild(std::size_t churn, std::size_t count) const -> bool
+    {
+        // Small trees rebuild for next to nothing; do not let a handful of movers thrash them
+        constexpr std::size_t MIN_CHURN_BASE = 64;
+        return static_cast<float>(churn) > settings_.rebuild_churn * static_cast<float>(std::max(count, MIN_CHURN_BASE));
+    }
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "render_core/frustum_culler.hpp"
+#include "render_core/render_scene.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace mango::app
+{
+    struct Render_Bvh_Settings
+    {
+        float margin_scale = 0.1f;          // fat boxes grow by this fraction of the largest half extent
+        float min_margin = 1e-3f;
+        float rebuild_churn = 0.3f;         // rebuild once this fraction of leaves moved, appeared or vanished
+        float rebuild_cost_ratio = 1.5f;    // rebuild once the SAH cost grew this much past the last build
+        std::size_t reinsert_limit = 256;   // more escaped leaves than this are refit in place instead
+    };
+
+    // Dynamic AABB tree over render proxies, one leaf per proxy row. Leaves keep a fat box
+    // around the proxy's world bounds so small moves cost a containment check only.
+    // sync() patches the tree from a frame's changed rows: leaves that left their fat box are
+    // reinserted one by one when few, otherwise refit in place on the worker pool. A full
+    // rebuild (Morton order, median splits) runs once churn or SAH cost passes the thresholds
+    // in the settings.
+    // Nodes carry the OR of their leaves' proxy flags, so queries with required flags (shadow
+    // casters) skip whole subtrees. Queries test the proxies' exact bounds at the leaves and
+    // return the same rows Frustum_Culler would, in tree order.
+    class Render_Bvh
+    {
+    public:
+        explicit Render_Bvh(const Render_Bvh_Settings& settings = {});
+
+        // Brings the tree in line with proxies after rows in changed were rewritten. Rows past
+        // the previous size are inserted, rows past the new size removed.
+        auto sync(const Render_Proxies& proxies, const std::vector<Render_Range>& changed) -> void;
+        auto rebuild(const Render_Proxies& proxies) -> void;
+        auto clear() -> void;
+
+        auto insert(uint32_t row, const Render_Bounds& bounds, uint32_t flags) -> void;
+        auto remove(uint32_t row) -> void;
+        // Returns true when the leaf left its fat box and was reinserted
+        auto update(uint32_t row, const Render_Bounds& bounds, uint32_t flags) -> bool;
+
+        // Frustum query with the same contract as Frustum_Culler::cull
+        auto cull(const Render_Proxies& proxies, Render_View& view) const -> void;
+        // Rows whose bounds touch a sphere, e.g. a point light's range
+        auto query_sphere(const Render_Proxies& proxies, const math::Vec3& center, float radius, uint32_t required_flags,
+                          std::vector<uint32_t>& rows) const -> void;
+
+        auto size() const -> std::size_t { return leaf_count_; }
+        auto get_height() const -> int32_t;
+        // Summed surface area of the inner nodes relative to the root's; lower is better
+        auto get_cost() const -> float;
+        auto get_rebuild_count() const -> uint64_t { return rebuild_count_; }
+        // Leaves the last sync() found outside their fat box
+        auto get_last_moved_count() const -> std::size_t { return last_moved_count_; }
+
+        // Checks links, heights, boxes and flags; for tests
+        auto validate(const Render_Proxies& proxies) const -> bool;
+
+    private:
+        static constexpr int32_t NULL_NODE = -1;
+
+        struct Node
+        {
+            math::Vec3 min{0.0f, 0.0f, 0.0f};
+            math::Vec3 max{0.0f, 0.0f, 0.0f};
+            int32_t parent = NULL_NODE;     // next free node while on the free list
+            int32_t child1 = NULL_NODE;
+            int32_t child2 = NULL_NODE;
+            int32_t height = 0;             // 0 for leaves, -1 while free
+            uint32_t row = 0;               // leaves only
+            uint32_t flags = 0;
+
+            auto is_leaf() const -> bool { return child1 == NULL_NODE; }
+        };
+
+        struct Build_Item
+        {
+            uint32_t code;      // Morton code of the bounds center
+            uint32_t row;
+        };
+
+        auto allocate_node() -> int32_t;
+        auto free_node(int32_t index) -> void;
+        auto set_leaf_box(Node& leaf, const math::Vec3& center, const math::Vec3& extents) const -> void;
+        auto insert_leaf(int32_t leaf) -> void;
+        auto remove_leaf(int32_t leaf) -> void;
+        auto balance(int32_t index) -> int32_t;
+        auto refit_node(int32_t index) -> void;
+        auto refit_moved() -> void;
+        auto sort_build_items() -> void;
+        auto build(const Render_Proxies& proxies, int32_t first, std::size_t begin, std::size_t end, int32_t parent, uint32_t depth) -> void;
+        auto should_rebuild(std::size_t churn, std::size_t count) const -> bool;
+
+        Render_Bvh_Settings settings_;
+        std::vector<Node> nodes_;
+        std::vector<int32_t> leaf_of_row_;
+        int32_t root_ = NULL_NODE;
+        int32_t free_list_ = NULL_NODE;
+        std::size_t leaf_count_ = 0;
+
+        std::size_t churn_ = 0;                 // leaves moved, inserted or removed since the last build
+        float built_cost_ = 0.0f;
+        uint32_t syncs_since_cost_check_ = 0;
+        uint64_t rebuild_count_ = 0;
+        std::size_t last_moved_count_ = 0;
+
+        // Scratch reused across sync() and rebuild()
+        std::vector<uint32_t> changed_rows_;
+        std::vector<uint8_t> escaped_;
+        std::vector<int32_t> moved_;
+        std::vector<int32_t> refit_nodes_;
+        std::vector<int32_t> refit_order_;
+        std::vector<uint8_t> refit_marked_;
+        std::vector<Build_Item> build_items_;
+        std::vector<Build_Item> sort_scratch_;
+    };
+}
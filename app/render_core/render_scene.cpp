@@ -1 +1,174 @@
 #include "render_core/render_scene.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+
+namespace mango::app
+{
+    auto Render_Bounds_Columns::operator[](std::size_t row) const -> Render_Bounds
+    {
+        Render_Bounds bound;
+        bound.center = math::Vec3(center_x[row], center_y[row], center_z[row]);
+        bound.extents = math::Vec3(extent_x[row], extent_y[row], extent_z[row]);
+        bound.radius = radius[row];
+        return bound;
+    }
+
+    auto Render_Bounds_Columns::set(std::size_t row, const Render_Bounds& bound) -> void
+    {
+        center_x[row] = bound.center.x;
+        center_y[row] = bound.center.y;
+        center_z[row] = bound.center.z;
+        extent_x[row] = bound.extents.x;
+        extent_y[row] = bound.extents.y;
+        extent_z[row] = bound.extents.z;
+        radius[row] = bound.radius;
+    }
+
+    auto Render_Bounds_Columns::push_back(const Render_Bounds& bound) -> void
+    {
+        center_x.push_back(bound.center.x);
+        center_y.push_back(bound.center.y);
+        center_z.push_back(bound.center.z);
+        extent_x.push_back(bound.extents.x);
+        extent_y.push_back(bound.extents.y);
+        extent_z.push_back(bound.extents.z);
+        radius.push_back(bound.radius);
+    }
+
+    auto Render_Bounds_Columns::pop_back() -> void
+    {
+        resize(size() - 1);
+    }
+
+    auto Render_Bounds_Columns::copy_range(const Render_Bounds_Columns& source, std::size_t begin, std::size_t end) -> void
+    {
+        auto copy = [&](const std::vector<float>& from, std::vector<float>& to) {
+            std::copy(from.begin() + static_cast<std::ptrdiff_t>(begin), from.begin() + static_cast<std::ptrdiff_t>(end),
+                      to.begin() + static_cast<std::ptrdiff_t>(begin));
+        };
+        copy(source.center_x, center_x);
+        copy(source.center_y, center_y);
+        copy(source.center_z, center_z);
+        copy(source.extent_x, extent_x);
+        copy(source.extent_y, extent_y);
+        copy(source.extent_z, extent_z);
+        copy(source.radius, radius);
+    }
+
+    auto Render_Bounds_Columns::resize(std::size_t count) -> void
+    {
+        for (auto* column : { &center_x, &center_y, &center_z, &extent_x, &extent_y, &extent_z, &radius }) {
+            column->resize(count);
+        }
+    }
+
+    auto Render_Bounds_Columns::reserve(std::size_t count) -> void
+    {
+        for (auto* column : { &center_x, &center_y, &center_z, &extent_x, &extent_y, &extent_z, &radius }) {
+            column->reserve(count);
+        }
+    }
+
+    auto Render_Bounds_Columns::clear() -> void
+    {
+        for (auto* column : { &center_x, &center_y, &center_z, &extent_x, &extent_y, &extent_z, &radius }) {
+            column->clear();
+        }
+    }
+
+    auto Render_Proxies::push(const math::Mat4& world, const resource::Mesh_Data* mesh, uint32_t material_index,
+                              const Render_Bounds& bound, uint32_t flag, uint64_t entity_id) -> void
+    {
+        world_matrices.push_back(world);
+        meshes.push_back(mesh);
+        material_indices.push_back(material_index);
+        bounds.push_back(bound);
+        flags.push_back(flag);
+        entity_ids.push_back(entity_id);
+    }
+
+    auto Render_Proxies::assign(std::size_t row, const math::Mat4& world, const resource::Mesh_Data* mesh, uint32_t material_index,
+                                const Render_Bounds& bound, uint32_t flag, uint64_t entity_id) -> void
+    {
+        world_matrices[row] = world;
+        meshes[row] = mesh;
+        material_indices[row] = material_index;
+        bounds.set(row, bound);
+        flags[row] = flag;
+        entity_ids[row] = entity_id;
+    }
+
+    auto Render_Proxies::move(std::size_t from, std::size_t to) -> void
+    {
+        world_matrices[to] = world_matrices[from];
+        meshes[to] = meshes[from];
+        material_indices[to] = material_indices[from];
+        bounds.set(to, bounds[from]);
+        flags[to] = flags[from];
+        entity_ids[to] = entity_ids[from];
+    }
+
+    auto Render_Proxies::pop_back() -> void
+    {
+        world_matrices.pop_back();
+        meshes.pop_back();
+        material_indices.pop_back();
+        bounds.pop_back();
+        flags.pop_back();
+        entity_ids.pop_back();
+    }
+
+    auto Render_Proxies::copy_range(const Render_Proxies& source, std::size_t begin, std::size_t end) -> void
+    {
+        auto from = static_cast<std::ptrdiff_t>(begin);
+        auto to = static_cast<std::ptrdiff_t>(end);
+        std::copy(source.world_matrices.begin() + from, source.world_matrices.begin() + to, world_matrices.begin() + from);
+        std::copy(source.meshes.begin() + from, source.meshes.begin() + to, meshes.begin() + from);
+        std::copy(source.material_indices.begin() + from, source.material_indices.begin() + to, material_indices.begin() + from);
+        bounds.copy_range(source.bounds, begin, end);
+        std::copy(source.flags.begin() + from, source.flags.begin() + to, flags.begin() + from);
+        std::copy(source.entity_ids.begin() + from, source.entity_ids.begin() + to, entity_ids.begin() + from);
+    }
+
+    auto Render_Proxies::resize(std::size_t count) -> void
+    {
+        world_matrices.resize(count);
+        meshes.resize(count);
+        material_indices.resize(count);
+        bounds.resize(count);
+        flags.resize(count);
+        entity_ids.resize(count);
+    }
+
+    auto Render_Proxies::reserve(std::size_t count) -> void
+    {
+        world_matrices.reserve(count);
+        meshes.reserve(count);
+        material_indices.reserve(count);
+        bounds.reserve(count);
+        flags.reserve(count);
+        entity_ids.reserve(count);
+    }
+
+    auto Render_Proxies::clear() -> void
+    {
+        world_matrices.clear();
+        meshes.clear();
+        material_indices.clear();
+        bounds.clear();
+        flags.clear();
+        entity_ids.clear();
+    }
+
+    auto Render_Scene::clear() -> void
+    {
+        proxies.clear();
+        materials.clear();
+        lights.clear();
+        camera = {};
+        dirty_proxies.clear();
+        dirty_materials.clear();
+        lights_dirty = false;
+    }
+}
@@ -1,25 +1,133 @@
 #pragma once
 
+#include "math/math.hpp"
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 
+namespace mango::resource
+{
+    struct Mesh_Data;
+}
+
 namespace mango::app
 {
-    struct Render_Mesh_Instance
+    enum Render_Proxy_Flags : uint32_t
+    {
+        RENDER_PROXY_CASTS_SHADOW = 1u << 0,
+        RENDER_PROXY_OWN_MATERIAL = 1u << 1,    // material_index points at the entity's Pbr_Material
+    };
+
+    // World-space bounds: AABB center/extents plus the enclosing sphere radius
+    struct Render_Bounds
+    {
+        math::Vec3 center{0.0f, 0.0f, 0.0f};
+        float radius = 0.0f;
+        math::Vec3 extents{0.0f, 0.0f, 0.0f};
+        float padding = 0.0f;
+    };
+
+    // Render_Bounds split into one array per component so culling can load several boxes
+    // per register. operator[] reassembles a row by value.
+    struct Render_Bounds_Columns
+    {
+        std::vector<float> center_x;
+        std::vector<float> center_y;
+        std::vector<float> center_z;
+        std::vector<float> extent_x;
+        std::vector<float> extent_y;
+        std::vector<float> extent_z;
+        std::vector<float> radius;
+
+        auto size() const -> std::size_t { return radius.size(); }
+        auto operator[](std::size_t row) const -> Render_Bounds;
+
+        auto set(std::size_t row, const Render_Bounds& bound) -> void;
+        auto push_back(const Render_Bounds& bound) -> void;
+        auto pop_back() -> void;
+        auto copy_range(const Render_Bounds_Columns& source, std::size_t begin, std::size_t end) -> void;
+        auto resize(std::size_t count) -> void;
+        auto reserve(std::size_t count) -> void;
+        auto clear() -> void;
+    };
+
+    // Same layout as the Material entries of the instance set read by pbr.vert
+    struct Render_Material
     {
-        uint64_t entity_id = 0;
-        uint32_t material_slot = 0;
+        math::Vec4 base_color{1.0f, 1.0f, 1.0f, 1.0f};
+        math::Vec4 params{0.0f, 0.5f, 1.0f, 0.0f};     // x=metallic, y=roughness, z=ao, w=emissive_strength
     };
 
-    struct Render_Point_Light
+    // Same layout as one entry of the lights UBO
+    struct Render_Light
     {
-        uint64_t entity_id = 0;
-        float intensity = 0.0f;
+        math::Vec4 position_type;       // xyz=position/direction, w=type (0=dir,1=point,2=spot)
+        math::Vec4 color_intensity;     // xyz=color, w=intensity
+        math::Vec4 params;              // xyz=spot_direction, w=range
+        math::Vec4 spot_params;         // x=inner_cos, y=outer_cos, zw=unused
     };
 
+    // Half-open row range [begin, end)
+    struct Render_Range
+    {
+        uint32_t begin = 0;
+        uint32_t end = 0;
+    };
+
+    struct Render_Camera
+    {
+        math::Mat4 view{1.0f};
+        math::Mat4 proj{1.0f};
+        math::Mat4 view_proj{1.0f};
+        math::Vec4 position{0.0f, 0.0f, 0.0f, 1.0f};
+        bool valid = false;
+    };
+
+    // One row per draw, stored column-wise so passes touch only the arrays they need.
+    // meshes[i] is a non-owning key valid while the World that produced it is unchanged.
+    struct Render_Proxies
+    {
+        std::vector<math::Mat4> world_matrices;
+        std::vector<const resource::Mesh_Data*> meshes;
+        std::vector<uint32_t> material_indices;
+        Render_Bounds_Columns bounds;
+        std::vector<uint32_t> flags;
+        std::vector<uint64_t> entity_ids;
+
+        auto size() const -> std::size_t { return meshes.size(); }
+        auto empty() const -> bool { return meshes.empty(); }
+
+        auto push(const math::Mat4& world, const resource::Mesh_Data* mesh, uint32_t material_index,
+                  const Render_Bounds& bound, uint32_t flag, uint64_t entity_id) -> void;
+        auto assign(std::size_t row, const math::Mat4& world, const resource::Mesh_Data* mesh, uint32_t material_index,
+                    const Render_Bounds& bound, uint32_t flag, uint64_t entity_id) -> void;
+        // Copies row from over row to; the caller pops or reuses from
+        auto move(std::size_t from, std::size_t to) -> void;
+        auto pop_back() -> void;
+        // Copies rows [begin, end) of source over the same rows here
+        auto copy_range(const Render_Proxies& source, std::size_t begin, std::size_t end) -> void;
+        auto resize(std::size_t count) -> void;
+        auto reserve(std::size_t count) -> void;
+        auto clear() -> void;
+    };
+
+    // Snapshot of everything the renderer draws in one frame. Keeps its capacity across
+    // clear() so extracting into the same instance every frame does not allocate.
     struct Render_Scene
     {
-        std::vector<Render_Mesh_Instance> mesh_instances;
-        std::vector<Render_Point_Light> point_lights;
+        static constexpr uint32_t DEFAULT_MATERIAL = 0;
+
+        Render_Proxies proxies;
+        std::vector<Render_Material> materials;     // [DEFAULT_MATERIAL] is the default material
+        std::vector<Render_Light> lights;
+        Render_Camera camera;
+
+        // What the last extraction rewrote, as sorted disjoint row ranges below the current
+        // sizes, so uploads can skip rows that did not change
+        std::vector<Render_Range> dirty_proxies;
+        std::vector<Render_Range> dirty_materials;
+        bool lights_dirty = false;
+
+        auto clear() -> void;
     };
 }
@@ -0,0 +1,183 @@
+#include "render_core/render_scene_buffer.hpp"
+#include "resource/mesh.hpp"
+#include <algorithm>
+
+namespace mango::app
+{
+    namespace
+    {
+        auto merge_ranges(std::vector<Render_Range>& ranges) -> void
+        {
+            std::sort(ranges.begin(), ranges.end(), [](const Render_Range& a, const Render_Range& b) { return a.begin < b.begin; });
+            std::size_t kept = 0;
+            for (const auto& range : ranges) {
+                if (kept > 0 && range.begin <= ranges[kept - 1].end) {
+                    ranges[kept - 1].end = std::max(ranges[kept - 1].end, range.end);
+                } else {
+                    ranges[kept++] = range;
+                }
+            }
+            ranges.resize(kept);
+        }
+    }
+
+    Render_Scene_Buffer::Render_Scene_Buffer(uint32_t slot_count)
+        : slots_(std::clamp(slot_count, MIN_SLOTS, MAX_SLOTS))
+    {
+    }
+
+    auto Render_Scene_Buffer::publish(const Render_Scene& source, const Frame_Context& context) -> bool
+    {
+        uint32_t index = NO_SLOT;
+        {
+            std::unique_lock lock(mutex_);
+            auto find_free = [&] {
+                // The most recently written free slot has the fewest rows to catch up on
+                index = NO_SLOT;
+                for (uint32_t i = 0; i < slots_.size(); ++i) {
+                    if (slots_[i].state == Slot_State::free && (index == NO_SLOT || slots_[i].serial > slots_[index].serial)) {
+                        index = i;
+                    }
+                }
+                return index != NO_SLOT;
+            };
+            slot_freed_.wait(lock, [&] { return closed_ || find_free(); });
+            if (closed_) {
+                return false;
+            }
+            slots_[index].state = Slot_State::writing;
+        }
+
+        // The slot is ours until it is queued
+        record_changes(source);
+        auto& slot = slots_[index];
+        last_copied_rows_ = copy_into(slot, source);
+        slot.changed_proxies.assign(source.dirty_proxies.begin(), source.dirty_proxies.end());
+        slot.context = context;
+        slot.context.scene = &slot.scene;
+        slot.context.changed_proxies = &slot.changed_proxies;
+
+        {
+            std::lock_guard lock(mutex_);
+            slot.state = Slot_State::queued;
+            queued_.push_back(index);
+        }
+        frame_queued_.notify_one();
+        return true;
+    }
+
+    auto Render_Scene_Buffer::acquire(Frame_Context& context) -> bool
+    {
+        std::unique_lock lock(mutex_);
+        frame_queued_.wait(lock, [&] { return closed_ || !queued_.empty(); });
+        if (queued_.empty()) {
+            return false;
+        }
+        reading_ = queued_.front();
+        queued_.pop_front();
+        slots_[reading_].state = Slot_State::reading;
+        context = slots_[reading_].context;
+        return true;
+    }
+
+    auto Render_Scene_Buffer::release() -> void
+    {
+        {
+            std::lock_guard lock(mutex_);
+            if (reading_ == NO_SLOT) {
+                return;
+            }
+            slots_[reading_].state = Slot_State::free;
+            reading_ = NO_SLOT;
+        }
+        slot_freed_.notify_one();
+    }
+
+    auto Render_Scene_Buffer::close() -> void
+    {
+        {
+            std::lock_guard lock(mutex_);
+            closed_ = true;
+        }
+        slot_freed_.notify_all();
+        frame_queued_.notify_all();
+    }
+
+    auto Render_Scene_Buffer::record_changes(const Render_Scene& source) -> void
+    {
+        // Reuse the oldest entry's storage once the history is full
+        Frame_Changes changes;
+        if (history_.size() == HISTORY_LENGTH) {
+            changes = std::move(history_.front());
+            history_.pop_front();
+        }
+        changes.serial = ++serial_;
+        changes.proxies.assign(source.dirty_proxies.begin(), source.dirty_proxies.end());
+        changes.materials.assign(source.dirty_materials.begin(), source.dirty_materials.end());
+        changes.lights = source.lights_dirty;
+        history_.push_back(std::move(changes));
+    }
+
+    auto Render_Scene_Buffer::copy_into(Slot& slot, const Render_Scene& source) -> std::size_t
+    {
+        auto& scene = slot.scene;
+        const auto proxy_count = source.proxies.size();
+        const auto material_count = source.materials.size();
+
+        scene.dirty_proxies.clear();
+        scene.dirty_materials.clear();
+        scene.lights_dirty = false;
+
+        // history_.back() is this publish; the slot needs every entry after its serial
+        bool full = slot.serial == 0 || slot.serial + 1 < history_.front().serial;
+        if (full) {
+            scene.dirty_proxies.push_back({ 0, static_cast<uint32_t>(proxy_count) });
+            scene.dirty_materials.push_back({ 0, static_cast<uint32_t>(material_count) });
+            scene.lights_dirty = true;
+        } else {
+            for (const auto& changes : history_) {
+                if (changes.serial <= slot.serial) {
+                    continue;
+                }
+                scene.dirty_proxies.insert(scene.dirty_proxies.end(), changes.proxies.begin(), changes.proxies.end());
+                scene.dirty_materials.insert(scene.dirty_materials.end(), changes.materials.begin(), changes.materials.end());
+                scene.lights_dirty = scene.lights_dirty || changes.lights;
+            }
+        }
+
+        // Rows past the new size were removed; clip and merge what is left
+        auto clip = [](std::vector<Render_Range>& ranges, std::size_t count) {
+            for (auto& range : ranges) {
+                range.end = std::min(range.end, static_cast<uint32_t>(count));
+            }
+            ranges.erase(std::remove_if(ranges.begin(), ranges.end(), [](const Render_Range& range) { return range.begin >= range.end; }),
+                         ranges.end());
+            merge_ranges(ranges);
+        };
+        clip(scene.dirty_proxies, proxy_count);
+        clip(scene.dirty_materials, material_count);
+
+        scene.proxies.resize(proxy_count);
+        slot.mesh_refs.resize(proxy_count);
+        scene.materials.resize(material_count);
+
+        std::size_t copied = 0;
+        for (const auto& range : scene.dirty_proxies) {
+            scene.proxies.copy_range(source.proxies, range.begin, range.end);
+            for (auto row = range.begin; row < range.end; ++row) {
+                slot.mesh_refs[row] = source.proxies.meshes[row]->weak_from_this().lock();
+            }
+            copied += range.end - range.begin;
+        }
+        for (const auto& range : scene.dirty_materials) {
+            std::copy(source.materials.begin() + range.begin, source.materials.begin() + range.end, scene.materials.begin() + range.begin);
+        }
+        if (scene.lights_dirty) {
+            scene.lights = source.lights;
+        }
+        scene.camera = source.camera;
+
+        slot.serial = serial_;
+        return copied;
+    }
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "render_core/frame_context.hpp"
+#include "render_core/render_scene.hpp"
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace mango::app
+{
+    // Hands Render_Scene snapshots from the simulation thread to the render thread.
+    // publish() copies the extracted scene into a free slot and queues it with its
+    // Frame_Context; acquire() hands the oldest queued slot to the renderer, which reads it
+    // through Frame_Context::scene until release(). With N slots the simulation runs at most
+    // N - 1 frames ahead of recording and blocks in publish() beyond that.
+    // A slot is brought up to date by copying only the proxy and material rows in the dirty
+    // ranges of the frames it missed, so publish() has to follow every extract(). The slot's
+    // own dirty ranges then list exactly the rows that differ from its previous contents;
+    // Frame_Context::changed_proxies lists the rows that differ from the previous frame.
+    // Each slot holds a reference to every mesh it draws, so the World may drop a Mesh while
+    // an older frame is still being recorded.
+    class Render_Scene_Buffer
+    {
+    public:
+        static constexpr uint32_t MIN_SLOTS = 2;
+        static constexpr uint32_t MAX_SLOTS = 3;
+
+        // 2 = double buffered, 3 = triple buffered
+        explicit Render_Scene_Buffer(uint32_t slot_count = MIN_SLOTS);
+
+        Render_Scene_Buffer(const Render_Scene_Buffer&) = delete;
+        Render_Scene_Buffer& operator=(const Render_Scene_Buffer&) = delete;
+
+        // Simulation thread. Blocks while no slot is free; returns false once closed
+        auto publish(const Render_Scene& source, const Frame_Context& context) -> bool;
+
+        // Render thread. Blocks for the next queued frame; returns false once closed and drained
+        auto acquire(Frame_Context& context) -> bool;
+        auto release() -> void;
+
+        // Wakes both sides: publish() fails from now on, acquire() drains what is queued
+        auto close() -> void;
+
+        auto get_slot_count() const -> uint32_t { return static_cast<uint32_t>(slots_.size()); }
+
+        // Proxy rows the last publish() copied
+        auto get_last_copied_rows() const -> std::size_t { return last_copied_rows_; }
+
+    private:
+        static constexpr uint32_t NO_SLOT = 0xFFFFFFFF;
+        static constexpr std::size_t HISTORY_LENGTH = 8;
+
+        enum class Slot_State
+        {
+            free,
+            writing,
+            queued,
+            reading,
+        };
+
+        struct Slot
+        {
+            Render_Scene scene;
+            std::vector<std::shared_ptr<const resource::Mesh_Data>> mesh_refs;     // parallel to proxies
+            std::vector<Render_Range> changed_proxies;      // the source's own dirty ranges at publish()
+            Frame_Context context;
+            uint64_t serial = 0;                // publish() the contents match; 0 when never written
+            Slot_State state = Slot_State::free;
+        };
+
+        // Rows one publish() changed
+        struct Frame_Changes
+        {
+            uint64_t serial = 0;
+            std::vector<Render_Range> proxies;
+            std::vector<Render_Range> materials;
+            bool lights = false;
+        };
+
+        auto record_changes(const Render_Scene& source) -> void;
+        auto copy_into(Slot& slot, const Render_Scene& source) -> std::size_t;
+
+        std::vector<Slot> slots_;
+        std::deque<uint32_t> queued_;
+        std::deque<Frame_Changes> history_;     // oldest first; producer side only
+        uint64_t serial_ = 0;
+        std::size_t last_copied_rows_ = 0;
+        uint32_t reading_ = NO_SLOT;
+        bool closed_ = false;
+
+        std::mutex mutex_;
+        std::condition_variable slot_freed_;
+        std::condition_variable frame_queued_;
+    };
+}
@@ -1,13 +1,384 @@
 #include "render_core/render_scene_extractor.hpp"
 #include "core/manager/world.hpp"
-#include "core/manager/scene-graph.hpp"
+#include "resource/camera.hpp"
+#include "resource/light.hpp"
+#include "resource/material.hpp"
+#include "resource/mesh.hpp"
+#include "resource/model.hpp"
+#include "resource/transform.hpp"
+#include "resource/world_transform.hpp"
+#include <algorithm>
+#include <cmath>
 
 namespace mango::app
 {
-    auto Render_Scene_Extractor::extract(const core::World& world, const core::Scene_Graph& graph) -> Render_Scene
+    namespace
     {
-        (void)world;
-        (void)graph;
-        return {};
+        using World_Transform_Store = core::TwigStorage<resource::World_Transform>;
+
+        auto pack_light(const resource::Light& light, const math::Vec3& position) -> Render_Light
+        {
+            Render_Light packed{};
+            if (light.type == resource::Light_Type::directional) {
+                auto dir = glm::normalize(light.direction);
+                packed.position_type = {dir.x, dir.y, dir.z, 0.0f};
+            } else {
+                packed.position_type = {position.x, position.y, position.z, static_cast<float>(static_cast<int>(light.type))};
+            }
+            packed.color_intensity = {light.color.x, light.color.y, light.color.z, light.intensity};
+            packed.params = {light.direction.x, light.direction.y, light.direction.z, light.range};
+            packed.spot_params = {std::cos(glm::radians(light.inner_angle)), std::cos(glm::radians(light.outer_angle)), 0.0f, 0.0f};
+            return packed;
+        }
+    }
+
+    auto Render_Scene_Extractor::transform_bounds(const math::Mat4& world, const math::Vec3& local_min, const math::Vec3& local_max) -> Render_Bounds
+    {
+        math::Vec3 center = (local_min + local_max) * 0.5f;
+        math::Vec3 half = (local_max - local_min) * 0.5f;
+
+        Render_Bounds bounds;
+        bounds.center = math::Vec3(world * math::Vec4(center, 1.0f));
+        // Extents of the rotated box along each world axis (Arvo)
+        for (int axis = 0; axis < 3; ++axis) {
+            bounds.extents[axis] = std::abs(world[0][axis]) * half.x
+                                 + std::abs(world[1][axis]) * half.y
+                                 + std::abs(world[2][axis]) * half.z;
+        }
+        bounds.radius = std::sqrt(bounds.extents.x * bounds.extents.x
+                                + bounds.extents.y * bounds.extents.y
+                                + bounds.extents.z * bounds.extents.z);
+        return bounds;
+    }
+
+    auto Render_Scene_Extractor::extract(core::World& world) -> std::size_t
+    {
+        auto since = last_sync_;
+        last_sync_ = world.advance_tick();
+        scene_.dirty_proxies.clear();
+        scene_.dirty_materials.clear();
+        scene_.lights_dirty = false;
+
+        // Detached or destroyed twigs; a trimmed log means the gap is too old to patch
+        pending_.clear();
+        bool full = since == 0
+            || !world.removed_since<resource::World_Transform>(since, pending_)
+            || !world.removed_since<resource::Mesh>(since, pending_)
+            || !world.removed_since<resource::Model>(since, pending_)
+            || !world.removed_since<resource::Pbr_Material>(since, pending_);
+        if (full) {
+            rebuild(world);
+            pack_lights(world);
+            pack_camera(world);
+            return scene_.proxies.size();
+        }
+
+        // Material values are patched in place; only gaining a material moves a proxy's index
+        world.each_changed_since<resource::Pbr_Material>(since, [&](core::Entity entity, resource::Pbr_Material&) {
+            if (!material_of_entity_.contains(entity)) {
+                pending_.push_back(entity);
+            }
+            sync_material(world, entity);
+        });
+
+        auto collect = [&](core::Entity entity, const auto&) { pending_.push_back(entity); };
+        world.each_changed_since<resource::World_Transform>(since, collect);
+        world.each_changed_since<resource::Mesh>(since, collect);
+        world.each_changed_since<resource::Model>(since, collect);
+
+        std::sort(pending_.begin(), pending_.end(), [](core::Entity a, core::Entity b) { return a.id < b.id; });
+        pending_.erase(std::unique(pending_.begin(), pending_.end()), pending_.end());
+        for (auto entity : pending_) {
+            sync_entity(world, entity);
+        }
+        auto rewritten = dirty_rows_.size();
+
+        // Lights are few; repack them all when any of them was written or moved
+        auto changed = [since](const core::ITwigStorage* store) { return store && store->get_change_version() >= since; };
+        const auto* lights = world.get_twig_storage<resource::Light>();
+        const auto* world_transforms = world.get_twig_storage<resource::World_Transform>();
+        const auto* transforms = world.get_twig_storage<resource::Transform>();
+        bool relight = changed(lights);
+        if (!relight && lights && (changed(world_transforms) || changed(transforms))) {
+            for (auto entity : lights->get_entities()) {
+                if ((world_transforms && world_transforms->get_change_tick(entity) >= since)
+                    || (transforms && transforms->get_change_tick(entity) >= since)) {
+                    relight = true;
+                    break;
+                }
+            }
+        }
+        if (relight) {
+            pack_lights(world);
+        }
+        pack_camera(world);
+        finish_ranges();
+        return rewritten;
+    }
+
+    auto Render_Scene_Extractor::reset() -> void
+    {
+        scene_.clear();
+        scene_.lights_dirty = true;     // consumers holding older lights must drop them
+        rows_of_entity_.clear();
+        material_of_entity_.clear();
+        free_materials_.clear();
+        dirty_rows_.clear();
+        row_marked_.clear();
+        dirty_materials_.clear();
+        last_sync_ = 0;
+    }
+
+    auto Render_Scene_Extractor::rebuild(core::World& world) -> void
+    {
+        scene_.proxies.clear();
+        scene_.materials.assign(1, Render_Material{});
+        rows_of_entity_.clear();
+        material_of_entity_.clear();
+        free_materials_.clear();
+
+        const auto* materials = world.get_twig_storage<resource::Pbr_Material>();
+        const auto* meshes = world.get_twig_storage<resource::Mesh>();
+        const auto* models = world.get_twig_storage<resource::Model>();
+
+        if (materials) {
+            scene_.materials.reserve(1 + materials->size());
+            for (auto entity : materials->get_entities()) {
+                sync_material(world, entity);
+            }
+        }
+
+        std::size_t proxy_count = meshes ? meshes->size() : 0;
+        if (models) {
+            for (const auto& model : models->get_data()) {
+                proxy_count += model.get_instances().size();
+            }
+        }
+        scene_.proxies.reserve(proxy_count);
+
+        // An entity with both a Mesh and a Model is visited twice; the second pass rewrites in place
+        if (meshes) {
+            for (auto entity : meshes->get_entities()) {
+                sync_entity(world, entity);
+            }
+        }
+        if (models) {
+            for (auto entity : models->get_entities()) {
+                sync_entity(world, entity);
+            }
+        }
+
+        dirty_rows_.clear();
+        row_marked_.clear();
+        dirty_materials_.clear();
+        if (!scene_.proxies.empty()) {
+            scene_.dirty_proxies.push_back({ 0, static_cast<uint32_t>(scene_.proxies.size()) });
+        }
+        scene_.dirty_materials.push_back({ 0, static_cast<uint32_t>(scene_.materials.size()) });
+    }
+
+    auto Render_Scene_Extractor::sync_material(const core::World& world, core::Entity entity) -> uint32_t
+    {
+        const auto* materials = world.get_twig_storage<resource::Pbr_Material>();
+        const auto* material = materials ? materials->get(entity) : nullptr;
+        auto it = material_of_entity_.find(entity);
+
+        if (!material) {
+            if (it == material_of_entity_.end()) {
+                return Render_Scene::DEFAULT_MATERIAL;
+            }
+            scene_.materials[it->second] = Render_Material{};
+            dirty_materials_.push_back(it->second);
+            free_materials_.push_back(it->second);
+            material_of_entity_.erase(it);
+            return Render_Scene::DEFAULT_MATERIAL;
+        }
+
+        uint32_t index;
+        if (it != material_of_entity_.end()) {
+            index = it->second;
+        } else if (!free_materials_.empty()) {
+            index = free_materials_.back();
+            free_materials_.pop_back();
+            material_of_entity_.emplace(entity, index);
+        } else {
+            index = static_cast<uint32_t>(scene_.materials.size());
+            scene_.materials.emplace_back();
+            material_of_entity_.emplace(entity, index);
+        }
+        scene_.materials[index] = { material->base_color, material->params };
+        dirty_materials_.push_back(index);
+        return index;
+    }
+
+    auto Render_Scene_Extractor::sync_entity(const core::World& world, core::Entity entity) -> void
+    {
+        const auto* world_transforms = world.get_twig_storage<resource::World_Transform>();
+        const auto* materials = world.get_twig_storage<resource::Pbr_Material>();
+        const auto* meshes = world.get_twig_storage<resource::Mesh>();
+        const auto* models = world.get_twig_storage<resource::Model>();
+
+        auto known_material = material_of_entity_.find(entity);
+        auto material = known_material != material_of_entity_.end() ? known_material->second : Render_Scene::DEFAULT_MATERIAL;
+        if ((materials && materials->has(entity)) != (known_material != material_of_entity_.end())) {
+            material = sync_material(world, entity);
+        }
+
+        // Entities without a World_Transform have not been placed yet and get no proxies
+        staged_.clear();
+        auto slot = world_transforms ? world_transforms->find_slot(entity) : World_Transform_Store::INVALID_SLOT;
+        if (slot != World_Transform_Store::INVALID_SLOT) {
+            const auto& matrix = world_transforms->get_data()[slot].matrix;
+            auto flags = RENDER_PROXY_CASTS_SHADOW | (material != Render_Scene::DEFAULT_MATERIAL ? RENDER_PROXY_OWN_MATERIAL : 0u);
+            auto stage = [&](const resource::Mesh_Data* mesh_data) {
+                if (mesh_data && !mesh_data->vertices.empty()) {
+                    staged_.push(matrix, mesh_data, material,
+                                 transform_bounds(matrix, mesh_data->bounds_min, mesh_data->bounds_max),
+                                 flags, entity.id);
+                }
+            };
+            if (const auto* mesh = meshes ? meshes->get(entity) : nullptr) {
+                stage(mesh->get_data().get());
+            }
+            if (const auto* model = models ? models->get(entity) : nullptr) {
+                for (const auto& instance : model->get_instances()) {
+                    stage(instance.mesh ? instance.mesh->get_data().get() : nullptr);
+                }
+            }
+        }
+
+        auto it = rows_of_entity_.find(entity);
+        if (it == rows_of_entity_.end()) {
+            if (staged_.empty()) {
+                return;
+            }
+            it = rows_of_entity_.emplace(entity, std::vector<uint32_t>{}).first;
+        }
+        auto& rows = it->second;
+
+        auto write = [&](std::size_t row, std::size_t i) {
+            scene_.proxies.assign(row, staged_.world_matrices[i], staged_.meshes[i], staged_.material_indices[i],
+                                  staged_.bounds[i], staged_.flags[i], staged_.entity_ids[i]);
+            mark_row(static_cast<uint32_t>(row));
+        };
+
+        // Same proxy count (a move or a material swap) rewrites the rows in place
+        if (rows.size() == staged_.size()) {
+            for (std::size_t i = 0; i < rows.size(); ++i) {
+                write(rows[i], i);
+            }
+            return;
+        }
+
+        // Highest first, so the row moved into each hole never belongs to this entity
+        std::sort(rows.begin(), rows.end(), std::greater<>{});
+        for (auto row : rows) {
+            remove_row(row);
+        }
+        rows.clear();
+
+        for (std::size_t i = 0; i < staged_.size(); ++i) {
+            auto row = scene_.proxies.size();
+            scene_.proxies.push(staged_.world_matrices[i], staged_.meshes[i], staged_.material_indices[i],
+                                staged_.bounds[i], staged_.flags[i], staged_.entity_ids[i]);
+            rows.push_back(static_cast<uint32_t>(row));
+            mark_row(static_cast<uint32_t>(row));
+        }
+        if (rows.empty()) {
+            rows_of_entity_.erase(it);
+        }
+    }
+
+    auto Render_Scene_Extractor::remove_row(uint32_t row) -> void
+    {
+        auto last = static_cast<uint32_t>(scene_.proxies.size() - 1);
+        if (row != last) {
+            scene_.proxies.move(last, row);
+            auto owner = core::Entity{ static_cast<core::Entity::Id>(scene_.proxies.entity_ids[row]) };
+            auto& owner_rows = rows_of_entity_.find(owner)->second;
+            std::replace(owner_rows.begin(), owner_rows.end(), last, row);
+            mark_row(row);
+        }
+        scene_.proxies.pop_back();
+    }
+
+    auto Render_Scene_Extractor::mark_row(uint32_t row) -> void
+    {
+        if (row >= row_marked_.size()) {
+            row_marked_.resize(row + 1, 0);
+        }
+        if (!row_marked_[row]) {
+            row_marked_[row] = 1;
+            dirty_rows_.push_back(row);
+        }
+    }
+
+    auto Render_Scene_Extractor::finish_ranges() -> void
+    {
+        auto to_ranges = [](std::vector<uint32_t>& rows, std::size_t limit, std::vector<Render_Range>& out) {
+            std::sort(rows.begin(), rows.end());
+            rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+            for (auto row : rows) {
+                if (row >= limit) {
+                    break;
+                }
+                if (!out.empty() && out.back().end == row) {
+                    ++out.back().end;
+                } else {
+                    out.push_back({ row, row + 1 });
+                }
+            }
+            rows.clear();
+        };
+
+        for (auto row : dirty_rows_) {
+            row_marked_[row] = 0;
+        }
+        to_ranges(dirty_rows_, scene_.proxies.size(), scene_.dirty_proxies);
+        to_ranges(dirty_materials_, scene_.materials.size(), scene_.dirty_materials);
+    }
+
+    auto Render_Scene_Extractor::pack_lights(const core::World& world) -> void
+    {
+        scene_.lights.clear();
+        scene_.lights_dirty = true;
+
+        const auto* lights = world.get_twig_storage<resource::Light>();
+        if (!lights) {
+            return;
+        }
+        const auto* world_transforms = world.get_twig_storage<resource::World_Transform>();
+        const auto* transforms = world.get_twig_storage<resource::Transform>();
+        scene_.lights.reserve(lights->size());
+        const auto& entities = lights->get_entities();
+        const auto& data = lights->get_data();
+        for (std::size_t i = 0; i < data.size(); ++i) {
+            math::Vec3 position(0.0f);
+            if (const auto* placed = world_transforms ? world_transforms->get(entities[i]) : nullptr) {
+                position = placed->get_position();
+            } else if (const auto* local = transforms ? transforms->get(entities[i]) : nullptr) {
+                position = local->position;
+            }
+            scene_.lights.push_back(pack_light(data[i], position));
+        }
+    }
+
+    auto Render_Scene_Extractor::pack_camera(const core::World& world) -> void
+    {
+        scene_.camera = {};
+        const auto* cameras = world.get_twig_storage<resource::Camera>();
+        const auto* transforms = world.get_twig_storage<resource::Transform>();
+        if (!cameras || cameras->empty() || !transforms) {
+            return;
+        }
+        auto camera_entity = cameras->get_entities().front();
+        const auto& camera = cameras->get_data().front();
+        if (const auto* camera_transform = transforms->get(camera_entity)) {
+            scene_.camera.view = camera.get_view_matrix(*camera_transform);
+            scene_.camera.proj = camera.get_projection_matrix();
+            scene_.camera.view_proj = scene_.camera.proj * scene_.camera.view;
+            scene_.camera.position = math::Vec4(camera_transform->position, 1.0f);
+            scene_.camera.valid = true;
+        }
     }
 }
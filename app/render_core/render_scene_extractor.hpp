@@ -1,18 +1,62 @@
 #pragma once
 
 #include "render_core/render_scene.hpp"
+#include "base/entity.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
 
 namespace mango::core
 {
     struct World;
-    struct Scene_Graph;
 }
 
 namespace mango::app
 {
+    // Keeps a Render_Scene in sync with the World across frames: one proxy per Mesh and
+    // per Model instance with a World_Transform, a material table fed by Pbr_Material,
+    // every Light packed for upload, and the first Camera.
+    // The first extract() builds everything; later calls read the twig change ticks and
+    // removal logs since the previous call and rewrite only the proxies of entities whose
+    // World_Transform, Mesh, Model or Pbr_Material was written, attached or removed.
+    // Removed proxies are swap-and-popped, so rows are not stable across calls. Material
+    // rows are stable while the entity keeps its Pbr_Material. Editing Mesh_Data in
+    // place is not tracked; re-attach the Mesh or mark it changed.
     class Render_Scene_Extractor
     {
     public:
-        static auto extract(const core::World& world, const core::Scene_Graph& graph) -> Render_Scene;
+        // Patches the scene and returns how many proxy rows were rewritten. Advances the
+        // World tick; run it after transform propagation.
+        auto extract(core::World& world) -> std::size_t;
+
+        auto get_scene() const -> const Render_Scene& { return scene_; }
+
+        // Forgets everything; the next extract() rebuilds the scene from scratch
+        auto reset() -> void;
+
+        // World-space bounds of a local AABB under a world matrix
+        static auto transform_bounds(const math::Mat4& world, const math::Vec3& local_min, const math::Vec3& local_max) -> Render_Bounds;
+
+    private:
+        auto rebuild(core::World& world) -> void;
+        auto sync_entity(const core::World& world, core::Entity entity) -> void;
+        auto sync_material(const core::World& world, core::Entity entity) -> uint32_t;
+        auto remove_row(uint32_t row) -> void;
+        auto mark_row(uint32_t row) -> void;
+        auto pack_lights(const core::World& world) -> void;
+        auto pack_camera(const core::World& world) -> void;
+        auto finish_ranges() -> void;
+
+        Render_Scene scene_;
+        Render_Proxies staged_;                                             // new proxies of one entity
+        std::unordered_map<core::Entity, std::vector<uint32_t>> rows_of_entity_;
+        std::unordered_map<core::Entity, uint32_t> material_of_entity_;
+        std::vector<uint32_t> free_materials_;
+        std::vector<core::Entity> pending_;
+        std::vector<uint32_t> dirty_rows_;
+        std::vector<uint8_t> row_marked_;
+        std::vector<uint32_t> dirty_materials_;
+        std::uint64_t last_sync_ = 0;
     };
 }
@@ -3,6 +3,9 @@
 layout(location = 0) in vec3 v_position;
 layout(location = 1) in vec3 v_normal;
 layout(location = 2) in vec2 v_uv;
+// Material of the instance, looked up once per vertex in pbr.vert
+layout(location = 3) flat in vec4 v_base_color;
+layout(location = 4) flat in vec4 v_params;
 
 layout(set = 0, binding = 0) uniform CameraUBO
 {
@@ -27,13 +30,6 @@ layout(set = 0, binding = 1) uniform LightsUBO
     mat4 shadow_view_proj;
 } lights_ubo;
 
-layout(push_constant) uniform PushConstants
-{
-    mat4 model;
-    vec4 base_color;
-    vec4 params;
-} pc;
-
 // IBL textures (set=1)
 layout(set = 1, binding = 0) uniform samplerCube irradiance_map;
 layout(set = 1, binding = 1) uniform samplerCube prefiltered_env;
@@ -143,10 +139,10 @@ void main()
         return;
     }
 
-    vec3 albedo = pc.base_color.rgb;
-    float metallic = clamp(pc.params.x, 0.0, 1.0);
-    float roughness = clamp(pc.params.y, 0.05, 1.0);
-    float ao = clamp(pc.params.z, 0.0, 1.0);
+    vec3 albedo = v_base_color.rgb;
+    float metallic = clamp(v_params.x, 0.0, 1.0);
+    float roughness = clamp(v_params.y, 0.05, 1.0);
+    float ao = clamp(v_params.z, 0.0, 1.0);
 
     vec3 F0 = mix(vec3(0.04), albedo, metallic);
 
@@ -241,7 +237,7 @@ void main()
     vec3 color = ambient + Lo;
 
     // Output LINEAR HDR (tone mapping + gamma applied in post-processing blit pass)
-    out_color = vec4(color, pc.base_color.a);
+    out_color = vec4(color, v_base_color.a);
 
     // G-buffer: encoded normal + roughness
     out_normal = vec4(N * 0.5 + 0.5, roughness);
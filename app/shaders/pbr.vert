@@ -12,22 +12,48 @@ layout(set = 0, binding = 0) uniform CameraUBO
     vec4 camera_pos;
 } ubo;
 
-layout(push_constant) uniform PushConstants
+// Per-draw data, indexed by gl_InstanceIndex: instanced draws start at their batch's
+// first instance, GPU-culled draws put the instance in firstInstance
+struct Instance
 {
     mat4 model;
+    vec4 center_radius;
+    vec4 extents;
+    uvec4 info;             // x=mesh, y=material, z=flags
+};
+
+struct Material
+{
     vec4 base_color;
     vec4 params;
-} pc;
+};
+
+layout(std430, set = 3, binding = 0) readonly buffer Instances
+{
+    Instance instances[];
+};
+
+layout(std430, set = 3, binding = 1) readonly buffer Materials
+{
+    Material materials[];
+};
 
 layout(location = 0) out vec3 v_position;
 layout(location = 1) out vec3 v_normal;
 layout(location = 2) out vec2 v_uv;
+layout(location = 3) flat out vec4 v_base_color;
+layout(location = 4) flat out vec4 v_params;
 
 void main()
 {
-    vec4 world_pos = pc.model * vec4(in_position, 1.0);
+    Instance instance = instances[gl_InstanceIndex];
+    Material material = materials[instance.info.y];
+
+    vec4 world_pos = instance.model * vec4(in_position, 1.0);
     v_position = world_pos.xyz;
-    v_normal = transpose(inverse(mat3(pc.model))) * in_normal;
+    v_normal = transpose(inverse(mat3(instance.model))) * in_normal;
     v_uv = in_uv;
+    v_base_color = material.base_color;
+    v_params = material.params;
     gl_Position = ubo.view_proj * world_pos;
 }
@@ -9,14 +9,21 @@ layout(set = 0, binding = 0) uniform ShadowUBO
     mat4 light_vp;
 } ubo;
 
-layout(push_constant) uniform PushConstants
+// Same buffer layout as pbr.vert
+struct Instance
 {
     mat4 model;
-    vec4 base_color;
-    vec4 params;
-} pc;
+    vec4 center_radius;
+    vec4 extents;
+    uvec4 info;
+};
+
+layout(std430, set = 1, binding = 0) readonly buffer Instances
+{
+    Instance instances[];
+};
 
 void main()
 {
-    gl_Position = ubo.light_vp * pc.model * vec4(in_position, 1.0);
+    gl_Position = ubo.light_vp * instances[gl_InstanceIndex].model * vec4(in_position, 1.0);
 }
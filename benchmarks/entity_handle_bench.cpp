@@ -0,0 +1,91 @@
+// Memory and lookup cost of the configured entity handle layout.
+// Built as mangifera_entity_handle_bench_compact and _wide; compare both outputs.
+#include "base/entity.hpp"
+#include "data-struct/freelist.hpp"
+#include "data-struct/twig-storage.hpp"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+    using namespace mango::core;
+    using Clock = std::chrono::steady_clock;
+
+    constexpr std::size_t ENTITY_COUNT = 1 << 20;
+    constexpr std::size_t LOOKUP_COUNT = 1 << 22;
+
+    struct Position { float x = 0.0f, y = 0.0f, z = 0.0f; };
+
+    template<typename Fn>
+    auto ns_per_op(std::size_t ops, Fn&& fn) -> double
+    {
+        auto begin = Clock::now();
+        fn();
+        auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() - begin).count();
+        return elapsed / static_cast<double>(ops);
+    }
+}
+
+int main()
+{
+    EntityList list;
+    std::vector<Entity> handles;
+    handles.reserve(ENTITY_COUNT);
+    for (std::size_t i = 0; i < ENTITY_COUNT; ++i) {
+        handles.push_back(list.allocate());
+    }
+
+    // Churn a quarter of the handles so lookups see recycled indices and stale handles
+    std::mt19937 rng(42);
+    std::vector<Entity> stale;
+    for (std::size_t i = 0; i < ENTITY_COUNT / 4; ++i) {
+        auto& handle = handles[rng() % ENTITY_COUNT];
+        stale.push_back(handle);
+        list.deallocate(handle);
+        handle = list.allocate();
+    }
+
+    TwigStorage<Position> storage;
+    std::unordered_map<Entity, Position> map;
+    for (auto handle : handles) {
+        storage.insert(handle, Position{});
+        map.emplace(handle, Position{});
+    }
+
+    std::vector<Entity> queries;
+    queries.reserve(LOOKUP_COUNT);
+    for (std::size_t i = 0; i < LOOKUP_COUNT; ++i) {
+        queries.push_back(i % 8 == 0 ? stale[rng() % stale.size()] : handles[rng() % handles.size()]);
+    }
+
+    std::size_t hits = 0;
+    auto exists_ns = ns_per_op(LOOKUP_COUNT, [&] {
+        for (auto query : queries) {
+            hits += list.exists(query) ? 1 : 0;
+        }
+    });
+    auto storage_ns = ns_per_op(LOOKUP_COUNT, [&] {
+        for (auto query : queries) {
+            hits += storage.get(query) ? 1 : 0;
+        }
+    });
+    auto map_ns = ns_per_op(LOOKUP_COUNT, [&] {
+        for (auto query : queries) {
+            hits += map.count(query);
+        }
+    });
+
+    std::printf("entity handle mode: %s\n", MANGO_WIDE_ENTITY_HANDLES ? "wide (32-bit index, 32-bit generation)" : "compact (23-bit index, 8-bit generation)");
+    std::printf("  sizeof(Entity)            %zu bytes\n", sizeof(Entity));
+    std::printf("  max index / generation    %u / %u\n", Entity::MAX_INDEX, Entity::MAX_GENERATION);
+    std::printf("  handle array (%zu)  %.2f MiB\n", ENTITY_COUNT, static_cast<double>(handles.size() * sizeof(Entity)) / (1024.0 * 1024.0));
+    std::printf("  TwigStorage dense handles %.2f MiB\n", static_cast<double>(storage.get_entities().size() * sizeof(Entity)) / (1024.0 * 1024.0));
+    std::printf("  EntityList::exists        %.2f ns\n", exists_ns);
+    std::printf("  TwigStorage::get          %.2f ns\n", storage_ns);
+    std::printf("  unordered_map::count      %.2f ns\n", map_ns);
+    std::printf("  (hits %zu)\n", hits);
+    return 0;
+}
@@ -0,0 +1,106 @@
+// Allocate / deallocate / iterate cost of Freelist<T> against Paged_Freelist<T>.
+// Freelist<T> keeps elements in one vector, so growth moves them; Paged_Freelist<T>
+// keeps addresses stable. Iteration over Freelist<T> walks every slot (it has no
+// liveness bits), the paged variant skips freed slots through its alive bitmap.
+#include "data-struct/freelist.hpp"
+#include "data-struct/paged-freelist.hpp"
+#include <chrono>
+#include <cstdio>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace
+{
+    using namespace mango::core;
+    using Clock = std::chrono::steady_clock;
+
+    constexpr std::uint32_t ELEMENT_COUNT = 1 << 20;
+
+    struct Particle { float position[3]; float velocity[3]; float age; std::uint32_t flags; };
+
+    template<typename Fn>
+    auto ns_per_op(std::size_t ops, Fn&& fn) -> double
+    {
+        auto begin = Clock::now();
+        fn();
+        auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() - begin).count();
+        return elapsed / static_cast<double>(ops);
+    }
+
+    auto make_churn_order() -> std::vector<std::uint32_t>
+    {
+        std::vector<std::uint32_t> order(ELEMENT_COUNT);
+        for (std::uint32_t i = 0; i < ELEMENT_COUNT; ++i) {
+            order[i] = i;
+        }
+        std::shuffle(order.begin(), order.end(), std::mt19937(7));
+        order.resize(ELEMENT_COUNT / 2);
+        return order;
+    }
+
+    volatile float sink = 0.0f;
+
+    template<typename List, typename Iterate>
+    auto run(const char* name, List& list, const std::vector<std::uint32_t>& churn, Iterate&& iterate) -> void
+    {
+        auto allocate = ns_per_op(ELEMENT_COUNT, [&] {
+            for (std::uint32_t i = 0; i < ELEMENT_COUNT; ++i) {
+                list.allocate(Particle{{1.0f, 2.0f, 3.0f}, {0.0f, 0.0f, 0.0f}, 0.0f, i});
+            }
+        });
+        auto deallocate = ns_per_op(churn.size(), [&] {
+            for (auto index : churn) {
+                list.deallocate(index);
+            }
+        });
+        auto reallocate = ns_per_op(churn.size(), [&] {
+            for (std::size_t i = 0; i < churn.size(); ++i) {
+                list.allocate(Particle{});
+            }
+        });
+        for (auto index : churn) {
+            list.deallocate(index);
+        }
+        auto iterate_ns = ns_per_op(list.size(), [&] { iterate(list); });
+
+        std::printf("%-16s allocate %6.2f  deallocate %6.2f  reallocate %6.2f  iterate %6.2f ns/op\n",
+                    name, allocate, deallocate, reallocate, iterate_ns);
+    }
+}
+
+int main()
+{
+    auto churn = make_churn_order();
+
+    {
+        Freelist<Particle> list;
+        run("Freelist", list, churn, [] (Freelist<Particle>& l) {
+            float sum = 0.0f;
+            for (std::uint32_t i = 0; i < l.capacity(); ++i) {
+                sum += l.get(i).position[0];
+            }
+            sink = sum;
+        });
+    }
+
+    {
+        Paged_Freelist<Particle> list;
+        run("Paged_Freelist", list, churn, [] (Paged_Freelist<Particle>& l) {
+            float sum = 0.0f;
+            l.for_each([&] (std::uint32_t, Particle& p) { sum += p.position[0]; });
+            sink = sum;
+        });
+    }
+
+    {
+        Paged_Freelist<Particle, 16384> list(Page_Backing::huge);
+        run("Paged (huge)", list, churn, [] (Paged_Freelist<Particle, 16384>& l) {
+            float sum = 0.0f;
+            l.for_each([&] (std::uint32_t, Particle& p) { sum += p.position[0]; });
+            sink = sum;
+        });
+    }
+
+    return 0;
+}
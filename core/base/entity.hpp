@@ -2,39 +2,67 @@
 #include <cstdint>
 #include <functional>
 
+#ifndef MANGO_WIDE_ENTITY_HANDLES
+#define MANGO_WIDE_ENTITY_HANDLES 0
+#endif
+
 namespace mango::core
 {
+#if MANGO_WIDE_ENTITY_HANDLES
+    // Wide handle: bits [0..31] index, bits [32..63] generation.
     struct Entity {
-        std::uint32_t id;
+        using Id = std::uint64_t;
 
-        static constexpr std::uint32_t INDEX_MASK      = 0x7FFFFE;     // bits [1..23]
-        static constexpr std::uint32_t DIRTY_MASK      = 0x000001;     // bit 0
-        static constexpr std::uint32_t GENERATION_MASK = 0xFF000000;   // bits [24..31]
+        Id id;
 
-        explicit constexpr Entity(std::uint32_t id_value = 0) : id(id_value) {}
+        static constexpr Id INDEX_MASK      = 0x00000000FFFFFFFFull;
+        static constexpr Id GENERATION_MASK = 0xFFFFFFFF00000000ull;
+        static constexpr std::uint32_t INDEX_SHIFT = 0;
+        static constexpr std::uint32_t GENERATION_SHIFT = 32;
+        static constexpr std::uint32_t MAX_INDEX = 0xFFFFFFFE;          // all ones is INVALID_ENTITY
+        static constexpr std::uint32_t MAX_GENERATION = 0xFFFFFFFF;
+#else
+    // Compact handle: bit 0 dirty, bits [1..23] index, bits [24..31] generation.
+    struct Entity {
+        using Id = std::uint32_t;
 
-        std::uint32_t get_index() const {
-            return (id & INDEX_MASK) >> 1;
-        }
+        Id id;
 
-        std::uint32_t get_generation() const {
-            return (id & GENERATION_MASK) >> 24;
-        }
+        static constexpr Id INDEX_MASK      = 0x00FFFFFE;   // bits [1..23]
+        static constexpr Id DIRTY_MASK      = 0x00000001;   // bit 0
+        static constexpr Id GENERATION_MASK = 0xFF000000;   // bits [24..31]
+        static constexpr std::uint32_t INDEX_SHIFT = 1;
+        static constexpr std::uint32_t GENERATION_SHIFT = 24;
+        static constexpr std::uint32_t MAX_INDEX = 0x7FFFFE;
+        static constexpr std::uint32_t MAX_GENERATION = 0xFF;
 
+        // Legacy flag carried in the handle; twig change ticks (World::changed_since) are
+        // the way to track modified entities.
         bool is_dirty() const {
             return id & DIRTY_MASK;
         }
 
-        void set_index(std::uint32_t index) {
-            id = (id & ~INDEX_MASK) | ((index & 0x7FFFFF) << 1);
+        void set_dirty(bool dirty) {
+            id = dirty ? (id | DIRTY_MASK) : (id & ~DIRTY_MASK);
         }
+#endif
 
-        void set_generation(std::uint32_t gen) {
-            id = (id & ~GENERATION_MASK) | ((gen & 0xFF) << 24);
+        explicit constexpr Entity(Id id_value = 0) : id(id_value) {}
+
+        std::uint32_t get_index() const {
+            return static_cast<std::uint32_t>((id & INDEX_MASK) >> INDEX_SHIFT);
         }
 
-        void set_dirty(bool dirty) {
-            id = dirty ? (id | DIRTY_MASK) : (id & ~DIRTY_MASK);
+        std::uint32_t get_generation() const {
+            return static_cast<std::uint32_t>((id & GENERATION_MASK) >> GENERATION_SHIFT);
+        }
+
+        void set_index(std::uint32_t index) {
+            id = (id & ~INDEX_MASK) | ((static_cast<Id>(index) << INDEX_SHIFT) & INDEX_MASK);
+        }
+
+        void set_generation(std::uint32_t gen) {
+            id = (id & ~GENERATION_MASK) | ((static_cast<Id>(gen) << GENERATION_SHIFT) & GENERATION_MASK);
         }
 
         bool operator==(const Entity& other) const {
@@ -45,7 +73,7 @@ namespace mango::core
         }
     };
 
-    constexpr Entity INVALID_ENTITY = Entity{0xFFFFFFFF};
+    constexpr Entity INVALID_ENTITY = Entity{~Entity::Id{0}};
 }
 
 namespace std
@@ -55,7 +83,7 @@ namespace std
     {
         auto operator()(const mango::core::Entity& entity) const noexcept -> std::size_t
         {
-            return std::hash<std::uint32_t>{}(entity.id);
+            return std::hash<mango::core::Entity::Id>{}(entity.id);
         }
     };
 }
@@ -0,0 +1,131 @@
+#include "gardener.hpp"
+#include "thread/worker-pool.hpp"
+#include <atomic>
+#include <chrono>
+
+namespace mango::core
+{
+    void Gardener_Registry::run_pass(Pass pass, float delta_time)
+    {
+        auto run_one = [&](std::size_t index) {
+            auto* gardener = active_gardeners_[index];
+            auto begin = std::chrono::steady_clock::now();
+            if (pass == Pass::update) {
+                gardener->update(delta_time);
+            } else {
+                gardener->fixed_update(delta_time);
+            }
+            auto ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+            auto& timing = timings_[index];
+            (pass == Pass::update ? timing.update_ms : timing.fixed_update_ms) = ms;
+        };
+
+        std::vector<std::size_t> enabled;
+        for (std::size_t i = 0; i < active_gardeners_.size(); ++i) {
+            if (active_gardeners_[i]->is_enabled()) {
+                enabled.push_back(i);
+            }
+        }
+
+        auto& pool = *Worker_Pool::current_instance();
+        if (!parallel_ || enabled.size() < 2 || pool.get_worker_count() == 0) {
+            for (auto index : enabled) {
+                run_one(index);
+            }
+            return;
+        }
+
+        // Dependency DAG over the enabled gardeners, edges follow registration order
+        struct Node
+        {
+            std::vector<std::size_t> successors;
+            std::atomic<std::size_t> pending{0};
+        };
+        std::vector<Node> nodes(enabled.size());
+        for (std::size_t i = 0; i < enabled.size(); ++i) {
+            for (std::size_t j = i + 1; j < enabled.size(); ++j) {
+                if (active_gardeners_[enabled[i]]->conflicts_with(*active_gardeners_[enabled[j]])) {
+                    nodes[i].successors.push_back(j);
+                    nodes[j].pending.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        }
+
+        Task_Group group;
+        std::function<void(std::size_t)> launch = [&](std::size_t node) {
+            pool.run(group, [&, node] {
+                run_one(enabled[node]);
+                for (auto next : nodes[node].successors) {
+                    if (nodes[next].pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                        launch(next);
+                    }
+                }
+            });
+        };
+
+        for (std::size_t i = 0; i < nodes.size(); ++i) {
+            if (nodes[i].pending.load(std::memory_order_relaxed) == 0) {
+                launch(i);
+            }
+        }
+        pool.wait(group);
+    }
+
+    void Gardener_Registry::queue_events(Gardener_Event event, std::span<const Entity> entities, TwigID twig_type_id)
+    {
+        if (active_gardeners_.empty() || entities.empty()) {
+            return;
+        }
+
+        if (event != Gardener_Event::POST_GRAFT && event != Gardener_Event::POST_LOPPER) {
+            return;
+        }
+
+        if (twig_type_id >= last_batch_of_twig_.size()) {
+            last_batch_of_twig_.resize(twig_type_id + 1, INVALID_BATCH);
+        }
+        auto& last = last_batch_of_twig_[twig_type_id];
+        if (last == INVALID_BATCH || pending_batches_[last].event != event) {
+            last = pending_batches_.size();
+            pending_batches_.push_back({ event, twig_type_id, {} });
+        }
+        auto& batch = pending_batches_[last].entities;
+        batch.insert(batch.end(), entities.begin(), entities.end());
+    }
+
+    void Gardener_Registry::trigger_events(Gardener_Event event, std::span<const Entity> entities, TwigID twig_type_id)
+    {
+        if (entity_listeners_ > 0) {
+            for (auto entity : entities) {
+                trigger_event(event, entity, twig_type_id);
+            }
+            return;
+        }
+        queue_events(event, entities, twig_type_id);
+    }
+
+    void Gardener_Registry::flush_events()
+    {
+        if (pending_batches_.empty()) {
+            return;
+        }
+
+        // Taken out first: gardeners may attach or detach twigs while handling a batch,
+        // and those events are queued for the next flush
+        auto batches = std::move(pending_batches_);
+        pending_batches_.clear();
+        last_batch_of_twig_.assign(last_batch_of_twig_.size(), INVALID_BATCH);
+
+        // In queue order, so every entity's events of one twig arrive as they happened
+        for (const auto& batch : batches) {
+            for (auto* gardener : active_gardeners_) {
+                if (!gardener->is_enabled()) continue;
+                if (batch.event == Gardener_Event::POST_GRAFT) {
+                    gardener->on_post_graft_batch(batch.entities, batch.twig_type_id);
+                } else {
+                    gardener->on_post_lopper_batch(batch.entities, batch.twig_type_id);
+                }
+            }
+        }
+    }
+}
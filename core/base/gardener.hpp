@@ -4,7 +4,10 @@
 #include <functional>
 #include <vector>
 #include <memory>
+#include <span>
+#include <string_view>
 #include <type_traits>
+#include <typeinfo>
 
 namespace mango::core
 {
@@ -26,19 +29,101 @@ namespace mango::core
     public:
         virtual ~Gardener_Base() = default;
 
+        // Per-entity hooks, called at the moment of the change. Only delivered to gardeners
+        // that call enable_entity_events(); bulk spawns make them expensive.
         virtual void on_pre_graft(Entity entity, std::size_t twig_type_id) {}
         virtual void on_post_graft(Entity entity, std::size_t twig_type_id) {}
         virtual void on_pre_lopper(Entity entity, std::size_t twig_type_id) {}
         virtual void on_post_lopper(Entity entity, std::size_t twig_type_id) {}
 
+        // Batched hooks, delivered at Gardener_Registry::flush_events() with the entities
+        // that gained (or lost) twig_type_id since the last flush. Batches of one twig arrive
+        // in the order their events happened, so an entity that gained, lost and regained a
+        // twig gets a graft, a lopper and a graft batch; the last one is its final state.
+        // Entities may have been destroyed in the meantime.
+        virtual void on_post_graft_batch(std::span<const Entity> entities, TwigID twig_type_id) {}
+        virtual void on_post_lopper_batch(std::span<const Entity> entities, TwigID twig_type_id) {}
+
+        auto wants_entity_events() const -> bool { return entity_events_; }
+
         virtual void update(float delta_time) {}
         virtual void fixed_update(float fixed_delta_time) {}
 
         virtual void set_enabled(bool enabled) { enabled_ = enabled; }
         virtual bool is_enabled() const { return enabled_; }
 
+        // Shown in the registry timings
+        virtual std::string_view get_name() const { return typeid(*this).name(); }
+
+        // Twig types touched by update/fixed_update. A gardener that declares nothing is
+        // assumed to touch everything and never runs alongside another gardener.
+        auto get_reads() const -> const TwigSet& { return reads_; }
+        auto get_writes() const -> const TwigSet& { return writes_; }
+        auto has_declared_access() const -> bool { return declared_access_; }
+
+        // True when the two gardeners may not run at the same time. Two readers of the same
+        // twig conflict too: World reads are not thread-safe (the non-const get_twig stamps
+        // change ticks and view() fills the shared view cache).
+        auto conflicts_with(const Gardener_Base& other) const -> bool
+        {
+            if (!declared_access_ || !other.declared_access_) {
+                return true;
+            }
+            return intersects(writes_, other.writes_)
+                || intersects(writes_, other.reads_)
+                || intersects(reads_, other.writes_)
+                || intersects(reads_, other.reads_);
+        }
+
     protected:
+        // Call from the derived constructor: reads<Transform>(); writes<World_Transform>();
+        // Structural changes (create/destroy/attach/detach) must go through a World_Command_Buffer.
+        template<typename... Ts>
+        void reads()
+        {
+            declared_access_ = true;
+            (insert_twig(reads_, Ts::get_static_id()), ...);
+        }
+
+        template<typename... Ts>
+        void writes()
+        {
+            declared_access_ = true;
+            (insert_twig(writes_, Ts::get_static_id()), ...);
+        }
+
+        // Declares an empty access set for gardeners that touch no twigs at all
+        void declare_no_twig_access() { declared_access_ = true; }
+
+        // Opts into the per-entity on_pre/post_* hooks (compatibility path)
+        void enable_entity_events() { entity_events_ = true; }
+
         bool enabled_ = true;
+
+    private:
+        static auto intersects(const TwigSet& a, const TwigSet& b) -> bool
+        {
+            auto it_a = a.begin();
+            auto it_b = b.begin();
+            while (it_a != a.end() && it_b != b.end()) {
+                if (*it_a == *it_b) return true;
+                if (*it_a < *it_b) ++it_a; else ++it_b;
+            }
+            return false;
+        }
+
+        TwigSet reads_;
+        TwigSet writes_;
+        bool declared_access_ = false;
+        bool entity_events_ = false;
+    };
+
+    // Wall time of a gardener's last update / fixed_update, in milliseconds
+    struct Gardener_Timing
+    {
+        std::string_view name;
+        double update_ms = 0.0;
+        double fixed_update_ms = 0.0;
     };
 
     // Template gardener service - like Java service pattern
@@ -90,12 +175,37 @@ namespace mango::core
     template<typename Derived>
     bool Gardener<Derived>::initialized_ = false;
 
-    // Gardener registry for managing all gardeners
+    // Gardener registry for managing all gardeners.
+    // update_all/fixed_update_all order gardeners by their declared twig access: each
+    // frame a DAG is built with an edge from every gardener to each later-registered one
+    // it conflicts with (any twig in common), and gardeners with disjoint twig sets run
+    // concurrently on the Worker_Pool. Conflicting gardeners keep their registration order.
     class Gardener_Registry
     {
     private:
         std::vector<std::unique_ptr<Gardener_Base>> gardeners_;
         std::vector<Gardener_Base*> active_gardeners_;
+        std::vector<Gardener_Timing> timings_;
+        bool parallel_ = true;
+
+        // Coalesced POST_GRAFT / POST_LOPPER events in queue order. An event joins the last
+        // batch of its twig when that batch is of the same kind: a twig's events are never
+        // reordered, and events of other twigs in between do not split a batch.
+        struct Pending_Batch
+        {
+            Gardener_Event event;
+            TwigID twig_type_id;
+            std::vector<Entity> entities;
+        };
+        static constexpr std::size_t INVALID_BATCH = ~std::size_t{0};
+        std::vector<Pending_Batch> pending_batches_;
+        std::vector<std::size_t> last_batch_of_twig_;      // index into pending_batches_ per TwigID
+        std::size_t entity_listeners_ = 0;
+
+        void queue_events(Gardener_Event event, std::span<const Entity> entities, TwigID twig_type_id);
+
+        enum class Pass { update, fixed_update };
+        void run_pass(Pass pass, float delta_time);
 
     public:
         template<typename T, typename... Args>
@@ -107,6 +217,10 @@ namespace mango::core
             T* raw_ptr = gardener.get();
             gardeners_.push_back(std::move(gardener));
             active_gardeners_.push_back(raw_ptr);
+            timings_.push_back({ raw_ptr->get_name() });
+            if (raw_ptr->wants_entity_events()) {
+                ++entity_listeners_;
+            }
             return raw_ptr;
         }
 
@@ -121,51 +235,63 @@ namespace mango::core
             return nullptr;
         }
 
+        // Delivers queued lifecycle events first, so gardeners see this frame's spawns
         void update_all(float delta_time)
         {
-            for (auto* gardener : active_gardeners_) {
-                if (gardener->is_enabled()) {
-                    gardener->update(delta_time);
-                }
-            }
+            flush_events();
+            run_pass(Pass::update, delta_time);
         }
 
-        void fixed_update_all(float fixed_delta_time)
-        {
-            for (auto* gardener : active_gardeners_) {
-                if (gardener->is_enabled()) {
-                    gardener->fixed_update(fixed_delta_time);
-                }
-            }
-        }
+        void fixed_update_all(float fixed_delta_time) { run_pass(Pass::fixed_update, fixed_delta_time); }
+
+        // Off: run every gardener on the calling thread in registration order
+        void set_parallel(bool parallel) { parallel_ = parallel; }
+        bool is_parallel() const { return parallel_; }
 
-        // Trigger lifecycle events
+        // One entry per registered gardener, in registration order
+        auto get_timings() const -> const std::vector<Gardener_Timing>& { return timings_; }
+
+        // Lifecycle event for one entity. Opted-in gardeners get the per-entity hook right
+        // away; POST events are also queued for the batched hooks.
         void trigger_event(Gardener_Event event, Entity entity, std::size_t twig_type_id)
         {
-            for (auto* gardener : active_gardeners_) {
-                if (!gardener->is_enabled()) continue;
-
-                switch (event) {
-                    case Gardener_Event::PRE_GRAFT:
-                        gardener->on_pre_graft(entity, twig_type_id);
-                        break;
-                    case Gardener_Event::POST_GRAFT:
-                        gardener->on_post_graft(entity, twig_type_id);
-                        break;
-                    case Gardener_Event::PRE_LOPPER:
-                        gardener->on_pre_lopper(entity, twig_type_id);
-                        break;
-                    case Gardener_Event::POST_LOPPER:
-                        gardener->on_post_lopper(entity, twig_type_id);
-                        break;
+            if (entity_listeners_ > 0) {
+                for (auto* gardener : active_gardeners_) {
+                    if (!gardener->is_enabled() || !gardener->wants_entity_events()) continue;
+
+                    switch (event) {
+                        case Gardener_Event::PRE_GRAFT:
+                            gardener->on_pre_graft(entity, twig_type_id);
+                            break;
+                        case Gardener_Event::POST_GRAFT:
+                            gardener->on_post_graft(entity, twig_type_id);
+                            break;
+                        case Gardener_Event::PRE_LOPPER:
+                            gardener->on_pre_lopper(entity, twig_type_id);
+                            break;
+                        case Gardener_Event::POST_LOPPER:
+                            gardener->on_post_lopper(entity, twig_type_id);
+                            break;
+                    }
                 }
             }
+            queue_events(event, std::span<const Entity>(&entity, 1), static_cast<TwigID>(twig_type_id));
         }
 
+        // Same event for many entities (bulk spawn); one append per batch
+        void trigger_events(Gardener_Event event, std::span<const Entity> entities, TwigID twig_type_id);
+
+        // Sync point: hands every queued batch to the enabled gardeners and clears the queue
+        void flush_events();
+
         void clear()
         {
             active_gardeners_.clear();
             gardeners_.clear();
+            timings_.clear();
+            pending_batches_.clear();
+            last_batch_of_twig_.clear();
+            entity_listeners_ = 0;
         }
     };
 }
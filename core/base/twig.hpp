@@ -2,54 +2,113 @@
 #include <string_view>
 #include <vector>
 #include <cstdint>
-#include <atomic>
 #include <algorithm>
+#include <mutex>
+#include <typeinfo>
 
 namespace mango::core
 {
     using TwigID  = std::uint32_t;
     using TwigSet = std::vector<TwigID>;
 
+    // TwigIDs below this are reserved for engine twigs with a compile-time slot
+    // (see resource/twig_slots.hpp); user twigs are numbered densely after them.
+    inline constexpr TwigID ENGINE_TWIG_SLOTS = 16;
+
     struct TwigBase {
         virtual ~TwigBase() = default;
         virtual std::string_view get_twig_type() const = 0;
         virtual TwigID get_twig_id() const = 0;
     };
 
+    // Thread-safe: registration may happen from static initialisers or any thread.
     class TwigTypeRegistry {
     public:
         static TwigID register_type(std::string_view name) {
-            TwigID id = next_id++;
-            names.push_back(name);
+            auto& registry = state();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            TwigID id = registry.next_id++;
+            set_name(registry, id, name);
+            return id;
+        }
+
+        static TwigID register_fixed_type(TwigID id, std::string_view name) {
+            auto& registry = state();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            set_name(registry, id, name);
             return id;
         }
 
         static std::string_view get_name(TwigID id) {
-            return names.at(id);
+            auto& registry = state();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            return registry.names.at(id);
+        }
+
+        // One past the highest TwigID handed out so far
+        static TwigID get_id_count() {
+            auto& registry = state();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            return registry.next_id;
         }
 
     private:
-        inline static std::atomic<TwigID> next_id{0};
-        inline static std::vector<std::string_view> names;
+        struct State {
+            std::mutex mutex;
+            std::vector<std::string_view> names;
+            TwigID next_id = ENGINE_TWIG_SLOTS;
+        };
+
+        // Function-local so it is constructed before the first static-init registration
+        static State& state() {
+            static State registry;
+            return registry;
+        }
+
+        static void set_name(State& registry, TwigID id, std::string_view name) {
+            if (id >= registry.names.size()) {
+                registry.names.resize(id + 1);
+            }
+            registry.names[id] = name;
+        }
     };
 
+    // A twig type gets a compile-time id by declaring
+    //   static constexpr core::TwigID FIXED_TWIG_ID = <slot below ENGINE_TWIG_SLOTS>;
+    // Other twig types are registered lazily on first use.
     template<typename T>
     struct Twig : TwigBase {
-        static TwigID type_id;
-
-        static TwigID get_static_id() { return type_id; }
+        static TwigID get_static_id() {
+            if constexpr (requires { T::FIXED_TWIG_ID; }) {
+                static_assert(T::FIXED_TWIG_ID < ENGINE_TWIG_SLOTS, "FIXED_TWIG_ID outside the engine slot range");
+                return T::FIXED_TWIG_ID;
+            } else {
+                static const TwigID id = TwigTypeRegistry::register_type(typeid(T).name());
+                return id;
+            }
+        }
 
         std::string_view get_twig_type() const override {
-            return TwigTypeRegistry::get_name(type_id);
+            return TwigTypeRegistry::get_name(registered_id);
         }
 
         TwigID get_twig_id() const override {
-            return type_id;
+            return get_static_id();
         }
+
+    private:
+        // Forces registration (and the name of fixed slots) during static init
+        static const TwigID registered_id;
     };
 
     template<typename T>
-    TwigID Twig<T>::type_id = TwigTypeRegistry::register_type(typeid(T).name());
+    const TwigID Twig<T>::registered_id = [] {
+        if constexpr (requires { T::FIXED_TWIG_ID; }) {
+            return TwigTypeRegistry::register_fixed_type(T::FIXED_TWIG_ID, typeid(T).name());
+        } else {
+            return Twig<T>::get_static_id();
+        }
+    }();
 
     inline void insert_twig(TwigSet& set, TwigID id) {
         auto it = std::lower_bound(set.begin(), set.end(), id);
@@ -1,7 +1,9 @@
 #pragma once
 #include "base/entity.hpp"
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <stdexcept>
 #include <new>        // Required for placement new and operator new[]/delete[]
 #include <vector>
 #include <mutex>
@@ -11,35 +13,51 @@
 
 namespace mango::core
 {
+    // Entity handle allocator with a LIFO free stack of recycled indices.
+    // A slot whose generation reaches Entity::MAX_GENERATION is retired instead of being
+    // recycled, so a stale handle can never match a reused index after the counter wraps.
+    // reserve() may be called from any thread while the list is otherwise untouched: it
+    // claims either a recycled index or a fresh one past the end through one atomic
+    // cursor. flush_reserved() turns reservations into live entities on the owning thread
+    // and runs implicitly before any other mutation.
     struct EntityList
     {
     private:
-        struct EntityNode
-        {
-            std::uint32_t next;
-        };
-
         std::vector<Entity> data_;
         std::vector<std::uint32_t> generations_;
-        std::uint32_t free_head_;
+        std::vector<std::uint32_t> free_;
         std::uint32_t size_;
-        static constexpr std::uint32_t INVALID_INDEX = 0xFFFFFFFF;
+        std::uint32_t retired_ = 0;
+
+        // Counts down through free_; below zero it hands out fresh indices past data_
+        std::atomic<std::int64_t> reserve_cursor_;
+
+        static auto check_capacity(std::size_t slot_count) -> void
+        {
+            if (slot_count > static_cast<std::size_t>(Entity::MAX_INDEX) + 1) {
+                throw std::length_error("EntityList: entity index space exhausted");
+            }
+        }
 
     public:
-        EntityList(): free_head_(INVALID_INDEX), size_(0) {}
+        EntityList(): size_(0), reserve_cursor_(0) {}
 
         Entity allocate()
         {
+            flush_reserved();
+
             std::uint32_t index;
-            if (free_head_ != INVALID_INDEX) {
-                index = free_head_;
-                free_head_ = reinterpret_cast<EntityNode*>(&data_[index])->next;
+            if (!free_.empty()) {
+                index = free_.back();
+                free_.pop_back();
             } else {
                 index = static_cast<std::uint32_t>(data_.size());
+                check_capacity(data_.size() + 1);
                 data_.emplace_back();
                 generations_.push_back(0);
             }
             size_++;
+            reserve_cursor_.store(static_cast<std::int64_t>(free_.size()), std::memory_order_relaxed);
 
             Entity e;
             e.set_index(index);
@@ -55,16 +73,68 @@ namespace mango::core
             return e;
         }
 
+        // Pre-grows the slot arrays for `count` more entities beyond the recycled ones
+        void reserve_capacity(std::size_t count)
+        {
+            if (count > free_.size()) {
+                data_.reserve(data_.size() + count - free_.size());
+                generations_.reserve(generations_.size() + count - free_.size());
+            }
+        }
+
+        // Thread-safe. The handle becomes valid at the next flush_reserved().
+        Entity reserve()
+        {
+            auto n = reserve_cursor_.fetch_sub(1, std::memory_order_relaxed);
+
+            Entity e;
+            if (n > 0) {
+                auto index = free_[static_cast<std::size_t>(n - 1)];
+                e.set_index(index);
+                e.set_generation(generations_[index]);
+            } else {
+                e.set_index(static_cast<std::uint32_t>(data_.size() + static_cast<std::size_t>(-n)));
+                e.set_generation(0);
+            }
+            return e;
+        }
+
+        void flush_reserved()
+        {
+            auto cursor = reserve_cursor_.load(std::memory_order_relaxed);
+            auto free_count = static_cast<std::int64_t>(free_.size());
+            if (cursor == free_count) {
+                return;
+            }
+
+            size_ += static_cast<std::uint32_t>(free_count - cursor);
+            if (cursor < 0) {
+                auto fresh = static_cast<std::size_t>(-cursor);
+                check_capacity(data_.size() + fresh);
+                data_.resize(data_.size() + fresh);
+                generations_.resize(generations_.size() + fresh, 0);
+                cursor = 0;
+            }
+            free_.resize(static_cast<std::size_t>(cursor));
+            reserve_cursor_.store(cursor, std::memory_order_relaxed);
+        }
+
         bool deallocate(Entity e)
         {
+            flush_reserved();
+
             std::uint32_t index = e.get_index();
             if (index >= data_.size()) return false;
 
             data_[index].~Entity();
             generations_[index]++; // bump generation
-            reinterpret_cast<EntityNode*>(&data_[index])->next = free_head_;
-            free_head_ = index;
+            if (generations_[index] < Entity::MAX_GENERATION) {
+                free_.push_back(index);
+            } else {
+                retired_++;
+            }
             size_--;
+            reserve_cursor_.store(static_cast<std::int64_t>(free_.size()), std::memory_order_relaxed);
             return true;
         }
 
@@ -80,10 +150,26 @@ namespace mango::core
             return exists(e) ? &data_[e.get_index()] : nullptr;
         }
 
-        auto get_count() const -> int
+        auto get_count() const -> std::size_t
         {
             return size_;
         }
+
+        // Slots that exhausted their generations and are never handed out again
+        auto get_retired_count() const -> std::size_t
+        {
+            return retired_;
+        }
+
+        void clear()
+        {
+            data_.clear();
+            generations_.clear();
+            free_.clear();
+            size_ = 0;
+            retired_ = 0;
+            reserve_cursor_.store(0, std::memory_order_relaxed);
+        }
     };
 
     template<typename T>
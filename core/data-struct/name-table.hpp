@@ -0,0 +1,59 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace mango::core
+{
+    using Name_Id = std::uint32_t;
+
+    // Interns strings so equal names share one id and one allocation. Ids are dense,
+    // never reused, and compare in O(1); strings stay at a stable address.
+    class Name_Table
+    {
+    public:
+        static constexpr Name_Id EMPTY_NAME = 0;
+
+        Name_Table()
+        {
+            intern("");
+        }
+
+        auto intern(std::string_view name) -> Name_Id
+        {
+            if (auto it = ids_.find(name); it != ids_.end()) {
+                return it->second;
+            }
+            auto id = static_cast<Name_Id>(names_.size());
+            const auto& stored = names_.emplace_back(name);
+            ids_.emplace(std::string_view(stored), id);
+            return id;
+        }
+
+        // Looks a name up without interning it; returns false for names never seen
+        auto find(std::string_view name, Name_Id& out) const -> bool
+        {
+            auto it = ids_.find(name);
+            if (it == ids_.end()) {
+                return false;
+            }
+            out = it->second;
+            return true;
+        }
+
+        auto view(Name_Id id) const -> const std::string&
+        {
+            return id < names_.size() ? names_[id] : names_[EMPTY_NAME];
+        }
+
+        auto size() const -> std::size_t { return names_.size(); }
+
+    private:
+        std::deque<std::string> names_;                         // deque keeps the keys below valid
+        std::unordered_map<std::string_view, Name_Id> ids_;
+    };
+}
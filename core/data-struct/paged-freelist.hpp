@@ -0,0 +1,225 @@
+#pragma once
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace mango::core
+{
+    enum class Page_Backing
+    {
+        normal,     // cache-line aligned heap pages
+        huge        // pages packed into shared 2 MiB aligned arenas advised as transparent huge
+                    // pages (Linux); normal elsewhere
+    };
+
+    // Freelist with stable element addresses.
+    // Elements live in fixed-size pages reached through a page table, so growing never
+    // moves existing elements: a T& or T* from get() stays valid until that index is
+    // deallocated. Freed indices are reused LIFO in O(1) like Freelist<T>.
+    // Unlike Freelist<T>, slots are constructed on allocate and destroyed on deallocate.
+    template<typename T, std::size_t PAGE_CAPACITY = 1024>
+    struct Paged_Freelist
+    {
+        static_assert((PAGE_CAPACITY & (PAGE_CAPACITY - 1)) == 0, "PAGE_CAPACITY must be a power of two");
+
+    private:
+        static constexpr std::uint32_t INVALID_INDEX = 0xFFFFFFFF;
+        static constexpr std::size_t CACHE_LINE = 64;
+        static constexpr std::size_t HUGE_PAGE = 2 * 1024 * 1024;
+        static constexpr std::size_t WORD_BITS = 64;
+        static constexpr std::size_t ALIVE_WORDS = (PAGE_CAPACITY + WORD_BITS - 1) / WORD_BITS;
+
+        // A free slot stores the next free index in place of the element
+        union Slot
+        {
+            std::uint32_t next;
+            alignas(T) std::byte storage[sizeof(T)];
+        };
+
+        struct alignas(CACHE_LINE) Page
+        {
+            Slot slots[PAGE_CAPACITY];
+            std::uint64_t alive[ALIVE_WORDS];
+        };
+
+        // Huge backing carves pages out of arenas of at least one huge page, so small pages
+        // do not each pin a whole 2 MiB. Arenas are only released by clear().
+        static constexpr std::size_t PAGE_BYTES = (sizeof(Page) + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE;
+        static constexpr std::size_t ARENA_BYTES = (PAGE_BYTES + HUGE_PAGE - 1) / HUGE_PAGE * HUGE_PAGE;
+        static constexpr std::size_t PAGES_PER_ARENA = ARENA_BYTES / PAGE_BYTES;
+
+        std::vector<Page*> pages_;
+        std::vector<std::byte*> arenas_;
+        std::size_t arena_pages_ = 0;       // pages carved from the last arena
+        std::uint32_t free_head_ = INVALID_INDEX;
+        std::uint32_t size_ = 0;
+        std::uint32_t high_water_ = 0;      // slots ever handed out; all below are constructed or free
+        Page_Backing backing_ = Page_Backing::normal;
+
+        auto allocate_page() -> Page*
+        {
+            void* memory = nullptr;
+            if (backing_ == Page_Backing::huge) {
+                if (arenas_.empty() || arena_pages_ == PAGES_PER_ARENA) {
+                    auto* arena = static_cast<std::byte*>(::operator new(ARENA_BYTES, std::align_val_t(HUGE_PAGE)));
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+                    madvise(arena, ARENA_BYTES, MADV_HUGEPAGE);
+#endif
+                    arenas_.push_back(arena);
+                    arena_pages_ = 0;
+                }
+                memory = arenas_.back() + arena_pages_++ * PAGE_BYTES;
+            } else {
+                memory = ::operator new(PAGE_BYTES, std::align_val_t(CACHE_LINE));
+            }
+            auto* page = static_cast<Page*>(memory);
+            for (auto& word : page->alive) {
+                word = 0;
+            }
+            return page;
+        }
+
+        auto free_pages() -> void
+        {
+            if (backing_ == Page_Backing::huge) {
+                for (auto* arena : arenas_) {
+                    ::operator delete(static_cast<void*>(arena), std::align_val_t(HUGE_PAGE));
+                }
+            } else {
+                for (auto* page : pages_) {
+                    ::operator delete(static_cast<void*>(page), std::align_val_t(CACHE_LINE));
+                }
+            }
+            pages_.clear();
+            arenas_.clear();
+            arena_pages_ = 0;
+        }
+
+        auto slot(std::uint32_t index) const -> Slot&
+        {
+            return pages_[index / PAGE_CAPACITY]->slots[index % PAGE_CAPACITY];
+        }
+
+        auto set_alive(std::uint32_t index, bool alive) -> void
+        {
+            auto& word = pages_[index / PAGE_CAPACITY]->alive[(index % PAGE_CAPACITY) / WORD_BITS];
+            auto bit = std::uint64_t{1} << (index % WORD_BITS);
+            word = alive ? (word | bit) : (word & ~bit);
+        }
+
+        auto take_index() -> std::uint32_t
+        {
+            if (free_head_ != INVALID_INDEX) {
+                auto index = free_head_;
+                free_head_ = slot(index).next;
+                return index;
+            }
+            if (high_water_ == pages_.size() * PAGE_CAPACITY) {
+                pages_.push_back(allocate_page());
+            }
+            return high_water_++;
+        }
+
+    public:
+        explicit Paged_Freelist(Page_Backing backing = Page_Backing::normal) : backing_(backing) {}
+
+        Paged_Freelist(const Paged_Freelist&) = delete;
+        Paged_Freelist& operator=(const Paged_Freelist&) = delete;
+
+        ~Paged_Freelist()
+        {
+            clear();
+        }
+
+        template<typename... Args>
+        std::uint32_t allocate(Args&&... args)
+        {
+            auto index = take_index();
+            new (slot(index).storage) T(std::forward<Args>(args)...);
+            set_alive(index, true);
+            size_++;
+            return index;
+        }
+
+        void deallocate(std::uint32_t index)
+        {
+            if (!is_alive(index)) return;
+
+            get(index).~T();
+            set_alive(index, false);
+            slot(index).next = free_head_;
+            free_head_ = index;
+            size_--;
+        }
+
+        bool is_alive(std::uint32_t index) const
+        {
+            if (index >= high_water_) return false;
+            auto word = pages_[index / PAGE_CAPACITY]->alive[(index % PAGE_CAPACITY) / WORD_BITS];
+            return (word >> (index % WORD_BITS)) & 1;
+        }
+
+        T& get(std::uint32_t index)
+        {
+            assert(is_alive(index));
+            return *std::launder(reinterpret_cast<T*>(slot(index).storage));
+        }
+
+        const T& get(std::uint32_t index) const
+        {
+            assert(is_alive(index));
+            return *std::launder(reinterpret_cast<const T*>(slot(index).storage));
+        }
+
+        // Visits live elements in index order: fn(index, T&). Skips whole empty 64-slot words.
+        template<typename Fn>
+        void for_each(Fn&& fn)
+        {
+            for (std::size_t page_index = 0; page_index < pages_.size(); ++page_index) {
+                auto* page = pages_[page_index];
+                for (std::size_t w = 0; w < ALIVE_WORDS; ++w) {
+                    auto word = page->alive[w];
+                    while (word) {
+                        auto bit = static_cast<std::size_t>(std::countr_zero(word));
+                        word &= word - 1;
+                        auto local = w * WORD_BITS + bit;
+                        auto index = static_cast<std::uint32_t>(page_index * PAGE_CAPACITY + local);
+                        fn(index, *std::launder(reinterpret_cast<T*>(page->slots[local].storage)));
+                    }
+                }
+            }
+        }
+
+        std::uint32_t size() const { return size_; }
+        std::uint32_t capacity() const { return static_cast<std::uint32_t>(pages_.size() * PAGE_CAPACITY); }
+        bool empty() const { return size_ == 0; }
+        std::size_t get_page_count() const { return pages_.size(); }
+        Page_Backing get_backing() const { return backing_; }
+
+        // Bytes held for pages: whole arenas with huge backing
+        std::size_t get_reserved_bytes() const
+        {
+            return backing_ == Page_Backing::huge ? arenas_.size() * ARENA_BYTES : pages_.size() * PAGE_BYTES;
+        }
+
+        // Destroys every element and releases all pages
+        void clear()
+        {
+            for_each([] (std::uint32_t, T& value) { value.~T(); });
+            free_pages();
+            free_head_ = INVALID_INDEX;
+            size_ = 0;
+            high_water_ = 0;
+        }
+    };
+}
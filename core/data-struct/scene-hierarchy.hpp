@@ -0,0 +1,310 @@
+#pragma once
+#include "base/entity.hpp"
+#include "data-struct/name-table.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace mango::core
+{
+    // Stable handle of a scene node. Survives re-sorting of the hierarchy storage.
+    using Scene_Node_Id = std::uint32_t;
+    inline constexpr Scene_Node_Id INVALID_SCENE_NODE = 0xFFFFFFFF;
+
+    // Index-based scene hierarchy stored as parallel arrays (one row per node).
+    // Links are dense row indices, so walking the tree touches only a few small arrays
+    // and never a refcount. Appending a child links it through the parent's last_child
+    // without walking siblings.
+    // sort_depth_first() reorders the rows so every subtree is the contiguous range
+    // [row, subtree_end(row)) with parents before children; appends and reparenting
+    // after that leave the order stale until the next sort. Names are interned.
+    class Scene_Hierarchy
+    {
+    public:
+        static constexpr std::uint32_t INVALID_ROW = 0xFFFFFFFF;
+
+        // Adds a node as the last child of parent, or as a new root when parent is INVALID_SCENE_NODE
+        auto add_node(Scene_Node_Id parent, Entity entity, std::string_view name) -> Scene_Node_Id
+        {
+            auto row = static_cast<std::uint32_t>(ids_.size());
+            auto parent_row = parent == INVALID_SCENE_NODE ? INVALID_ROW : row_of(parent);
+
+            auto id = static_cast<Scene_Node_Id>(row_of_id_.size());
+            row_of_id_.push_back(row);
+            ids_.push_back(id);
+            entities_.push_back(entity);
+            names_.push_back(name_table_.intern(name));
+            parent_.push_back(INVALID_ROW);
+            first_child_.push_back(INVALID_ROW);
+            last_child_.push_back(INVALID_ROW);
+            next_sibling_.push_back(INVALID_ROW);
+            prev_sibling_.push_back(INVALID_ROW);
+            subtree_end_.push_back(row + 1);
+
+            if (parent_row != INVALID_ROW) {
+                link_last(row, parent_row);
+                if (depth_first_) {
+                    depth_first_ = extend_subtrees_to_end(parent_row);
+                }
+            }
+            ++structure_version_;
+            return id;
+        }
+
+        auto contains(Scene_Node_Id id) const -> bool
+        {
+            return id < row_of_id_.size();
+        }
+
+        auto row_of(Scene_Node_Id id) const -> std::uint32_t
+        {
+            return contains(id) ? row_of_id_[id] : INVALID_ROW;
+        }
+
+        auto id_at(std::uint32_t row) const -> Scene_Node_Id
+        {
+            return row < ids_.size() ? ids_[row] : INVALID_SCENE_NODE;
+        }
+
+        auto parent_of(Scene_Node_Id id) const -> Scene_Node_Id { return link(parent_, id); }
+        auto first_child_of(Scene_Node_Id id) const -> Scene_Node_Id { return link(first_child_, id); }
+        auto last_child_of(Scene_Node_Id id) const -> Scene_Node_Id { return link(last_child_, id); }
+        auto next_sibling_of(Scene_Node_Id id) const -> Scene_Node_Id { return link(next_sibling_, id); }
+        auto prev_sibling_of(Scene_Node_Id id) const -> Scene_Node_Id { return link(prev_sibling_, id); }
+
+        auto name_of(Scene_Node_Id id) const -> const std::string&
+        {
+            return name_table_.view(name_id_of(id));
+        }
+
+        auto name_id_of(Scene_Node_Id id) const -> Name_Id
+        {
+            return contains(id) ? names_[row_of_id_[id]] : Name_Table::EMPTY_NAME;
+        }
+
+        auto get_name_table() const -> const Name_Table& { return name_table_; }
+
+        auto entity_of(Scene_Node_Id id) const -> Entity
+        {
+            return contains(id) ? entities_[row_of_id_[id]] : INVALID_ENTITY;
+        }
+
+        auto set_name(Scene_Node_Id id, std::string_view name) -> void
+        {
+            if (contains(id)) {
+                names_[row_of_id_[id]] = name_table_.intern(name);
+            }
+        }
+
+        // True when ancestor is node itself or lies on its parent chain
+        auto is_in_subtree(Scene_Node_Id node, Scene_Node_Id ancestor) const -> bool
+        {
+            if (!contains(node) || !contains(ancestor)) {
+                return false;
+            }
+            auto target = row_of_id_[ancestor];
+            for (auto row = row_of_id_[node]; row != INVALID_ROW; row = parent_[row]) {
+                if (row == target) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // Moves id (with its subtree) to the end of new_parent's children, or makes it a root
+        // when new_parent is INVALID_SCENE_NODE. Fails when new_parent lies inside that subtree.
+        auto reparent(Scene_Node_Id id, Scene_Node_Id new_parent) -> bool
+        {
+            if (!contains(id) || (new_parent != INVALID_SCENE_NODE && !contains(new_parent))) {
+                return false;
+            }
+            if (new_parent != INVALID_SCENE_NODE && is_in_subtree(new_parent, id)) {
+                return false;
+            }
+
+            auto row = row_of_id_[id];
+            unlink(row);
+            if (new_parent != INVALID_SCENE_NODE) {
+                link_last(row, row_of_id_[new_parent]);
+            }
+            depth_first_ = false;
+            ++structure_version_;
+            return true;
+        }
+
+        auto size() const -> std::size_t { return ids_.size(); }
+        auto empty() const -> bool { return ids_.empty(); }
+
+        // Bumped whenever rows are added or reordered
+        auto get_structure_version() const -> std::uint64_t { return structure_version_; }
+
+        auto is_depth_first() const -> bool { return depth_first_; }
+
+        // One past the last row of the subtree rooted at row. Only meaningful while is_depth_first().
+        auto subtree_end(std::uint32_t row) const -> std::uint32_t { return subtree_end_[row]; }
+
+        // Row-indexed arrays for linear passes. Parent rows always precede children once sorted.
+        auto get_parent_rows() const -> const std::vector<std::uint32_t>& { return parent_; }
+        auto get_entities() const -> const std::vector<Entity>& { return entities_; }
+        auto get_ids() const -> const std::vector<Scene_Node_Id>& { return ids_; }
+
+        // Reorders rows into depth-first pre-order (roots in row order, children in sibling order).
+        auto sort_depth_first() -> void
+        {
+            if (depth_first_) {
+                return;
+            }
+
+            const auto count = ids_.size();
+            std::vector<std::uint32_t> order;
+            order.reserve(count);
+            for (std::uint32_t root = 0; root < count; ++root) {
+                if (parent_[root] != INVALID_ROW) {
+                    continue;
+                }
+                auto row = root;
+                while (true) {
+                    order.push_back(row);
+                    if (first_child_[row] != INVALID_ROW) {
+                        row = first_child_[row];
+                        continue;
+                    }
+                    while (row != root && next_sibling_[row] == INVALID_ROW) {
+                        row = parent_[row];
+                    }
+                    if (row == root) {
+                        break;
+                    }
+                    row = next_sibling_[row];
+                }
+            }
+
+            std::vector<std::uint32_t> new_row(count);
+            for (std::uint32_t i = 0; i < count; ++i) {
+                new_row[order[i]] = i;
+            }
+
+            auto remap = [&] (std::uint32_t old) { return old == INVALID_ROW ? INVALID_ROW : new_row[old]; };
+            permute(ids_, order, [] (Scene_Node_Id id) { return id; });
+            permute(entities_, order, [] (Entity e) { return e; });
+            permute(names_, order, [] (Name_Id name) { return name; });
+            permute(parent_, order, remap);
+            permute(first_child_, order, remap);
+            permute(last_child_, order, remap);
+            permute(next_sibling_, order, remap);
+            permute(prev_sibling_, order, remap);
+            for (std::uint32_t row = 0; row < count; ++row) {
+                row_of_id_[ids_[row]] = row;
+            }
+
+            // Children follow their parent, so accumulating sizes back to front yields every subtree range
+            for (std::uint32_t row = 0; row < count; ++row) {
+                subtree_end_[row] = row + 1;
+            }
+            for (auto row = static_cast<std::uint32_t>(count); row-- > 0;) {
+                if (parent_[row] != INVALID_ROW && subtree_end_[row] > subtree_end_[parent_[row]]) {
+                    subtree_end_[parent_[row]] = subtree_end_[row];
+                }
+            }
+
+            depth_first_ = true;
+            ++structure_version_;
+        }
+
+        auto clear() -> void
+        {
+            row_of_id_.clear();
+            ids_.clear();
+            entities_.clear();
+            names_.clear();
+            parent_.clear();
+            first_child_.clear();
+            last_child_.clear();
+            next_sibling_.clear();
+            prev_sibling_.clear();
+            subtree_end_.clear();
+            depth_first_ = true;
+            ++structure_version_;
+        }
+
+    private:
+        auto link_last(std::uint32_t row, std::uint32_t parent_row) -> void
+        {
+            parent_[row] = parent_row;
+            prev_sibling_[row] = last_child_[parent_row];
+            next_sibling_[row] = INVALID_ROW;
+            if (last_child_[parent_row] == INVALID_ROW) {
+                first_child_[parent_row] = row;
+            } else {
+                next_sibling_[last_child_[parent_row]] = row;
+            }
+            last_child_[parent_row] = row;
+        }
+
+        auto unlink(std::uint32_t row) -> void
+        {
+            auto parent = parent_[row];
+            auto prev = prev_sibling_[row];
+            auto next = next_sibling_[row];
+            if (prev != INVALID_ROW) {
+                next_sibling_[prev] = next;
+            } else if (parent != INVALID_ROW) {
+                first_child_[parent] = next;
+            }
+            if (next != INVALID_ROW) {
+                prev_sibling_[next] = prev;
+            } else if (parent != INVALID_ROW) {
+                last_child_[parent] = prev;
+            }
+            parent_[row] = INVALID_ROW;
+            prev_sibling_[row] = INVALID_ROW;
+            next_sibling_[row] = INVALID_ROW;
+        }
+
+        auto link(const std::vector<std::uint32_t>& rows, Scene_Node_Id id) const -> Scene_Node_Id
+        {
+            return contains(id) ? id_at(rows[row_of_id_[id]]) : INVALID_SCENE_NODE;
+        }
+
+        // A row appended last stays depth-first only if its parent's subtree (and so every
+        // ancestor's) ended at the previous last row; grows those ranges by one when it did
+        auto extend_subtrees_to_end(std::uint32_t row) -> bool
+        {
+            const auto end = static_cast<std::uint32_t>(ids_.size());
+            for (auto current = row; current != INVALID_ROW; current = parent_[current]) {
+                if (subtree_end_[current] != end - 1) {
+                    return false;
+                }
+                subtree_end_[current] = end;
+            }
+            return true;
+        }
+
+        template<typename T, typename Fn>
+        static auto permute(std::vector<T>& values, const std::vector<std::uint32_t>& order, Fn&& convert) -> void
+        {
+            std::vector<T> sorted;
+            sorted.reserve(values.size());
+            for (auto old : order) {
+                sorted.push_back(convert(values[old]));
+            }
+            values.swap(sorted);
+        }
+
+        std::vector<std::uint32_t> row_of_id_;      // indexed by Scene_Node_Id
+        std::vector<Scene_Node_Id> ids_;
+        std::vector<Entity> entities_;
+        std::vector<Name_Id> names_;
+        std::vector<std::uint32_t> parent_;
+        std::vector<std::uint32_t> first_child_;
+        std::vector<std::uint32_t> last_child_;
+        std::vector<std::uint32_t> next_sibling_;
+        std::vector<std::uint32_t> prev_sibling_;
+        std::vector<std::uint32_t> subtree_end_;
+        Name_Table name_table_;
+        std::uint64_t structure_version_ = 0;
+        bool depth_first_ = true;
+    };
+}
@@ -0,0 +1,298 @@
+#pragma once
+#include "base/entity.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mango::core
+{
+    struct ITwigStorage
+    {
+        virtual ~ITwigStorage() = default;
+        virtual void remove(Entity e) = 0;
+        virtual void clear() = 0;
+        virtual bool has(Entity e) const = 0;
+        virtual auto size() const -> std::size_t = 0;
+
+        // Bumped whenever an entity gains or loses this twig (not on overwrite)
+        auto get_structure_version() const -> std::uint64_t { return structure_version_; }
+
+        // Tick of the latest insert, overwrite, marked write or removal in this store
+        auto get_change_version() const -> std::uint64_t { return change_version_; }
+
+        // Change ticks are read from the owner's clock (the World tick); 0 without one
+        auto set_clock(const std::uint64_t* clock) -> void { clock_ = clock; }
+        auto current_tick() const -> std::uint64_t { return clock_ ? *clock_ : 0; }
+
+        // Appends entities removed at a tick >= since. Returns false when the log was
+        // already trimmed past since; the caller then has to resync from scratch.
+        auto removed_since(std::uint64_t since, std::vector<Entity>& out) const -> bool
+        {
+            if (since < removal_floor_) {
+                return false;
+            }
+            for (const auto& [entity, tick] : removals_) {
+                if (tick >= since) {
+                    out.push_back(entity);
+                }
+            }
+            return true;
+        }
+
+        // Forgets removals older than tick
+        auto trim_removals(std::uint64_t tick) -> void
+        {
+            if (tick <= removal_floor_) {
+                return;
+            }
+            std::size_t keep = 0;
+            while (keep < removals_.size() && removals_[keep].second < tick) {
+                ++keep;
+            }
+            removals_.erase(removals_.begin(), removals_.begin() + static_cast<std::ptrdiff_t>(keep));
+            removal_floor_ = tick;
+        }
+
+    protected:
+        auto log_removal(Entity e) -> void
+        {
+            auto tick = current_tick();
+            removals_.emplace_back(e, tick);
+            change_version_ = tick;
+        }
+
+        std::uint64_t structure_version_ = 0;
+        std::uint64_t change_version_ = 0;
+        std::uint64_t removal_floor_ = 0;
+        const std::uint64_t* clock_ = nullptr;
+        std::vector<std::pair<Entity, std::uint64_t>> removals_;
+    };
+
+    // Sparse-set twig storage.
+    // Twigs are packed contiguously in data_ (parallel to entities_ and ticks_), and a
+    // paged sparse array maps an entity index to its dense slot. Lookup is two array
+    // reads, insert appends, remove is swap-and-pop, iteration is a linear walk.
+    // ticks_ holds the tick each twig was last written at, for incremental consumers.
+    template<typename T>
+    struct TwigStorage: ITwigStorage
+    {
+    public:
+        static constexpr std::uint32_t INVALID_SLOT = 0xFFFFFFFF;
+
+    private:
+        static constexpr std::uint32_t PAGE_SIZE = 4096;
+        using Page = std::array<std::uint32_t, PAGE_SIZE>;
+
+        std::vector<T> data_;
+        std::vector<Entity> entities_;
+        std::vector<std::uint64_t> ticks_;
+        std::vector<std::unique_ptr<Page>> sparse_;
+
+        auto sparse_slot(std::uint32_t index) const -> std::uint32_t
+        {
+            auto page = index / PAGE_SIZE;
+            if (page >= sparse_.size() || !sparse_[page]) {
+                return INVALID_SLOT;
+            }
+            return (*sparse_[page])[index % PAGE_SIZE];
+        }
+
+        auto sparse_ref(std::uint32_t index) -> std::uint32_t&
+        {
+            auto page = index / PAGE_SIZE;
+            if (page >= sparse_.size()) {
+                sparse_.resize(page + 1);
+            }
+            if (!sparse_[page]) {
+                sparse_[page] = std::make_unique<Page>();
+                sparse_[page]->fill(INVALID_SLOT);
+            }
+            return (*sparse_[page])[index % PAGE_SIZE];
+        }
+
+        template<bool Const>
+        struct Iterator
+        {
+            using value_type = std::pair<Entity, std::conditional_t<Const, const T&, T&>>;
+            using difference_type = std::ptrdiff_t;
+            using iterator_category = std::forward_iterator_tag;
+            using storage_type = std::conditional_t<Const, const TwigStorage, TwigStorage>;
+
+            storage_type* storage = nullptr;
+            std::size_t slot = 0;
+
+            auto operator*() const -> value_type { return { storage->entities_[slot], storage->data_[slot] }; }
+            auto operator++() -> Iterator& { ++slot; return *this; }
+            auto operator++(int) -> Iterator { auto tmp = *this; ++slot; return tmp; }
+            bool operator==(const Iterator& other) const { return slot == other.slot; }
+            bool operator!=(const Iterator& other) const { return slot != other.slot; }
+        };
+
+    public:
+        using iterator = Iterator<false>;
+        using const_iterator = Iterator<true>;
+
+        // Returns true when the entity did not have this twig before.
+        template<typename U>
+        auto insert(Entity e, U&& value) -> bool
+        {
+            auto tick = current_tick();
+            change_version_ = tick;
+
+            auto& slot = sparse_ref(e.get_index());
+            if (slot != INVALID_SLOT) {
+                // Same index: either an overwrite, or a stale twig left by a recycled handle.
+                bool added = entities_[slot] != e;
+                if (added) {
+                    removals_.emplace_back(entities_[slot], tick);
+                    ++structure_version_;
+                }
+                entities_[slot] = e;
+                data_[slot] = std::forward<U>(value);
+                ticks_[slot] = tick;
+                return added;
+            }
+
+            slot = static_cast<std::uint32_t>(data_.size());
+            data_.push_back(std::forward<U>(value));
+            entities_.push_back(e);
+            ticks_.push_back(tick);
+            ++structure_version_;
+            return true;
+        }
+
+        T* get(Entity e)
+        {
+            auto slot = find_slot(e);
+            return slot != INVALID_SLOT ? &data_[slot] : nullptr;
+        }
+
+        const T* get(Entity e) const
+        {
+            auto slot = find_slot(e);
+            return slot != INVALID_SLOT ? &data_[slot] : nullptr;
+        }
+
+        void remove(Entity e) override
+        {
+            auto slot = find_slot(e);
+            if (slot == INVALID_SLOT) {
+                return;
+            }
+
+            auto last = static_cast<std::uint32_t>(data_.size() - 1);
+            if (slot != last) {
+                data_[slot] = std::move(data_[last]);
+                entities_[slot] = entities_[last];
+                ticks_[slot] = ticks_[last];
+                sparse_ref(entities_[slot].get_index()) = slot;
+            }
+            data_.pop_back();
+            entities_.pop_back();
+            ticks_.pop_back();
+            sparse_ref(e.get_index()) = INVALID_SLOT;
+            ++structure_version_;
+            log_removal(e);
+        }
+
+        // Stamps the entity's twig with the current tick. Returns false if it has none.
+        auto mark_changed(Entity e) -> bool
+        {
+            auto slot = find_slot(e);
+            if (slot == INVALID_SLOT) {
+                return false;
+            }
+            ticks_[slot] = current_tick();
+            change_version_ = ticks_[slot];
+            return true;
+        }
+
+        // Stamps one slot without touching the store-wide version, so distinct slots may be
+        // marked from several threads. Call mark_store_changed() once around such a batch.
+        auto mark_changed_slot(std::uint32_t slot) -> void
+        {
+            ticks_[slot] = current_tick();
+        }
+
+        auto mark_store_changed() -> void
+        {
+            change_version_ = current_tick();
+        }
+
+        auto get_change_tick(Entity e) const -> std::uint64_t
+        {
+            auto slot = find_slot(e);
+            return slot != INVALID_SLOT ? ticks_[slot] : 0;
+        }
+
+        // Calls fn(Entity, T&) for every twig written at a tick >= since
+        template<typename Fn>
+        auto each_changed_since(std::uint64_t since, Fn&& fn) -> void
+        {
+            if (change_version_ < since) {
+                return;
+            }
+            for (std::size_t slot = 0; slot < ticks_.size(); ++slot) {
+                if (ticks_[slot] >= since) {
+                    fn(entities_[slot], data_[slot]);
+                }
+            }
+        }
+
+        bool has(Entity e) const override
+        {
+            return find_slot(e) != INVALID_SLOT;
+        }
+
+        // Dense slot of the entity's twig, or INVALID_SLOT.
+        auto find_slot(Entity e) const -> std::uint32_t
+        {
+            auto slot = sparse_slot(e.get_index());
+            if (slot == INVALID_SLOT || entities_[slot] != e) {
+                return INVALID_SLOT;
+            }
+            return slot;
+        }
+
+        auto size() const -> std::size_t override { return data_.size(); }
+        auto empty() const -> bool { return data_.empty(); }
+
+        auto reserve(std::size_t count) -> void
+        {
+            data_.reserve(count);
+            entities_.reserve(count);
+            ticks_.reserve(count);
+        }
+
+        // Removals are not logged one by one; consumers older than this tick must resync
+        void clear() override
+        {
+            data_.clear();
+            entities_.clear();
+            ticks_.clear();
+            sparse_.clear();
+            ++structure_version_;
+            removals_.clear();
+            change_version_ = current_tick();
+            removal_floor_ = change_version_ + 1;
+        }
+
+        // Twigs in slot order; elements may be written in place, but the array itself only
+        // changes through insert/remove, which keep entities_, ticks_ and sparse_ in step
+        auto get_data() -> std::span<T> { return data_; }
+        auto get_data() const -> std::span<const T> { return data_; }
+        auto get_entities() const -> const std::vector<Entity>& { return entities_; }
+        auto get_ticks() const -> const std::vector<std::uint64_t>& { return ticks_; }
+
+        auto begin() -> iterator { return { this, 0 }; }
+        auto end() -> iterator { return { this, data_.size() }; }
+        auto begin() const -> const_iterator { return { this, 0 }; }
+        auto end() const -> const_iterator { return { this, data_.size() }; }
+    };
+}
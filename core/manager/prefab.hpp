@@ -0,0 +1,30 @@
+#pragma once
+#include <tuple>
+#include <utility>
+
+namespace mango::core
+{
+    // A fixed twig set with default values, spawned in bulk with World::instantiate:
+    //   Prefab crate{ Transform{}, mesh, material };
+    //   world.instantiate(crate, 10000, [] (std::size_t i, Entity, Transform& t, Mesh&, Pbr_Material&) { ... });
+    // Twigs are copied per instance, so large payloads should be shared (see resource::Mesh).
+    template<typename... Ts>
+    struct Prefab
+    {
+        static_assert(sizeof...(Ts) > 0, "Prefab needs at least one twig type");
+
+        std::tuple<Ts...> twigs;
+
+        Prefab() = default;
+        explicit Prefab(Ts... defaults) : twigs(std::move(defaults)...) {}
+
+        template<typename T>
+        auto get() -> T& { return std::get<T>(twigs); }
+
+        template<typename T>
+        auto get() const -> const T& { return std::get<T>(twigs); }
+    };
+
+    template<typename... Ts>
+    Prefab(Ts...) -> Prefab<Ts...>;
+}
@@ -1,33 +1,73 @@
 #include "scene-graph.hpp"
-#include <sstream>
+#include <vector>
 
 namespace mango::core
 {
     Scene_Graph::Scene_Graph()
     {
-        root = std::make_shared<Scene_Node>();
-        root->id = 0;
-        root->name = "Scene";
-        root->parent = nullptr;
-        root->children = nullptr;
-        root->next = nullptr;
-
+        root = hierarchy.add_node(INVALID_SCENE_NODE, INVALID_ENTITY, "Scene");
         current_selected_node = root;
+        index_subtree(root);
+    }
+
+    template<typename Fn>
+    auto Scene_Graph::for_each_in_subtree(Scene_Node_Id node, Fn&& fn) const -> void
+    {
+        auto current = node;
+        while (true) {
+            fn(current);
+            auto child = hierarchy.first_child_of(current);
+            if (child != INVALID_SCENE_NODE) {
+                current = child;
+                continue;
+            }
+            while (current != node && hierarchy.next_sibling_of(current) == INVALID_SCENE_NODE) {
+                current = hierarchy.parent_of(current);
+            }
+            if (current == node) {
+                return;
+            }
+            current = hierarchy.next_sibling_of(current);
+        }
     }
 
-    auto Scene_Graph::get_root_node() -> std::shared_ptr<Scene_Node>
+    auto Scene_Graph::index_subtree(Scene_Node_Id node) -> void
     {
-        return root;
+        // Parents come first in the walk, so each path extends its parent's indexed one
+        for_each_in_subtree(node, [&](Scene_Node_Id current) {
+            path_index.emplace(path_of(current), current);
+        });
     }
 
-    auto Scene_Graph::get_current_selected_node() -> std::shared_ptr<Scene_Node>
+    auto Scene_Graph::unindex_subtree(Scene_Node_Id node) -> void
     {
-        return current_selected_node;
+        std::vector<Scene_Node_Id> shadowed;
+        for_each_in_subtree(node, [&](Scene_Node_Id current) {
+            auto it = path_index.find(path_of(current));
+            if (it == path_index.end() || it->second != current) {
+                return;
+            }
+            path_index.erase(it);
+
+            // A same-named sibling was hidden behind this path; it takes the path over
+            auto name = hierarchy.name_id_of(current);
+            auto parent = hierarchy.parent_of(current);
+            auto sibling = parent != INVALID_SCENE_NODE ? hierarchy.first_child_of(parent) : INVALID_SCENE_NODE;
+            for (; sibling != INVALID_SCENE_NODE; sibling = hierarchy.next_sibling_of(sibling)) {
+                if (sibling != current && hierarchy.name_id_of(sibling) == name) {
+                    shadowed.push_back(sibling);
+                    break;
+                }
+            }
+        });
+        for (auto sibling : shadowed) {
+            index_subtree(sibling);
+        }
     }
 
-    auto Scene_Graph::set_current_selected_node(std::shared_ptr<Scene_Node> node) -> void
+    auto Scene_Graph::set_current_selected_node(Scene_Node_Id node) -> void
     {
-        if (node) {
+        if (hierarchy.contains(node)) {
             current_selected_node = node;
         }
     }
@@ -42,20 +82,15 @@ namespace mango::core
         return current_instance();
     }
 
-    auto Scene_Graph::path_of(std::shared_ptr<Scene_Node> node) -> std::string
+    auto Scene_Graph::path_of(Scene_Node_Id node) const -> std::string
     {
-        if (!node) {
+        if (!hierarchy.contains(node)) {
             return "";
         }
 
-        std::vector<std::string> parts;
-        auto current = node;
-        while (current) {
-            parts.push_back(current->name);
-            if (current == root) {
-                break;
-            }
-            current = current->parent;
+        std::vector<Scene_Node_Id> parts;
+        for (auto current = node; current != INVALID_SCENE_NODE; current = hierarchy.parent_of(current)) {
+            parts.push_back(current);
         }
 
         std::string path;
@@ -63,93 +98,114 @@ namespace mango::core
             if (!path.empty()) {
                 path += "/";
             }
-            path += *it;
+            path += hierarchy.name_of(*it);
         }
         return path;
     }
 
-    auto Scene_Graph::node_of(const std::string& path) -> std::shared_ptr<Scene_Node>
+    auto Scene_Graph::node_of(const std::string& path) const -> Scene_Node_Id
     {
-        std::stringstream ss(path);
-        std::string segment;
-        std::vector<std::string> parts;
-        while (std::getline(ss, segment, '/')) {
-            if (!segment.empty())
-                parts.push_back(segment);
-        }
-
-        if (parts.empty()) {
-            return root;
-        }
-
-        auto current = root;
-        size_t index = 0;
-        if (!parts.empty() && parts.front() == root->name) {
-            index = 1;
+        if (auto it = path_index.find(path); it != path_index.end()) {
+            return it->second;
         }
 
-        for (; index < parts.size(); ++index) {
-            const auto& name = parts[index];
-            bool found = false;
-            auto child = current->children;
-            while (child) {
-                if (child->name == name) {
-                    current = child;
-                    found = true;
-                    break;
+        // Normalize: drop empty segments and make the path start at the root
+        const auto& root_name = hierarchy.name_of(root);
+        std::string normalized;
+        std::size_t begin = 0;
+        bool first = true;
+        while (begin <= path.size()) {
+            auto end = path.find('/', begin);
+            if (end == std::string::npos) {
+                end = path.size();
+            }
+            std::string_view segment(path.data() + begin, end - begin);
+            if (!segment.empty()) {
+                if (first && segment != root_name) {
+                    normalized = root_name;
                 }
-                child = child->next;
+                if (!normalized.empty()) {
+                    normalized += '/';
+                }
+                normalized += segment;
+                first = false;
             }
+            begin = end + 1;
+        }
 
-            if (!found) {
-                return nullptr;
-            }
+        if (normalized.empty()) {
+            return root;
         }
+        auto it = path_index.find(normalized);
+        return it != path_index.end() ? it->second : INVALID_SCENE_NODE;
+    }
+
+    auto Scene_Graph::name_of(Scene_Node_Id node) const -> std::string
+    {
+        return hierarchy.name_of(node);
+    }
 
-        return current;
+    auto Scene_Graph::entity_of(Scene_Node_Id node) const -> Entity
+    {
+        return hierarchy.entity_of(node);
     }
 
-    auto Scene_Graph::name_of(std::shared_ptr<Scene_Node> node) -> std::string
+    auto Scene_Graph::node_of_entity(Entity entity) const -> Scene_Node_Id
     {
-        return node ? node->name : "";
+        auto it = entity_index.find(entity);
+        return it != entity_index.end() ? it->second : INVALID_SCENE_NODE;
     }
 
-    auto Scene_Graph::parent_of(std::shared_ptr<Scene_Node> node) -> std::shared_ptr<Scene_Node>
+    auto Scene_Graph::parent_of(Scene_Node_Id node) const -> Scene_Node_Id
     {
-        return node ? node->parent : nullptr;
+        return hierarchy.parent_of(node);
     }
 
-    auto Scene_Graph::first_child_of(std::shared_ptr<Scene_Node> node) -> std::shared_ptr<Scene_Node>
+    auto Scene_Graph::first_child_of(Scene_Node_Id node) const -> Scene_Node_Id
     {
-        return node ? node->children : nullptr;
+        return hierarchy.first_child_of(node);
     }
 
-    auto Scene_Graph::next_decendent_of(std::shared_ptr<Scene_Node> node) -> std::shared_ptr<Scene_Node>
+    auto Scene_Graph::next_decendent_of(Scene_Node_Id node) const -> Scene_Node_Id
     {
-        return node ? node->next : nullptr;
+        return hierarchy.next_sibling_of(node);
     }
 
-    auto Scene_Graph::add_entity_to_scene(Entity entity, std::shared_ptr<Scene_Node> parent, const std::string& name) -> std::shared_ptr<Scene_Node>
+    auto Scene_Graph::add_entity_to_scene(Entity entity, Scene_Node_Id parent, const std::string& name) -> Scene_Node_Id
     {
-        if (!parent) {
+        if (!hierarchy.contains(parent)) {
             parent = root;
         }
 
-        auto new_node = std::make_shared<Scene_Node>();
-        new_node->name = name.empty() ? ("Entity " + std::to_string(entity.id)) : name;
-        new_node->parent = parent;
+        auto node_name = name.empty() ? ("Entity " + std::to_string(entity.id)) : name;
+        auto node = hierarchy.add_node(parent, entity, node_name);
+        path_index.emplace(path_of(node), node);
+        entity_index[entity] = node;
+        return node;
+    }
 
-        if (parent->children) {
-            auto current = parent->children;
-            while (current->next) {
-                current = current->next;
-            }
-            current->next = new_node;
-        } else {
-            parent->children = new_node;
+    auto Scene_Graph::rename(Scene_Node_Id node, std::string_view name) -> bool
+    {
+        if (!hierarchy.contains(node) || name.empty() || name.find('/') != std::string_view::npos) {
+            return false;
+        }
+
+        unindex_subtree(node);
+        hierarchy.set_name(node, name);
+        index_subtree(node);
+        return true;
+    }
+
+    auto Scene_Graph::reparent(Scene_Node_Id node, Scene_Node_Id new_parent) -> bool
+    {
+        if (node == root || !hierarchy.contains(node) || !hierarchy.contains(new_parent)
+            || hierarchy.is_in_subtree(new_parent, node)) {
+            return false;
         }
 
-        entities_mapping.push_back({entity, new_node});
-        return new_node;
+        unindex_subtree(node);
+        hierarchy.reparent(node, new_parent);
+        index_subtree(node);
+        return true;
     }
 }
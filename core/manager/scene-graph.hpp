@@ -1,49 +1,80 @@
 #pragma once
 #include "data-struct/freelist.hpp"
-#include "data-struct/scene-node.hpp"
+#include "data-struct/scene-hierarchy.hpp"
 #include "data-struct/singleton.hpp"
 #include "base/gardener.hpp"
+#include <functional>
+#include <string>
+#include <string_view>
 #include <unordered_map>
-#include <memory>
-#include <vector>
 
 namespace mango::core
 {
 
+    // Scene hierarchy plus lookup indices kept in sync on add, rename and reparent:
+    // full path -> node and Entity <-> node, both O(1) on average. When siblings share
+    // a name, their shared path resolves to whichever was indexed first.
     struct Scene_Graph : core::Singleton<Scene_Graph>
     {
     private:
-        std::shared_ptr<Scene_Node> root;
-        std::shared_ptr<Scene_Node> current_selected_node;
-        std::vector<std::pair<Entity, std::shared_ptr<Scene_Node>>> entities_mapping;
+        struct Path_Hash
+        {
+            using is_transparent = void;
+            auto operator()(std::string_view path) const noexcept -> std::size_t { return std::hash<std::string_view>{}(path); }
+        };
+
+        Scene_Hierarchy hierarchy;
+        Scene_Node_Id root = INVALID_SCENE_NODE;
+        Scene_Node_Id current_selected_node = INVALID_SCENE_NODE;
+        std::unordered_map<std::string, Scene_Node_Id, Path_Hash, std::equal_to<>> path_index;
+        std::unordered_map<Entity, Scene_Node_Id> entity_index;
+
+        auto index_subtree(Scene_Node_Id node) -> void;
+        auto unindex_subtree(Scene_Node_Id node) -> void;
+        template<typename Fn>
+        auto for_each_in_subtree(Scene_Node_Id node, Fn&& fn) const -> void;
     public:
 
         Scene_Graph();
 
-        auto get_root_node() -> std::shared_ptr<Scene_Node>;
+        auto get_root_node() const -> Scene_Node_Id { return root; }
 
-        auto get_current_selected_node() -> std::shared_ptr<Scene_Node>;
+        auto get_current_selected_node() const -> Scene_Node_Id { return current_selected_node; }
 
-        auto set_current_selected_node(std::shared_ptr<Scene_Node> node) -> void;
+        auto set_current_selected_node(Scene_Node_Id node) -> void;
 
         auto read_write_graph() -> Scene_Graph*;
 
         auto read_only_graph() -> const Scene_Graph*;
 
-        auto path_of(std::shared_ptr<Scene_Node> node) -> std::string;
+        auto path_of(Scene_Node_Id node) const -> std::string;
 
-        auto node_of(const std::string& path) -> std::shared_ptr<Scene_Node>;
+        auto node_of(const std::string& path) const -> Scene_Node_Id;
 
-        auto name_of(std::shared_ptr<Scene_Node> node) -> std::string;
+        auto name_of(Scene_Node_Id node) const -> std::string;
 
-        auto parent_of(std::shared_ptr<Scene_Node> node) -> std::shared_ptr<Scene_Node>;
+        auto entity_of(Scene_Node_Id node) const -> Entity;
 
-        auto first_child_of(std::shared_ptr<Scene_Node> node) -> std::shared_ptr<Scene_Node>;
+        // Node an entity was added with, or INVALID_SCENE_NODE
+        auto node_of_entity(Entity entity) const -> Scene_Node_Id;
 
-        auto next_decendent_of(std::shared_ptr<Scene_Node> node) -> std::shared_ptr<Scene_Node>;
+        auto parent_of(Scene_Node_Id node) const -> Scene_Node_Id;
 
-        auto add_entity_to_scene(Entity entity, std::shared_ptr<Scene_Node> parent, const std::string& name = "") -> std::shared_ptr<Scene_Node>;
+        auto first_child_of(Scene_Node_Id node) const -> Scene_Node_Id;
 
-        auto get_entities_mapping() const -> const std::vector<std::pair<Entity, std::shared_ptr<Scene_Node>>>& { return entities_mapping; }
+        auto next_decendent_of(Scene_Node_Id node) const -> Scene_Node_Id;
+
+        auto add_entity_to_scene(Entity entity, Scene_Node_Id parent, const std::string& name = "") -> Scene_Node_Id;
+
+        auto rename(Scene_Node_Id node, std::string_view name) -> bool;
+
+        // Moves node and its subtree under new_parent. Fails for the root or when new_parent
+        // lies inside node's subtree.
+        auto reparent(Scene_Node_Id node, Scene_Node_Id new_parent) -> bool;
+
+        // Re-sorts node storage depth-first so subtrees are contiguous; cheap when already sorted
+        auto sort_depth_first() -> void { hierarchy.sort_depth_first(); }
+
+        auto get_hierarchy() const -> const Scene_Hierarchy& { return hierarchy; }
     };
 }
@@ -0,0 +1,143 @@
+#include "transform-propagation.hpp"
+#include "world.hpp"
+#include "scene-graph.hpp"
+#include "resource/transform.hpp"
+#include "resource/world_transform.hpp"
+#include "thread/worker-pool.hpp"
+#include <algorithm>
+#include <atomic>
+
+namespace mango::core
+{
+    auto Transform_Propagation::rebuild_rows(const Scene_Hierarchy& hierarchy) -> void
+    {
+        const auto count = static_cast<std::uint32_t>(hierarchy.size());
+        world_matrices_.assign(count, math::Mat4(1.0f));
+        dirty_.assign(count, 1);
+
+        row_of_entity_.clear();
+        const auto& entities = hierarchy.get_entities();
+        for (std::uint32_t row = 0; row < count; ++row) {
+            if (entities[row] != INVALID_ENTITY) {
+                row_of_entity_[entities[row]] = row;
+            }
+        }
+
+        // Each root row runs serially, then every child subtree of it is an independent task
+        subtree_ranges_.clear();
+        for (std::uint32_t root = 0; root < count; root = hierarchy.subtree_end(root)) {
+            for (auto child = root + 1; child < hierarchy.subtree_end(root); child = hierarchy.subtree_end(child)) {
+                subtree_ranges_.emplace_back(child, hierarchy.subtree_end(child));
+            }
+        }
+        hierarchy_version_ = hierarchy.get_structure_version();
+    }
+
+    auto Transform_Propagation::propagate(World& world, const Scene_Hierarchy& hierarchy, std::uint32_t first, std::uint32_t last) -> std::size_t
+    {
+        const auto* locals = world.get_twig_storage<resource::Transform>();
+        auto* results = world.get_twig_storage<resource::World_Transform>();
+        const auto& parents = hierarchy.get_parent_rows();
+        const auto& entities = hierarchy.get_entities();
+
+        std::size_t updated = 0;
+        for (auto row = first; row < last; ++row) {
+            auto parent = parents[row];
+            if (parent != Scene_Hierarchy::INVALID_ROW && dirty_[parent]) {
+                dirty_[row] = 1;
+            }
+            if (!dirty_[row]) {
+                continue;
+            }
+
+            auto entity = entities[row];
+            auto local_slot = locals ? locals->find_slot(entity) : TwigStorage<resource::Transform>::INVALID_SLOT;
+            auto local = local_slot != TwigStorage<resource::Transform>::INVALID_SLOT
+                ? locals->get_data()[local_slot].get_matrix()
+                : math::Mat4(1.0f);
+            world_matrices_[row] = parent != Scene_Hierarchy::INVALID_ROW ? world_matrices_[parent] * local : local;
+
+            auto result_slot = results ? results->find_slot(entity) : TwigStorage<resource::World_Transform>::INVALID_SLOT;
+            if (result_slot != TwigStorage<resource::World_Transform>::INVALID_SLOT) {
+                results->get_data()[result_slot].matrix = world_matrices_[row];
+                results->mark_changed_slot(result_slot);
+            }
+            ++updated;
+        }
+        return updated;
+    }
+
+    auto Transform_Propagation::run(World& world, Scene_Graph& graph) -> std::size_t
+    {
+        graph.sort_depth_first();
+        const auto& hierarchy = graph.get_hierarchy();
+
+        auto since = last_sync_;
+        last_sync_ = world.advance_tick();
+
+        bool full = since == 0 || hierarchy.get_structure_version() != hierarchy_version_;
+        if (full) {
+            rebuild_rows(hierarchy);
+        } else {
+            std::fill(dirty_.begin(), dirty_.end(), 0);
+        }
+
+        // A node whose Transform was removed falls back to its parent's matrix
+        changed_.clear();
+        if (!full && !world.removed_since<resource::Transform>(since, changed_)) {
+            std::fill(dirty_.begin(), dirty_.end(), 1);
+            full = true;
+        }
+        world.each_changed_since<resource::Transform>(full ? 0 : since, [&](Entity entity, resource::Transform&) {
+            changed_.push_back(entity);
+        });
+
+        // Structural work first: every entity with a Transform gets its World_Transform
+        loose_.clear();
+        for (auto entity : changed_) {
+            if (!world.is_entity_valid(entity)) {
+                continue;
+            }
+            if (auto it = row_of_entity_.find(entity); it != row_of_entity_.end()) {
+                dirty_[it->second] = 1;
+            } else if (world.has_twig<resource::Transform>(entity)) {
+                loose_.push_back(entity);
+            }
+            if (world.has_twig<resource::Transform>(entity) && !world.has_twig<resource::World_Transform>(entity)) {
+                world.attach_twig(entity, resource::World_Transform{});
+            }
+        }
+
+        std::size_t updated = 0;
+        for (std::uint32_t root = 0; root < hierarchy.size(); root = hierarchy.subtree_end(root)) {
+            updated += propagate(world, hierarchy, root, root + 1);
+        }
+
+        std::atomic<std::size_t> subtree_updates{0};
+        Worker_Pool::current_instance()->parallel_for(subtree_ranges_.size(), 1,
+            [&](std::size_t begin, std::size_t end, std::size_t) {
+                std::size_t local = 0;
+                for (auto i = begin; i < end; ++i) {
+                    local += propagate(world, hierarchy, subtree_ranges_[i].first, subtree_ranges_[i].second);
+                }
+                subtree_updates.fetch_add(local, std::memory_order_relaxed);
+            });
+        updated += subtree_updates.load(std::memory_order_relaxed);
+
+        const auto* locals = world.get_twig_storage<resource::Transform>();
+        if (auto* results = world.get_twig_storage<resource::World_Transform>()) {
+            for (auto entity : loose_) {
+                auto slot = results->find_slot(entity);
+                results->get_data()[slot].matrix = locals->get(entity)->get_matrix();
+                results->mark_changed_slot(slot);
+                ++updated;
+            }
+            if (updated > 0) {
+                results->mark_store_changed();
+            }
+        }
+
+        last_update_count_ = updated;
+        return updated;
+    }
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include "base/entity.hpp"
+#include "data-struct/scene-hierarchy.hpp"
+#include "math/math.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace mango::core
+{
+    struct World;
+    struct Scene_Graph;
+
+    // Composes local Transforms down the scene hierarchy into World_Transform twigs.
+    // Each run() sorts the hierarchy depth-first, marks nodes whose Transform was written
+    // or removed since the previous run, and recomputes only those nodes and their
+    // descendants in one linear pass (parents always precede children). Subtrees below
+    // each root are independent and are processed in parallel on the Worker_Pool.
+    // World matrices are kept contiguous by hierarchy row and copied into the
+    // World_Transform twig of each entity, which run() attaches on first sight.
+    // Entities with a Transform but no scene node are treated as roots.
+    class Transform_Propagation
+    {
+    public:
+        // Returns how many world matrices were recomputed
+        auto run(World& world, Scene_Graph& graph) -> std::size_t;
+
+        // Forces the next run() to recompute every node
+        auto invalidate() -> void { hierarchy_version_ = ~0ull; }
+
+        // Indexed by Scene_Hierarchy row as of the last run()
+        auto get_world_matrices() const -> const std::vector<math::Mat4>& { return world_matrices_; }
+
+        auto get_last_update_count() const -> std::size_t { return last_update_count_; }
+
+    private:
+        auto rebuild_rows(const Scene_Hierarchy& hierarchy) -> void;
+        auto propagate(World& world, const Scene_Hierarchy& hierarchy, std::uint32_t first, std::uint32_t last) -> std::size_t;
+
+        std::vector<math::Mat4> world_matrices_;
+        std::vector<std::uint8_t> dirty_;
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> subtree_ranges_;
+        std::unordered_map<Entity, std::uint32_t> row_of_entity_;
+        std::vector<Entity> changed_;
+        std::vector<Entity> loose_;
+        std::uint64_t last_sync_ = 0;
+        std::uint64_t hierarchy_version_ = ~0ull;
+        std::size_t last_update_count_ = 0;
+    };
+}
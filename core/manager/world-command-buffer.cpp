@@ -0,0 +1,93 @@
+#include "world-command-buffer.hpp"
+#include <algorithm>
+#include <tuple>
+
+namespace mango::core
+{
+    World_Command_Buffer::World_Command_Buffer(World& world)
+        : world_(&world), queues_(Worker_Pool::current_instance()->get_thread_count())
+    {
+
+    }
+
+    auto World_Command_Buffer::set_sort_key(std::uint64_t key) -> void
+    {
+        local_queue().sort_key = key;
+    }
+
+    auto World_Command_Buffer::create_entity() -> Entity
+    {
+        return world_->reserve_entity();
+    }
+
+    auto World_Command_Buffer::destroy_entity(Entity entity) -> void
+    {
+        record(entity, Phase::destroy, [entity] (World& world) {
+            world.destroy_entity(entity);
+        });
+    }
+
+    auto World_Command_Buffer::local_queue() -> Queue&
+    {
+        auto index = Worker_Pool::current_instance()->current_thread_index();
+        if (index >= queues_.size()) {
+            UKA_LOG_ERROR_FMT("World_Command_Buffer: thread index {} out of range", index);
+            throw std::runtime_error("World_Command_Buffer: thread index out of range");
+        }
+        return queues_[index];
+    }
+
+    auto World_Command_Buffer::record(Entity entity, Phase phase, std::function<void(World&)> apply) -> void
+    {
+        auto& queue = local_queue();
+        auto& commands = queue.commands;
+        commands.push_back({ entity, phase, queue.sort_key, static_cast<std::uint32_t>(commands.size()), std::move(apply) });
+    }
+
+    auto World_Command_Buffer::playback() -> void
+    {
+        world_->flush_reserved_entities();
+
+        // Commands under one key come from one queue, so the sequence orders them; the
+        // queue only breaks ties between threads that shared a key
+        struct Order
+        {
+            Phase phase;
+            std::uint64_t sort_key;
+            std::uint32_t sequence;
+            std::uint32_t queue;
+        };
+
+        std::vector<Order> order;
+        for (std::uint32_t queue = 0; queue < queues_.size(); ++queue) {
+            for (const auto& command : queues_[queue].commands) {
+                order.push_back({ command.phase, command.sort_key, command.sequence, queue });
+            }
+        }
+
+        std::sort(order.begin(), order.end(), [] (const Order& a, const Order& b) {
+            return std::tie(a.phase, a.sort_key, a.sequence, a.queue)
+                 < std::tie(b.phase, b.sort_key, b.sequence, b.queue);
+        });
+
+        for (const auto& item : order) {
+            auto& command = queues_[item.queue].commands[item.sequence];
+            // A handle destroyed earlier (or twice in this buffer) is skipped, not an error
+            if (!world_->is_entity_valid(command.entity)) {
+                UKA_LOG_WARN_FMT("World_Command_Buffer: skipping command for dead entity {}", command.entity.id);
+                continue;
+            }
+            command.apply(*world_);
+        }
+
+        for (auto& queue : queues_) {
+            queue.commands.clear();
+            queue.sort_key = 0;
+        }
+    }
+
+    auto World_Command_Buffer::empty() const -> bool
+    {
+        return std::all_of(queues_.begin(), queues_.end(), [] (const Queue& queue) { return queue.commands.empty(); });
+    }
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include "manager/world.hpp"
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace mango::core
+{
+    // Records structural World changes from systems, physics callbacks or pool jobs and
+    // applies them later with playback() at a sync point.
+    // Every thread appends to its own queue (indexed by Worker_Pool::current_thread_index;
+    // threads outside the pool use their external slot), so recording takes no lock.
+    // create_entity() hands out a real handle right away (reserved atomically in the World);
+    // it becomes valid when playback starts. Which index it gets depends on the order the
+    // threads reserved in, so the order of playback never does.
+    // Playback order: attaches/detaches first, then destroys, each group sorted by the
+    // sort key the command was recorded under and then by recording order. It is the same
+    // from run to run as long as every key is recorded by one thread at a time: key on the
+    // work, not the worker (the entity a par_each callback is visiting, a chunk index, a
+    // gardener id).
+    class World_Command_Buffer
+    {
+    public:
+        explicit World_Command_Buffer(World& world);
+
+        World_Command_Buffer(const World_Command_Buffer&) = delete;
+        World_Command_Buffer& operator=(const World_Command_Buffer&) = delete;
+
+        // Commands the calling thread records from now on sort under key (0 until set;
+        // every thread starts over at 0 after playback)
+        auto set_sort_key(std::uint64_t key) -> void;
+
+        auto create_entity() -> Entity;
+        auto destroy_entity(Entity entity) -> void;
+
+        template <typename T>
+        auto attach_twig(Entity entity, T value) -> void
+        {
+            record(entity, Phase::structure, [entity, value = std::move(value)] (World& world) {
+                world.attach_twig(entity, value);
+            });
+        }
+
+        template <typename T>
+        auto detach_twig(Entity entity) -> void
+        {
+            record(entity, Phase::structure, [entity] (World& world) {
+                if (world.has_twig<T>(entity)) {
+                    world.detach_twig<T>(entity);
+                }
+            });
+        }
+
+        // Applies and clears every recorded command. Must run on the World's owning thread
+        // while nothing else touches the World or records into this buffer.
+        auto playback() -> void;
+
+        auto empty() const -> bool;
+
+    private:
+        enum class Phase : std::uint8_t
+        {
+            structure = 0,
+            destroy = 1
+        };
+
+        struct Command
+        {
+            Entity entity;
+            Phase phase;
+            std::uint64_t sort_key;
+            std::uint32_t sequence;
+            std::function<void(World&)> apply;
+        };
+
+        // Padded so neighbouring threads never write the same cache line
+        struct alignas(64) Queue
+        {
+            std::vector<Command> commands;
+            std::uint64_t sort_key = 0;
+        };
+
+        auto local_queue() -> Queue&;
+        auto record(Entity entity, Phase phase, std::function<void(World&)> apply) -> void;
+
+        World* world_;
+        std::vector<Queue> queues_;
+    };
+}
@@ -0,0 +1,206 @@
+#pragma once
+#include "base/entity.hpp"
+#include "data-struct/twig-storage.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mango::core
+{
+    // Twig types a view must NOT have: world.view<A, B>(core::exclude<C>)
+    template<typename... Ts>
+    struct Exclude {};
+
+    template<typename... Ts>
+    inline constexpr Exclude<Ts...> exclude{};
+
+    // Declared access for World::par_each. A bare twig type means Write<T>.
+    template<typename T>
+    struct Read {};
+
+    template<typename T>
+    struct Write {};
+
+    template<typename A>
+    struct Twig_Access
+    {
+        using type = A;
+        using reference = A&;
+        static constexpr bool writes = true;
+    };
+
+    template<typename T>
+    struct Twig_Access<Read<T>>
+    {
+        using type = T;
+        using reference = const T&;
+        static constexpr bool writes = false;
+    };
+
+    template<typename T>
+    struct Twig_Access<Write<T>>
+    {
+        using type = T;
+        using reference = T&;
+        static constexpr bool writes = true;
+    };
+
+    // True when a twig type appears more than once (e.g. Read<A> together with Write<A>)
+    template<typename... Ts>
+    struct Has_Duplicate_Twig : std::false_type {};
+
+    template<typename T, typename... Rest>
+    struct Has_Duplicate_Twig<T, Rest...>
+        : std::bool_constant<(std::is_same_v<T, Rest> || ...) || Has_Duplicate_Twig<Rest...>::value> {};
+
+    // Match list shared by every view with the same include/exclude signature.
+    // slots holds one row per matching entity: the dense slot of each included twig.
+    struct View_Cache
+    {
+        std::uint64_t signature = ~0ull;
+        std::vector<Entity> entities;
+        std::vector<std::uint32_t> slots;
+    };
+
+    template<typename Excluded, typename... Ts>
+    class World_View;
+
+    // Multi-twig query. Iteration is driven by the smallest included store and the
+    // resulting match list is cached until one of the involved stores changes
+    // structurally, so each() is a linear walk over slot rows with no lookups.
+    // Attaching/detaching twigs of the involved types inside each() is not allowed.
+    template<typename... Xs, typename... Ts>
+    class World_View<Exclude<Xs...>, Ts...>
+    {
+        static_assert(sizeof...(Ts) > 0, "World_View needs at least one twig type");
+        static constexpr std::size_t TWIG_COUNT = sizeof...(Ts);
+
+    public:
+        World_View(std::tuple<TwigStorage<Ts>*...> stores,
+                   std::tuple<const TwigStorage<Xs>*...> excluded,
+                   View_Cache& cache)
+            : stores_(stores), excluded_(excluded), cache_(&cache)
+        {
+            valid_ = std::apply([] (auto*... store) { return ((store != nullptr) && ...); }, stores_);
+        }
+
+        template<typename Fn>
+        auto each(Fn&& fn) -> void
+        {
+            refresh();
+            if (!valid_) {
+                return;
+            }
+
+            auto bases = std::apply([] (auto*... store) { return std::make_tuple(store->get_data().data()...); }, stores_);
+            const auto& entities = cache_->entities;
+            const std::uint32_t* row = cache_->slots.data();
+            for (std::size_t i = 0; i < entities.size(); ++i, row += TWIG_COUNT) {
+                invoke_row(fn, entities[i], row, bases, std::index_sequence_for<Ts...>{});
+            }
+        }
+
+        // Visits cached rows [first, last) without refreshing the match list.
+        // Call size() once beforehand; safe to run from several threads on disjoint ranges.
+        template<typename Fn>
+        auto each_rows(std::size_t first, std::size_t last, Fn&& fn) const -> void
+        {
+            if (!valid_) {
+                return;
+            }
+
+            auto bases = std::apply([] (auto*... store) { return std::make_tuple(store->get_data().data()...); }, stores_);
+            const auto& entities = cache_->entities;
+            const std::uint32_t* row = cache_->slots.data() + first * TWIG_COUNT;
+            for (std::size_t i = first; i < last; ++i, row += TWIG_COUNT) {
+                invoke_row(fn, entities[i], row, bases, std::index_sequence_for<Ts...>{});
+            }
+        }
+
+        auto size() -> std::size_t
+        {
+            refresh();
+            return valid_ ? cache_->entities.size() : 0;
+        }
+
+        auto empty() -> bool { return size() == 0; }
+
+        auto get_entities() -> const std::vector<Entity>&
+        {
+            static const std::vector<Entity> no_entities;
+            refresh();
+            return valid_ ? cache_->entities : no_entities;
+        }
+
+    private:
+        template<typename Fn, typename Bases, std::size_t... I>
+        static auto invoke_row(Fn& fn, Entity entity, const std::uint32_t* row, const Bases& bases, std::index_sequence<I...>) -> void
+        {
+            if constexpr (std::is_invocable_v<Fn&, Entity, Ts&...>) {
+                fn(entity, std::get<I>(bases)[row[I]]...);
+            } else {
+                fn(std::get<I>(bases)[row[I]]...);
+            }
+        }
+
+        auto signature() const -> std::uint64_t
+        {
+            // Structure versions only grow, so their sum changes whenever any of them does
+            std::uint64_t sum = 0;
+            std::apply([&] (auto*... store) { ((sum += store ? store->get_structure_version() : 0), ...); }, stores_);
+            std::apply([&] (auto*... store) { ((sum += store ? store->get_structure_version() : 0), ...); }, excluded_);
+            return sum;
+        }
+
+        template<std::size_t... I>
+        auto fill_row(Entity entity, std::array<std::uint32_t, TWIG_COUNT>& row, std::index_sequence<I...>) const -> bool
+        {
+            return ((row[I] = std::get<I>(stores_)->find_slot(entity), row[I] != TwigStorage<Ts>::INVALID_SLOT) && ...);
+        }
+
+        auto refresh() -> void
+        {
+            if (!valid_) {
+                return;
+            }
+
+            auto current = signature();
+            if (cache_->signature == current) {
+                return;
+            }
+
+            const std::vector<Entity>* driver = nullptr;
+            std::apply([&] (auto*... store) {
+                ((driver = (!driver || store->size() < driver->size()) ? &store->get_entities() : driver), ...);
+            }, stores_);
+
+            cache_->entities.clear();
+            cache_->slots.clear();
+            cache_->entities.reserve(driver->size());
+            cache_->slots.reserve(driver->size() * TWIG_COUNT);
+
+            std::array<std::uint32_t, TWIG_COUNT> row{};
+            for (auto entity : *driver) {
+                if (!fill_row(entity, row, std::index_sequence_for<Ts...>{})) {
+                    continue;
+                }
+                bool excluded = std::apply([&] (auto*... store) { return ((store && store->has(entity)) || ...); }, excluded_);
+                if (excluded) {
+                    continue;
+                }
+                cache_->entities.push_back(entity);
+                cache_->slots.insert(cache_->slots.end(), row.begin(), row.end());
+            }
+            cache_->signature = current;
+        }
+
+        std::tuple<TwigStorage<Ts>*...> stores_;
+        std::tuple<const TwigStorage<Xs>*...> excluded_;
+        View_Cache* cache_ = nullptr;
+        bool valid_ = false;
+    };
+}
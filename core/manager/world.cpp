@@ -27,15 +27,76 @@ namespace mango::core
         return entities.allocate();
     }
 
+    auto World::create_entities(std::size_t count) -> std::vector<Entity>
+    {
+        entities.flush_reserved();
+        entities.reserve_capacity(count);
+
+        std::vector<Entity> created;
+        created.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            created.push_back(entities.allocate());
+        }
+        return created;
+    }
+
+    auto World::reserve_entity() -> Entity
+    {
+        return entities.reserve();
+    }
+
+    auto World::flush_reserved_entities() -> void
+    {
+        entities.flush_reserved();
+    }
+
     auto World::destroy_entity(Entity entity) -> bool
     {
+        entities.flush_reserved();
+        if (!entities.exists(entity)) {
+            return false;
+        }
+
+        // Drop the entity's twigs so a recycled index never sees stale data
+        for (TwigID id = 0; id < twig_stores.size(); ++id) {
+            auto& store = twig_stores[id];
+            if (!store || !store->has(entity)) {
+                continue;
+            }
+            notify(Gardener_Event::PRE_LOPPER, entity, id);
+            store->remove(entity);
+            notify(Gardener_Event::POST_LOPPER, entity, id);
+        }
         return entities.deallocate(entity);
     }
 
+    auto World::advance_tick() -> std::uint64_t
+    {
+        ++current_tick;
+        if (current_tick > REMOVAL_LOG_TICKS) {
+            for (auto& store : twig_stores) {
+                if (store) {
+                    store->trim_removals(current_tick - REMOVAL_LOG_TICKS);
+                }
+            }
+        }
+        return current_tick;
+    }
+
     void World::clear_all()
     {
-        twig_stores.clear();
-        entities = EntityList();
+        // Live views point at their cache and at the stores: empty both in place, so such
+        // a view refreshes on its next use instead of reading freed memory
+        for (auto& [key, cache] : view_caches) {
+            cache = View_Cache{};
+        }
+        for (auto& store : twig_stores) {
+            if (store) {
+                store->clear();
+            }
+        }
+        entities.clear();
+        cleared_tick = current_tick++;
     }
 
 }
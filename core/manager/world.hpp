@@ -1,70 +1,128 @@
 #pragma once
 #include "base/entity.hpp"
 #include "base/twig.hpp"
+#include "base/gardener.hpp"
 #include "data-struct/freelist.hpp"
+#include "data-struct/twig-storage.hpp"
 #include "data-struct/singleton.hpp"
+#include "manager/world-view.hpp"
+#include "manager/prefab.hpp"
+#include "thread/worker-pool.hpp"
 #include "log/historiographer.hpp"
 #include <unordered_map>
-#include <unordered_set>
+#include <algorithm>
 #include <memory>
+#include <numeric>
+#include <stdexcept>
 
 namespace mango::core
 {
-    struct Scene_Node;
     struct Scene_Graph;
 
-    struct ITwigStorage
-    {
-        virtual ~ITwigStorage() = default;
-        virtual void remove(Entity e) = 0;
-        virtual bool has(Entity e) const = 0;
-    };
-
-    template<typename T>
-    struct TwigStorage: ITwigStorage
+    struct World: core::Singleton<World>
     {
-        std::unordered_map<Entity, T> data;
+    private:
+        EntityList entities;
+        // Indexed by TwigID; engine twigs occupy the fixed low slots
+        std::vector<std::unique_ptr<ITwigStorage>> twig_stores;
+        std::unordered_map<std::size_t, View_Cache> view_caches;
+        std::uint64_t current_tick = 1;
+        std::uint64_t cleared_tick = 0;
+        Gardener_Registry* gardeners = nullptr;
 
-        void insert(Entity e, const T& value)
+        auto notify(Gardener_Event event, Entity entity, TwigID id) -> void
         {
-            data[e] = value;
+            if (gardeners) {
+                gardeners->trigger_event(event, entity, id);
+            }
         }
 
-        T* get(Entity e)
+        auto notify(Gardener_Event event, std::span<const Entity> targets, TwigID id) -> void
         {
-            auto it = data.find(e);
-            return (it != data.end()) ? &it->second : nullptr;
+            if (gardeners) {
+                gardeners->trigger_events(event, targets, id);
+            }
         }
 
-        void remove(Entity e) override
+        template <typename T>
+        auto get_or_create_store(TwigID id) -> TwigStorage<T>&
         {
-            data.erase(e);
+            if (id >= twig_stores.size()) {
+                twig_stores.resize(std::max<std::size_t>(id + 1, ENGINE_TWIG_SLOTS));
+            }
+            auto& slot = twig_stores[id];
+            if (!slot) {
+                auto store = std::make_unique<TwigStorage<T>>();
+                store->set_clock(&current_tick);
+                slot = std::move(store);
+            }
+            return *static_cast<TwigStorage<T>*>(slot.get());
         }
 
-        bool has(Entity e) const override
+        template <typename... Access, typename Scratch, typename Fn>
+        auto par_each_impl(std::vector<Scratch>* scratch, Fn&& fn, std::size_t grain) -> void
         {
-            return data.find(e) != data.end();
+            static_assert(sizeof...(Access) > 0, "par_each needs at least one twig type");
+            static_assert(!Has_Duplicate_Twig<typename Twig_Access<Access>::type...>::value,
+                "par_each: a twig type is requested more than once (conflicting access)");
+
+            auto& pool = *Worker_Pool::current_instance();
+            std::vector<Scratch> no_scratch;
+            auto& locals = scratch ? *scratch : no_scratch;
+            if (locals.size() < pool.get_thread_count()) {
+                locals.resize(pool.get_thread_count());
+            }
+
+            auto view = this->view<typename Twig_Access<Access>::type...>();
+            auto count = view.size();
+
+            // Round chunks so neighbouring workers never share a cache line of the
+            // first written twig array (or the first twig if all are read-only).
+            constexpr std::size_t twig_size = first_written_size<Access...>();
+            constexpr std::size_t line_rows = 64 / std::gcd(twig_size, std::size_t{64});
+            grain = (std::max<std::size_t>(grain, 1) + line_rows - 1) / line_rows * line_rows;
+
+            // Written twigs get their change tick stamped per row
+            auto stores = std::make_tuple(get_twig_storage<typename Twig_Access<Access>::type>()...);
+            if (count > 0) {
+                (mark_written<Access>(std::get<TwigStorage<typename Twig_Access<Access>::type>*>(stores)), ...);
+            }
+
+            pool.parallel_for(count, grain, [&](std::size_t begin, std::size_t end, std::uint32_t thread_index) {
+                auto& local = locals[thread_index];
+                view.each_rows(begin, end, [&](Entity entity, typename Twig_Access<Access>::type&... twigs) {
+                    (mark_written<Access>(std::get<TwigStorage<typename Twig_Access<Access>::type>*>(stores), &twigs), ...);
+                    fn(local, entity, static_cast<typename Twig_Access<Access>::reference>(twigs)...);
+                });
+            });
         }
-    };
 
-    struct World: core::Singleton<World>
-    {
-    private:
-        EntityList entities;
-        std::unordered_map<TwigID, std::unique_ptr<ITwigStorage>> twig_stores;
+        // Without a twig pointer bumps the store version, otherwise stamps that twig's slot
+        template <typename A, typename T>
+        static auto mark_written(TwigStorage<T>* store, T* twig = nullptr) -> void
+        {
+            if constexpr (Twig_Access<A>::writes) {
+                if (!twig) {
+                    store->mark_store_changed();
+                } else {
+                    store->mark_changed_slot(static_cast<std::uint32_t>(twig - store->get_data().data()));
+                }
+            }
+        }
 
-        template <typename T>
-        auto get_or_create_store(TwigID id) -> TwigStorage<T>&
+        template <typename... Access>
+        static constexpr auto first_written_size() -> std::size_t
         {
-            auto it = twig_stores.find(id);
-            if (it == twig_stores.end()) {
-                auto store = std::make_unique<TwigStorage<T>>();
-                auto* raw_store = store.get();
-                twig_stores.emplace(id, std::move(store));
-                return *raw_store;
+            std::size_t sizes[] = { sizeof(typename Twig_Access<Access>::type)... };
+            bool writes[] = { Twig_Access<Access>::writes... };
+            for (std::size_t i = 0; i < sizeof...(Access); ++i) {
+                if (writes[i]) {
+                    return sizes[i];
+                }
             }
-            return *static_cast<TwigStorage<T>*>(it->second.get());
+            return sizes[0];
         }
+
     public:
         World();
         ~World();
@@ -75,9 +133,86 @@ namespace mango::core
         auto create_entity() -> Entity;
         auto destroy_entity(Entity entity) -> bool;
 
+        // Graft/lopper events of attach/detach/destroy and the bulk paths go to this
+        // registry (per-entity to opted-in gardeners, batched at its flush_events()).
+        auto set_gardener_registry(Gardener_Registry* registry) -> void { gardeners = registry; }
+        auto get_gardener_registry() const -> Gardener_Registry* { return gardeners; }
+
+        // Allocates count entities in one go (slot arrays grow once)
+        auto create_entities(std::size_t count) -> std::vector<Entity>;
+
+        // Spawns count entities with every twig of the prefab. Storage for each twig is
+        // reserved once and all columns are filled in a single pass; init_fn (optional)
+        // customises instance i in place before it is stored:
+        //   init_fn(std::size_t i, Entity entity, Ts&... twigs)
+        template <typename... Ts, typename Init_Fn>
+        auto instantiate(const Prefab<Ts...>& prefab, std::size_t count, Init_Fn&& init_fn) -> std::vector<Entity>
+        {
+            static_assert(!Has_Duplicate_Twig<Ts...>::value, "instantiate: prefab lists a twig type twice");
+
+            auto spawned = create_entities(count);
+            auto stores = std::make_tuple(&get_or_create_store<Ts>(Ts::get_static_id())...);
+            std::apply([&] (auto*... store) { (store->reserve(store->size() + count), ...); }, stores);
+
+            (notify(Gardener_Event::PRE_GRAFT, spawned, Ts::get_static_id()), ...);
+            for (std::size_t i = 0; i < count; ++i) {
+                auto twigs = prefab.twigs;
+                std::apply([&] (Ts&... values) { init_fn(i, spawned[i], values...); }, twigs);
+                (std::get<TwigStorage<Ts>*>(stores)->insert(spawned[i], std::move(std::get<Ts>(twigs))), ...);
+            }
+            (notify(Gardener_Event::POST_GRAFT, spawned, Ts::get_static_id()), ...);
+            return spawned;
+        }
+
+        template <typename... Ts>
+        auto instantiate(const Prefab<Ts...>& prefab, std::size_t count) -> std::vector<Entity>
+        {
+            return instantiate(prefab, count, [] (std::size_t, Entity, Ts&...) {});
+        }
+
+        // Attaches the same twig value to many entities with a single storage reservation
+        template <typename T>
+        auto attach_twig_bulk(const std::vector<Entity>& targets, const T& value) -> void
+        {
+            flush_reserved_entities();
+            auto& store = get_or_create_store<T>(T::get_static_id());
+            store.reserve(store.size() + targets.size());
+            for (auto entity : targets) {
+                if (!is_entity_valid(entity)) {
+                    UKA_LOG_ERROR_FMT("attach_twig_bulk failed: invalid entity {}", entity.id);
+                    throw std::runtime_error("attach_twig_bulk: invalid entity");
+                }
+            }
+
+            notify(Gardener_Event::PRE_GRAFT, targets, T::get_static_id());
+            for (auto entity : targets) {
+                store.insert(entity, value);
+            }
+            notify(Gardener_Event::POST_GRAFT, targets, T::get_static_id());
+        }
+
+        // Thread-safe handle reservation for deferred creation (see World_Command_Buffer).
+        // Reserved handles become valid at flush_reserved_entities(), which every other
+        // structural call performs implicitly. Must not race with structural changes.
+        auto reserve_entity() -> Entity;
+        auto flush_reserved_entities() -> void;
+
+        // Removals older than this many ticks are dropped from the per-store logs
+        static constexpr std::uint64_t REMOVAL_LOG_TICKS = 64;
+
+        // Change tracking. attach_twig, mutable get_twig, par_each Write<T> and mark_changed
+        // stamp the twig with the current tick. An incremental consumer keeps the tick it
+        // last synced at and asks for everything stamped since:
+        //   auto since = last_sync;
+        //   last_sync = world.advance_tick();
+        //   world.each_changed_since<Transform>(since, [] (Entity e, Transform& t) { ... });
+        auto get_tick() const -> std::uint64_t { return current_tick; }
+        auto advance_tick() -> std::uint64_t;
+
         template <typename T>
         auto attach_twig(Entity entity, const T& value) -> void
         {
+            flush_reserved_entities();
             if (!is_entity_valid(entity)) {
                 UKA_LOG_ERROR_FMT("attach_twig failed: invalid entity {}", entity.id);
                 throw std::runtime_error("attach_twig: invalid entity");
@@ -85,30 +220,39 @@ namespace mango::core
 
             auto id = T::get_static_id();
             auto& store = get_or_create_store<T>(id);
+            if (store.has(entity)) {
+                store.insert(entity, value);
+                return;
+            }
+
+            notify(Gardener_Event::PRE_GRAFT, entity, id);
             store.insert(entity, value);
+            notify(Gardener_Event::POST_GRAFT, entity, id);
         }
 
         template <typename T>
         auto detach_twig(Entity entity) -> void
         {
+            flush_reserved_entities();
             if (!is_entity_valid(entity)) {
                 UKA_LOG_ERROR_FMT("detach_twig failed: invalid entity {}", entity.id);
                 throw std::runtime_error("detach_twig: invalid entity");
             }
 
-            auto id = T::get_static_id();
-            auto it = twig_stores.find(id);
-            if (it == twig_stores.end()) {
+            auto* store_ptr = get_twig_storage<T>();
+            if (!store_ptr) {
                 UKA_LOG_ERROR_FMT("detach_twig failed: twig type {} not exist", T::get_static_id());
                 throw std::runtime_error("detach_twig: twig type not exist");
             }
 
-            auto& store = *static_cast<TwigStorage<T>*>(it->second.get());
+            auto& store = *store_ptr;
             if (!store.has(entity)) {
                 UKA_LOG_ERROR_FMT("detach_twig failed: entity {} does not have this twig", entity.id);
                 throw std::runtime_error("detach_twig: entity does not have this twig");
             }
+            notify(Gardener_Event::PRE_LOPPER, entity, T::get_static_id());
             store.remove(entity);
+            notify(Gardener_Event::POST_LOPPER, entity, T::get_static_id());
         }
 
         template <typename T>
@@ -119,13 +263,8 @@ namespace mango::core
                 throw std::runtime_error("has_twig: invalid entity");
             }
 
-            auto id = T::get_static_id();
-            auto it = twig_stores.find(id);
-            if (it == twig_stores.end()) {
-                return false;
-            }
-            auto& store = *static_cast<TwigStorage<T>*>(it->second.get());
-            return store.has(entity);
+            const auto* store = get_twig_storage<T>();
+            return store && store->has(entity);
         }
 
         template <typename T>
@@ -136,42 +275,148 @@ namespace mango::core
                 throw std::runtime_error("get_twig: invalid entity");
             }
 
-            auto id = T::get_static_id();
-            auto it = twig_stores.find(id);
-            if (it == twig_stores.end()) {
+            auto* store_ptr = get_twig_storage<T>();
+            if (!store_ptr) {
                 UKA_LOG_ERROR_FMT("get_twig failed: twig type {} not exist", T::get_static_id());
                 throw std::runtime_error("get_twig: twig type not exist");
             }
 
-            auto& store = *static_cast<TwigStorage<T>*>(it->second.get());
-            if (!store.has(entity)) {
+            auto& store = *store_ptr;
+            auto slot = store.find_slot(entity);
+            if (slot == TwigStorage<T>::INVALID_SLOT) {
                 UKA_LOG_ERROR_FMT("get_twig failed: entity {} does not have this twig", entity.id);
                 throw std::runtime_error("get_twig: entity does not have this twig");
             }
 
-            return *store.get(entity);
+            // Mutable access counts as a write; use the const overload to only read
+            store.mark_changed_slot(slot);
+            store.mark_store_changed();
+            return store.get_data()[slot];
+        }
+
+        template <typename T>
+        auto get_twig(Entity entity) const -> const T&
+        {
+            if (!is_entity_valid(entity)) {
+                UKA_LOG_ERROR_FMT("get_twig failed: invalid entity {}", entity.id);
+                throw std::runtime_error("get_twig: invalid entity");
+            }
+
+            const auto* store = get_twig_storage<T>();
+            if (!store) {
+                UKA_LOG_ERROR_FMT("get_twig failed: twig type {} not exist", T::get_static_id());
+                throw std::runtime_error("get_twig: twig type not exist");
+            }
+
+            const auto* twig = store->get(entity);
+            if (!twig) {
+                UKA_LOG_ERROR_FMT("get_twig failed: entity {} does not have this twig", entity.id);
+                throw std::runtime_error("get_twig: entity does not have this twig");
+            }
+            return *twig;
+        }
+
+        // Stamps a twig written through a view or a cached reference
+        template <typename T>
+        auto mark_changed(Entity entity) -> void
+        {
+            if (auto* store = get_twig_storage<T>()) {
+                store->mark_changed(entity);
+            }
+        }
+
+        template <typename T, typename Fn>
+        auto each_changed_since(std::uint64_t since, Fn&& fn) -> void
+        {
+            if (auto* store = get_twig_storage<T>()) {
+                store->each_changed_since(since, std::forward<Fn>(fn));
+            }
+        }
+
+        template <typename T>
+        auto changed_since(std::uint64_t since) -> std::vector<Entity>
+        {
+            std::vector<Entity> changed;
+            each_changed_since<T>(since, [&](Entity entity, T&) { changed.push_back(entity); });
+            return changed;
         }
 
+        // Entities that lost twig T at a tick >= since (detach or destroy). Returns false
+        // when since is older than the kept log, in which case the consumer must resync.
+        template <typename T>
+        auto removed_since(std::uint64_t since, std::vector<Entity>& out) const -> bool
+        {
+            if (since <= cleared_tick) {
+                return false;
+            }
+            const auto* store = get_twig_storage<T>();
+            return store ? store->removed_since(since, out) : true;
+        }
+
+        // One bounds check and one array read; engine twigs resolve their id at compile time
         template <typename T>
         auto get_twig_storage() -> TwigStorage<T>*
         {
             auto id = T::get_static_id();
-            auto it = twig_stores.find(id);
-            if (it == twig_stores.end()) {
-                return nullptr;
-            }
-            return static_cast<TwigStorage<T>*>(it->second.get());
+            return id < twig_stores.size() ? static_cast<TwigStorage<T>*>(twig_stores[id].get()) : nullptr;
         }
 
         template <typename T>
         auto get_twig_storage() const -> const TwigStorage<T>*
         {
             auto id = T::get_static_id();
-            auto it = twig_stores.find(id);
-            if (it == twig_stores.end()) {
-                return nullptr;
-            }
-            return static_cast<const TwigStorage<T>*>(it->second.get());
+            return id < twig_stores.size() ? static_cast<const TwigStorage<T>*>(twig_stores[id].get()) : nullptr;
+        }
+
+        // Entities having all of Ts... (and none of the excluded twigs):
+        //   world.view<Transform, Model>().each([] (Entity e, Transform& t, Model& m) { ... });
+        //   world.view<Transform>(core::exclude<Light>).each(...);
+        template <typename... Ts, typename... Xs>
+        auto view(Exclude<Xs...> = {}) -> World_View<Exclude<Xs...>, Ts...>
+        {
+            // Include order matters (it fixes the slot row layout), exclude order does not
+            TwigSet include_set{ Ts::get_static_id()... };
+            TwigSet exclude_set;
+            (insert_twig(exclude_set, Xs::get_static_id()), ...);
+            auto key = hash_twigs(include_set) ^ (hash_twigs(exclude_set) * 0x9E3779B97F4A7C15ull);
+
+            return World_View<Exclude<Xs...>, Ts...>(
+                std::make_tuple(get_twig_storage<Ts>()...),
+                std::make_tuple(static_cast<const TwigStorage<Xs>*>(get_twig_storage<Xs>())...),
+                view_caches[key]);
+        }
+
+        // Parallel view iteration on the Worker_Pool. Access is part of the signature:
+        //   world.par_each<Read<Transform>, Write<World_Transform>>(
+        //       [] (Entity e, const Transform& t, World_Transform& w) { ... });
+        // Read<T> twigs arrive as const T&, Write<T> (or bare T) as T&. Naming a twig twice
+        // is rejected at compile time. fn must only touch the twigs of its own entity.
+        template <typename... Access, typename Fn>
+        auto par_each(Fn&& fn, std::size_t grain = 1024) -> void
+        {
+            par_each_impl<Access...>(static_cast<std::vector<char>*>(nullptr),
+                [&](char&, Entity entity, typename Twig_Access<Access>::reference... twigs) {
+                    if constexpr (std::is_invocable_v<Fn&, Entity, typename Twig_Access<Access>::reference...>) {
+                        fn(entity, twigs...);
+                    } else {
+                        fn(twigs...);
+                    }
+                }, grain);
+        }
+
+        // Same as above with per-thread scratch: scratch is resized to the pool's thread count
+        // and fn receives the calling thread's element first, e.g. for local accumulation.
+        template <typename... Access, typename Scratch, typename Fn>
+        auto par_each(std::vector<Scratch>& scratch, Fn&& fn, std::size_t grain = 1024) -> void
+        {
+            par_each_impl<Access...>(&scratch,
+                [&](Scratch& local, Entity entity, typename Twig_Access<Access>::reference... twigs) {
+                    if constexpr (std::is_invocable_v<Fn&, Scratch&, Entity, typename Twig_Access<Access>::reference...>) {
+                        fn(local, entity, twigs...);
+                    } else {
+                        fn(local, twigs...);
+                    }
+                }, grain);
         }
 
         void clear_all();
@@ -1,5 +1,6 @@
 #pragma once
 #include "base/twig.hpp"
+#include "twig_slots.hpp"
 #include "math/math.hpp"
 #include "transform.hpp"
 
@@ -8,6 +9,8 @@ namespace mango::resource
     struct Camera : core::Twig<Camera>
     {
     public:
+        static constexpr core::TwigID FIXED_TWIG_ID = twig_slot::camera;
+
         float fov        = 60.0f;
         float aspect     = 16.0f / 9.0f;
         float near_plane = 0.1f;
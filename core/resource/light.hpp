@@ -1,5 +1,6 @@
 #pragma once
 #include "base/twig.hpp"
+#include "twig_slots.hpp"
 #include "math/math.hpp"
 
 namespace mango::resource
@@ -8,6 +9,8 @@ namespace mango::resource
 
     struct Light : core::Twig<Light>
     {
+        static constexpr core::TwigID FIXED_TWIG_ID = twig_slot::light;
+
         Light_Type type = Light_Type::directional;
         math::Vec3 color{1.0f, 1.0f, 1.0f};
         float intensity = 3.5f;
@@ -1,11 +1,14 @@
 #pragma once
 #include "base/twig.hpp"
+#include "twig_slots.hpp"
 #include "math/math.hpp"
 
 namespace mango::resource
 {
     struct Pbr_Material : core::Twig<Pbr_Material>
     {
+        static constexpr core::TwigID FIXED_TWIG_ID = twig_slot::pbr_material;
+
         math::Vec4 base_color{1.0f, 1.0f, 1.0f, 1.0f};
         float metallic          = 0.0f;
         float roughness         = 0.5f;
@@ -1,28 +1,146 @@
 #include "mesh.hpp"
+#include "mesh_lod.hpp"
+#include "meshlet.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <unordered_map>
 
 namespace mango::resource
 {
-    auto Mesh::set_vertices(const std::vector<Vertex>& verts) -> void {
-        vertices = verts;
+    namespace
+    {
+        const Mesh_Data empty_mesh_data;
+
+        struct Position_Cell
+        {
+            std::array<std::int64_t, 3> cell;
+
+            auto operator==(const Position_Cell& other) const -> bool = default;
+        };
+
+        struct Position_Cell_Hash
+        {
+            auto operator()(const Position_Cell& key) const -> std::size_t
+            {
+                return (std::size_t(key.cell[0]) * 73856093u) ^ (std::size_t(key.cell[1]) * 19349663u) ^
+                       (std::size_t(key.cell[2]) * 83492791u);
+            }
+        };
+    }
+
+    auto weld_positions(const std::vector<Vertex>& vertices) -> std::vector<std::uint32_t> {
+        std::vector<std::uint32_t> points(vertices.size());
+        if (vertices.empty()) {
+            return points;
+        }
+
+        math::Vec3 low = vertices.front().position;
+        math::Vec3 high = low;
+        for (const auto& vertex : vertices) {
+            low = glm::min(low, vertex.position);
+            high = glm::max(high, vertex.position);
+        }
+        double cell_size = std::max(double(glm::length(high - low)) * 1e-6, 1e-30);
+
+        std::unordered_map<Position_Cell, std::uint32_t, Position_Cell_Hash> ids;
+        ids.reserve(vertices.size());
+        for (std::size_t v = 0; v < vertices.size(); ++v) {
+            const auto& p = vertices[v].position;
+            auto cell = [&](float x) { return static_cast<std::int64_t>(std::llround(x / cell_size)); };
+            auto [it, inserted] = ids.try_emplace(Position_Cell{ { cell(p.x), cell(p.y), cell(p.z) } },
+                                                  static_cast<std::uint32_t>(ids.size()));
+            points[v] = it->second;
+        }
+        return points;
+    }
+
+    auto Mesh_Data::compute_bounds() -> void {
+        if (vertices.empty()) {
+            bounds_min = bounds_max = math::Vec3(0.0f, 0.0f, 0.0f);
+            return;
+        }
+        bounds_min = bounds_max = vertices.front().position;
+        for (const auto& vertex : vertices) {
+            for (int axis = 0; axis < 3; ++axis) {
+                bounds_min[axis] = std::min(bounds_min[axis], vertex.position[axis]);
+                bounds_max[axis] = std::max(bounds_max[axis], vertex.position[axis]);
+            }
+        }
+    }
+
+    auto Mesh_Data::get_lod_count() const -> std::uint32_t {
+        return lods.empty() ? 1u : static_cast<std::uint32_t>(lods.size());
+    }
+
+    auto Mesh_Data::get_lod(std::uint32_t lod) const -> Mesh_Lod {
+        if (lods.empty()) {
+            return { 0, static_cast<std::uint32_t>(indices.size()), 0.0f };
+        }
+        return lods[std::min<std::size_t>(lod, lods.size() - 1)];
+    }
+
+    auto Mesh::edit_data() -> Mesh_Data& {
+        // Only a buffer allocated here (not one handed in via set_data) may be written in place
+        if (!data || data.get() != owned || data.use_count() > 1) {
+            auto copy = std::make_shared<Mesh_Data>(data ? *data : Mesh_Data());
+            owned = copy.get();
+            data = std::move(copy);
+        }
+        return const_cast<Mesh_Data&>(*data);
+    }
+
+    auto Mesh::set_vertices(std::vector<Vertex> verts) -> void {
+        auto& edited = edit_data();
+        edited.vertices = std::move(verts);
+        edited.compute_bounds();
+        edited.lod_indices.clear();
+        edited.lods.clear();
+        edited.meshlets.clear();
+    }
+
+    auto Mesh::set_indices(std::vector<std::uint32_t> inds) -> void {
+        auto& edited = edit_data();
+        edited.indices = std::move(inds);
+        edited.lod_indices.clear();
+        edited.lods.clear();
+        edited.meshlets.clear();
+    }
+
+    auto Mesh::generate_lods() -> void {
+        if (data) {
+            generate_mesh_lods(edit_data());
+        }
+    }
+
+    auto Mesh::generate_meshlets() -> void {
+        if (data) {
+            build_meshlets(edit_data());
+        }
+    }
+
+    auto Mesh::set_data(std::shared_ptr<const Mesh_Data> mesh_data) -> void {
+        data = std::move(mesh_data);
+        owned = nullptr;
     }
 
-    auto Mesh::set_indices(const std::vector<std::uint32_t>& inds) -> void {
-        indices = inds;
+    auto Mesh::get_data() const -> const std::shared_ptr<const Mesh_Data>& {
+        return data;
     }
 
     auto Mesh::get_vertices() const -> const std::vector<Vertex>& {
-        return vertices;
+        return data ? data->vertices : empty_mesh_data.vertices;
     }
 
     auto Mesh::get_indices() const -> const std::vector<std::uint32_t>& {
-        return indices;
+        return data ? data->indices : empty_mesh_data.indices;
     }
 
     auto Mesh::get_vertex_count() const -> std::size_t {
-        return vertices.size();
+        return get_vertices().size();
     }
 
     auto Mesh::get_index_count() const -> std::size_t {
-        return indices.size();
+        return get_indices().size();
     }
 }
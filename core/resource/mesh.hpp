@@ -1,6 +1,8 @@
 #pragma once
 #include "base/twig.hpp"
+#include "twig_slots.hpp"
 #include "math/math.hpp"
+#include <memory>
 #include <vector>
 
 
@@ -13,12 +15,84 @@ namespace mango::resource
         mango::math::Vec2 uv;
     };
 
+    // One level of detail: a range of the mesh's index buffer, laid out as indices followed
+    // by lod_indices, and the QEM estimate of its largest distance from the full-detail
+    // surface in object-space units
+    struct Mesh_Lod
+    {
+        std::uint32_t first_index = 0;
+        std::uint32_t index_count = 0;
+        float error = 0.0f;
+    };
+
+    // A cluster of at most 64 vertices and 124 triangles: a range of indices, a bounding
+    // sphere and a normal cone for backface rejection of the whole cluster (see
+    // build_meshlets). Laid out like the cluster entries read by gpu_cull.comp.
+    struct Meshlet
+    {
+        math::Vec3 center{0.0f, 0.0f, 0.0f};
+        float radius = 0.0f;
+        math::Vec3 cone_axis{0.0f, 0.0f, 1.0f};     // mean front-face normal
+        float cone_cutoff = 1.0f;                   // sine of the cone's half angle; 1 never culls
+        std::uint32_t first_index = 0;
+        std::uint32_t index_count = 0;
+        std::uint32_t vertex_count = 0;             // distinct vertices
+        std::uint32_t padding = 0;
+    };
+
+    // Geometry payload shared by every Mesh copy that has not been modified since.
+    // Renderers key GPU uploads by its address and pin it with shared_from_this().
+    struct Mesh_Data : std::enable_shared_from_this<Mesh_Data>
+    {
+        std::vector<Vertex> vertices;
+        std::vector<std::uint32_t> indices;
+
+        // Local-space AABB of vertices; refreshed by Mesh::set_vertices, call
+        // compute_bounds() after filling vertices by hand
+        math::Vec3 bounds_min{0.0f, 0.0f, 0.0f};
+        math::Vec3 bounds_max{0.0f, 0.0f, 0.0f};
+
+        // Simplified index lists over the same vertices, coarsest last (generate_mesh_lods).
+        // lods[0] is the full mesh when lods is not empty; both are cleared by the setters.
+        std::vector<std::uint32_t> lod_indices;
+        std::vector<Mesh_Lod> lods;
+
+        // Clusters covering indices, which build_meshlets reorders so every cluster is one
+        // contiguous range; cleared by the setters
+        std::vector<Meshlet> meshlets;
+
+        auto compute_bounds() -> void;
+
+        auto get_lod_count() const -> std::uint32_t;
+        // Clamped to the coarsest LOD; the full index list when there are no LODs
+        auto get_lod(std::uint32_t lod) const -> Mesh_Lod;
+    };
+
+    // Point id of every vertex, ids dense in order of first appearance. Positions closer
+    // than a millionth of the bounds diagonal share a point, which also catches rounding
+    // noise in generated meshes (sphere poles).
+    auto weld_positions(const std::vector<Vertex>& vertices) -> std::vector<std::uint32_t>;
+
+    // Copying a Mesh shares its geometry; the setters copy it first if it is shared
+    // (copy-on-write), so twigs attached to thousands of entities cost one pointer each.
     struct Mesh : core::Twig<Mesh>
     {
     public:
-        auto set_vertices(const std::vector<Vertex>& verts) -> void;
+        static constexpr core::TwigID FIXED_TWIG_ID = twig_slot::mesh;
+
+        auto set_vertices(std::vector<Vertex> verts) -> void;
+
+        auto set_indices(std::vector<std::uint32_t> inds) -> void;
 
-        auto set_indices(const std::vector<std::uint32_t>& inds) -> void;
+        auto set_data(std::shared_ptr<const Mesh_Data> mesh_data) -> void;
+
+        // Builds the LOD chain of the current vertices and indices; call after setting both
+        auto generate_lods() -> void;
+
+        // Splits the current triangles into meshlets, reordering the indices
+        auto generate_meshlets() -> void;
+
+        auto get_data() const -> const std::shared_ptr<const Mesh_Data>&;
 
         auto get_vertices() const -> const std::vector<Vertex>&;
 
@@ -29,7 +103,9 @@ namespace mango::resource
         auto get_index_count() const -> std::size_t;
 
     private:
-        std::vector<Vertex> vertices;
-        std::vector<std::uint32_t> indices;
+        auto edit_data() -> Mesh_Data&;
+
+        std::shared_ptr<const Mesh_Data> data;
+        const Mesh_Data* owned = nullptr;
     };
 }
@@ -0,0 +1,299 @@
+#include "mesh_lod.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+namespace mango::resource
+{
+    namespace
+    {
+        // Sum of squared distances to a set of planes: p^T A p + 2 b.p + c, A symmetric
+        struct Quadric
+        {
+            double a00 = 0.0, a01 = 0.0, a02 = 0.0, a11 = 0.0, a12 = 0.0, a22 = 0.0;
+            double b0 = 0.0, b1 = 0.0, b2 = 0.0;
+            double c = 0.0;
+
+            static auto from_plane(double nx, double ny, double nz, double d) -> Quadric
+            {
+                return { nx * nx, nx * ny, nx * nz, ny * ny, ny * nz, nz * nz, nx * d, ny * d, nz * d, d * d };
+            }
+
+            auto operator+=(const Quadric& other) -> Quadric&
+            {
+                a00 += other.a00; a01 += other.a01; a02 += other.a02;
+                a11 += other.a11; a12 += other.a12; a22 += other.a22;
+                b0 += other.b0; b1 += other.b1; b2 += other.b2;
+                c += other.c;
+                return *this;
+            }
+
+            auto evaluate(const math::Vec3& p) const -> double
+            {
+                double x = p.x, y = p.y, z = p.z;
+                double quadratic = a00 * x * x + a11 * y * y + a22 * z * z + 2.0 * (a01 * x * y + a02 * x * z + a12 * y * z);
+                return std::max(quadratic + 2.0 * (b0 * x + b1 * y + b2 * z) + c, 0.0);
+            }
+        };
+
+        struct Collapse
+        {
+            double cost = 0.0;
+            std::uint32_t from = 0;
+            std::uint32_t to = 0;
+            std::uint32_t from_version = 0;     // stale once either end changed
+            std::uint32_t to_version = 0;
+
+            auto operator>(const Collapse& other) const -> bool { return cost > other.cost; }
+        };
+
+        auto edge_key(std::uint32_t a, std::uint32_t b) -> std::uint64_t
+        {
+            return a < b ? (std::uint64_t(a) << 32) | b : (std::uint64_t(b) << 32) | a;
+        }
+    }
+
+    auto generate_mesh_lods(Mesh_Data& data, const Mesh_Lod_Settings& settings) -> void
+    {
+        data.lods.clear();
+        data.lod_indices.clear();
+        const auto& vertices = data.vertices;
+        const auto& indices = data.indices;
+        if (settings.max_lods < 2 || indices.size() < 3 || vertices.empty()) {
+            return;
+        }
+        for (auto index : indices) {
+            if (index >= vertices.size()) return;
+        }
+
+        math::Vec3 low = vertices.front().position;
+        math::Vec3 high = low;
+        for (const auto& vertex : vertices) {
+            low = glm::min(low, vertex.position);
+            high = glm::max(high, vertex.position);
+        }
+        double diagonal = glm::length(high - low);
+        if (diagonal <= 0.0) {
+            return;
+        }
+        double max_cost = settings.max_relative_error * diagonal * settings.max_relative_error * diagonal;
+
+        // Weld vertices into points by position; a point whose vertices differ in normal
+        // or uv sits on a seam and is locked
+        auto point_of_vertex = weld_positions(vertices);
+        std::vector<std::uint32_t> vertex_of_point;
+        std::vector<std::uint8_t> locked;
+        for (std::uint32_t v = 0; v < vertices.size(); ++v) {
+            auto point = point_of_vertex[v];
+            if (point == vertex_of_point.size()) {
+                vertex_of_point.push_back(v);
+                locked.push_back(0);
+            } else {
+                const auto& first = vertices[vertex_of_point[point]];
+                if (first.normal != vertices[v].normal || first.uv != vertices[v].uv) {
+                    locked[point] = 1;
+                }
+            }
+        }
+        const auto point_count = vertex_of_point.size();
+        auto position = [&](std::uint32_t point) -> const math::Vec3& { return vertices[vertex_of_point[point]].position; };
+
+        // Triangles as vertex indices; those collapsed in position space are dropped
+        std::vector<std::array<std::uint32_t, 3>> triangles;
+        triangles.reserve(indices.size() / 3);
+        for (std::size_t i = 0; i + 2 < indices.size(); i += 3) {
+            auto a = point_of_vertex[indices[i]];
+            auto b = point_of_vertex[indices[i + 1]];
+            auto c = point_of_vertex[indices[i + 2]];
+            if (a != b && b != c && a != c) {
+                triangles.push_back({ indices[i], indices[i + 1], indices[i + 2] });
+            }
+        }
+        auto point = [&](std::uint32_t triangle, int corner) { return point_of_vertex[triangles[triangle][corner]]; };
+
+        // Edges used by other than two triangles: open borders and non-manifold fans
+        std::unordered_map<std::uint64_t, std::uint32_t> edge_use;
+        edge_use.reserve(triangles.size() * 3);
+        for (std::uint32_t t = 0; t < triangles.size(); ++t) {
+            for (int k = 0; k < 3; ++k) {
+                ++edge_use[edge_key(point(t, k), point(t, (k + 1) % 3))];
+            }
+        }
+        for (const auto& [key, uses] : edge_use) {
+            if (uses != 2) {
+                locked[key >> 32] = 1;
+                locked[key & 0xFFFFFFFFu] = 1;
+            }
+        }
+
+        // Plane quadrics of the incident triangles and the triangle fan of every point
+        std::vector<Quadric> quadrics(point_count);
+        std::vector<std::vector<std::uint32_t>> fans(point_count);
+        for (std::uint32_t t = 0; t < triangles.size(); ++t) {
+            auto p0 = position(point(t, 0));
+            auto n = glm::cross(position(point(t, 1)) - p0, position(point(t, 2)) - p0);
+            double length = std::sqrt(double(n.x) * n.x + double(n.y) * n.y + double(n.z) * n.z);
+            for (int k = 0; k < 3; ++k) {
+                fans[point(t, k)].push_back(t);
+            }
+            if (length <= 0.0) continue;
+
+            double nx = n.x / length, ny = n.y / length, nz = n.z / length;
+            auto plane = Quadric::from_plane(nx, ny, nz, -(nx * p0.x + ny * p0.y + nz * p0.z));
+            for (int k = 0; k < 3; ++k) {
+                quadrics[point(t, k)] += plane;
+            }
+        }
+
+        std::vector<std::uint32_t> version(point_count, 0);
+        std::vector<std::uint8_t> removed(point_count, 0);
+        std::vector<std::uint8_t> alive(triangles.size(), 1);
+        std::priority_queue<Collapse, std::vector<Collapse>, std::greater<>> heap;
+
+        auto contains = [&](std::uint32_t t, std::uint32_t p) {
+            return point(t, 0) == p || point(t, 1) == p || point(t, 2) == p;
+        };
+        auto push = [&](std::uint32_t from, std::uint32_t to) {
+            if (locked[from] || locked[to]) return;
+            auto merged = quadrics[from];
+            merged += quadrics[to];
+            heap.push({ merged.evaluate(position(to)), from, to, version[from], version[to] });
+        };
+        auto push_fan = [&](std::uint32_t p) {
+            for (auto t : fans[p]) {
+                if (!alive[t]) continue;
+                for (int k = 0; k < 3; ++k) {
+                    auto other = point(t, k);
+                    if (other != p) {
+                        push(p, other);
+                        push(other, p);
+                    }
+                }
+            }
+        };
+        for (std::uint32_t p = 0; p < point_count; ++p) {
+            for (auto t : fans[p]) {
+                for (int k = 0; k < 3; ++k) {
+                    if (point(t, k) != p) push(p, point(t, k));
+                }
+            }
+        }
+
+        // Moving `from` onto `to` must keep the surface a manifold (the two points share
+        // exactly the neighbours of their shared triangles) and turn no triangle over
+        std::vector<std::uint32_t> mark(point_count, 0);
+        std::uint32_t stamp = 0;
+        auto can_collapse = [&](std::uint32_t from, std::uint32_t to) {
+            ++stamp;
+            for (auto t : fans[to]) {
+                if (!alive[t]) continue;
+                for (int k = 0; k < 3; ++k) mark[point(t, k)] = stamp;
+            }
+            std::uint32_t shared = 0;
+            std::uint32_t common = 0;
+            const auto& target = position(to);
+            for (auto t : fans[from]) {
+                if (!alive[t]) continue;
+                if (contains(t, to)) {
+                    ++shared;
+                    continue;
+                }
+                std::array<math::Vec3, 3> before;
+                std::array<math::Vec3, 3> after;
+                for (int k = 0; k < 3; ++k) {
+                    auto p = point(t, k);
+                    before[k] = position(p);
+                    after[k] = p == from ? target : before[k];
+                    if (p != from && mark[p] == stamp) {
+                        ++common;
+                        mark[p] = stamp - 1;    // count each neighbour once
+                    }
+                }
+                auto n0 = glm::cross(before[1] - before[0], before[2] - before[0]);
+                auto n1 = glm::cross(after[1] - after[0], after[2] - after[0]);
+                if (glm::dot(n0, n1) <= 0.2f * glm::length(n0) * glm::length(n1)) {
+                    return false;
+                }
+            }
+            // On a manifold the only common neighbours are the third corners of the shared
+            // triangles, each also seen once in the rest of the fan
+            return common <= shared;
+        };
+
+        auto live = static_cast<std::uint32_t>(triangles.size());
+        auto emit = [&](double error) {
+            auto first = static_cast<std::uint32_t>(indices.size() + data.lod_indices.size());
+            for (std::uint32_t t = 0; t < triangles.size(); ++t) {
+                if (alive[t]) {
+                    data.lod_indices.insert(data.lod_indices.end(), triangles[t].begin(), triangles[t].end());
+                }
+            }
+            data.lods.push_back({ first, live * 3, static_cast<float>(std::sqrt(error)) });
+        };
+
+        data.lods.push_back({ 0, static_cast<std::uint32_t>(indices.size()), 0.0f });
+        auto last_count = live;
+        double worst = 0.0;
+        auto target = static_cast<std::uint32_t>(live * settings.reduction);
+        while (data.lods.size() < settings.max_lods && target >= settings.min_triangles) {
+            bool exhausted = false;
+            while (live > target) {
+                if (heap.empty()) {
+                    exhausted = true;
+                    break;
+                }
+                auto collapse = heap.top();
+                heap.pop();
+                auto from = collapse.from;
+                auto to = collapse.to;
+                if (removed[from] || removed[to] || version[from] != collapse.from_version || version[to] != collapse.to_version) {
+                    continue;
+                }
+                if (collapse.cost > max_cost) {
+                    exhausted = true;
+                    break;
+                }
+                if (!can_collapse(from, to)) {
+                    continue;
+                }
+
+                for (auto t : fans[from]) {
+                    if (!alive[t]) continue;
+                    if (contains(t, to)) {
+                        alive[t] = 0;
+                        --live;
+                        continue;
+                    }
+                    for (auto& vertex : triangles[t]) {
+                        if (point_of_vertex[vertex] == from) vertex = vertex_of_point[to];
+                    }
+                    fans[to].push_back(t);
+                }
+                fans[from].clear();
+                quadrics[to] += quadrics[from];
+                removed[from] = 1;
+                ++version[from];
+                ++version[to];
+                worst = std::max(worst, collapse.cost);
+                push_fan(to);
+            }
+
+            // Keep a level only when it saves a meaningful share of the previous one
+            if (live < last_count - last_count / 10) {
+                emit(worst);
+                last_count = live;
+            }
+            if (exhausted) break;
+            target = static_cast<std::uint32_t>(live * settings.reduction);
+        }
+
+        if (data.lods.size() == 1) {
+            data.lods.clear();
+            data.lod_indices.clear();
+        }
+    }
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include "mesh.hpp"
+#include <cstdint>
+
+namespace mango::resource
+{
+    struct Mesh_Lod_Settings
+    {
+        std::uint32_t max_lods = 5;             // including the full mesh
+        float reduction = 0.5f;                 // share of the previous LOD's triangles each LOD keeps
+        std::uint32_t min_triangles = 32;       // no LOD targets fewer triangles
+        float max_relative_error = 0.1f;        // of the bounds diagonal; simplification stops beyond it
+    };
+
+    // Quadric error metric simplification (Garland-Heckbert) by half-edge collapses: a
+    // vertex merges into a neighbour instead of a new position, so every LOD indexes the
+    // original vertices and shares their buffer. Vertices on open borders, non-manifold
+    // edges and attribute seams (one position, several different vertices) never move.
+    // Collapses that flip a triangle or pinch the surface are skipped.
+    // Replaces data.lods and data.lod_indices; a mesh that does not simplify gets none.
+    auto generate_mesh_lods(Mesh_Data& data, const Mesh_Lod_Settings& settings = {}) -> void;
+}
@@ -0,0 +1,231 @@
+#include "meshlet.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace mango::resource
+{
+    namespace
+    {
+        constexpr std::uint32_t NO_TRIANGLE = ~0u;
+
+        // Every edge between welded positions is shared by exactly two triangles; triangles
+        // collapsed by the welding (sphere poles) are ignored
+        auto is_closed(const Mesh_Data& data) -> bool
+        {
+            auto points = weld_positions(data.vertices);
+            std::unordered_map<std::uint64_t, std::uint32_t> edge_use;
+            edge_use.reserve(data.indices.size());
+            for (std::size_t i = 0; i + 2 < data.indices.size(); i += 3) {
+                std::array<std::uint32_t, 3> p = { points[data.indices[i]], points[data.indices[i + 1]], points[data.indices[i + 2]] };
+                if (p[0] == p[1] || p[1] == p[2] || p[0] == p[2]) continue;
+                for (int k = 0; k < 3; ++k) {
+                    auto a = p[k];
+                    auto b = p[(k + 1) % 3];
+                    ++edge_use[a < b ? (std::uint64_t(a) << 32) | b : (std::uint64_t(b) << 32) | a];
+                }
+            }
+            if (edge_use.empty()) return false;
+            return std::all_of(edge_use.begin(), edge_use.end(), [](const auto& edge) { return edge.second == 2; });
+        }
+
+        // Bounding sphere and normal cone of indices[first, first + count)
+        auto make_meshlet(const Mesh_Data& data, std::uint32_t first, std::uint32_t count,
+                          const std::vector<std::uint32_t>& meshlet_vertices, bool closed) -> Meshlet
+        {
+            const auto& vertices = data.vertices;
+            Meshlet meshlet;
+            meshlet.first_index = first;
+            meshlet.index_count = count;
+            meshlet.vertex_count = static_cast<std::uint32_t>(meshlet_vertices.size());
+
+            math::Vec3 low = vertices[meshlet_vertices.front()].position;
+            math::Vec3 high = low;
+            for (auto v : meshlet_vertices) {
+                low = glm::min(low, vertices[v].position);
+                high = glm::max(high, vertices[v].position);
+            }
+            meshlet.center = (low + high) * 0.5f;
+            for (auto v : meshlet_vertices) {
+                meshlet.radius = std::max(meshlet.radius, glm::length(vertices[v].position - meshlet.center));
+            }
+
+            // Face normals turned to the side the vertex normals point to
+            std::vector<math::Vec3> normals;
+            normals.reserve(count / 3);
+            math::Vec3 axis(0.0f, 0.0f, 0.0f);
+            for (auto i = first; i + 2 < first + count; i += 3) {
+                const auto& a = vertices[data.indices[i]];
+                const auto& b = vertices[data.indices[i + 1]];
+                const auto& c = vertices[data.indices[i + 2]];
+                auto n = glm::cross(b.position - a.position, c.position - a.position);
+                float length = glm::length(n);
+                if (!(length > 0.0f)) continue;     // no area, never visible
+
+                n *= 1.0f / length;
+                if (glm::dot(n, a.normal + b.normal + c.normal) < 0.0f) {
+                    n *= -1.0f;
+                }
+                normals.push_back(n);
+                axis += n;
+            }
+            float axis_length = glm::length(axis);
+            if (!closed || normals.empty() || !(axis_length > 0.0f)) {
+                return meshlet;
+            }
+
+            meshlet.cone_axis = axis * (1.0f / axis_length);
+            float min_dot = 1.0f;
+            for (const auto& n : normals) {
+                min_dot = std::min(min_dot, glm::dot(n, meshlet.cone_axis));
+            }
+            // Cones wider than about 84 degrees almost never cull; leave them open
+            if (min_dot > 0.1f) {
+                meshlet.cone_cutoff = std::sqrt(1.0f - min_dot * min_dot);
+            }
+            return meshlet;
+        }
+    }
+
+    auto build_meshlets(Mesh_Data& data, const Meshlet_Settings& settings) -> void
+    {
+        data.meshlets.clear();
+        const auto& vertices = data.vertices;
+        auto& indices = data.indices;
+        const auto triangle_count = static_cast<std::uint32_t>(indices.size() / 3);
+        if (triangle_count == 0 || settings.max_vertices < 3 || settings.max_triangles == 0) {
+            return;
+        }
+        for (auto index : indices) {
+            if (index >= vertices.size()) return;
+        }
+        const bool closed = is_closed(data);
+
+        // Triangles around each vertex, once per corner
+        std::vector<std::uint32_t> first_triangle(vertices.size() + 1, 0);
+        for (std::uint32_t i = 0; i < triangle_count * 3; ++i) {
+            ++first_triangle[indices[i] + 1];
+        }
+        for (std::size_t v = 0; v < vertices.size(); ++v) {
+            first_triangle[v + 1] += first_triangle[v];
+        }
+        std::vector<std::uint32_t> vertex_triangles(triangle_count * 3);
+        {
+            auto fill = first_triangle;
+            for (std::uint32_t i = 0; i < triangle_count * 3; ++i) {
+                vertex_triangles[fill[indices[i]]++] = i / 3;
+            }
+        }
+
+        // Per meshlet: corners of each triangle already inside (hits) and candidate queues by
+        // hits, so a triangle closing a gap (3 hits, no new vertex) goes before one that
+        // adds a vertex; stamps reset both when a meshlet starts
+        std::vector<std::uint8_t> emitted(triangle_count, 0);
+        std::vector<std::uint32_t> vertex_stamp(vertices.size(), 0);
+        std::vector<std::uint32_t> triangle_stamp(triangle_count, 0);
+        std::vector<std::uint8_t> hits(triangle_count, 0);
+        std::array<std::vector<std::uint32_t>, 3> candidates;
+        std::array<std::size_t, 3> heads{};
+        std::vector<std::uint32_t> ordered;
+        ordered.reserve(indices.size());
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> ranges;     // first index, index count
+        std::uint32_t stamp = 0;
+        std::uint32_t meshlet_first = 0;
+        std::uint32_t meshlet_vertices = 0;
+
+        auto open = [&] {
+            ++stamp;
+            for (auto& queue : candidates) queue.clear();
+            heads.fill(0);
+            meshlet_vertices = 0;
+            meshlet_first = static_cast<std::uint32_t>(ordered.size());
+        };
+        auto flush = [&] {
+            auto count = static_cast<std::uint32_t>(ordered.size()) - meshlet_first;
+            if (count > 0) {
+                ranges.push_back({ meshlet_first, count });
+            }
+        };
+        auto add = [&](std::uint32_t t) {
+            emitted[t] = 1;
+            for (int k = 0; k < 3; ++k) {
+                auto v = indices[t * 3 + k];
+                ordered.push_back(v);
+                if (vertex_stamp[v] == stamp) continue;
+
+                vertex_stamp[v] = stamp;
+                ++meshlet_vertices;
+                for (auto j = first_triangle[v]; j < first_triangle[v + 1]; ++j) {
+                    auto u = vertex_triangles[j];
+                    if (emitted[u]) continue;
+                    if (triangle_stamp[u] != stamp) {
+                        triangle_stamp[u] = stamp;
+                        hits[u] = 0;
+                    }
+                    ++hits[u];
+                    candidates[hits[u] - 1].push_back(u);
+                }
+            }
+        };
+        // Best queued neighbour that still fits; stale entries (emitted, or since moved to
+        // a fuller queue) are dropped on the way
+        auto next = [&]() -> std::uint32_t {
+            for (int level = 2; level >= 0; --level) {
+                auto new_vertices = static_cast<std::uint32_t>(2 - level);
+                if (meshlet_vertices + new_vertices > settings.max_vertices) continue;
+                auto& queue = candidates[level];
+                while (heads[level] < queue.size()) {
+                    auto u = queue[heads[level]++];
+                    if (!emitted[u] && hits[u] == level + 1) return u;
+                }
+            }
+            return NO_TRIANGLE;
+        };
+
+        open();
+        std::uint32_t seed = 0;
+        std::uint32_t meshlet_triangles = 0;
+        for (;;) {
+            auto t = next();
+            if (t == NO_TRIANGLE) {
+                if (meshlet_triangles > 0) {
+                    flush();
+                    open();
+                    meshlet_triangles = 0;
+                }
+                while (seed < triangle_count && emitted[seed]) ++seed;
+                if (seed == triangle_count) break;
+                t = seed;
+            }
+            add(t);
+            if (++meshlet_triangles == settings.max_triangles) {
+                flush();
+                open();
+                meshlet_triangles = 0;
+            }
+        }
+        flush();
+
+        // A trailing partial triangle stays at the end, outside every meshlet
+        ordered.insert(ordered.end(), indices.begin() + triangle_count * 3, indices.end());
+        indices.swap(ordered);
+
+        data.meshlets.reserve(ranges.size());
+        std::vector<std::uint32_t> distinct;
+        for (auto [first, count] : ranges) {
+            distinct.assign(indices.begin() + first, indices.begin() + first + count);
+            std::sort(distinct.begin(), distinct.end());
+            distinct.erase(std::unique(distinct.begin(), distinct.end()), distinct.end());
+            data.meshlets.push_back(make_meshlet(data, first, count, distinct, closed));
+        }
+    }
+
+    auto is_meshlet_backfacing(const Meshlet& meshlet, const math::Vec3& camera) -> bool
+    {
+        auto offset = meshlet.center - camera;
+        return glm::dot(offset, meshlet.cone_axis) >= meshlet.cone_cutoff * glm::length(offset) + meshlet.radius;
+    }
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include "mesh.hpp"
+#include <cstdint>
+
+namespace mango::resource
+{
+    struct Meshlet_Settings
+    {
+        std::uint32_t max_vertices = 64;
+        std::uint32_t max_triangles = 124;
+    };
+
+    // Greedy clustering: a meshlet starts at the first unassigned triangle and grows
+    // breadth-first over triangles sharing its vertices, preferring those that add the
+    // fewest new vertices, until a limit is reached or no neighbour is left. The indices
+    // are rewritten in meshlet order, so the triangles and LODs are unchanged and every
+    // meshlet is a plain index range that one indexed draw covers.
+    // Normal cones are oriented by the vertex normals rather than the winding, and only
+    // closed meshes get one: the back of an open mesh may be seen through its border when
+    // drawn two-sided. Replaces data.meshlets.
+    auto build_meshlets(Mesh_Data& data, const Meshlet_Settings& settings = {}) -> void;
+
+    // True when every triangle of the meshlet faces away from a camera at this position
+    // (mesh space): the bounding sphere lies inside the normal cone's backfacing region
+    auto is_meshlet_backfacing(const Meshlet& meshlet, const math::Vec3& camera) -> bool;
+}
@@ -168,6 +168,8 @@ namespace mango::resource
         auto mesh = std::make_shared<Mesh>();
         mesh->set_vertices(vertices);
         mesh->set_indices(indices);
+        mesh->generate_meshlets();
+        mesh->generate_lods();
 
         auto model = std::make_shared<Model>();
         model->add_instance(mesh);
@@ -1,5 +1,6 @@
 #pragma once
 #include "base/twig.hpp"
+#include "twig_slots.hpp"
 #include "math/math.hpp"
 #include "mesh.hpp"
 #include <memory>
@@ -20,6 +21,8 @@ namespace mango::resource
 
     struct Model : core::Twig<Model>
     {
+        static constexpr core::TwigID FIXED_TWIG_ID = twig_slot::model;
+
     private:
         std::vector<Mesh_Instance> instances;
         std::vector<std::string> materials;
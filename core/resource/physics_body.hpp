@@ -1,11 +1,14 @@
 #pragma once
 #include "base/twig.hpp"
+#include "twig_slots.hpp"
 #include "physics/physics_world.hpp"
 
 namespace mango::resource
 {
     struct Physics_Body : core::Twig<Physics_Body>
     {
+        static constexpr core::TwigID FIXED_TWIG_ID = twig_slot::physics_body;
+
         physics::Body_Type type = physics::Body_Type::dynamic_body;
         physics::Shape_Type shape_type = physics::Shape_Type::box;
 
@@ -42,6 +42,7 @@ namespace mango::resource
         Mesh mesh;
         mesh.set_vertices(vertices);
         mesh.set_indices(indices);
+        mesh.generate_lods();
         return mesh;
     }
 
@@ -124,6 +125,7 @@ namespace mango::resource
         Mesh mesh;
         mesh.set_vertices(vertices);
         mesh.set_indices(indices);
+        mesh.generate_lods();
         return mesh;
     }
 }
@@ -8,9 +8,12 @@ namespace mango::resource
 
     auto Transform::get_matrix() const -> math::Mat4
     {
-        math::Mat4 T = math::translate(math::Mat4(1.0f), position);
-        math::Mat4 R = math::to_mat4(rotation);
-        math::Mat4 S = math::scale(math::Mat4(1.0f), scale);
-        return T * R * S;
+        // T * R * S without building and multiplying the three matrices
+        math::Mat4 m = math::to_mat4(rotation);
+        m[0] *= scale.x;
+        m[1] *= scale.y;
+        m[2] *= scale.z;
+        m[3] = math::Vec4(position, 1.0f);
+        return m;
     }
 }
@@ -1,11 +1,14 @@
 #pragma once
 #include "base/twig.hpp"
+#include "twig_slots.hpp"
 #include "math/math.hpp"
 
 namespace mango::resource
 {
     struct Transform : core::Twig<Transform>
     {
+        static constexpr core::TwigID FIXED_TWIG_ID = twig_slot::transform;
+
         math::Vec3 position{0.0f, 0.0f, 0.0f};
         math::Quat rotation{1.0f, 0.0f, 0.0f, 0.0f};
         math::Vec3 scale{1.0f, 1.0f, 1.0f};
@@ -0,0 +1,19 @@
+#pragma once
+#include "base/twig.hpp"
+
+namespace mango::resource
+{
+    // Compile-time TwigIDs of the engine twigs. Stores for these live at fixed
+    // indices in the World, so looking them up never touches the registry.
+    namespace twig_slot
+    {
+        inline constexpr core::TwigID transform       = 0;
+        inline constexpr core::TwigID mesh            = 1;
+        inline constexpr core::TwigID model           = 2;
+        inline constexpr core::TwigID pbr_material    = 3;
+        inline constexpr core::TwigID light           = 4;
+        inline constexpr core::TwigID camera          = 5;
+        inline constexpr core::TwigID physics_body    = 6;
+        inline constexpr core::TwigID world_transform = 7;
+    }
+}
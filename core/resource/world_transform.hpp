@@ -0,0 +1,19 @@
+#pragma once
+#include "base/twig.hpp"
+#include "twig_slots.hpp"
+#include "math/math.hpp"
+
+namespace mango::resource
+{
+    // Composed local-to-world matrix of an entity's Transform and all of its scene
+    // ancestors. Written by core::Transform_Propagation; read it instead of calling
+    // Transform::get_matrix() when drawing, culling or syncing.
+    struct World_Transform : core::Twig<World_Transform>
+    {
+        static constexpr core::TwigID FIXED_TWIG_ID = twig_slot::world_transform;
+
+        math::Mat4 matrix{1.0f};
+
+        auto get_position() const -> math::Vec3 { return math::Vec3(matrix[3]); }
+    };
+}
@@ -0,0 +1,226 @@
+#include "worker-pool.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace mango::core
+{
+    namespace
+    {
+        // Pools are told apart by id rather than address, so a thread's slot in a destroyed
+        // pool is never mistaken for one in a pool allocated at the same address
+        std::atomic<std::uint64_t> next_pool_id{1};
+
+        thread_local std::uint32_t tls_thread_index = 0;
+        thread_local std::uint64_t tls_pool_id = 0;
+    }
+
+    Worker_Pool::Worker_Pool(std::uint32_t worker_count, std::uint32_t external_slots)
+        : external_slot_count_(std::max<std::uint32_t>(external_slots, 1)),
+          id_(next_pool_id.fetch_add(1, std::memory_order_relaxed)),
+          slot_taken_(external_slot_count_, false)
+    {
+        if (worker_count == 0) {
+            auto hardware = std::thread::hardware_concurrency();
+            worker_count = hardware > 1 ? hardware - 1 : 0;
+        }
+
+        queues_.reserve(external_slot_count_ + worker_count);
+        for (std::uint32_t i = 0; i < external_slot_count_ + worker_count; ++i) {
+            queues_.push_back(std::make_unique<Task_Queue>());
+        }
+
+        register_external_thread();
+
+        threads_.reserve(worker_count);
+        for (std::uint32_t i = external_slot_count_; i < external_slot_count_ + worker_count; ++i) {
+            threads_.emplace_back([this, i] { worker_main(i); });
+        }
+    }
+
+    Worker_Pool::~Worker_Pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+            stopping_.store(true, std::memory_order_release);
+        }
+        wake_.notify_all();
+        for (auto& thread : threads_) {
+            if (thread.joinable()) {
+                thread.join();
+            }
+        }
+    }
+
+    auto Worker_Pool::current_thread_index() -> std::uint32_t
+    {
+        return tls_pool_id == id_ ? tls_thread_index : register_external_thread();
+    }
+
+    auto Worker_Pool::register_external_thread() -> std::uint32_t
+    {
+        if (tls_pool_id == id_) {
+            return tls_thread_index;
+        }
+
+        std::lock_guard<std::mutex> lock(slot_mutex_);
+        auto free_slot = std::find(slot_taken_.begin(), slot_taken_.end(), false);
+        if (free_slot == slot_taken_.end()) {
+            throw std::runtime_error("Worker_Pool: every external thread slot is taken");
+        }
+        *free_slot = true;
+        tls_thread_index = static_cast<std::uint32_t>(free_slot - slot_taken_.begin());
+        tls_pool_id = id_;
+        return tls_thread_index;
+    }
+
+    auto Worker_Pool::unregister_external_thread() -> void
+    {
+        if (tls_pool_id != id_ || tls_thread_index >= external_slot_count_) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(slot_mutex_);
+        slot_taken_[tls_thread_index] = false;
+        tls_thread_index = 0;
+        tls_pool_id = 0;
+    }
+
+    auto Worker_Pool::run(Task_Group& group, Task task) -> void
+    {
+        group.pending_.fetch_add(1, std::memory_order_relaxed);
+        push([&group, task = std::move(task)] {
+            try {
+                task();
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(group.error_mutex_);
+                if (!group.error_) {
+                    group.error_ = std::current_exception();
+                }
+            }
+            group.pending_.fetch_sub(1, std::memory_order_acq_rel);
+        });
+    }
+
+    auto Worker_Pool::wait(Task_Group& group) -> void
+    {
+        auto self = current_thread_index();
+        Task task;
+        while (!group.is_done()) {
+            if (try_pop(self, task)) {
+                task();
+                task = nullptr;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(group.error_mutex_);
+        if (group.error_) {
+            auto error = group.error_;
+            group.error_ = nullptr;
+            std::rethrow_exception(error);
+        }
+    }
+
+    auto Worker_Pool::parallel_for(std::size_t count, std::size_t grain, const Range_Fn& fn) -> void
+    {
+        if (count == 0) {
+            return;
+        }
+        grain = std::max<std::size_t>(grain, 1);
+
+        auto chunk_count = (count + grain - 1) / grain;
+        if (chunk_count == 1 || threads_.empty()) {
+            fn(0, count, current_thread_index());
+            return;
+        }
+
+        // One task per participating thread; chunks are claimed from a shared cursor
+        std::atomic<std::size_t> next_chunk{0};
+        auto drain = [&] {
+            auto thread_index = current_thread_index();
+            for (auto chunk = next_chunk.fetch_add(1); chunk < chunk_count; chunk = next_chunk.fetch_add(1)) {
+                auto begin = chunk * grain;
+                fn(begin, std::min(begin + grain, count), thread_index);
+            }
+        };
+
+        Task_Group group;
+        auto helpers = std::min<std::size_t>(chunk_count - 1, threads_.size());
+        for (std::size_t i = 0; i < helpers; ++i) {
+            run(group, drain);
+        }
+        drain();
+        wait(group);
+    }
+
+    auto Worker_Pool::push(Task task) -> void
+    {
+        auto index = current_thread_index();
+        {
+            std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+            queues_[index]->tasks.push_back(std::move(task));
+        }
+        queued_.fetch_add(1, std::memory_order_release);
+
+        // Taking the sleep mutex orders this notify after a worker's predicate check
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex_);
+        }
+        wake_.notify_one();
+    }
+
+    auto Worker_Pool::try_pop(std::uint32_t thread_index, Task& task) -> bool
+    {
+        if (queued_.load(std::memory_order_acquire) == 0) {
+            return false;
+        }
+
+        // Own queue first (LIFO keeps freshly split work cache-hot)
+        {
+            auto& own = *queues_[thread_index];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty()) {
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                queued_.fetch_sub(1, std::memory_order_acq_rel);
+                return true;
+            }
+        }
+
+        // Steal the oldest task from the other queues
+        auto queue_count = static_cast<std::uint32_t>(queues_.size());
+        for (std::uint32_t offset = 1; offset < queue_count; ++offset) {
+            auto& victim = *queues_[(thread_index + offset) % queue_count];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                queued_.fetch_sub(1, std::memory_order_acq_rel);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    auto Worker_Pool::worker_main(std::uint32_t thread_index) -> void
+    {
+        tls_thread_index = thread_index;
+        tls_pool_id = id_;
+
+        Task task;
+        while (!stopping_.load(std::memory_order_acquire)) {
+            if (try_pop(thread_index, task)) {
+                task();
+                task = nullptr;
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(sleep_mutex_);
+            wake_.wait(lock, [this] {
+                return stopping_.load(std::memory_order_acquire) || queued_.load(std::memory_order_acquire) > 0;
+            });
+        }
+    }
+}
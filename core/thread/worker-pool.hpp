@@ -0,0 +1,111 @@
+#pragma once
+#include "data-struct/singleton.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mango::core
+{
+    // Tracks a batch of tasks so a caller can wait for (and help with) all of them.
+    class Task_Group
+    {
+    public:
+        Task_Group() = default;
+        Task_Group(const Task_Group&) = delete;
+        Task_Group& operator=(const Task_Group&) = delete;
+
+        auto is_done() const -> bool { return pending_.load(std::memory_order_acquire) == 0; }
+
+    private:
+        friend class Worker_Pool;
+
+        std::atomic<std::size_t> pending_{0};
+        std::mutex error_mutex_;
+        std::exception_ptr error_;
+    };
+
+    // Work-stealing thread pool.
+    // Each worker owns a deque: it pops its own work LIFO and steals FIFO from the others.
+    // Threads that are not workers (main thread, render thread) take one of a fixed number
+    // of external slots, each with its own queue and thread index, so two of them calling
+    // into the pool at once never share per-thread scratch.
+    // Waiting threads execute pending tasks instead of blocking, so nested waits are safe.
+    class Worker_Pool : public Singleton<Worker_Pool>
+    {
+    public:
+        using Task = std::function<void()>;
+        using Range_Fn = std::function<void(std::size_t begin, std::size_t end, std::uint32_t thread_index)>;
+
+        static constexpr std::uint32_t DEFAULT_EXTERNAL_SLOTS = 4;
+
+        // worker_count == 0 picks hardware_concurrency - 1 (the caller is the remaining thread).
+        // The constructing thread is registered in external slot 0.
+        explicit Worker_Pool(std::uint32_t worker_count = 0, std::uint32_t external_slots = DEFAULT_EXTERNAL_SLOTS);
+        ~Worker_Pool();
+
+        Worker_Pool(const Worker_Pool&) = delete;
+        Worker_Pool& operator=(const Worker_Pool&) = delete;
+
+        auto get_worker_count() const -> std::uint32_t { return static_cast<std::uint32_t>(threads_.size()); }
+
+        auto get_external_slot_count() const -> std::uint32_t { return external_slot_count_; }
+
+        // External slots plus workers; size of any per-thread scratch array
+        auto get_thread_count() const -> std::uint32_t { return static_cast<std::uint32_t>(queues_.size()); }
+
+        // 0..external_slots - 1 on external threads, the indices after that on pool workers.
+        // A thread that is not registered yet takes a free external slot here.
+        auto current_thread_index() -> std::uint32_t;
+
+        // Claims an external slot for the calling thread (no-op when it already has one) and
+        // returns its index. Throws when every slot is taken.
+        auto register_external_thread() -> std::uint32_t;
+
+        // Frees the calling thread's external slot. Call before a registered thread exits,
+        // outside any parallel work; slots of threads that never unregister stay taken.
+        auto unregister_external_thread() -> void;
+
+        auto run(Task_Group& group, Task task) -> void;
+
+        // Blocks until every task of the group finished, executing queued tasks meanwhile.
+        // Rethrows the first exception raised by a task of the group.
+        auto wait(Task_Group& group) -> void;
+
+        // Splits [0, count) into chunks of `grain` and runs fn(begin, end, thread_index)
+        // on the pool and the calling thread. Returns when every chunk is done.
+        auto parallel_for(std::size_t count, std::size_t grain, const Range_Fn& fn) -> void;
+
+    private:
+        struct Task_Queue
+        {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+        };
+
+        auto push(Task task) -> void;
+        auto try_pop(std::uint32_t thread_index, Task& task) -> bool;
+        auto worker_main(std::uint32_t thread_index) -> void;
+
+        // One queue per thread index: external slots first, then the workers
+        std::vector<std::unique_ptr<Task_Queue>> queues_;
+        std::vector<std::thread> threads_;
+        std::uint32_t external_slot_count_ = 0;
+        std::uint64_t id_ = 0;
+
+        std::mutex slot_mutex_;
+        std::vector<bool> slot_taken_;
+
+        std::mutex sleep_mutex_;
+        std::condition_variable wake_;
+        std::atomic<std::size_t> queued_{0};
+        std::atomic<bool> stopping_{false};
+    };
+}
@@ -332,6 +332,21 @@ namespace mango::graphics::vk
         m_capabilities.dynamic_rendering_supported =
             vulkan_13 || has_device_extension(m_physical_device, VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME);
         m_capabilities.ray_tracing_supported = query_ray_tracing_support();
+        m_capabilities.multi_draw_indirect_supported = m_device_features.multiDrawIndirect == VK_TRUE;
+        m_capabilities.draw_indirect_first_instance_supported = m_device_features.drawIndirectFirstInstance == VK_TRUE;
+
+        // Core in 1.2 but still optional, so ask for the feature bit rather than trusting the version
+        if (vulkan_12) {
+            VkPhysicalDeviceVulkan12Features vulkan_12_features{};
+            vulkan_12_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+
+            VkPhysicalDeviceFeatures2 features{};
+            features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+            features.pNext = &vulkan_12_features;
+            vkGetPhysicalDeviceFeatures2(m_physical_device, &features);
+
+            m_capabilities.draw_indirect_count_supported = vulkan_12_features.drawIndirectCount == VK_TRUE;
+        }
     }
 
     void Vk_Device::create_logical_device(const Device_Desc& desc)
@@ -368,6 +383,14 @@ namespace mango::graphics::vk
             device_features.fillModeNonSolid = VK_TRUE;
         }
 
+        if (m_capabilities.multi_draw_indirect_supported) {
+            device_features.multiDrawIndirect = VK_TRUE;
+        }
+
+        if (m_capabilities.draw_indirect_first_instance_supported) {
+            device_features.drawIndirectFirstInstance = VK_TRUE;
+        }
+
         // Enable timeline semaphore feature
         VkPhysicalDeviceTimelineSemaphoreFeatures timeline_features{};
         timeline_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
@@ -389,12 +412,31 @@ namespace mango::graphics::vk
         ray_tracing_pipeline_features.rayTracingPipeline = VK_TRUE;
         ray_tracing_pipeline_features.pNext = &acceleration_structure_features;
 
+        const bool enable_ray_tracing = m_enable_raytracing && m_capabilities.ray_tracing_supported;
+
         void* device_feature_chain = &timeline_features;
-        if (m_enable_raytracing && m_capabilities.ray_tracing_supported) {
+        if (enable_ray_tracing) {
             timeline_features.pNext = &ray_tracing_pipeline_features;
             device_feature_chain = &timeline_features;
         }
 
+        // drawIndirectCount only exists in the 1.2 feature block, which may not be chained next
+        // to the standalone structs it covers, so move timeline semaphores and buffer device
+        // addresses into it as well
+        VkPhysicalDeviceVulkan12Features vulkan_12_features{};
+        vulkan_12_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+        if (m_capabilities.draw_indirect_count_supported) {
+            vulkan_12_features.timelineSemaphore = VK_TRUE;
+            vulkan_12_features.drawIndirectCount = VK_TRUE;
+            device_feature_chain = &vulkan_12_features;
+
+            if (enable_ray_tracing) {
+                vulkan_12_features.bufferDeviceAddress = VK_TRUE;
+                acceleration_structure_features.pNext = nullptr;
+                vulkan_12_features.pNext = &ray_tracing_pipeline_features;
+            }
+        }
+
         VkDeviceCreateInfo create_info{};
         create_info.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
         create_info.pNext = device_feature_chain;
@@ -285,6 +285,42 @@ namespace mango::graphics::vk
         vkCmdDrawIndexed(m_command_buffer, index_count, instance_count, first_index, vertex_offset, first_instance);
     }
 
+    void Vk_Command_Buffer::draw_indirect(std::shared_ptr<Buffer> buffer, uint64_t offset, uint32_t draw_count, uint32_t stride)
+    {
+        auto vk_buffer = std::dynamic_pointer_cast<Vk_Buffer>(buffer);
+        if (!vk_buffer) {
+            UH_ERROR("Invalid buffer type for Vulkan indirect draw");
+            return;
+        }
+
+        vkCmdDrawIndirect(m_command_buffer, vk_buffer->get_vk_buffer(), offset, draw_count, stride);
+    }
+
+    void Vk_Command_Buffer::draw_indexed_indirect(std::shared_ptr<Buffer> buffer, uint64_t offset, uint32_t draw_count, uint32_t stride)
+    {
+        auto vk_buffer = std::dynamic_pointer_cast<Vk_Buffer>(buffer);
+        if (!vk_buffer) {
+            UH_ERROR("Invalid buffer type for Vulkan indirect draw");
+            return;
+        }
+
+        vkCmdDrawIndexedIndirect(m_command_buffer, vk_buffer->get_vk_buffer(), offset, draw_count, stride);
+    }
+
+    void Vk_Command_Buffer::draw_indexed_indirect_count(std::shared_ptr<Buffer> buffer, uint64_t offset, std::shared_ptr<Buffer> count_buffer,
+        uint64_t count_offset, uint32_t max_draw_count, uint32_t stride)
+    {
+        auto vk_buffer = std::dynamic_pointer_cast<Vk_Buffer>(buffer);
+        auto vk_count = std::dynamic_pointer_cast<Vk_Buffer>(count_buffer);
+        if (!vk_buffer || !vk_count) {
+            UH_ERROR("Invalid buffer types for Vulkan indirect count draw");
+            return;
+        }
+
+        vkCmdDrawIndexedIndirectCount(m_command_buffer, vk_buffer->get_vk_buffer(), offset,
+                                      vk_count->get_vk_buffer(), count_offset, max_draw_count, stride);
+    }
+
     // ========== Dispatch for compute ==========
 
     void Vk_Command_Buffer::dispatch(uint32_t group_count_x, uint32_t group_count_y, uint32_t group_count_z)
@@ -313,6 +349,17 @@ namespace mango::graphics::vk
         vkCmdCopyBuffer(m_command_buffer, vk_src->get_vk_buffer(), vk_dst->get_vk_buffer(), 1, &copy_region);
     }
 
+    void Vk_Command_Buffer::fill_buffer(std::shared_ptr<Buffer> buffer, uint64_t offset, uint64_t size, uint32_t value)
+    {
+        auto vk_buffer = std::dynamic_pointer_cast<Vk_Buffer>(buffer);
+        if (!vk_buffer) {
+            UH_ERROR("Invalid buffer type for Vulkan fill");
+            return;
+        }
+
+        vkCmdFillBuffer(m_command_buffer, vk_buffer->get_vk_buffer(), offset, size, value);
+    }
+
     void Vk_Command_Buffer::copy_buffer_to_texture(std::shared_ptr<Buffer> src, std::shared_ptr<Texture> dst,
         uint32_t width, uint32_t height, uint32_t mip, uint32_t array_layer)
     {
@@ -534,6 +581,9 @@ namespace mango::graphics::vk
             case Resource_State::present:
                 return VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
 
+            case Resource_State::indirect_argument:
+                return VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT;
+
             default:
                 return VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
         }
@@ -569,6 +619,9 @@ namespace mango::graphics::vk
             case Resource_State::present:
                 return 0;
 
+            case Resource_State::indirect_argument:
+                return VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+
             default:
                 return 0;
         }
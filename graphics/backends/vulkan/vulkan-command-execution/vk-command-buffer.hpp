@@ -47,12 +47,17 @@ namespace mango::graphics::vk
         // ========== Draw calls ==========
         void draw(uint32_t vertex_count, uint32_t instance_count = 1, uint32_t first_vertex = 0, uint32_t first_instance = 0) override;
         void draw_indexed(uint32_t index_count, uint32_t instance_count = 1, uint32_t first_index = 0, int32_t vertex_offset = 0, uint32_t first_instance = 0) override;
+        void draw_indirect(std::shared_ptr<Buffer> buffer, uint64_t offset, uint32_t draw_count, uint32_t stride) override;
+        void draw_indexed_indirect(std::shared_ptr<Buffer> buffer, uint64_t offset, uint32_t draw_count, uint32_t stride) override;
+        void draw_indexed_indirect_count(std::shared_ptr<Buffer> buffer, uint64_t offset, std::shared_ptr<Buffer> count_buffer,
+                                         uint64_t count_offset, uint32_t max_draw_count, uint32_t stride) override;
 
         // ========== Dispatch for compute ==========
         void dispatch(uint32_t group_count_x, uint32_t group_count_y, uint32_t group_count_z) override;
 
         // ========== Resource copy / upload ==========
         void copy_buffer(std::shared_ptr<Buffer> src, std::shared_ptr<Buffer> dst, uint64_t src_offset, uint64_t dst_offset, uint64_t size) override;
+        void fill_buffer(std::shared_ptr<Buffer> buffer, uint64_t offset, uint64_t size, uint32_t value) override;
         void copy_buffer_to_texture(std::shared_ptr<Buffer> src, std::shared_ptr<Texture> dst, uint32_t width, uint32_t height, uint32_t mip = 0, uint32_t array_layer = 0) override;
 
         // ========== Barriers ==========
@@ -112,15 +112,18 @@ namespace mango::graphics::vk
             case Buffer_Type::storage:
                 flags = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
                 break;
+            case Buffer_Type::indirect:
+                flags = VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+                break;
         }
 
         // GPU-only buffers need transfer destination capability
         if (m_desc.memory == Memory_Type::gpu_only) {
             flags |= VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
         }
-        // CPU-visible buffers might also need transfer for readback
+        // Readback buffers are copy destinations
         else if (m_desc.memory == Memory_Type::gpu2cpu) {
-            flags |= VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+            flags |= VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
         }
         // CPU-to-GPU buffers might be used as transfer source
         else if (m_desc.memory == Memory_Type::cpu2gpu) {
@@ -13,5 +13,8 @@ namespace mango::graphics
         bool dynamic_rendering_supported = false;
         bool timeline_semaphore_supported = false;
         bool descriptor_indexing_supported = false;
+        bool multi_draw_indirect_supported = false;             // draw_*_indirect with more than one draw
+        bool draw_indirect_first_instance_supported = false;    // indirect commands with first_instance != 0
+        bool draw_indirect_count_supported = false;             // draw_indexed_indirect_count
     };
 }
@@ -75,11 +75,20 @@ namespace mango::graphics
         virtual void draw(uint32_t vertexCount, uint32_t instanceCount = 1, uint32_t firstVertex = 0, uint32_t firstInstance = 0) = 0;
         virtual void draw_indexed(uint32_t indexCount, uint32_t instanceCount = 1, uint32_t firstIndex = 0, int32_t vertexOffset = 0, uint32_t firstInstance = 0) = 0;
 
+        // Indirect draws: arguments are read from the buffer on the GPU. More than one draw
+        // per call needs Device_Capabilities::multi_draw_indirect_supported; the count variant
+        // reads the draw count from a second buffer and needs draw_indirect_count_supported.
+        virtual void draw_indirect(std::shared_ptr<Buffer> buffer, uint64_t offset, uint32_t drawCount, uint32_t stride) = 0;
+        virtual void draw_indexed_indirect(std::shared_ptr<Buffer> buffer, uint64_t offset, uint32_t drawCount, uint32_t stride) = 0;
+        virtual void draw_indexed_indirect_count(std::shared_ptr<Buffer> buffer, uint64_t offset, std::shared_ptr<Buffer> countBuffer,
+                                                 uint64_t countOffset, uint32_t maxDrawCount, uint32_t stride) = 0;
+
         // Dispatch for compute
         virtual void dispatch(uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) = 0;
 
         // Resource copy / upload helpers
         virtual void copy_buffer(std::shared_ptr<Buffer> src, std::shared_ptr<Buffer> dst, uint64_t srcOffset, uint64_t dstOffset, uint64_t size) = 0;
+        virtual void fill_buffer(std::shared_ptr<Buffer> buffer, uint64_t offset, uint64_t size, uint32_t value) = 0;
         virtual void copy_buffer_to_texture(std::shared_ptr<Buffer> src, std::shared_ptr<Texture> dst, uint32_t width, uint32_t height, uint32_t mip = 0, uint32_t arrayLayer = 0) = 0;
 
         //barriers
@@ -11,6 +11,7 @@ namespace mango::graphics
         index,
         uniform,
         storage,
+        indirect,       // draw arguments and counts; also a storage buffer so compute can write them
     };
 
     enum struct Memory_Type
@@ -14,6 +14,7 @@ namespace mango::graphics
         copy_src,
         copy_dst,
         present,
+        indirect_argument,
     };
 
     struct Barrier
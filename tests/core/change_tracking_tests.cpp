@@ -0,0 +1,68 @@
+#include "core/manager/world.hpp"
+#include "tests/test_macros.hpp"
+#include <algorithm>
+#include <utility>
+
+namespace
+{
+    struct Position : mango::core::Twig<Position> { int value = 0; };
+    struct Velocity : mango::core::Twig<Velocity> { int value = 0; };
+}
+
+int main()
+{
+    using namespace mango::core;
+    auto& world = *World::current_instance();
+
+    std::vector<Entity> entities;
+    for (int i = 0; i < 16; ++i) {
+        auto entity = world.create_entity();
+        world.attach_twig(entity, Position{});
+        world.attach_twig(entity, Velocity{});
+        entities.push_back(entity);
+    }
+
+    auto since = world.advance_tick();
+    TEST_ASSERT(world.changed_since<Position>(since).empty());
+
+    // Mutable access stamps, const access does not
+    world.get_twig<Position>(entities[3]).value = 7;
+    (void)std::as_const(world).get_twig<Position>(entities[5]);
+    auto changed = world.changed_since<Position>(since);
+    TEST_ASSERT(changed.size() == 1 && changed[0] == entities[3]);
+
+    // Writes through a view are stamped explicitly
+    world.view<Position>().each([&](Entity entity, Position& position) {
+        if (entity == entities[9]) {
+            position.value = 9;
+            world.mark_changed<Position>(entity);
+        }
+    });
+    TEST_ASSERT(world.changed_since<Position>(since).size() == 2);
+
+    // par_each stamps Write twigs only
+    since = world.advance_tick();
+    world.par_each<Read<Velocity>, Write<Position>>([](const Velocity& velocity, Position& position) {
+        position.value += velocity.value;
+    });
+    TEST_ASSERT(world.changed_since<Position>(since).size() == entities.size());
+    TEST_ASSERT(world.changed_since<Velocity>(since).empty());
+
+    // Removals are logged for incremental consumers
+    since = world.advance_tick();
+    world.detach_twig<Velocity>(entities[0]);
+    world.destroy_entity(entities[1]);
+    std::vector<Entity> removed;
+    TEST_ASSERT(world.removed_since<Velocity>(since, removed));
+    TEST_ASSERT(removed.size() == 2);
+    TEST_ASSERT(std::find(removed.begin(), removed.end(), entities[1]) != removed.end());
+
+    // A consumer that fell behind the kept log has to resync
+    for (std::uint64_t i = 0; i < World::REMOVAL_LOG_TICKS + 1; ++i) {
+        world.advance_tick();
+    }
+    removed.clear();
+    TEST_ASSERT(!world.removed_since<Velocity>(since, removed));
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,47 @@
+#include "core/data-struct/freelist.hpp"
+#include "tests/test_macros.hpp"
+
+int main()
+{
+    using namespace mango::core;
+
+    // Handles round-trip index and generation at the configured width
+    Entity handle;
+    handle.set_index(Entity::MAX_INDEX);
+    handle.set_generation(Entity::MAX_GENERATION - 1);
+    TEST_ASSERT(handle.get_index() == Entity::MAX_INDEX);
+    TEST_ASSERT(handle.get_generation() == Entity::MAX_GENERATION - 1);
+    TEST_ASSERT(handle != INVALID_ENTITY);
+
+    // Recycling keeps LIFO order and bumps the generation
+    EntityList list;
+    auto a = list.allocate();
+    auto b = list.allocate();
+    list.deallocate(a);
+    auto c = list.allocate();
+    TEST_ASSERT(c.get_index() == a.get_index());
+    TEST_ASSERT(!list.exists(a) && list.exists(b) && list.exists(c));
+
+    // Reserved handles become live at flush
+    auto reserved = list.reserve();
+    TEST_ASSERT(!list.exists(reserved));
+    list.flush_reserved();
+    TEST_ASSERT(list.exists(reserved));
+    TEST_ASSERT(list.get_count() == 3);
+
+#if !MANGO_WIDE_ENTITY_HANDLES
+    // A slot that exhausted its generations is retired instead of resurrecting old handles
+    EntityList churn;
+    auto first = churn.allocate();
+    auto current = first;
+    for (std::uint32_t i = 0; i < Entity::MAX_GENERATION; ++i) {
+        churn.deallocate(current);
+        current = churn.allocate();
+    }
+    TEST_ASSERT(churn.get_retired_count() == 1);
+    TEST_ASSERT(current.get_index() != first.get_index());
+    TEST_ASSERT(!churn.exists(first));
+#endif
+
+    return EXIT_SUCCESS;
+}
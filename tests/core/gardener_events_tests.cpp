@@ -0,0 +1,125 @@
+#include "core/manager/world.hpp"
+#include "tests/test_macros.hpp"
+#include <vector>
+
+namespace
+{
+    using namespace mango::core;
+
+    struct Position : Twig<Position> { int value = 0; };
+    struct Velocity : Twig<Velocity> { int value = 0; };
+
+    struct Batch_Gardener : Gardener_Base
+    {
+        std::size_t grafted = 0;
+        std::size_t lopped = 0;
+        std::size_t graft_batches = 0;
+
+        void on_post_graft_batch(std::span<const Entity> entities, TwigID) override
+        {
+            grafted += entities.size();
+            ++graft_batches;
+        }
+
+        void on_post_lopper_batch(std::span<const Entity> entities, TwigID) override
+        {
+            lopped += entities.size();
+        }
+    };
+
+    // Every batch of one twig, in delivery order
+    struct Order_Gardener : Gardener_Base
+    {
+        struct Delivery
+        {
+            bool graft;
+            std::vector<Entity> entities;
+        };
+        TwigID twig = 0;
+        std::vector<Delivery> deliveries;
+
+        void on_post_graft_batch(std::span<const Entity> entities, TwigID twig_type_id) override
+        {
+            if (twig_type_id == twig) deliveries.push_back({ true, { entities.begin(), entities.end() } });
+        }
+
+        void on_post_lopper_batch(std::span<const Entity> entities, TwigID twig_type_id) override
+        {
+            if (twig_type_id == twig) deliveries.push_back({ false, { entities.begin(), entities.end() } });
+        }
+    };
+
+    struct Entity_Gardener : Gardener_Base
+    {
+        Entity_Gardener() { enable_entity_events(); }
+
+        std::size_t pre_grafts = 0;
+        std::size_t post_grafts = 0;
+
+        void on_pre_graft(Entity, std::size_t) override { ++pre_grafts; }
+        void on_post_graft(Entity, std::size_t) override { ++post_grafts; }
+    };
+}
+
+int main()
+{
+    auto& world = *World::current_instance();
+    Gardener_Registry registry;
+    auto* batch = registry.register_gardener<Batch_Gardener>();
+    world.set_gardener_registry(&registry);
+
+    // 50k spawns reach the batch gardener as one span per twig type
+    Prefab prefab{ Position{}, Velocity{} };
+    auto spawned = world.instantiate(prefab, 50000);
+    TEST_ASSERT(batch->grafted == 0);
+    registry.flush_events();
+    TEST_ASSERT(batch->grafted == 100000);
+    TEST_ASSERT(batch->graft_batches == 2);
+
+    // Single attach/detach/destroy events are coalesced until the next flush
+    auto extra = world.create_entity();
+    world.attach_twig(extra, Position{});
+    world.attach_twig(extra, Position{});   // overwrite, not a graft
+    world.detach_twig<Velocity>(spawned[0]);
+    world.destroy_entity(spawned[1]);
+    registry.update_all(0.016f);
+    TEST_ASSERT(batch->grafted == 100001);
+    TEST_ASSERT(batch->lopped == 3);
+
+    // Attach, detach, attach between two flushes arrives in that order, so the last batch
+    // naming the entity says it has the twig
+    auto* order = registry.register_gardener<Order_Gardener>();
+    order->twig = Position::get_static_id();
+    auto flicker = world.create_entity();
+    auto steady = world.create_entity();
+    world.attach_twig(flicker, Position{});
+    world.attach_twig(flicker, Velocity{});
+    world.attach_twig(steady, Position{});
+    world.detach_twig<Position>(flicker);
+    world.attach_twig(flicker, Position{});
+    registry.flush_events();
+    TEST_ASSERT(order->deliveries.size() == 3);
+    TEST_ASSERT(order->deliveries[0].graft && (order->deliveries[0].entities == std::vector<Entity>{ flicker, steady }));
+    TEST_ASSERT(!order->deliveries[1].graft && (order->deliveries[1].entities == std::vector<Entity>{ flicker }));
+    TEST_ASSERT(order->deliveries[2].graft && (order->deliveries[2].entities == std::vector<Entity>{ flicker }));
+    TEST_ASSERT(world.has_twig<Position>(flicker));
+
+    // The queue starts over after a flush
+    order->deliveries.clear();
+    world.detach_twig<Position>(steady);
+    registry.flush_events();
+    TEST_ASSERT(order->deliveries.size() == 1 && !order->deliveries[0].graft);
+    order->set_enabled(false);
+
+    // Opted-in gardeners still receive per-entity hooks immediately
+    auto* legacy = registry.register_gardener<Entity_Gardener>();
+    world.attach_twig(extra, Velocity{});
+    TEST_ASSERT(legacy->pre_grafts == 1 && legacy->post_grafts == 1);
+    world.instantiate(Prefab{ Position{} }, 10);
+    TEST_ASSERT(legacy->post_grafts == 11);
+    registry.flush_events();
+    TEST_ASSERT(batch->grafted == 100016);
+
+    world.set_gardener_registry(nullptr);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,159 @@
+#include "core/base/gardener.hpp"
+#include "core/thread/worker-pool.hpp"
+#include "tests/test_macros.hpp"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using namespace mango::core;
+
+    struct Position : Twig<Position> {};
+    struct Velocity : Twig<Velocity> {};
+    struct Health : Twig<Health> {};
+
+    std::atomic<int> clock_ticks{0};
+
+    // Gardeners currently inside update(), and the most seen at once
+    std::atomic<int> inside{0};
+    std::atomic<int> peak_inside{0};
+
+    struct Recording_Gardener : Gardener_Base
+    {
+        int started = -1;
+        int finished = -1;
+
+        // Set on both sides of an independent pair: update() waits (bounded) until the other
+        // one is inside as well, so a scheduler that runs them one after the other is caught
+        bool rendezvous = false;
+        bool met = false;
+
+        void update(float) override
+        {
+            started = clock_ticks.fetch_add(1);
+            auto now_inside = inside.fetch_add(1) + 1;
+            auto peak = peak_inside.load();
+            while (now_inside > peak && !peak_inside.compare_exchange_weak(peak, now_inside)) {}
+
+            if (rendezvous) {
+                auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+                while (inside.load() < 2 && std::chrono::steady_clock::now() < deadline) {
+                    std::this_thread::yield();
+                }
+                met = inside.load() >= 2;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+
+            inside.fetch_sub(1);
+            finished = clock_ticks.fetch_add(1);
+        }
+    };
+
+    auto disjoint(const Recording_Gardener& a, const Recording_Gardener& b) -> bool
+    {
+        return a.finished < b.started || b.finished < a.started;
+    }
+
+    struct Movement : Recording_Gardener
+    {
+        Movement() { reads<Velocity>(); writes<Position>(); }
+        std::string_view get_name() const override { return "Movement"; }
+    };
+
+    struct Render_Sync : Recording_Gardener
+    {
+        Render_Sync() { reads<Position>(); }
+    };
+
+    struct Audio_Sync : Recording_Gardener
+    {
+        Audio_Sync() { reads<Position>(); }
+    };
+
+    struct Regeneration : Recording_Gardener
+    {
+        Regeneration() { writes<Health>(); }
+    };
+
+    struct Legacy : Recording_Gardener {};
+}
+
+int main()
+{
+    Movement movement;
+    Render_Sync render_sync;
+    Audio_Sync audio_sync;
+    Regeneration regeneration;
+    Legacy legacy;
+
+    TEST_ASSERT(movement.conflicts_with(render_sync));
+    TEST_ASSERT(!movement.conflicts_with(regeneration));
+    TEST_ASSERT(!render_sync.conflicts_with(regeneration));
+    TEST_ASSERT(legacy.conflicts_with(regeneration));
+
+    // Reading through World stamps ticks and fills the view cache, so readers of one twig
+    // must not run at the same time
+    TEST_ASSERT(render_sync.conflicts_with(audio_sync));
+
+    bool has_workers = Worker_Pool::current_instance()->get_worker_count() > 0;
+
+    // Independent gardeners run at the same time
+    {
+        Gardener_Registry registry;
+        auto* move = registry.register_gardener<Movement>();
+        auto* regen = registry.register_gardener<Regeneration>();
+        move->rendezvous = has_workers;
+        regen->rendezvous = has_workers;
+
+        for (int frame = 0; frame < 3; ++frame) {
+            peak_inside = 0;
+            registry.update_all(0.016f);
+            if (has_workers) {
+                TEST_ASSERT(move->met && regen->met);
+                TEST_ASSERT(peak_inside.load() == 2);
+                TEST_ASSERT(!disjoint(*move, *regen));
+            }
+        }
+    }
+
+    // Conflicting gardeners never overlap and keep registration order
+    Gardener_Registry registry;
+    auto* move = registry.register_gardener<Movement>();
+    auto* sync = registry.register_gardener<Render_Sync>();
+    auto* audio = registry.register_gardener<Audio_Sync>();
+    auto* regen = registry.register_gardener<Regeneration>();
+    auto* old = registry.register_gardener<Legacy>();
+    std::vector<Recording_Gardener*> all = { move, sync, audio, regen, old };
+
+    for (int frame = 0; frame < 3; ++frame) {
+        registry.update_all(0.016f);
+
+        for (std::size_t i = 0; i < all.size(); ++i) {
+            for (std::size_t j = i + 1; j < all.size(); ++j) {
+                if (all[i]->conflicts_with(*all[j])) {
+                    TEST_ASSERT(disjoint(*all[i], *all[j]));
+                    TEST_ASSERT(all[i]->finished < all[j]->started);
+                }
+            }
+        }
+        TEST_ASSERT(sync->finished < audio->started);
+        TEST_ASSERT(regen->finished < old->started);
+    }
+
+    const auto& timings = registry.get_timings();
+    TEST_ASSERT(timings.size() == 5);
+    TEST_ASSERT(timings[0].name == "Movement");
+    TEST_ASSERT(timings[0].update_ms > 0.0);
+    TEST_ASSERT(timings[4].fixed_update_ms == 0.0);
+
+    // Disabled gardeners are skipped and do not block their successors
+    move->set_enabled(false);
+    move->started = -1;
+    registry.update_all(0.016f);
+    TEST_ASSERT(move->started == -1);
+    TEST_ASSERT(sync->finished < old->started);
+
+    return EXIT_SUCCESS;
+}
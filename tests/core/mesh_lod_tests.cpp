@@ -0,0 +1,85 @@
+#include "core/resource/mesh_lod.hpp"
+#include "core/resource/primitives.hpp"
+#include "tests/test_macros.hpp"
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace
+{
+    using namespace mango;
+
+    // Index range of one LOD within indices followed by lod_indices
+    auto lod_indices(const resource::Mesh_Data& data, const resource::Mesh_Lod& lod) -> std::vector<std::uint32_t>
+    {
+        std::vector<std::uint32_t> all = data.indices;
+        all.insert(all.end(), data.lod_indices.begin(), data.lod_indices.end());
+        return { all.begin() + lod.first_index, all.begin() + lod.first_index + lod.index_count };
+    }
+}
+
+int main()
+{
+    using namespace mango;
+
+    // Import-time chain of a finely tessellated sphere
+    auto sphere = resource::create_sphere_mesh(0.5f, 32, 16);
+    const auto& data = *sphere.get_data();
+    TEST_ASSERT(data.lods.size() >= 3);
+    TEST_ASSERT(data.get_lod_count() == data.lods.size());
+    TEST_ASSERT(data.lods[0].first_index == 0 && data.lods[0].index_count == data.indices.size() && data.lods[0].error == 0.0f);
+
+    for (std::uint32_t level = 1; level < data.lods.size(); ++level) {
+        const auto& lod = data.lods[level];
+        const auto& previous = data.lods[level - 1];
+        TEST_ASSERT(lod.index_count % 3 == 0 && lod.index_count < previous.index_count);
+        TEST_ASSERT(lod.error >= previous.error);
+        TEST_ASSERT(lod.first_index + lod.index_count <= data.indices.size() + data.lod_indices.size());
+
+        // Same vertex buffer, still closed around the center, and within the stored
+        // error of the true surface (checked at triangle centroids)
+        auto indices = lod_indices(data, lod);
+        for (std::size_t i = 0; i < indices.size(); i += 3) {
+            TEST_ASSERT(indices[i] < data.vertices.size() && indices[i + 1] < data.vertices.size() && indices[i + 2] < data.vertices.size());
+            auto a = data.vertices[indices[i]].position;
+            auto b = data.vertices[indices[i + 1]].position;
+            auto c = data.vertices[indices[i + 2]].position;
+            auto centroid = (a + b + c) * (1.0f / 3.0f);
+            TEST_ASSERT(glm::dot(glm::cross(b - a, c - a), centroid) < 0.0f);    // sphere winds clockwise seen from outside
+            TEST_ASSERT(0.5f - glm::length(centroid) <= lod.error + 1e-4f);
+        }
+    }
+    TEST_ASSERT(data.get_lod(99).index_count == data.lods.back().index_count);
+
+    // A flat grid loses interior vertices at no error; its border stays
+    auto plane = resource::create_plane_mesh(4.0f, 16);
+    const auto& flat = *plane.get_data();
+    TEST_ASSERT(flat.lods.size() >= 3);
+    for (const auto& lod : flat.lods) {
+        TEST_ASSERT(lod.error < 1e-4f);
+        float area = 0.0f;
+        auto indices = lod_indices(flat, lod);
+        for (std::size_t i = 0; i < indices.size(); i += 3) {
+            auto a = flat.vertices[indices[i]].position;
+            auto b = flat.vertices[indices[i + 1]].position;
+            auto c = flat.vertices[indices[i + 2]].position;
+            area += 0.5f * glm::length(glm::cross(b - a, c - a));
+        }
+        TEST_ASSERT(std::abs(area - 16.0f) < 1e-3f);
+    }
+
+    // Hard-edged cube: every corner is a seam, nothing simplifies
+    auto cube = resource::create_cube_mesh(0.5f);
+    TEST_ASSERT(cube.get_data()->lods.empty() && cube.get_data()->get_lod_count() == 1);
+    TEST_ASSERT(cube.get_data()->get_lod(2).index_count == cube.get_index_count());
+
+    // Changing the geometry drops the now stale chain
+    auto edited = sphere;
+    edited.set_indices(sphere.get_indices());
+    TEST_ASSERT(edited.get_data()->lods.empty() && edited.get_data()->lod_indices.empty());
+    TEST_ASSERT(!sphere.get_data()->lods.empty());
+    edited.generate_lods();
+    TEST_ASSERT(edited.get_data()->lods.size() == data.lods.size());
+
+    return 0;
+}
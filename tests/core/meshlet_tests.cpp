@@ -0,0 +1,114 @@
+#include "core/resource/meshlet.hpp"
+#include "core/resource/primitives.hpp"
+#include "tests/test_macros.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace
+{
+    using namespace mango;
+
+    // Triangles as sorted index triples, to compare meshes regardless of triangle order
+    // and of which corner a triangle starts at
+    auto triangle_set(const std::vector<std::uint32_t>& indices) -> std::vector<std::array<std::uint32_t, 3>>
+    {
+        std::vector<std::array<std::uint32_t, 3>> triangles;
+        for (std::size_t i = 0; i + 2 < indices.size(); i += 3) {
+            std::array<std::uint32_t, 3> t = { indices[i], indices[i + 1], indices[i + 2] };
+            std::sort(t.begin(), t.end());
+            triangles.push_back(t);
+        }
+        std::sort(triangles.begin(), triangles.end());
+        return triangles;
+    }
+
+    // Front-face normal of a triangle, oriented like build_meshlets does
+    auto front_normal(const resource::Mesh_Data& data, std::size_t i) -> math::Vec3
+    {
+        const auto& a = data.vertices[data.indices[i]];
+        const auto& b = data.vertices[data.indices[i + 1]];
+        const auto& c = data.vertices[data.indices[i + 2]];
+        auto n = glm::cross(b.position - a.position, c.position - a.position);
+        return glm::dot(n, a.normal + b.normal + c.normal) < 0.0f ? n * -1.0f : n;
+    }
+}
+
+int main()
+{
+    using namespace mango;
+
+    // A dense sphere: same triangles, reordered into full, bounded clusters
+    auto sphere = resource::create_sphere_mesh(0.5f, 128, 64);
+    auto original = sphere.get_indices();
+    sphere.generate_meshlets();
+    const auto& data = *sphere.get_data();
+    TEST_ASSERT(triangle_set(data.indices) == triangle_set(original));
+    TEST_ASSERT(data.meshlets.size() >= original.size() / 3 / 124);
+
+    std::uint32_t next_index = 0;
+    std::uint32_t triangles = 0;
+    std::uint32_t backfacing = 0;
+    const math::Vec3 camera(0.0f, 0.0f, 4.0f);
+    for (const auto& meshlet : data.meshlets) {
+        TEST_ASSERT(meshlet.first_index == next_index && meshlet.index_count % 3 == 0);
+        TEST_ASSERT(meshlet.index_count / 3 <= 124 && meshlet.vertex_count <= 64);
+        next_index += meshlet.index_count;
+        triangles += meshlet.index_count / 3;
+
+        std::vector<std::uint32_t> distinct(data.indices.begin() + meshlet.first_index,
+                                            data.indices.begin() + meshlet.first_index + meshlet.index_count);
+        std::sort(distinct.begin(), distinct.end());
+        distinct.erase(std::unique(distinct.begin(), distinct.end()), distinct.end());
+        TEST_ASSERT(distinct.size() == meshlet.vertex_count);
+        for (auto v : distinct) {
+            TEST_ASSERT(glm::length(data.vertices[v].position - meshlet.center) <= meshlet.radius * 1.0001f + 1e-6f);
+        }
+
+        // Closed mesh: every cone is real, and a cluster it rejects really faces away
+        TEST_ASSERT(meshlet.cone_cutoff < 1.0f);
+        if (resource::is_meshlet_backfacing(meshlet, camera)) {
+            ++backfacing;
+            for (auto i = meshlet.first_index; i < meshlet.first_index + meshlet.index_count; i += 3) {
+                auto n = front_normal(data, i);
+                TEST_ASSERT(glm::dot(n, data.vertices[data.indices[i]].position - camera) >= 0.0f);
+            }
+        }
+        // Clusters on the camera's side are kept
+        if (meshlet.center.z > 0.1f) {
+            TEST_ASSERT(!resource::is_meshlet_backfacing(meshlet, camera));
+        }
+    }
+    TEST_ASSERT(next_index == data.indices.size() && triangles == original.size() / 3);
+    TEST_ASSERT(triangles / data.meshlets.size() >= 80);        // clusters come out mostly full
+    TEST_ASSERT(backfacing * 4 >= data.meshlets.size());        // a fair share of the far side goes
+
+    // LODs index the vertices, so they are unaffected by the reordering
+    sphere.generate_lods();
+    TEST_ASSERT(!sphere.get_data()->meshlets.empty() && sphere.get_data()->lods.size() > 1);
+    TEST_ASSERT(sphere.get_data()->lods[0].index_count == original.size());
+
+    // Open meshes may be seen from behind when drawn two-sided: no cone ever culls
+    auto plane = resource::create_plane_mesh(4.0f, 32);
+    plane.generate_meshlets();
+    TEST_ASSERT(!plane.get_data()->meshlets.empty());
+    for (const auto& meshlet : plane.get_data()->meshlets) {
+        TEST_ASSERT(meshlet.cone_cutoff == 1.0f);
+        TEST_ASSERT(!resource::is_meshlet_backfacing(meshlet, math::Vec3(0.0f, -5.0f, 0.0f)));
+    }
+
+    // Smaller limits are honoured, and editing the geometry drops the clusters
+    auto small = resource::create_sphere_mesh(0.5f, 16, 8);
+    auto edited = *small.get_data();
+    resource::build_meshlets(edited, { 16, 20 });
+    for (const auto& meshlet : edited.meshlets) {
+        TEST_ASSERT(meshlet.vertex_count <= 16 && meshlet.index_count <= 60);
+    }
+    small.generate_meshlets();
+    TEST_ASSERT(!small.get_data()->meshlets.empty());
+    small.set_indices(small.get_indices());
+    TEST_ASSERT(small.get_data()->meshlets.empty());
+
+    return 0;
+}
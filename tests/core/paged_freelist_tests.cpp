@@ -0,0 +1,82 @@
+#include "core/data-struct/paged-freelist.hpp"
+#include "tests/test_macros.hpp"
+#include <string>
+
+namespace
+{
+    int live_objects = 0;
+
+    struct Tracked
+    {
+        std::string name;
+        explicit Tracked(std::string n = "") : name(std::move(n)) { ++live_objects; }
+        ~Tracked() { --live_objects; }
+    };
+}
+
+int main()
+{
+    using namespace mango::core;
+
+    {
+        Paged_Freelist<Tracked, 64> list;
+        auto first = list.allocate("first");
+        Tracked* address = &list.get(first);
+
+        // Growing across many pages never moves existing elements
+        for (int i = 0; i < 1000; ++i) {
+            list.allocate(std::to_string(i));
+        }
+        TEST_ASSERT(&list.get(first) == address);
+        TEST_ASSERT(list.get(first).name == "first");
+        TEST_ASSERT(list.size() == 1001);
+        TEST_ASSERT(list.get_page_count() == (1001 + 63) / 64);
+
+        // O(1) LIFO reuse of freed indices
+        list.deallocate(10);
+        list.deallocate(20);
+        TEST_ASSERT(!list.is_alive(10));
+        TEST_ASSERT(list.allocate("reused") == 20);
+        TEST_ASSERT(list.allocate() == 10);
+        TEST_ASSERT(live_objects == 1001);
+
+        std::uint32_t visited = 0;
+        std::uint32_t previous = 0;
+        bool ordered = true;
+        list.for_each([&](std::uint32_t index, Tracked&) {
+            ordered = ordered && (visited == 0 || index > previous);
+            previous = index;
+            ++visited;
+        });
+        TEST_ASSERT(visited == list.size());
+        TEST_ASSERT(ordered);
+    }
+    TEST_ASSERT(live_objects == 0);
+
+    // Huge-page backing behaves the same (it only changes how pages are allocated)
+    constexpr std::size_t HUGE_PAGE = 2 * 1024 * 1024;
+    Paged_Freelist<std::uint64_t> huge(Page_Backing::huge);
+    for (std::uint64_t i = 0; i < 5000; ++i) {
+        huge.allocate(i);
+    }
+    TEST_ASSERT(huge.get(4321) == 4321);
+
+    // Small pages share one arena instead of each taking a huge page
+    TEST_ASSERT(huge.get_page_count() == 5);
+    TEST_ASSERT(huge.get_reserved_bytes() == HUGE_PAGE);
+
+    // Filling the first arena opens a second one without moving anything
+    std::uint64_t* early = &huge.get(10);
+    std::uint32_t count = 5000;
+    while (huge.get_reserved_bytes() == HUGE_PAGE) {
+        huge.allocate(count++);
+    }
+    TEST_ASSERT(huge.get_reserved_bytes() == 2 * HUGE_PAGE);
+    TEST_ASSERT(&huge.get(10) == early && huge.get(count - 1) == count - 1);
+    // Over 90% of the full arena holds slots
+    TEST_ASSERT((huge.get_page_count() - 1) * 1024 * sizeof(std::uint64_t) > HUGE_PAGE / 10 * 9);
+    huge.clear();
+    TEST_ASSERT(huge.empty() && huge.get_page_count() == 0 && huge.get_reserved_bytes() == 0);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,84 @@
+#include "core/manager/world.hpp"
+#include "tests/test_macros.hpp"
+#include <atomic>
+
+namespace
+{
+    struct Position : mango::core::Twig<Position> { float value = 0.0f; int origin = 0; };
+    struct Velocity : mango::core::Twig<Velocity> { float value = 0.0f; };
+}
+
+int main()
+{
+    using namespace mango::core;
+    auto& world = *World::current_instance();
+    auto& pool = *Worker_Pool::current_instance();
+
+    // parallel_for covers every index exactly once
+    std::vector<std::atomic<int>> hits(10000);
+    pool.parallel_for(hits.size(), 37, [&](std::size_t begin, std::size_t end, std::uint32_t) {
+        for (auto i = begin; i < end; ++i) {
+            hits[i].fetch_add(1);
+        }
+    });
+    int wrong_hits = 0;
+    for (auto& hit : hits) {
+        wrong_hits += hit.load() != 1 ? 1 : 0;
+    }
+    TEST_ASSERT(wrong_hits == 0);
+
+    // Exceptions thrown by tasks reach the waiting thread
+    bool caught = false;
+    try {
+        Task_Group group;
+        pool.run(group, [] { throw std::runtime_error("task failed"); });
+        pool.wait(group);
+    }
+    catch (const std::runtime_error&) {
+        caught = true;
+    }
+    TEST_ASSERT(caught);
+
+    constexpr int ENTITY_COUNT = 20000;
+    for (int i = 0; i < ENTITY_COUNT; ++i) {
+        auto entity = world.create_entity();
+        Position position;
+        position.value = static_cast<float>(i);
+        position.origin = i;
+        world.attach_twig(entity, position);
+        if (i % 3 != 0) {
+            Velocity velocity;
+            velocity.value = 1.0f;
+            world.attach_twig(entity, velocity);
+        }
+    }
+
+    world.par_each<Read<Velocity>, Write<Position>>([](const Velocity& velocity, Position& position) {
+        position.value += velocity.value;
+    }, 100);
+
+    int moved = 0;
+    int wrong = 0;
+    world.view<Position>().each([&](Entity entity, Position& position) {
+        int step = world.has_twig<Velocity>(entity) ? 1 : 0;
+        moved += step;
+        wrong += position.value != static_cast<float>(position.origin + step) ? 1 : 0;
+    });
+    TEST_ASSERT(moved == ENTITY_COUNT - (ENTITY_COUNT + 2) / 3);
+    TEST_ASSERT(wrong == 0);
+
+    // Per-thread scratch: sum moved positions without atomics
+    std::vector<double> partial;
+    world.par_each<Read<Position>, Read<Velocity>>(partial, [](double& sum, Entity, const Position&, const Velocity& velocity) {
+        sum += velocity.value;
+    });
+    TEST_ASSERT(partial.size() == pool.get_thread_count());
+
+    double total = 0.0;
+    for (auto sum : partial) {
+        total += sum;
+    }
+    TEST_ASSERT(static_cast<int>(total) == moved);
+
+    return EXIT_SUCCESS;
+}
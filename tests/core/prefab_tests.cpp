@@ -0,0 +1,53 @@
+#include "core/manager/world.hpp"
+#include "tests/test_macros.hpp"
+#include <memory>
+
+namespace
+{
+    struct Position : mango::core::Twig<Position> { int value = 0; };
+    struct Shape : mango::core::Twig<Shape> { std::shared_ptr<const std::vector<int>> points; };
+}
+
+int main()
+{
+    using namespace mango::core;
+    auto& world = *World::current_instance();
+
+    auto created = world.create_entities(100);
+    TEST_ASSERT(created.size() == 100);
+    TEST_ASSERT(world.get_entities_count() == 100);
+
+    Position position;
+    position.value = 3;
+    world.attach_twig_bulk(created, position);
+    TEST_ASSERT(world.view<Position>().size() == 100);
+
+    // Instances share the prefab payload and are customised in place
+    Shape shape;
+    shape.points = std::make_shared<const std::vector<int>>(std::vector<int>(1024, 1));
+    Prefab prefab{ Position{}, std::move(shape) };
+
+    auto spawned = world.instantiate(prefab, 5000, [](std::size_t i, Entity, Position& p, Shape&) {
+        p.value = static_cast<int>(i);
+    });
+    TEST_ASSERT(spawned.size() == 5000);
+    TEST_ASSERT(world.get_entities_count() == 5100);
+    TEST_ASSERT(prefab.get<Shape>().points.use_count() == 5001);
+
+    int wrong = 0;
+    for (std::size_t i = 0; i < spawned.size(); ++i) {
+        wrong += world.get_twig<Position>(spawned[i]).value != static_cast<int>(i) ? 1 : 0;
+    }
+    TEST_ASSERT(wrong == 0);
+    TEST_ASSERT((world.view<Position, Shape>().size() == 5000));
+
+    // Recycled indices are reused by later bulk spawns
+    for (std::size_t i = 0; i < 10; ++i) {
+        world.destroy_entity(spawned[i]);
+    }
+    auto refill = world.instantiate(prefab, 10);
+    TEST_ASSERT(world.get_entities_count() == 5100);
+    TEST_ASSERT(refill[0].get_index() < spawned.back().get_index());
+
+    return EXIT_SUCCESS;
+}
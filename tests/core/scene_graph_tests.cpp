@@ -0,0 +1,90 @@
+#include "core/manager/scene-graph.hpp"
+#include "tests/test_macros.hpp"
+
+int main()
+{
+    using namespace mango::core;
+
+    auto& graph = *Scene_Graph::current_instance();
+    auto root = graph.get_root_node();
+    TEST_ASSERT(graph.name_of(root) == "Scene");
+
+    auto a = graph.add_entity_to_scene(Entity{10}, root, "A");
+    auto b = graph.add_entity_to_scene(Entity{20}, root, "B");
+    auto a1 = graph.add_entity_to_scene(Entity{30}, a, "A1");
+    auto a2 = graph.add_entity_to_scene(Entity{40}, a, "A2");
+    auto b1 = graph.add_entity_to_scene(Entity{50}, b, "B1");
+
+    // Children keep insertion order through last_child appends
+    TEST_ASSERT(graph.first_child_of(root) == a);
+    TEST_ASSERT(graph.next_decendent_of(a) == b);
+    TEST_ASSERT(graph.first_child_of(a) == a1);
+    TEST_ASSERT(graph.next_decendent_of(a1) == a2);
+    TEST_ASSERT(graph.parent_of(b1) == b);
+    TEST_ASSERT(graph.entity_of(a2) == Entity{40});
+    TEST_ASSERT(graph.path_of(a2) == "Scene/A/A2");
+    TEST_ASSERT(graph.node_of("Scene/B/B1") == b1);
+    TEST_ASSERT(graph.node_of("A/A1") == a1);
+    TEST_ASSERT(graph.node_of("Scene/C") == INVALID_SCENE_NODE);
+
+    // Adding under A after B's subtree breaks depth-first order; sorting restores it
+    const auto& hierarchy = graph.get_hierarchy();
+    TEST_ASSERT(!hierarchy.is_depth_first());
+    graph.sort_depth_first();
+    TEST_ASSERT(hierarchy.is_depth_first());
+
+    Scene_Node_Id expected[] = { root, a, a1, a2, b, b1 };
+    for (std::uint32_t row = 0; row < 6; ++row) {
+        TEST_ASSERT(hierarchy.id_at(row) == expected[row]);
+    }
+    TEST_ASSERT(hierarchy.subtree_end(hierarchy.row_of(root)) == 6);
+    TEST_ASSERT(hierarchy.subtree_end(hierarchy.row_of(a)) == 4);
+    TEST_ASSERT(hierarchy.subtree_end(hierarchy.row_of(b)) == 6);
+
+    // Ids and links survive the re-sort
+    TEST_ASSERT(graph.path_of(b1) == "Scene/B/B1");
+    TEST_ASSERT(graph.entity_of(a1) == Entity{30});
+
+    // Appending beneath the last subtree keeps the order and extends every ancestor range
+    auto b2 = graph.add_entity_to_scene(Entity{60}, b, "B2");
+    TEST_ASSERT(hierarchy.is_depth_first());
+    TEST_ASSERT(hierarchy.row_of(b2) == 6);
+    TEST_ASSERT(hierarchy.subtree_end(hierarchy.row_of(root)) == 7);
+    TEST_ASSERT(hierarchy.subtree_end(hierarchy.row_of(b)) == 7);
+
+    // Entity <-> node in both directions
+    TEST_ASSERT(graph.node_of_entity(Entity{50}) == b1);
+    TEST_ASSERT(graph.node_of_entity(Entity{99}) == INVALID_SCENE_NODE);
+
+    // Interned names: equal names share one id
+    auto a_copy = graph.add_entity_to_scene(Entity{70}, b, "A1");
+    TEST_ASSERT(hierarchy.name_id_of(a_copy) == hierarchy.name_id_of(a1));
+
+    // Rename re-keys the whole subtree
+    TEST_ASSERT(graph.rename(a, "Alpha"));
+    TEST_ASSERT(graph.node_of("Scene/Alpha/A2") == a2);
+    TEST_ASSERT(graph.node_of("Scene/A/A2") == INVALID_SCENE_NODE);
+    TEST_ASSERT(!graph.rename(a, "bad/name"));
+
+    // Reparent moves the subtree and rejects cycles and the root
+    TEST_ASSERT(graph.reparent(a1, b));
+    TEST_ASSERT(graph.parent_of(a1) == b);
+    TEST_ASSERT(graph.first_child_of(a) == a2);
+    TEST_ASSERT(graph.path_of(a1) == "Scene/B/A1");
+    TEST_ASSERT(!graph.reparent(b, a1));
+    TEST_ASSERT(!graph.reparent(root, b));
+    TEST_ASSERT(!hierarchy.is_depth_first());
+
+    // Two siblings now share "A1": the first indexed owns the path, the other takes over when it leaves
+    TEST_ASSERT(graph.node_of("Scene/B/A1") == a_copy);
+    TEST_ASSERT(graph.reparent(a_copy, a));
+    TEST_ASSERT(graph.node_of("Scene/B/A1") == a1);
+    TEST_ASSERT(graph.node_of("Scene/Alpha/A1") == a_copy);
+
+    graph.sort_depth_first();
+    TEST_ASSERT(graph.path_of(a1) == "Scene/B/A1");
+    TEST_ASSERT(graph.node_of("/Scene/B/") == b);
+
+    Scene_Graph::destroy_instance();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,81 @@
+#include "core/manager/transform-propagation.hpp"
+#include "core/manager/scene-graph.hpp"
+#include "core/manager/world.hpp"
+#include "core/resource/transform.hpp"
+#include "core/resource/world_transform.hpp"
+#include "tests/test_macros.hpp"
+#include <cmath>
+
+namespace
+{
+    using namespace mango;
+
+    auto near(const math::Vec3& a, const math::Vec3& b) -> bool
+    {
+        return std::abs(a.x - b.x) < 1e-5f && std::abs(a.y - b.y) < 1e-5f && std::abs(a.z - b.z) < 1e-5f;
+    }
+
+    auto spawn(core::World& world, core::Scene_Graph& graph, core::Scene_Node_Id parent, math::Vec3 position) -> std::pair<core::Entity, core::Scene_Node_Id>
+    {
+        auto entity = world.create_entity();
+        resource::Transform transform;
+        transform.position = position;
+        world.attach_twig(entity, transform);
+        return { entity, graph.add_entity_to_scene(entity, parent) };
+    }
+}
+
+int main()
+{
+    using namespace mango;
+    auto& world = *core::World::current_instance();
+    auto& graph = *core::Scene_Graph::current_instance();
+    auto root = graph.get_root_node();
+
+    auto [a, a_node] = spawn(world, graph, root, {1.0f, 0.0f, 0.0f});
+    auto [b, b_node] = spawn(world, graph, root, {0.0f, 5.0f, 0.0f});
+    auto [a1, a1_node] = spawn(world, graph, a_node, {0.0f, 2.0f, 0.0f});
+    auto [a11, a11_node] = spawn(world, graph, a1_node, {0.0f, 0.0f, 3.0f});
+
+    // Not part of the scene graph: its world matrix is its local one
+    auto loose = world.create_entity();
+    resource::Transform loose_transform;
+    loose_transform.position = {7.0f, 0.0f, 0.0f};
+    world.attach_twig(loose, loose_transform);
+
+    core::Transform_Propagation propagation;
+    TEST_ASSERT(propagation.run(world, graph) == 6);   // scene root, four nodes, one loose entity
+
+    const auto& cworld = world;
+    auto world_position = [&](core::Entity entity) {
+        return cworld.get_twig<resource::World_Transform>(entity).get_position();
+    };
+    TEST_ASSERT(near(world_position(a), {1.0f, 0.0f, 0.0f}));
+    TEST_ASSERT(near(world_position(a1), {1.0f, 2.0f, 0.0f}));
+    TEST_ASSERT(near(world_position(a11), {1.0f, 2.0f, 3.0f}));
+    TEST_ASSERT(near(world_position(b), {0.0f, 5.0f, 0.0f}));
+    TEST_ASSERT(near(world_position(loose), {7.0f, 0.0f, 0.0f}));
+
+    // Nothing changed: nothing recomputed
+    TEST_ASSERT(propagation.run(world, graph) == 0);
+
+    // Moving a1 recomputes exactly its subtree
+    world.get_twig<resource::Transform>(a1).position = {0.0f, 4.0f, 0.0f};
+    TEST_ASSERT(propagation.run(world, graph) == 2);
+    TEST_ASSERT(near(world_position(a11), {1.0f, 4.0f, 3.0f}));
+    TEST_ASSERT(near(world_position(b), {0.0f, 5.0f, 0.0f}));
+
+    // Parent scale applies to children
+    world.get_twig<resource::Transform>(a).scale = {2.0f, 2.0f, 2.0f};
+    TEST_ASSERT(propagation.run(world, graph) == 3);
+    TEST_ASSERT(near(world_position(a11), {1.0f, 8.0f, 6.0f}));
+
+    // Dropping a Transform makes the node inherit its parent's matrix
+    world.detach_twig<resource::Transform>(a1);
+    propagation.run(world, graph);
+    TEST_ASSERT(near(world_position(a11), {1.0f, 0.0f, 6.0f}));
+
+    core::Scene_Graph::destroy_instance();
+    core::World::destroy_instance();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,55 @@
+#include "core/manager/world.hpp"
+#include "tests/test_macros.hpp"
+#include <thread>
+
+namespace
+{
+    struct Fixed : mango::core::Twig<Fixed>
+    {
+        static constexpr mango::core::TwigID FIXED_TWIG_ID = mango::core::ENGINE_TWIG_SLOTS - 1;
+        int value = 0;
+    };
+
+    template<int N>
+    struct Dynamic : mango::core::Twig<Dynamic<N>> { int value = N; };
+}
+
+int main()
+{
+    using namespace mango::core;
+
+    // Fixed slots are compile-time constants
+    static_assert(Fixed::FIXED_TWIG_ID == ENGINE_TWIG_SLOTS - 1);
+    TEST_ASSERT(Fixed::get_static_id() == ENGINE_TWIG_SLOTS - 1);
+    TEST_ASSERT(Fixed{}.get_twig_id() == Fixed::get_static_id());
+    TEST_ASSERT(!Fixed{}.get_twig_type().empty());
+
+    // Dynamic ids are dense after the engine range, unique and stable across threads
+    TwigID ids[4] = {};
+    std::thread a([&] { ids[0] = Dynamic<0>::get_static_id(); ids[1] = Dynamic<1>::get_static_id(); });
+    std::thread b([&] { ids[2] = Dynamic<2>::get_static_id(); ids[3] = Dynamic<3>::get_static_id(); });
+    a.join();
+    b.join();
+    for (int i = 0; i < 4; ++i) {
+        TEST_ASSERT(ids[i] >= ENGINE_TWIG_SLOTS);
+        TEST_ASSERT(ids[i] < TwigTypeRegistry::get_id_count());
+        for (int j = 0; j < i; ++j) {
+            TEST_ASSERT(ids[i] != ids[j]);
+        }
+    }
+    TEST_ASSERT(Dynamic<2>::get_static_id() == ids[2]);
+
+    // Stores of both kinds resolve through the flat store array
+    auto& world = *World::current_instance();
+    auto entity = world.create_entity();
+    Fixed fixed;
+    fixed.value = 4;
+    world.attach_twig(entity, fixed);
+    world.attach_twig(entity, Dynamic<3>{});
+    TEST_ASSERT(world.get_twig<Fixed>(entity).value == 4);
+    TEST_ASSERT(world.get_twig<Dynamic<3>>(entity).value == 3);
+    TEST_ASSERT(!world.has_twig<Dynamic<1>>(entity));
+    TEST_ASSERT(world.get_twig_storage<Dynamic<0>>() == nullptr);
+
+    return EXIT_SUCCESS;
+}
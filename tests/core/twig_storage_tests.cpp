@@ -0,0 +1,45 @@
+#include "core/data-struct/twig-storage.hpp"
+#include "tests/test_macros.hpp"
+
+int main()
+{
+    using namespace mango::core;
+
+    TwigStorage<int> storage;
+    Entity a{};
+    a.set_index(1);
+    Entity b{};
+    b.set_index(5000);
+    Entity c{};
+    c.set_index(7);
+
+    TEST_ASSERT(storage.insert(a, 10));
+    TEST_ASSERT(storage.insert(b, 20));
+    TEST_ASSERT(storage.insert(c, 30));
+    TEST_ASSERT(!storage.insert(b, 21));
+    TEST_ASSERT(storage.size() == 3);
+    TEST_ASSERT(*storage.get(b) == 21);
+
+    // Swap-and-pop keeps the remaining twigs packed and addressable.
+    storage.remove(a);
+    TEST_ASSERT(storage.size() == 2);
+    TEST_ASSERT(!storage.has(a));
+    TEST_ASSERT(*storage.get(b) == 21);
+    TEST_ASSERT(*storage.get(c) == 30);
+
+    int sum = 0;
+    for (auto [entity, value] : storage) {
+        TEST_ASSERT(storage.has(entity));
+        sum += value;
+    }
+    TEST_ASSERT(sum == 51);
+
+    // A recycled index with a newer generation does not alias the old twig.
+    Entity c_next = c;
+    c_next.set_generation(1);
+    TEST_ASSERT(!storage.has(c_next));
+    TEST_ASSERT(storage.insert(c_next, 40));
+    TEST_ASSERT(!storage.has(c));
+    TEST_ASSERT(storage.size() == 2);
+    return 0;
+}
@@ -0,0 +1,84 @@
+#include "core/thread/worker-pool.hpp"
+#include "tests/test_macros.hpp"
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+int main()
+{
+    using namespace mango::core;
+
+    // The constructing thread holds external slot 0; workers come after the external slots
+    Worker_Pool pool(4, 3);
+    TEST_ASSERT(pool.get_thread_count() == 7);
+    TEST_ASSERT(pool.current_thread_index() == 0);
+
+    // Two outside threads call parallel_for at once. Every fn call marks its thread index
+    // busy, so two threads handed the same index at the same time show up as an overlap.
+    std::vector<std::atomic<int>> busy(pool.get_thread_count());
+    std::atomic<int> overlaps{0};
+    std::atomic<int> out_of_range{0};
+    std::atomic<std::size_t> covered{0};
+    auto work = [&](std::size_t begin, std::size_t end, std::uint32_t thread_index) {
+        if (thread_index >= busy.size()) {
+            out_of_range.fetch_add(1);
+            return;
+        }
+        if (busy[thread_index].fetch_add(1) != 0) {
+            overlaps.fetch_add(1);
+        }
+        volatile std::size_t sink = 0;
+        for (auto i = begin; i < end; ++i) {
+            for (int k = 0; k < 200; ++k) {
+                sink = sink + i * k;
+            }
+        }
+        covered.fetch_add(end - begin);
+        busy[thread_index].fetch_sub(1);
+    };
+
+    constexpr int ROUNDS = 50;
+    constexpr std::size_t COUNT = 4000;
+    std::uint32_t slots[2] = {};
+    auto outside = [&](int which, bool explicit_registration) {
+        if (explicit_registration) {
+            pool.register_external_thread();
+        }
+        slots[which] = pool.current_thread_index();
+        for (int round = 0; round < ROUNDS; ++round) {
+            pool.parallel_for(COUNT, 16, work);
+        }
+        pool.unregister_external_thread();
+    };
+    std::thread first(outside, 0, true);
+    std::thread second(outside, 1, false);
+    first.join();
+    second.join();
+
+    TEST_ASSERT(overlaps.load() == 0 && out_of_range.load() == 0);
+    TEST_ASSERT(covered.load() == 2 * ROUNDS * COUNT);
+    TEST_ASSERT(slots[0] != slots[1] && slots[0] != 0 && slots[1] != 0);
+    TEST_ASSERT(slots[0] < pool.get_external_slot_count() && slots[1] < pool.get_external_slot_count());
+
+    // Unregistered slots are reused; running out of slots is reported
+    std::vector<std::uint32_t> taken(2);
+    std::thread a([&] { taken[0] = pool.register_external_thread(); });
+    a.join();
+    std::thread b([&] { taken[1] = pool.register_external_thread(); });
+    b.join();
+    TEST_ASSERT(taken[0] != 0 && taken[1] != 0 && taken[0] != taken[1]);
+    bool full = false;
+    std::thread c([&] {
+        try {
+            pool.register_external_thread();
+        }
+        catch (const std::runtime_error&) {
+            full = true;
+        }
+    });
+    c.join();
+    TEST_ASSERT(full);
+
+    return EXIT_SUCCESS;
+}
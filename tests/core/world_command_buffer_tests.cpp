@@ -0,0 +1,88 @@
+#include "core/manager/world-command-buffer.hpp"
+#include "tests/test_macros.hpp"
+#include <algorithm>
+
+namespace
+{
+    struct Health : mango::core::Twig<Health> { int value = 0; };
+    struct Spawned : mango::core::Twig<Spawned> { std::uint32_t source = 0; };
+}
+
+int main()
+{
+    using namespace mango::core;
+    auto& world = *World::current_instance();
+
+    std::vector<Entity> entities;
+    for (int i = 0; i < 1000; ++i) {
+        auto entity = world.create_entity();
+        Health health;
+        health.value = i % 2 == 0 ? 0 : 10;
+        world.attach_twig(entity, health);
+        entities.push_back(entity);
+    }
+
+    // Recycled indices are reserved before fresh ones
+    world.destroy_entity(entities.back());
+    entities.pop_back();
+
+    // Dead entities spawn a marker and are destroyed, all from pool threads
+    World_Command_Buffer commands(world);
+    world.par_each<Read<Health>>([&](Entity entity, const Health& health) {
+        if (health.value > 0) {
+            return;
+        }
+        auto spawned = commands.create_entity();
+        Spawned marker;
+        marker.source = entity.get_index();
+        commands.attach_twig(spawned, marker);
+        commands.destroy_entity(entity);
+    }, 16);
+
+    TEST_ASSERT(!commands.empty());
+    TEST_ASSERT(world.get_entities_count() == 999);
+
+    commands.playback();
+    TEST_ASSERT(commands.empty());
+    TEST_ASSERT(world.get_entities_count() == 999);
+
+    int spawned_count = 0;
+    int bad_sources = 0;
+    world.view<Spawned>().each([&](Entity entity, Spawned& marker) {
+        ++spawned_count;
+        bad_sources += marker.source % 2 != 0 ? 1 : 0;
+        bad_sources += world.has_twig<Health>(entity) ? 1 : 0;
+    });
+    TEST_ASSERT(spawned_count == 500);
+    TEST_ASSERT(bad_sources == 0);
+    TEST_ASSERT(world.view<Health>().size() == 499);
+
+    // Keyed on the visited entity, conflicting commands from every chunk play back in key
+    // order whichever thread recorded them: the highest index attaches last and wins
+    auto target = entities[3];
+    std::uint32_t highest = 0;
+    world.view<Health>().each([&](Entity entity, Health&) {
+        highest = std::max(highest, entity.get_index());
+    });
+    for (int run = 0; run < 4; ++run) {
+        world.par_each<Read<Health>>([&](Entity entity, const Health&) {
+            commands.set_sort_key(entity.get_index());
+            Spawned marker;
+            marker.source = entity.get_index();
+            commands.detach_twig<Spawned>(target);
+            commands.attach_twig(target, marker);
+        }, 8);
+        commands.playback();
+        TEST_ASSERT(world.get_twig<Spawned>(target).source == highest);
+    }
+
+    // Destroying twice and attaching to a dead handle are skipped at playback
+    auto victim = entities[1];
+    commands.destroy_entity(victim);
+    commands.destroy_entity(victim);
+    commands.attach_twig(victim, Spawned{});
+    commands.playback();
+    TEST_ASSERT(!world.is_entity_valid(victim));
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,70 @@
+#include "core/manager/world.hpp"
+#include "tests/test_macros.hpp"
+
+namespace
+{
+    struct Position : mango::core::Twig<Position> { int value = 0; };
+    struct Velocity : mango::core::Twig<Velocity> { int value = 0; };
+    struct Frozen : mango::core::Twig<Frozen> {};
+}
+
+int main()
+{
+    using namespace mango::core;
+    auto& world = *World::current_instance();
+
+    for (int i = 0; i < 8; ++i) {
+        auto entity = world.create_entity();
+        Position position;
+        position.value = i;
+        world.attach_twig(entity, position);
+        if (i % 2 == 0) {
+            world.attach_twig(entity, Velocity{});
+        }
+        if (i == 4) {
+            world.attach_twig(entity, Frozen{});
+        }
+    }
+
+    int matched = 0;
+    world.view<Position, Velocity>().each([&](Entity, Position& position, Velocity& velocity) {
+        velocity.value = position.value * 10;
+        ++matched;
+    });
+    TEST_ASSERT(matched == 4);
+
+    int moving = 0;
+    int mismatched = 0;
+    world.view<Velocity, Position>(exclude<Frozen>).each([&](Velocity& velocity, Position& position) {
+        mismatched += velocity.value != position.value * 10 ? 1 : 0;
+        ++moving;
+    });
+    TEST_ASSERT(moving == 3);
+    TEST_ASSERT(mismatched == 0);
+
+    // Structural changes invalidate the cached match list.
+    auto extra = world.create_entity();
+    world.attach_twig(extra, Position{});
+    world.attach_twig(extra, Velocity{});
+    TEST_ASSERT((world.view<Position, Velocity>().size() == 5));
+    world.detach_twig<Velocity>(extra);
+    TEST_ASSERT((world.view<Position, Velocity>().size() == 4));
+    TEST_ASSERT(world.view<Position>(exclude<Velocity>).size() == 5);
+
+    // A view kept across clear_all sees the emptied world, then what is added after it
+    auto kept = world.view<Position, Velocity>();
+    TEST_ASSERT(kept.size() == 4);
+    world.clear_all();
+    TEST_ASSERT(kept.size() == 0);
+    auto fresh = world.create_entity();
+    world.attach_twig(fresh, Position{});
+    world.attach_twig(fresh, Velocity{});
+    int kept_rows = 0;
+    kept.each([&](Entity entity, Position&, Velocity&) {
+        kept_rows += entity == fresh ? 1 : 0;
+    });
+    TEST_ASSERT(kept_rows == 1);
+
+    World::destroy_instance();
+    return 0;
+}
@@ -0,0 +1,129 @@
+#include "app/render_core/draw_list.hpp"
+#include "app/render_core/instance_batcher.hpp"
+#include "core/resource/mesh.hpp"
+#include "tests/test_macros.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace
+{
+    // Sorts like Radix_Sorter through std::stable_sort and compares
+    auto sorts_like_stable_sort(std::vector<uint64_t> keys) -> bool
+    {
+        std::vector<std::pair<uint64_t, uint32_t>> expected;
+        std::vector<uint32_t> values(keys.size());
+        for (uint32_t i = 0; i < keys.size(); ++i) {
+            values[i] = i;
+            expected.push_back({ keys[i], i });
+        }
+        std::stable_sort(expected.begin(), expected.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+        mango::app::Radix_Sorter sorter;
+        sorter.sort(keys, values);
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            if (keys[i] != expected[i].first || values[i] != expected[i].second) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+int main()
+{
+    using namespace mango;
+
+    // Many chunks, many duplicates, digits spread over the whole key
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+    auto next = [&] {
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        return state;
+    };
+    std::vector<uint64_t> keys(200000);
+    for (auto& key : keys) {
+        key = (next() & 0xC3000000FFF00000ull) | (next() >> 60);
+    }
+    TEST_ASSERT(sorts_like_stable_sort(keys));
+    TEST_ASSERT(sorts_like_stable_sort({ 5, 1, 5, 0, 1ull << 63, 3 }));
+    TEST_ASSERT(sorts_like_stable_sort({ 7, 7, 7 }));
+    TEST_ASSERT(sorts_like_stable_sort({}));
+
+    // Keys: opaque before transparent, opaque front to back, transparent back to front
+    using app::Draw_Key;
+    using app::Draw_Pass;
+    auto near_opaque = Draw_Key::make(Draw_Pass::opaque, 0, 3, 1.0f);
+    auto far_opaque = Draw_Key::make(Draw_Pass::opaque, 0, 3, 10.0f);
+    auto near_transparent = Draw_Key::make(Draw_Pass::transparent, 2, 0, 1.0f);
+    auto far_transparent = Draw_Key::make(Draw_Pass::transparent, 2, 0, 10.0f);
+    TEST_ASSERT(near_opaque < far_opaque && far_opaque < far_transparent && far_transparent < near_transparent);
+    TEST_ASSERT(Draw_Key::pass(near_transparent) == Draw_Pass::transparent && Draw_Key::pipeline(near_transparent) == 2);
+    TEST_ASSERT(Draw_Key::pass(far_opaque) == Draw_Pass::opaque && Draw_Key::pipeline(far_opaque) == 0);
+    TEST_ASSERT(Draw_Key::make(Draw_Pass::opaque, 0, 2, 100.0f) < Draw_Key::make(Draw_Pass::opaque, 0, 3, 0.5f));
+    TEST_ASSERT(Draw_Key::depth_bits(-1.0f) == 0 && Draw_Key::depth_bits(0.25f) < Draw_Key::depth_bits(0.5f));
+
+    // Two meshes, material 1 is translucent; the camera looks down -Z
+    auto mesh_a = std::make_shared<resource::Mesh_Data>();
+    auto mesh_b = std::make_shared<resource::Mesh_Data>();
+    struct Row { const resource::Mesh_Data* mesh; float depth; uint32_t material; };
+    std::vector<Row> layout = {
+        { mesh_a.get(), 5.0f, 0 }, { mesh_b.get(), 2.0f, 0 }, { mesh_a.get(), 3.0f, 0 }, { mesh_b.get(), 8.0f, 1 },
+        { mesh_a.get(), 9.0f, 1 }, { mesh_b.get(), 4.0f, 0 }, { mesh_b.get(), 6.0f, 1 },
+    };
+    app::Render_Proxies proxies;
+    for (uint32_t i = 0; i < layout.size(); ++i) {
+        app::Render_Bounds bound;
+        bound.center = math::Vec3(0.0f, 0.0f, -layout[i].depth);
+        bound.extents = math::Vec3(0.5f, 0.5f, 0.5f);
+        bound.radius = 0.9f;
+        math::Mat4 world(1.0f);
+        world[3] = math::Vec4(bound.center, 1.0f);
+        proxies.push(world, layout[i].mesh, layout[i].material, bound, 0u, i);
+    }
+    std::vector<app::Render_Material> materials(2);
+    materials[1].base_color = math::Vec4(1.0f, 1.0f, 1.0f, 0.5f);
+    std::vector<uint32_t> visible = { 0, 1, 2, 3, 4, 5, 6 };
+
+    // Opaque: mesh B (nearest at 2) before A (nearest at 3), front to back inside each;
+    // transparent: back to front whatever the mesh
+    app::Draw_List draws;
+    draws.build(proxies, visible, math::Mat4(1.0f), &materials);
+    TEST_ASSERT((draws.get_rows() == std::vector<uint32_t>{ 1, 5, 2, 0, 4, 3, 6 }));
+    for (std::size_t i = 1; i < draws.get_keys().size(); ++i) {
+        TEST_ASSERT(draws.get_keys()[i - 1] <= draws.get_keys()[i]);
+    }
+
+    // Incoming order switches pipeline 4 times and mesh 6 times in 7 draws;
+    // sorted runs need 2 pipeline binds, 3 mesh binds and 4 draws
+    const auto& before = draws.get_unsorted_stats();
+    const auto& after = draws.get_sorted_stats();
+    TEST_ASSERT(before.draws == 7 && before.pipeline_binds == 4 && before.mesh_binds == 6);
+    TEST_ASSERT(after.draws == 4 && after.pipeline_binds == 2 && after.mesh_binds == 3);
+
+    // Batches follow the sorted runs and never mix passes
+    app::Instance_Batcher batcher;
+    batcher.build_sorted(proxies, draws);
+    const auto& batches = batcher.get_batches();
+    TEST_ASSERT(batches.size() == after.draws);
+    TEST_ASSERT(batches[0].mesh == mesh_b.get() && batches[0].first_instance == 0 && batches[0].instance_count == 2);
+    TEST_ASSERT(batches[1].mesh == mesh_a.get() && batches[1].first_instance == 2 && batches[1].instance_count == 2);
+    TEST_ASSERT(batches[2].mesh == mesh_a.get() && batches[2].instance_count == 1);
+    TEST_ASSERT(Draw_Key::pass(batches[2].key) == Draw_Pass::transparent);
+    TEST_ASSERT(batches[3].mesh == mesh_b.get() && batches[3].first_instance == 5 && batches[3].instance_count == 2);
+    TEST_ASSERT(Draw_Key::pass(batches[1].key) == Draw_Pass::opaque && Draw_Key::pass(batches[3].key) == Draw_Pass::transparent);
+    for (uint32_t i = 0; i < batcher.get_instances().size(); ++i) {
+        TEST_ASSERT(batcher.get_instances()[i].model == proxies.world_matrices[draws.get_rows()[i]]);
+    }
+
+    // Without materials (depth-only passes) everything is opaque: one run per mesh
+    draws.build(proxies, visible, math::Mat4(1.0f), nullptr);
+    TEST_ASSERT((draws.get_rows() == std::vector<uint32_t>{ 1, 5, 6, 3, 2, 0, 4 }));
+    TEST_ASSERT(draws.get_sorted_stats().draws == 2 && draws.get_sorted_stats().pipeline_binds == 1);
+
+    draws.build(proxies, {}, math::Mat4(1.0f), &materials);
+    TEST_ASSERT(draws.get_rows().empty() && draws.get_sorted_stats().draws == 0);
+
+    return 0;
+}
@@ -0,0 +1,87 @@
+#include "app/render_core/frustum_culler.hpp"
+#include "tests/test_macros.hpp"
+#include <cstdint>
+#include <vector>
+
+int main()
+{
+    using namespace mango;
+
+    auto box = [](float x, float y, float z, float half) {
+        app::Render_Bounds bound;
+        bound.center = math::Vec3(x, y, z);
+        bound.extents = math::Vec3(half, half, half);
+        bound.radius = half * 1.7320508f;
+        return bound;
+    };
+
+    // Camera at the origin looking down -Z, 90 degree fov, depth 0.1..100, Vulkan Y flip
+    auto proj = math::perspective(1.5707964f, 1.0f, 0.1f, 100.0f);
+    proj[1][1] *= -1.0f;
+    auto view = math::look_at(math::Vec3(0.0f, 0.0f, 0.0f), math::Vec3(0.0f, 0.0f, -1.0f), math::Vec3(0.0f, 1.0f, 0.0f));
+
+    app::Render_Proxies proxies;
+    auto add = [&](const app::Render_Bounds& bound, uint32_t flag) {
+        proxies.push(math::Mat4(1.0f), nullptr, 0, bound, flag, proxies.size());
+    };
+    add(box(0.0f, 0.0f, -10.0f, 1.0f), app::RENDER_PROXY_CASTS_SHADOW);     // 0 straight ahead
+    add(box(0.0f, 0.0f, 10.0f, 1.0f), 0);                                   // 1 behind
+    add(box(-30.0f, 0.0f, -10.0f, 1.0f), 0);                                // 2 far left
+    add(box(0.0f, 30.0f, -10.0f, 1.0f), 0);                                 // 3 far above
+    add(box(0.0f, 0.0f, -200.0f, 1.0f), 0);                                 // 4 past the far plane
+    add(box(-10.5f, 0.0f, -10.0f, 1.0f), app::RENDER_PROXY_CASTS_SHADOW);   // 5 straddles the left plane
+    add(box(0.0f, -9.0f, -10.0f, 1.0f), 0);                                 // 6 near the bottom edge, inside
+    add(box(0.0f, 0.0f, 0.5f, 1.0f), 0);                                    // 7 crosses the near plane
+    add(box(0.0f, 0.0f, -99.5f, 1.0f), 0);                                  // 8 crosses the far plane
+
+    app::Render_View camera;
+    camera.frustum = app::Frustum::from_view_proj(proj * view);
+    app::Frustum_Culler::cull(proxies, camera, app::Cull_Path::scalar);
+    TEST_ASSERT((camera.visible == std::vector<uint32_t>{ 0, 5, 6, 7, 8 }));
+    TEST_ASSERT(camera.stats.tested == 9);
+    TEST_ASSERT(camera.stats.visible == 5);
+    TEST_ASSERT(camera.stats.culled == 4);
+
+    // Flag filter, as used for shadow casters
+    app::Render_View casters = camera;
+    casters.required_flags = app::RENDER_PROXY_CASTS_SHADOW;
+    app::Frustum_Culler::cull(proxies, casters);
+    TEST_ASSERT((casters.visible == std::vector<uint32_t>{ 0, 5 }));
+
+    // A default frustum keeps everything
+    app::Render_View everything;
+    app::Frustum_Culler::cull(proxies, everything);
+    TEST_ASSERT(everything.stats.visible == 9 && everything.stats.culled == 0);
+
+    TEST_ASSERT(app::Frustum_Culler::is_available(app::Cull_Path::scalar));
+    TEST_ASSERT(app::Frustum_Culler::is_available(app::Frustum_Culler::get_best_path()));
+
+    // Every compiled path agrees with the scalar loop, tails included
+    uint32_t seed = 12345;
+    auto random = [&](float low, float high) {
+        seed = seed * 1664525u + 1013904223u;
+        return low + (high - low) * static_cast<float>(seed >> 8) / static_cast<float>(1u << 24);
+    };
+    app::Render_Proxies scattered;
+    for (uint32_t i = 0; i < 1003; ++i) {
+        scattered.push(math::Mat4(1.0f), nullptr, 0, box(random(-60.0f, 60.0f), random(-60.0f, 60.0f), random(-120.0f, 20.0f), random(0.1f, 4.0f)),
+                       i % 3 == 0 ? app::RENDER_PROXY_CASTS_SHADOW : 0u, i);
+    }
+    for (auto flags : { 0u, static_cast<uint32_t>(app::RENDER_PROXY_CASTS_SHADOW) }) {
+        app::Render_View reference;
+        reference.frustum = camera.frustum;
+        reference.required_flags = flags;
+        app::Frustum_Culler::cull(scattered, reference, app::Cull_Path::scalar);
+        TEST_ASSERT(reference.stats.visible > 0 && reference.stats.culled > 0);
+
+        for (auto path : { app::Cull_Path::sse, app::Cull_Path::avx2 }) {
+            app::Render_View batched = reference;
+            batched.visible.clear();
+            app::Frustum_Culler::cull(scattered, batched, path);
+            TEST_ASSERT(batched.visible == reference.visible);
+            TEST_ASSERT(batched.stats.culled == reference.stats.culled);
+        }
+    }
+
+    return 0;
+}
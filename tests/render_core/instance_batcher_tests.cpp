@@ -0,0 +1,73 @@
+#include "app/render_core/instance_batcher.hpp"
+#include "core/resource/mesh.hpp"
+#include "tests/test_macros.hpp"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+int main()
+{
+    using namespace mango;
+
+    auto tree = std::make_shared<resource::Mesh_Data>();
+    auto rock = std::make_shared<resource::Mesh_Data>();
+    auto house = std::make_shared<resource::Mesh_Data>();
+
+    // A forest of repeated props with a few unique meshes mixed in
+    app::Render_Proxies proxies;
+    std::vector<const resource::Mesh_Data*> pattern = { tree.get(), rock.get(), tree.get(), house.get(), tree.get(), rock.get() };
+    for (uint32_t i = 0; i < 600; ++i) {
+        math::Mat4 world(1.0f);
+        world[3] = math::Vec4(static_cast<float>(i), 0.0f, 0.0f, 1.0f);
+        app::Render_Bounds bound;
+        bound.center = math::Vec3(static_cast<float>(i), 0.0f, 0.0f);
+        bound.extents = math::Vec3(0.5f, 1.0f, 0.5f);
+        bound.radius = 1.3f;
+        proxies.push(world, pattern[i % pattern.size()], i % 7, bound, i % 2 == 0 ? app::RENDER_PROXY_CASTS_SHADOW : 0u, i);
+    }
+
+    std::vector<uint32_t> visible;
+    for (uint32_t row = 0; row < proxies.size(); row += 3) {
+        visible.push_back(row);
+    }
+
+    app::Instance_Batcher batcher;
+    batcher.build(proxies, visible);
+    const auto& batches = batcher.get_batches();
+    const auto& instances = batcher.get_instances();
+    const auto& rows = batcher.get_rows();
+
+    // Rows 0, 3, 6, ... hit tree and house only; one batch each, in first-appearance order
+    TEST_ASSERT(batches.size() == 2);
+    TEST_ASSERT(batches[0].mesh == tree.get() && batches[1].mesh == house.get());
+    TEST_ASSERT(batches[0].first_instance == 0 && batches[0].instance_count == 100);
+    TEST_ASSERT(batches[1].first_instance == 100 && batches[1].instance_count == 100);
+    TEST_ASSERT(instances.size() == visible.size() && rows.size() == visible.size());
+
+    // Every instance carries its row's data, rows stay ascending inside a batch
+    for (const auto& batch : batches) {
+        for (uint32_t i = batch.first_instance; i < batch.first_instance + batch.instance_count; ++i) {
+            auto row = rows[i];
+            TEST_ASSERT(proxies.meshes[row] == batch.mesh);
+            TEST_ASSERT(instances[i].model == proxies.world_matrices[row]);
+            TEST_ASSERT(instances[i].material == proxies.material_indices[row]);
+            TEST_ASSERT(instances[i].flags == proxies.flags[row]);
+            TEST_ASSERT(instances[i].center_radius.x == static_cast<float>(row) && instances[i].center_radius.w == 1.3f);
+            TEST_ASSERT(instances[i].extents.y == 1.0f && instances[i].mesh == 0);
+            TEST_ASSERT(i == batch.first_instance || rows[i - 1] < row);
+        }
+    }
+
+    // Rebuilding with another list replaces the previous result
+    visible = { 5, 1, 2 };
+    batcher.build(proxies, visible);
+    TEST_ASSERT(batcher.get_batches().size() == 2);
+    TEST_ASSERT(batcher.get_batches()[0].mesh == rock.get() && batcher.get_batches()[0].instance_count == 2);
+    TEST_ASSERT(batcher.get_batches()[1].mesh == tree.get() && batcher.get_batches()[1].first_instance == 2);
+    TEST_ASSERT((batcher.get_rows() == std::vector<uint32_t>{ 5, 1, 2 }));
+
+    batcher.build(proxies, {});
+    TEST_ASSERT(batcher.get_batches().empty() && batcher.get_instances().empty());
+
+    return 0;
+}
@@ -0,0 +1,135 @@
+#include "app/render_core/draw_list.hpp"
+#include "app/render_core/instance_batcher.hpp"
+#include "app/render_core/lod_selector.hpp"
+#include "core/resource/mesh.hpp"
+#include "tests/test_macros.hpp"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace
+{
+    using namespace mango;
+
+    // 100 triangles with two coarser levels of 50 and 20
+    auto make_lod_mesh() -> std::shared_ptr<resource::Mesh_Data>
+    {
+        auto mesh = std::make_shared<resource::Mesh_Data>();
+        mesh->vertices.resize(3);
+        mesh->indices.assign(300, 0);
+        mesh->lod_indices.assign(210, 0);
+        mesh->lods = { { 0, 300, 0.0f }, { 300, 150, 0.01f }, { 450, 60, 0.05f } };
+        return mesh;
+    }
+
+    // One proxy whose bounding sphere (radius 0.5) starts `distance` in front of a camera
+    // looking down -Z from the origin
+    auto place(app::Render_Proxies& proxies, std::size_t row, float distance, float scale = 1.0f) -> void
+    {
+        app::Render_Bounds bound;
+        bound.center = math::Vec3(0.0f, 0.0f, -(distance + 0.5f));
+        bound.extents = math::Vec3(0.3f, 0.3f, 0.3f);
+        bound.radius = 0.5f;
+        math::Mat4 world(scale);
+        world[3] = math::Vec4(bound.center, 1.0f);
+        proxies.assign(row, world, proxies.meshes[row], 0u, bound, 0u, proxies.entity_ids[row]);
+    }
+}
+
+int main()
+{
+    using namespace mango;
+
+    auto mesh = make_lod_mesh();
+    app::Render_Proxies proxies;
+    proxies.push(math::Mat4(1.0f), mesh.get(), 0u, app::Render_Bounds{}, 0u, 7u);
+    std::vector<uint32_t> visible = { 0 };
+    const math::Mat4 view(1.0f);
+    const float pixels_per_unit = 500.0f;      // an error of e at distance d covers 500 * e / d pixels
+
+    // 10 units away LOD 1 is 0.5 px and LOD 2 is 2.5 px; 100 units away LOD 2 is 0.25 px
+    app::Lod_Selector selector;
+    place(proxies, 0, 10.0f);
+    selector.select(proxies, visible, view, pixels_per_unit);
+    TEST_ASSERT(selector.get_lods()[0] == 1);
+    TEST_ASSERT(selector.get_stats().triangles == 50 && selector.get_stats().full_triangles == 100);
+    TEST_ASSERT(selector.get_stats().reduced == 1);
+
+    // At 30 units LOD 2 is 0.83 px: within the limit, but not by the hysteresis margin
+    place(proxies, 0, 30.0f);
+    selector.select(proxies, visible, view, pixels_per_unit);
+    TEST_ASSERT(selector.get_lods()[0] == 1);
+    app::Lod_Selector fresh;
+    fresh.select(proxies, visible, view, pixels_per_unit);
+    TEST_ASSERT(fresh.get_lods()[0] == 2);
+
+    // At 80 units (0.31 px) it coarsens, and stays coarse when coming back to 30
+    place(proxies, 0, 80.0f);
+    selector.select(proxies, visible, view, pixels_per_unit);
+    TEST_ASSERT(selector.get_lods()[0] == 2 && selector.get_stats().triangles == 20);
+    place(proxies, 0, 30.0f);
+    selector.select(proxies, visible, view, pixels_per_unit);
+    TEST_ASSERT(selector.get_lods()[0] == 2);
+
+    // Refining does not wait: at 20 units LOD 2 is 1.25 px
+    place(proxies, 0, 20.0f);
+    selector.select(proxies, visible, view, pixels_per_unit);
+    TEST_ASSERT(selector.get_lods()[0] == 1);
+
+    // The world scale grows the error; a camera inside the bounds gets full detail
+    place(proxies, 0, 30.0f, 2.0f);
+    fresh.select(proxies, visible, view, pixels_per_unit);
+    TEST_ASSERT(fresh.get_lods()[0] == 1);
+    place(proxies, 0, -0.25f);
+    fresh.select(proxies, visible, view, pixels_per_unit);
+    TEST_ASSERT(fresh.get_lods()[0] == 0 && fresh.get_stats().reduced == 0);
+
+    // A different entity in the row starts without history
+    place(proxies, 0, 30.0f);
+    proxies.entity_ids[0] = 8;
+    selector.select(proxies, visible, view, pixels_per_unit);
+    TEST_ASSERT(selector.get_lods()[0] == 2);
+    place(proxies, 0, 20.0f);
+    selector.select(proxies, visible, view, pixels_per_unit);
+    TEST_ASSERT(selector.get_lods()[0] == 1);
+
+    // Meshes without LODs always draw LOD 0 and count in full
+    place(proxies, 0, 30.0f);
+    auto plain = std::make_shared<resource::Mesh_Data>();
+    plain->vertices.resize(6);
+    proxies.push(math::Mat4(1.0f), plain.get(), 0u, app::Render_Bounds{}, 0u, 10u);
+    place(proxies, 1, 500.0f);
+    selector.select(proxies, { 0, 1 }, view, pixels_per_unit);
+    TEST_ASSERT(selector.get_lods()[1] == 0);
+    TEST_ASSERT(selector.get_stats().full_triangles == 102 && selector.get_stats().triangles == 52);
+
+    // LODs of one mesh sort next to each other and draw separately from one mesh bind
+    proxies.push(math::Mat4(1.0f), mesh.get(), 0u, app::Render_Bounds{}, 0u, 11u);
+    place(proxies, 0, 4.0f);
+    place(proxies, 1, 6.0f);
+    place(proxies, 2, 200.0f);
+    std::vector<uint32_t> rows = { 0, 1, 2 };
+    app::Lod_Selector lods;
+    lods.select(proxies, rows, view, pixels_per_unit);
+    TEST_ASSERT(lods.get_lods()[0] == 0 && lods.get_lods()[2] == 2);
+
+    app::Draw_List draws;
+    draws.build(proxies, rows, view, nullptr, &lods.get_lods());
+    TEST_ASSERT((draws.get_rows() == std::vector<uint32_t>{ 0, 2, 1 }));
+    TEST_ASSERT((draws.get_lods() == std::vector<uint8_t>{ 0, 2, 0 }));
+    TEST_ASSERT(draws.get_sorted_stats().draws == 3 && draws.get_sorted_stats().mesh_binds == 2);
+
+    app::Instance_Batcher batcher;
+    batcher.build_sorted(proxies, draws);
+    const auto& batches = batcher.get_batches();
+    TEST_ASSERT(batches.size() == 3);
+    TEST_ASSERT(batches[0].mesh == mesh.get() && batches[0].lod == 0 && batches[0].instance_count == 1);
+    TEST_ASSERT(batches[1].mesh == mesh.get() && batches[1].lod == 2 && batches[1].first_instance == 1);
+    TEST_ASSERT(mesh->get_lod(batches[1].lod).first_index == 450 && mesh->get_lod(batches[1].lod).index_count == 60);
+
+    // Without LODs the same rows form one run per mesh
+    draws.build(proxies, rows, view, nullptr);
+    TEST_ASSERT(draws.get_sorted_stats().draws == 2 && (draws.get_lods() == std::vector<uint8_t>{ 0, 0, 0 }));
+
+    return 0;
+}
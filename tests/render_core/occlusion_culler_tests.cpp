@@ -0,0 +1,192 @@
+#include "app/render_core/occlusion_culler.hpp"
+#include "core/resource/mesh.hpp"
+#include "tests/test_macros.hpp"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+int main()
+{
+    using namespace mango;
+
+    auto box = [](float x, float y, float z, float half) {
+        app::Render_Bounds bound;
+        bound.center = math::Vec3(x, y, z);
+        bound.extents = math::Vec3(half, half, half);
+        bound.radius = half * 1.7320508f;
+        return bound;
+    };
+
+    // A two triangle quad facing the camera, half size 1, centered on the origin
+    auto quad = std::make_shared<resource::Mesh_Data>();
+    for (auto [x, y] : { std::pair{ -1.0f, -1.0f }, std::pair{ 1.0f, -1.0f }, std::pair{ 1.0f, 1.0f }, std::pair{ -1.0f, 1.0f } }) {
+        quad->vertices.push_back({ math::Vec3(x, y, 0.0f), math::Vec3(0.0f, 0.0f, 1.0f), math::Vec2(0.0f, 0.0f) });
+    }
+    quad->indices = { 0, 1, 2, 0, 2, 3 };
+    auto wall_at = [](float x, float y, float z, float half) {
+        auto world = math::Mat4(1.0f);
+        world[0][0] = half;
+        world[1][1] = half;
+        world[3] = math::Vec4(x, y, z, 1.0f);
+        return world;
+    };
+
+    // Camera at the origin looking down -Z, Vulkan Y flip
+    auto proj = math::perspective(1.0f, 2.0f, 0.1f, 100.0f);
+    proj[1][1] *= -1.0f;
+    auto view = math::look_at(math::Vec3(0.0f, 0.0f, 0.0f), math::Vec3(0.0f, 0.0f, -1.0f), math::Vec3(0.0f, 1.0f, 0.0f));
+    const auto view_proj = proj * view;
+
+    // A wall 10 wide at z = -10 hides what sits 40 deep within +-20 of the axis
+    app::Render_Proxies proxies;
+    auto add = [&](const math::Mat4& world, const resource::Mesh_Data* mesh, const app::Render_Bounds& bound) {
+        proxies.push(world, mesh, 0, bound, app::RENDER_PROXY_CASTS_SHADOW, proxies.size());
+    };
+    auto wall_bound = box(0.0f, 0.0f, -10.0f, 5.0f);
+    wall_bound.extents.z = 0.0f;
+    add(wall_at(0.0f, 0.0f, -10.0f, 5.0f), quad.get(), wall_bound);     // 0 the wall
+    add(math::Mat4(1.0f), nullptr, box(0.0f, 0.0f, -40.0f, 1.0f));       // 1 right behind it
+    add(math::Mat4(1.0f), nullptr, box(0.0f, 0.0f, -5.0f, 1.0f));        // 2 in front of it
+    add(math::Mat4(1.0f), nullptr, box(30.0f, 0.0f, -40.0f, 1.0f));      // 3 beside it
+    add(math::Mat4(1.0f), nullptr, box(19.5f, 0.0f, -40.0f, 2.0f));      // 4 peeking past its edge
+    add(math::Mat4(1.0f), nullptr, box(0.0f, 0.0f, -10.5f, 0.4f));       // 5 just behind, fully covered
+    add(math::Mat4(1.0f), nullptr, box(0.0f, 0.0f, 0.0f, 1.0f));         // 6 around the eye
+
+    auto all_rows = [&] {
+        app::Render_View view_all;
+        view_all.frustum = app::Frustum::from_view_proj(view_proj);
+        app::Frustum_Culler::cull(proxies, view_all);
+        return view_all;
+    };
+
+    app::Occlusion_Culler culler;
+    {
+        auto camera = all_rows();
+        auto frustum_visible = camera.stats.visible;
+        culler.cull(proxies, view_proj, camera);
+        const auto& stats = culler.get_stats();
+        TEST_ASSERT(stats.occluders == 1 && stats.occluder_triangles == 2);
+        TEST_ASSERT(stats.tested == frustum_visible && stats.occluded == 2);
+        TEST_ASSERT((camera.visible == std::vector<uint32_t>{ 0, 2, 3, 4, 6 }));
+        TEST_ASSERT(camera.stats.visible == 5 && camera.stats.culled == camera.stats.tested - 5);
+        TEST_ASSERT(culler.get_visibility_mask().size() == proxies.size());
+        TEST_ASSERT(culler.is_visible(0) && !culler.is_visible(1) && culler.is_visible(2) && !culler.is_visible(5));
+        TEST_ASSERT(stats.occluder_ms >= 0.0f && stats.occludee_ms >= 0.0f);
+
+        // The wall fills the middle of the buffer and nothing else
+        auto w = culler.get_width();
+        auto h = culler.get_height();
+        TEST_ASSERT(w == 256 && h == 128);
+        TEST_ASSERT(culler.get_depth(w / 2, h / 2) < 1.0f && culler.get_depth(2, 2) == 1.0f);
+    }
+
+    // Occluders below the area threshold or over budget are left out
+    {
+        app::Occlusion_Settings settings;
+        settings.min_occluder_area = 1.5f;     // more than the whole screen
+        app::Occlusion_Culler picky(settings);
+        auto camera = all_rows();
+        picky.cull(proxies, view_proj, camera);
+        TEST_ASSERT(picky.get_stats().occluders == 0 && picky.get_stats().occluded == 0);
+        TEST_ASSERT(camera.stats.visible == picky.get_stats().tested);
+
+        settings = {};
+        settings.triangle_budget = 1;
+        app::Occlusion_Culler tight(settings);
+        camera = all_rows();
+        tight.cull(proxies, view_proj, camera);
+        TEST_ASSERT(tight.get_stats().occluders == 0);
+    }
+
+    // A glass wall hides nothing; without materials it is taken as opaque
+    {
+        std::vector<app::Render_Material> materials(2);
+        materials[1].base_color.w = 0.5f;
+        proxies.material_indices[0] = 1;
+        app::Occlusion_Culler glass;
+        auto camera = all_rows();
+        auto frustum_visible = camera.stats.visible;
+        glass.cull(proxies, view_proj, camera, &materials);
+        TEST_ASSERT(glass.get_stats().occluders == 0 && glass.get_stats().occluded == 0);
+        TEST_ASSERT(camera.stats.visible == frustum_visible && glass.is_visible(1));
+
+        materials[1].base_color.w = 1.0f;
+        camera = all_rows();
+        glass.cull(proxies, view_proj, camera, &materials);
+        TEST_ASSERT(glass.get_stats().occluders == 1 && !glass.is_visible(1));
+
+        materials[1].base_color.w = 0.5f;
+        camera = all_rows();
+        glass.cull(proxies, view_proj, camera);
+        TEST_ASSERT(glass.get_stats().occluders == 1 && !glass.is_visible(1));
+        proxies.material_indices[0] = 0;
+    }
+
+    // A wall cut by the near plane still rasterizes the part in front of the camera
+    {
+        app::Occlusion_Culler single;
+        auto tilted = wall_at(0.0f, 0.0f, -5.0f, 50.0f);
+        tilted[2] = math::Vec4(0.0f, 0.0f, 1.0f, 0.0f);
+        tilted[1] = math::Vec4(0.0f, 0.0f, 50.0f, 0.0f);     // a floor from z = -55 to z = 45, one unit down
+        tilted[3] = math::Vec4(0.0f, -1.0f, -5.0f, 1.0f);
+        single.clear();
+        single.rasterize(*quad, view_proj * tilted);
+        TEST_ASSERT(single.get_depth(single.get_width() / 2, single.get_height() - 1) < 1.0f);
+        TEST_ASSERT(single.get_depth(single.get_width() / 2, 0) == 1.0f);
+        TEST_ASSERT(!single.is_box_visible(box(0.0f, -3.0f, -20.0f, 0.5f), view_proj));
+        TEST_ASSERT(single.is_box_visible(box(0.0f, 2.0f, -20.0f, 0.5f), view_proj));
+    }
+
+    // Every SIMD path agrees with the scalar one on a cluttered scene
+    {
+        uint32_t seed = 99;
+        auto random = [&](float low, float high) {
+            seed = seed * 1664525u + 1013904223u;
+            return low + (high - low) * static_cast<float>(seed >> 8) / static_cast<float>(1u << 24);
+        };
+        app::Render_Proxies clutter;
+        for (uint32_t i = 0; i < 40; ++i) {
+            float x = random(-30.0f, 30.0f);
+            float y = random(-10.0f, 10.0f);
+            float z = random(-60.0f, -5.0f);
+            float half = random(1.0f, 6.0f);
+            auto bound = box(x, y, z, half);
+            bound.extents.z = 0.0f;
+            clutter.push(wall_at(x, y, z, half), quad.get(), 0, bound, 0, i);
+        }
+        for (uint32_t i = 0; i < 4000; ++i) {
+            clutter.push(math::Mat4(1.0f), nullptr, 0, box(random(-40.0f, 40.0f), random(-15.0f, 15.0f), random(-90.0f, -2.0f), random(0.1f, 1.5f)), 0, i);
+        }
+
+        auto run = [&](app::Cull_Path path, std::unique_ptr<app::Occlusion_Culler>& out) {
+            app::Occlusion_Settings settings;
+            settings.path = path;
+            out = std::make_unique<app::Occlusion_Culler>(settings);
+            app::Render_View camera;
+            camera.frustum = app::Frustum::from_view_proj(view_proj);
+            app::Frustum_Culler::cull(clutter, camera);
+            out->cull(clutter, view_proj, camera);
+            return camera.visible;
+        };
+        std::unique_ptr<app::Occlusion_Culler> scalar;
+        auto reference = run(app::Cull_Path::scalar, scalar);
+        TEST_ASSERT(scalar->get_stats().occluders > 0 && scalar->get_stats().occluded > 0);
+        for (auto path : { app::Cull_Path::sse, app::Cull_Path::avx2 }) {
+            if (!app::Frustum_Culler::is_available(path)) {
+                continue;
+            }
+            std::unique_ptr<app::Occlusion_Culler> simd;
+            auto visible = run(path, simd);
+            bool same_depth = true;
+            for (uint32_t y = 0; y < scalar->get_height(); ++y) {
+                for (uint32_t x = 0; x < scalar->get_width(); ++x) {
+                    same_depth &= scalar->get_depth(x, y) == simd->get_depth(x, y);
+                }
+            }
+            TEST_ASSERT(same_depth);
+            TEST_ASSERT(visible == reference);
+        }
+    }
+
+    return 0;
+}
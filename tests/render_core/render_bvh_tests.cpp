@@ -0,0 +1,181 @@
+#include "app/render_core/render_bvh.hpp"
+#include "tests/test_macros.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+int main()
+{
+    using namespace mango;
+
+    uint32_t seed = 777;
+    auto random = [&](float low, float high) {
+        seed = seed * 1664525u + 1013904223u;
+        return low + (high - low) * static_cast<float>(seed >> 8) / static_cast<float>(1u << 24);
+    };
+    auto random_box = [&](float spread) {
+        app::Render_Bounds bound;
+        bound.center = math::Vec3(random(-spread, spread), random(-spread, spread), random(-spread, spread));
+        float half = random(0.1f, 2.0f);
+        bound.extents = math::Vec3(half, half * 0.5f, half);
+        bound.radius = std::sqrt(half * half * 2.25f);
+        return bound;
+    };
+
+    app::Render_Proxies proxies;
+    for (uint32_t i = 0; i < 3000; ++i) {
+        proxies.push(math::Mat4(1.0f), nullptr, 0, random_box(100.0f), i % 4 == 0 ? app::RENDER_PROXY_CASTS_SHADOW : 0u, i);
+    }
+
+    auto proj = math::perspective(1.0f, 1.5f, 0.1f, 150.0f);
+    proj[1][1] *= -1.0f;
+    auto view = math::look_at(math::Vec3(0.0f, 10.0f, 60.0f), math::Vec3(0.0f, 0.0f, 0.0f), math::Vec3(0.0f, 1.0f, 0.0f));
+    const auto frustum = app::Frustum::from_view_proj(proj * view);
+
+    // The tree must return exactly what the linear pass returns, for both kinds of view
+    auto matches_linear = [&](const app::Render_Bvh& bvh, uint32_t required_flags) {
+        app::Render_View linear;
+        linear.frustum = frustum;
+        linear.required_flags = required_flags;
+        app::Frustum_Culler::cull(proxies, linear, app::Cull_Path::scalar);
+
+        app::Render_View tree = linear;
+        tree.visible.clear();
+        bvh.cull(proxies, tree);
+        std::sort(tree.visible.begin(), tree.visible.end());
+        return tree.visible == linear.visible && tree.stats.culled == linear.stats.culled && !linear.visible.empty();
+    };
+
+    // The first sync builds the whole tree
+    app::Render_Bvh bvh;
+    bvh.sync(proxies, {});
+    TEST_ASSERT(bvh.size() == proxies.size());
+    TEST_ASSERT(bvh.get_rebuild_count() == 1);
+    TEST_ASSERT(bvh.validate(proxies));
+    TEST_ASSERT(bvh.get_height() > 0 && bvh.get_height() <= 32);
+    TEST_ASSERT(matches_linear(bvh, 0));
+    TEST_ASSERT(matches_linear(bvh, app::RENDER_PROXY_CASTS_SHADOW));
+
+    // Light volume query against brute force
+    {
+        math::Vec3 center(5.0f, -3.0f, 12.0f);
+        float radius = 25.0f;
+        std::vector<uint32_t> rows;
+        bvh.query_sphere(proxies, center, radius, 0, rows);
+        std::sort(rows.begin(), rows.end());
+        std::vector<uint32_t> expected;
+        for (uint32_t row = 0; row < proxies.size(); ++row) {
+            auto bound = proxies.bounds[row];
+            float distance_sq = 0.0f;
+            for (int axis = 0; axis < 3; ++axis) {
+                float d = std::max(std::abs(center[axis] - bound.center[axis]) - bound.extents[axis], 0.0f);
+                distance_sq += d * d;
+            }
+            if (distance_sq <= radius * radius) {
+                expected.push_back(row);
+            }
+        }
+        TEST_ASSERT(!expected.empty() && rows == expected);
+    }
+
+    // Jitter inside the fat margin touches no links
+    {
+        auto bound = proxies.bounds[10];
+        bound.center.x += bound.extents.x * 0.01f;
+        proxies.bounds.set(10, bound);
+        bvh.sync(proxies, { { 10, 11 } });
+        TEST_ASSERT(bvh.get_last_moved_count() == 0);
+        TEST_ASSERT(bvh.validate(proxies));
+    }
+
+    // A few far moves and a flag change are reinserted
+    {
+        std::vector<app::Render_Range> changed;
+        for (uint32_t row = 100; row < 110; ++row) {
+            proxies.bounds.set(row, random_box(100.0f));
+            changed.push_back({ row, row + 1 });
+        }
+        proxies.flags[200] ^= app::RENDER_PROXY_CASTS_SHADOW;
+        changed.push_back({ 200, 201 });
+        bvh.sync(proxies, changed);
+        TEST_ASSERT(bvh.get_last_moved_count() == 11);
+        TEST_ASSERT(bvh.get_rebuild_count() == 1);
+        TEST_ASSERT(bvh.validate(proxies));
+        TEST_ASSERT(matches_linear(bvh, 0));
+        TEST_ASSERT(matches_linear(bvh, app::RENDER_PROXY_CASTS_SHADOW));
+    }
+
+    // Many small moves are refit in place
+    {
+        for (uint32_t row = 0; row < 600; ++row) {
+            auto bound = proxies.bounds[row];
+            bound.center += math::Vec3(1.0f, 0.5f, -1.0f);
+            proxies.bounds.set(row, bound);
+        }
+        bvh.sync(proxies, { { 0, 600 } });
+        TEST_ASSERT(bvh.get_last_moved_count() > app::Render_Bvh_Settings{}.reinsert_limit);
+        TEST_ASSERT(bvh.validate(proxies));
+        TEST_ASSERT(matches_linear(bvh, 0));
+    }
+
+    // Rows removed from the end and appended
+    {
+        for (int i = 0; i < 50; ++i) {
+            proxies.pop_back();
+        }
+        bvh.sync(proxies, {});
+        TEST_ASSERT(bvh.size() == proxies.size());
+        TEST_ASSERT(bvh.validate(proxies));
+
+        auto first_new = static_cast<uint32_t>(proxies.size());
+        for (uint32_t i = 0; i < 20; ++i) {
+            proxies.push(math::Mat4(1.0f), nullptr, 0, random_box(100.0f), app::RENDER_PROXY_CASTS_SHADOW, 5000 + i);
+        }
+        bvh.sync(proxies, { { first_new, first_new + 20 } });
+        TEST_ASSERT(bvh.size() == proxies.size());
+        TEST_ASSERT(bvh.validate(proxies));
+        TEST_ASSERT(matches_linear(bvh, app::RENDER_PROXY_CASTS_SHADOW));
+    }
+
+    // Once enough of the scene moved the tree is rebuilt from scratch
+    {
+        auto rebuilds = bvh.get_rebuild_count();
+        for (uint32_t row = 0; row < proxies.size(); ++row) {
+            proxies.bounds.set(row, random_box(100.0f));
+        }
+        bvh.sync(proxies, { { 0, static_cast<uint32_t>(proxies.size()) } });
+        TEST_ASSERT(bvh.get_rebuild_count() == rebuilds + 1);
+        TEST_ASSERT(bvh.validate(proxies));
+        TEST_ASSERT(matches_linear(bvh, 0));
+    }
+
+    // Direct per-row use
+    {
+        app::Render_Bvh small;
+        app::Render_Proxies few;
+        for (uint32_t i = 0; i < 8; ++i) {
+            auto bound = random_box(20.0f);
+            few.push(math::Mat4(1.0f), nullptr, 0, bound, 0, i);
+            small.insert(i, bound, 0);
+        }
+        TEST_ASSERT(small.validate(few));
+        auto bound = few.bounds[3];
+        bound.center += math::Vec3(50.0f, 0.0f, 0.0f);
+        few.bounds.set(3, bound);
+        TEST_ASSERT(small.update(3, bound, 0));
+        TEST_ASSERT(!small.update(3, bound, 0));
+        TEST_ASSERT(small.validate(few));
+        small.remove(7);
+        few.pop_back();
+        TEST_ASSERT(small.size() == 7);
+
+        small.clear();
+        TEST_ASSERT(small.size() == 0 && small.get_height() == 0);
+        app::Render_View empty;
+        small.cull(few, empty);
+        TEST_ASSERT(empty.visible.empty() && empty.stats.tested == 0);
+    }
+
+    return 0;
+}
@@ -0,0 +1,136 @@
+#include "app/render_core/render_scene_buffer.hpp"
+#include "core/resource/mesh.hpp"
+#include "tests/test_macros.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+int main()
+{
+    using namespace mango;
+
+    auto mesh = std::make_shared<resource::Mesh_Data>();
+    app::Render_Scene source;
+    source.materials.push_back({});
+    for (int i = 0; i < 4; ++i) {
+        math::Mat4 world(1.0f);
+        world[3][0] = static_cast<float>(i);
+        source.proxies.push(world, mesh.get(), app::Render_Scene::DEFAULT_MATERIAL, {}, 0, static_cast<uint64_t>(i));
+    }
+    source.dirty_proxies = { { 0, 4 } };
+    source.dirty_materials = { { 0, 1 } };
+    source.lights_dirty = true;
+
+    app::Render_Scene_Buffer buffer(2);
+    TEST_ASSERT(buffer.get_slot_count() == 2);
+
+    app::Frame_Context context{};
+    context.frame_index = 1;
+    TEST_ASSERT(buffer.publish(source, context));
+    TEST_ASSERT(buffer.get_last_copied_rows() == 4);
+
+    app::Frame_Context frame{};
+    TEST_ASSERT(buffer.acquire(frame));
+    TEST_ASSERT(frame.frame_index == 1);
+    TEST_ASSERT(frame.scene && frame.scene->proxies.size() == 4);
+    const auto* first = frame.scene;
+
+    // The snapshot pins its meshes
+    std::weak_ptr<resource::Mesh_Data> watch = mesh;
+    mesh.reset();
+    TEST_ASSERT(!watch.expired());
+
+    // While frame 1 is recorded, frame 2 goes to the other slot and leaves the first alone
+    source.proxies.world_matrices[2][3][0] = 20.0f;
+    source.dirty_proxies = { { 2, 3 } };
+    source.dirty_materials.clear();
+    source.lights_dirty = false;
+    context.frame_index = 2;
+    TEST_ASSERT(buffer.publish(source, context));
+    TEST_ASSERT(buffer.get_last_copied_rows() == 4);       // first write of that slot
+    TEST_ASSERT(first->proxies.world_matrices[2][3][0] == 2.0f);
+    buffer.release();
+
+    TEST_ASSERT(buffer.acquire(frame));
+    TEST_ASSERT(frame.frame_index == 2);
+    TEST_ASSERT(frame.scene != first);
+    TEST_ASSERT(frame.scene->proxies.world_matrices[2][3][0] == 20.0f);
+
+    // Frame 3 reuses the first slot, which catches up on frame 2's row and its own
+    source.proxies.world_matrices[0][3][0] = 30.0f;
+    source.dirty_proxies = { { 0, 1 } };
+    context.frame_index = 3;
+    TEST_ASSERT(buffer.publish(source, context));
+    TEST_ASSERT(buffer.get_last_copied_rows() == 2);
+    buffer.release();
+
+    TEST_ASSERT(buffer.acquire(frame));
+    TEST_ASSERT(frame.frame_index == 3);
+    TEST_ASSERT(frame.scene == first);
+    TEST_ASSERT(frame.scene->proxies.world_matrices[0][3][0] == 30.0f);
+    TEST_ASSERT(frame.scene->proxies.world_matrices[2][3][0] == 20.0f);
+    TEST_ASSERT(frame.scene->dirty_proxies.size() == 2);
+    TEST_ASSERT(frame.changed_proxies && frame.changed_proxies->size() == 1);
+    TEST_ASSERT(frame.changed_proxies->front().begin == 0 && frame.changed_proxies->front().end == 1);
+    TEST_ASSERT(!frame.scene->lights_dirty);
+    buffer.release();
+
+    // Removed rows are dropped along with their mesh references
+    source.proxies.pop_back();
+    source.dirty_proxies.clear();
+    context.frame_index = 4;
+    TEST_ASSERT(buffer.publish(source, context));
+    TEST_ASSERT(buffer.acquire(frame));
+    TEST_ASSERT(frame.scene->proxies.size() == 3);
+    TEST_ASSERT(frame.scene->proxies.world_matrices[0][3][0] == 30.0f);
+    buffer.release();
+
+    // Pipelined: one producer, one consumer, every frame seen once and in order
+    constexpr uint64_t FRAMES = 2000;
+    constexpr uint32_t ROWS = 64;
+    auto shared_mesh = std::make_shared<resource::Mesh_Data>();
+    app::Render_Scene live;
+    for (uint32_t i = 0; i < ROWS; ++i) {
+        live.proxies.push(math::Mat4(1.0f), shared_mesh.get(), 0, {}, 0, i);
+    }
+
+    app::Render_Scene_Buffer pipe(3);
+    std::atomic<uint64_t> consumed{0};
+    std::atomic<bool> consistent{true};
+    std::thread render_thread([&] {
+        app::Frame_Context rendered{};
+        uint64_t expected = 1;
+        while (pipe.acquire(rendered)) {
+            const auto& scene = *rendered.scene;
+            auto row = rendered.frame_index % ROWS;
+            if (rendered.frame_index != expected++ || scene.proxies.world_matrices[row][3][0] != static_cast<float>(rendered.frame_index)) {
+                consistent = false;
+            }
+            for (uint32_t r = 0; r < ROWS; ++r) {
+                auto value = static_cast<uint64_t>(scene.proxies.world_matrices[r][3][0]);
+                if (value > rendered.frame_index || (value != 0 && value % ROWS != r)) {
+                    consistent = false;
+                }
+            }
+            consumed.fetch_add(1);
+            pipe.release();
+        }
+    });
+
+    for (uint64_t f = 1; f <= FRAMES; ++f) {
+        auto row = static_cast<uint32_t>(f % ROWS);
+        live.proxies.world_matrices[row][3][0] = static_cast<float>(f);
+        live.dirty_proxies = { { row, row + 1 } };
+        app::Frame_Context published{};
+        published.frame_index = f;
+        pipe.publish(live, published);
+    }
+    pipe.close();
+    render_thread.join();
+
+    TEST_ASSERT(consumed.load() == FRAMES);
+    TEST_ASSERT(consistent.load());
+    TEST_ASSERT(!pipe.publish(live, context));
+    return 0;
+}
@@ -1,18 +1,161 @@
 #include "app/render_core/render_scene_extractor.hpp"
 #include "core/manager/world.hpp"
 #include "core/manager/scene-graph.hpp"
+#include "core/manager/transform-propagation.hpp"
+#include "core/resource/light.hpp"
+#include "core/resource/material.hpp"
+#include "core/resource/mesh.hpp"
+#include "core/resource/transform.hpp"
 #include "tests/test_macros.hpp"
+#include <cmath>
 
 int main()
 {
-    auto& world = *mango::core::World::current_instance();
-    auto& graph = *mango::core::Scene_Graph::current_instance();
+    using namespace mango;
+    auto& world = *core::World::current_instance();
+    auto& graph = *core::Scene_Graph::current_instance();
 
-    const auto scene = mango::app::Render_Scene_Extractor::extract(world, graph);
-    TEST_ASSERT(scene.mesh_instances.empty());
-    TEST_ASSERT(scene.point_lights.empty());
+    app::Render_Scene_Extractor extractor;
+    extractor.extract(world);
+    const auto& empty = extractor.get_scene();
+    TEST_ASSERT(empty.proxies.empty());
+    TEST_ASSERT(empty.lights.empty());
+    TEST_ASSERT(empty.materials.size() == 1);     // the default material
+    TEST_ASSERT(!empty.camera.valid);
+    TEST_ASSERT(empty.dirty_proxies.empty());
 
-    mango::core::Scene_Graph::destroy_instance();
-    mango::core::World::destroy_instance();
+    resource::Mesh mesh;
+    mesh.set_vertices({
+        { { -1.0f, 0.0f, -1.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f } },
+        { {  1.0f, 2.0f,  1.0f }, { 0.0f, 1.0f, 0.0f }, { 1.0f, 1.0f } },
+        { {  1.0f, 0.0f, -1.0f }, { 0.0f, 1.0f, 0.0f }, { 1.0f, 0.0f } },
+    });
+    TEST_ASSERT(mesh.get_data()->bounds_max.y == 2.0f);
+
+    auto shaded = world.create_entity();
+    resource::Transform moved;
+    moved.position = { 10.0f, 0.0f, 0.0f };
+    world.attach_twig(shaded, moved);
+    world.attach_twig(shaded, mesh);
+    resource::Pbr_Material red;
+    red.base_color = { 1.0f, 0.0f, 0.0f, 1.0f };
+    world.attach_twig(shaded, red);
+    graph.add_entity_to_scene(shaded, graph.get_root_node(), "Shaded");
+
+    auto plain = world.create_entity();
+    world.attach_twig(plain, resource::Transform{});
+    world.attach_twig(plain, mesh);
+    graph.add_entity_to_scene(plain, graph.get_root_node(), "Plain");
+
+    auto lamp = world.create_entity();
+    resource::Transform lamp_transform;
+    lamp_transform.position = { 0.0f, 3.0f, 0.0f };
+    world.attach_twig(lamp, lamp_transform);
+    resource::Light point;
+    point.type = resource::Light_Type::point;
+    point.intensity = 2.0f;
+    world.attach_twig(lamp, point);
+    graph.add_entity_to_scene(lamp, graph.get_root_node(), "Lamp");
+
+    // Proxies come from World_Transform, so nothing is drawn before propagation
+    extractor.extract(world);
+    TEST_ASSERT(extractor.get_scene().proxies.empty());
+
+    core::Transform_Propagation propagation;
+    propagation.run(world, graph);
+
+    const auto& scene = extractor.get_scene();
+    TEST_ASSERT(extractor.extract(world) == 2);
+    TEST_ASSERT(scene.proxies.size() == 2);
+    TEST_ASSERT(scene.dirty_proxies.size() == 1 && scene.dirty_proxies[0].begin == 0 && scene.dirty_proxies[0].end == 2);
+    TEST_ASSERT(scene.proxies.meshes[0] == scene.proxies.meshes[1]);     // shared geometry, one key
+    TEST_ASSERT(scene.materials.size() == 2);
+
+    for (std::size_t i = 0; i < scene.proxies.size(); ++i) {
+        const auto& material = scene.materials[scene.proxies.material_indices[i]];
+        const auto& bounds = scene.proxies.bounds[i];
+        if (scene.proxies.entity_ids[i] == shaded.id) {
+            TEST_ASSERT(material.base_color.y == 0.0f);
+            TEST_ASSERT(scene.proxies.flags[i] & app::RENDER_PROXY_OWN_MATERIAL);
+            TEST_ASSERT(std::abs(bounds.center.x - 10.0f) < 1e-5f);
+        } else {
+            TEST_ASSERT(scene.proxies.material_indices[i] == app::Render_Scene::DEFAULT_MATERIAL);
+            TEST_ASSERT(std::abs(bounds.center.y - 1.0f) < 1e-5f);
+            TEST_ASSERT(std::abs(bounds.extents.x - 1.0f) < 1e-5f);
+        }
+    }
+
+    TEST_ASSERT(scene.lights.size() == 1);
+    TEST_ASSERT(scene.lights[0].position_type.y == 3.0f);
+    TEST_ASSERT(scene.lights[0].position_type.w == 1.0f);
+    TEST_ASSERT(scene.lights[0].color_intensity.w == 2.0f);
+
+    auto row_of = [&](core::Entity entity) -> std::size_t {
+        for (std::size_t i = 0; i < scene.proxies.size(); ++i) {
+            if (scene.proxies.entity_ids[i] == entity.id) return i;
+        }
+        return scene.proxies.size();
+    };
+
+    // Nothing written: nothing rewritten
+    propagation.run(world, graph);
+    TEST_ASSERT(extractor.extract(world) == 0);
+    TEST_ASSERT(scene.dirty_proxies.empty());
+    TEST_ASSERT(scene.dirty_materials.empty());
+    TEST_ASSERT(!scene.lights_dirty);
+
+    // Moving one entity rewrites exactly its row
+    world.get_twig<resource::Transform>(plain).position = { 0.0f, 5.0f, 0.0f };
+    propagation.run(world, graph);
+    TEST_ASSERT(extractor.extract(world) == 1);
+    auto plain_row = static_cast<uint32_t>(row_of(plain));
+    TEST_ASSERT(scene.dirty_proxies.size() == 1);
+    TEST_ASSERT(scene.dirty_proxies[0].begin == plain_row && scene.dirty_proxies[0].end == plain_row + 1);
+    TEST_ASSERT(std::abs(scene.proxies.bounds[plain_row].center.y - 6.0f) < 1e-5f);
+    TEST_ASSERT(!scene.lights_dirty);
+
+    // Editing a material patches its table row and leaves proxies alone
+    auto shaded_material = scene.proxies.material_indices[row_of(shaded)];
+    world.get_twig<resource::Pbr_Material>(shaded).base_color = { 0.0f, 0.0f, 1.0f, 1.0f };
+    TEST_ASSERT(extractor.extract(world) == 0);
+    TEST_ASSERT(scene.dirty_materials.size() == 1 && scene.dirty_materials[0].begin == shaded_material);
+    TEST_ASSERT(scene.materials[shaded_material].base_color.z == 1.0f);
+
+    // Moving the lamp repacks the lights only
+    world.get_twig<resource::Transform>(lamp).position = { 0.0f, 4.0f, 0.0f };
+    propagation.run(world, graph);
+    TEST_ASSERT(extractor.extract(world) == 0);
+    TEST_ASSERT(scene.lights_dirty);
+    TEST_ASSERT(scene.lights[0].position_type.y == 4.0f);
+
+    // Gaining a material moves the proxy off the default material
+    resource::Pbr_Material green;
+    green.base_color = { 0.0f, 1.0f, 0.0f, 1.0f };
+    world.attach_twig(plain, green);
+    TEST_ASSERT(extractor.extract(world) == 1);
+    const auto& plain_material = scene.materials[scene.proxies.material_indices[row_of(plain)]];
+    TEST_ASSERT(plain_material.base_color.y == 1.0f);
+    TEST_ASSERT(scene.proxies.flags[row_of(plain)] & app::RENDER_PROXY_OWN_MATERIAL);
+
+    // Destroying an entity drops its proxy and frees its material row
+    world.destroy_entity(shaded);
+    propagation.run(world, graph);
+    extractor.extract(world);
+    TEST_ASSERT(scene.proxies.size() == 1);
+    TEST_ASSERT(scene.proxies.entity_ids[0] == plain.id);
+    TEST_ASSERT(scene.materials[shaded_material].base_color.x == 1.0f && scene.materials[shaded_material].base_color.y == 1.0f);
+    TEST_ASSERT(!scene.dirty_materials.empty());
+    for (const auto& range : scene.dirty_proxies) {
+        TEST_ASSERT(range.end <= scene.proxies.size());
+    }
+
+    // A reset extractor rebuilds the same scene
+    app::Render_Scene_Extractor fresh;
+    fresh.extract(world);
+    TEST_ASSERT(fresh.get_scene().proxies.size() == 1);
+    TEST_ASSERT(fresh.get_scene().proxies.bounds[0].center.y == scene.proxies.bounds[0].center.y);
+
+    core::Scene_Graph::destroy_instance();
+    core::World::destroy_instance();
     return 0;
 }